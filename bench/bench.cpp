@@ -0,0 +1,29 @@
+#include "./bench.hpp"
+
+#include <chrono>
+#include <stdio.h>
+
+double bench_now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void bench_report(const char* p_name, int64_t p_ops, double p_seconds) {
+    printf("%-56s %10.2f ns/op %12.2f Mops/s\n", p_name, p_seconds * 1e9 / double(p_ops), double(p_ops) / p_seconds / 1e6);
+}
+
+void bench_compare(const char* p_name, const char* p_a_name, double p_a_seconds, const char* p_b_name, double p_b_seconds) {
+    printf("%-40s %s %9.3f ms, %s %9.3f ms, x%.2f\n", p_name, p_a_name, p_a_seconds * 1e3, p_b_name, p_b_seconds * 1e3, p_b_seconds / p_a_seconds);
+}
+
+int bench_max_threads() {
+    const int cores = int(std::thread::hardware_concurrency());
+    return cores > 0 ? cores : 1;
+}
+
+int bench_next_threads(int p_threads) {
+    const int max_threads = bench_max_threads();
+    if (p_threads >= max_threads) {
+        return 0;
+    }
+    return MIN(p_threads * 2, max_threads);
+}
@@ -0,0 +1,71 @@
+#ifndef __BENCH_HPP__
+#define __BENCH_HPP__
+
+#include "../core/os/memory.hpp"
+#include "../core/templates/safe_refcount.hpp"
+#include "../core/typedefs.hpp"
+
+#include <stdint.h>
+#include <thread>
+
+/** Helpers shared by the benchmarks of the godot_engine_bench executable,
+ *  built when configuring with -DGODOT_BENCHMARKS=ON. Each benchmark is a
+ *  function listed in bench_main.cpp, printing one line per measurement. */
+
+/** Seconds since an arbitrary point, from a monotonic clock. */
+double bench_now();
+
+/** Prints p_ops operations done in p_seconds, as time per operation and
+ *  operations per second. */
+void bench_report(const char* p_name, int64_t p_ops, double p_seconds);
+
+/** Prints two timings of the same work side by side, with the ratio. */
+void bench_compare(const char* p_name, const char* p_a_name, double p_a_seconds, const char* p_b_name, double p_b_seconds);
+
+int bench_max_threads();
+/** The thread count after p_threads when measuring contention: doubling up
+ *  to the core count, which comes last, then 0. */
+int bench_next_threads(int p_threads);
+
+/** Keeps the compiler from optimizing p_value, and what computed it, out. */
+template <typename T>
+_FORCE_INLINE_ void bench_keep(const T& p_value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(p_value) : "memory");
+#else
+    static volatile T sink;
+    sink = p_value;
+#endif
+}
+
+/** Runs p_func(thread_index) on p_threads threads released together, and
+ *  returns the seconds from the release until the last one finished. */
+template <typename F>
+double bench_run_threads(int p_threads, const F& p_func) {
+    SafeNumeric<int> ready;
+    SafeFlag go;
+    std::thread* threads = memnew_arr(std::thread, p_threads);
+    for (int i = 0; i < p_threads; i++) {
+        threads[i] = std::thread([&p_func, &ready, &go, i]() {
+            ready.increment();
+            while (!go.is_set()) {
+                std::this_thread::yield();
+            }
+            p_func(i);
+        });
+    }
+    while (ready.get() < p_threads) {
+        std::this_thread::yield();
+    }
+
+    const double start = bench_now();
+    go.set();
+    for (int i = 0; i < p_threads; i++) {
+        threads[i].join();
+    }
+    const double seconds = bench_now() - start;
+    memdelete_arr(threads);
+    return seconds;
+}
+
+#endif
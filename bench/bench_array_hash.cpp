@@ -0,0 +1,71 @@
+#include "./bench.hpp"
+
+#include "../core/string/string_name.hpp"
+#include "../core/variant/array.hpp"
+#include "../core/variant/variant.hpp"
+
+#include <stdio.h>
+
+#define BENCH_ARRAY_HASH_SIZE 10000
+#define BENCH_ARRAY_HASH_REPS 2000
+
+/** Hashes p_array p_reps times, rewriting its first element before each one
+ *  so that the cached hash is dropped unless p_cached. */
+static void _bench_array_hash(const char* p_kind, Array& p_array, bool p_cached) {
+    const Variant first = p_array.get(0);
+    uint32_t sum = 0;
+    const double start = bench_now();
+    for (int r = 0; r < BENCH_ARRAY_HASH_REPS; r++) {
+        if (!p_cached) {
+            p_array.set(0, first);
+        }
+        sum += p_array.hash();
+    }
+    const double seconds = bench_now() - start;
+    bench_keep(sum);
+
+    char name[96];
+    if (p_cached) {
+        snprintf(name, sizeof(name), "Array::hash 10K %s, cached, per call", p_kind);
+        bench_report(name, BENCH_ARRAY_HASH_REPS, seconds);
+    } else {
+        snprintf(name, sizeof(name), "Array::hash 10K %s, per element", p_kind);
+        bench_report(name, int64_t(BENCH_ARRAY_HASH_REPS) * BENCH_ARRAY_HASH_SIZE, seconds);
+    }
+}
+
+/** Array::hash() of 10K element arrays, per element: typed arrays stored
+ *  unboxed, untyped ones of a single type hashed as a run of values, and
+ *  ones mixing ints and StringNames hashed element by element. Then the
+ *  cost of a call returning the cached hash. */
+void bench_array_hash() {
+    Array ints;
+    ints.set_typed(Variant::INT, StringName(), Variant());
+    Array floats;
+    floats.set_typed(Variant::FLOAT, StringName(), Variant());
+    Array vectors;
+    vectors.set_typed(Variant::VECTOR3, StringName(), Variant());
+    Array boxed_ints;
+    Array mixed;
+    const StringName name("bench");
+
+    for (int64_t i = 0; i < BENCH_ARRAY_HASH_SIZE; i++) {
+        ints.push_back(i * 7919);
+        floats.push_back(double(i) * 0.5);
+        vectors.push_back(Vector3(real_t(i), real_t(-i), 0.5f));
+        boxed_ints.push_back(i * 7919);
+        if (i % 2) {
+            mixed.push_back(i);
+        } else {
+            mixed.push_back(name);
+        }
+    }
+
+    _bench_array_hash("typed int", ints, false);
+    _bench_array_hash("typed float", floats, false);
+    _bench_array_hash("typed Vector3", vectors, false);
+    _bench_array_hash("untyped int", boxed_ints, false);
+    _bench_array_hash("mixed", mixed, false);
+    _bench_array_hash("typed int", ints, true);
+    _bench_array_hash("mixed", mixed, true);
+}
@@ -0,0 +1,129 @@
+#include "./bench.hpp"
+
+#include "../core/string/float_conversion.hpp"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_FLOAT_CONVERSION_COUNT 1000000
+#define BENCH_FLOAT_CONVERSION_TEXT_SIZE 32
+
+/** Formats p_values with FloatConversion and with libc: snprintf("%.17g"),
+ *  the shortest precision that always round trips. Then parses the shortest
+ *  texts back with both, counting the results that differ from strtod() or
+ *  from the original value, which should be none. */
+static void _bench_float_conversion(const char* p_kind, const double* p_values) {
+    char* texts = memnew_arr(char, BENCH_FLOAT_CONVERSION_COUNT * BENCH_FLOAT_CONVERSION_TEXT_SIZE);
+    char buffer[FloatConversion::FIXED_BUFFER_SIZE];
+    char name[96];
+    int64_t sum = 0;
+
+    double start = bench_now();
+    for (int i = 0; i < BENCH_FLOAT_CONVERSION_COUNT; i++) {
+        char* text = texts + i * BENCH_FLOAT_CONVERSION_TEXT_SIZE;
+        text[FloatConversion::format_shortest(p_values[i], text)] = 0;
+    }
+    const double shortest_seconds = bench_now() - start;
+
+    start = bench_now();
+    for (int i = 0; i < BENCH_FLOAT_CONVERSION_COUNT; i++) {
+        sum += snprintf(buffer, sizeof(buffer), "%.17g", p_values[i]);
+    }
+    const double printf_seconds = bench_now() - start;
+    snprintf(name, sizeof(name), "format %s", p_kind);
+    bench_compare(name, "format_shortest", shortest_seconds, "%.17g", printf_seconds);
+
+    start = bench_now();
+    for (int i = 0; i < BENCH_FLOAT_CONVERSION_COUNT; i++) {
+        sum += FloatConversion::format_shortest(float(p_values[i]), buffer);
+        bench_keep(buffer[0]);
+    }
+    const double shortest_float_seconds = bench_now() - start;
+
+    start = bench_now();
+    for (int i = 0; i < BENCH_FLOAT_CONVERSION_COUNT; i++) {
+        sum += snprintf(buffer, sizeof(buffer), "%.9g", double(float(p_values[i])));
+    }
+    const double printf_float_seconds = bench_now() - start;
+    snprintf(name, sizeof(name), "format float %s", p_kind);
+    bench_compare(name, "format_shortest", shortest_float_seconds, "%.9g", printf_float_seconds);
+
+    start = bench_now();
+    for (int i = 0; i < BENCH_FLOAT_CONVERSION_COUNT; i++) {
+        sum += FloatConversion::format_fixed(p_values[i], 6, buffer);
+        bench_keep(buffer[0]);
+    }
+    const double fixed_seconds = bench_now() - start;
+
+    start = bench_now();
+    for (int i = 0; i < BENCH_FLOAT_CONVERSION_COUNT; i++) {
+        sum += snprintf(buffer, sizeof(buffer), "%.6f", p_values[i]);
+    }
+    const double printf_fixed_seconds = bench_now() - start;
+    snprintf(name, sizeof(name), "format 6 decimals %s", p_kind);
+    bench_compare(name, "format_fixed", fixed_seconds, "%.6f", printf_fixed_seconds);
+    bench_keep(sum);
+
+    double parsed = 0;
+    start = bench_now();
+    for (int i = 0; i < BENCH_FLOAT_CONVERSION_COUNT; i++) {
+        parsed += FloatConversion::parse(texts + i * BENCH_FLOAT_CONVERSION_TEXT_SIZE);
+    }
+    const double parse_seconds = bench_now() - start;
+    bench_keep(parsed);
+
+    parsed = 0;
+    start = bench_now();
+    for (int i = 0; i < BENCH_FLOAT_CONVERSION_COUNT; i++) {
+        parsed += strtod(texts + i * BENCH_FLOAT_CONVERSION_TEXT_SIZE, nullptr);
+    }
+    const double strtod_seconds = bench_now() - start;
+    bench_keep(parsed);
+    snprintf(name, sizeof(name), "parse %s", p_kind);
+    bench_compare(name, "parse", parse_seconds, "strtod", strtod_seconds);
+
+    int mismatches = 0;
+    for (int i = 0; i < BENCH_FLOAT_CONVERSION_COUNT; i++) {
+        const char* text = texts + i * BENCH_FLOAT_CONVERSION_TEXT_SIZE;
+        const double a = FloatConversion::parse(text);
+        const double b = strtod(text, nullptr);
+        mismatches += memcmp(&a, &b, sizeof(double)) != 0 || memcmp(&a, &p_values[i], sizeof(double)) != 0;
+    }
+    if (mismatches) {
+        printf("%-40s %d parses differ from strtod or the value\n", p_kind, mismatches);
+    }
+
+    snprintf(name, sizeof(name), "FloatConversion::format_shortest %s", p_kind);
+    bench_report(name, BENCH_FLOAT_CONVERSION_COUNT, shortest_seconds);
+    snprintf(name, sizeof(name), "FloatConversion::parse %s", p_kind);
+    bench_report(name, BENCH_FLOAT_CONVERSION_COUNT, parse_seconds);
+
+    memdelete_arr(texts);
+}
+
+/** FloatConversion against libc's snprintf() and strtod(), 1M values each:
+ *  finite doubles of random bits, spanning every exponent with 17 digits,
+ *  then short decimals (three digits after the point) like most values in
+ *  scenes and settings. */
+void bench_float_conversion() {
+    double* values = memnew_arr(double, BENCH_FLOAT_CONVERSION_COUNT);
+
+    uint64_t seed = 0x9E3779B97F4A7C15ull;
+    for (int i = 0; i < BENCH_FLOAT_CONVERSION_COUNT; i++) {
+        do {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            memcpy(&values[i], &seed, sizeof(double));
+        } while (!isfinite(values[i]));
+    }
+    _bench_float_conversion("random bits", values);
+
+    for (int i = 0; i < BENCH_FLOAT_CONVERSION_COUNT; i++) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        values[i] = double(int64_t(seed >> 44) - 524288) / 1000.0;
+    }
+    _bench_float_conversion("short decimals", values);
+
+    memdelete_arr(values);
+}
@@ -0,0 +1,110 @@
+#include "./bench.hpp"
+
+#include "../core/templates/hash_map.hpp"
+
+#include <stdio.h>
+#include <unordered_map>
+
+/** std::unordered_map hashing with HashMap's default hasher, so the
+ *  comparison is about the tables and not the hash functions. */
+struct BenchStdHasher {
+    _FORCE_INLINE_ size_t operator()(int64_t p_key) const { return HashMapHasherDefault::hash(p_key); }
+};
+
+typedef HashMap<int64_t, int64_t> BenchMap;
+typedef std::unordered_map<int64_t, int64_t, BenchStdHasher> BenchStdMap;
+
+/** Keys spread over 64 bits, visited in an order unrelated to insertion. */
+static _FORCE_INLINE_ int64_t _bench_hash_map_key(int64_t p_index) {
+    return int64_t(uint64_t(p_index) * 0x9E3779B97F4A7C15ull);
+}
+
+static void _bench_hash_map(int64_t p_size, int p_reps) {
+    const int64_t ops = p_size * p_reps;
+    BenchMap* maps = memnew_arr(BenchMap, p_reps);
+    BenchStdMap* std_maps = memnew_arr(BenchStdMap, p_reps);
+    char name[96];
+
+    double start = bench_now();
+    for (int r = 0; r < p_reps; r++) {
+        for (int64_t i = 0; i < p_size; i++) {
+            maps[r].insert(_bench_hash_map_key(i), i);
+        }
+    }
+    const double insert_seconds = bench_now() - start;
+
+    start = bench_now();
+    for (int r = 0; r < p_reps; r++) {
+        for (int64_t i = 0; i < p_size; i++) {
+            std_maps[r].insert_or_assign(_bench_hash_map_key(i), i);
+        }
+    }
+    const double std_insert_seconds = bench_now() - start;
+    snprintf(name, sizeof(name), "insert %lld x%d", (long long)p_size, p_reps);
+    bench_compare(name, "HashMap", insert_seconds, "std", std_insert_seconds);
+
+    /** Half the lookups miss: odd indices map to keys that were never inserted. */
+    int64_t sum = 0;
+    start = bench_now();
+    for (int r = 0; r < p_reps; r++) {
+        for (int64_t i = 0; i < p_size; i++) {
+            const int64_t* value = maps[r].getptr(_bench_hash_map_key((i * 7919) % p_size + (i & 1) * p_size));
+            sum += value ? *value : 1;
+        }
+    }
+    const double lookup_seconds = bench_now() - start;
+    bench_keep(sum);
+
+    sum = 0;
+    start = bench_now();
+    for (int r = 0; r < p_reps; r++) {
+        for (int64_t i = 0; i < p_size; i++) {
+            const BenchStdMap::const_iterator E = std_maps[r].find(_bench_hash_map_key((i * 7919) % p_size + (i & 1) * p_size));
+            sum += E != std_maps[r].end() ? E->second : 1;
+        }
+    }
+    const double std_lookup_seconds = bench_now() - start;
+    bench_keep(sum);
+    snprintf(name, sizeof(name), "lookup %lld x%d, half misses", (long long)p_size, p_reps);
+    bench_compare(name, "HashMap", lookup_seconds, "std", std_lookup_seconds);
+
+    sum = 0;
+    start = bench_now();
+    for (int r = 0; r < p_reps; r++) {
+        for (const KeyValue<int64_t, int64_t>& E : maps[r]) {
+            sum += E.value;
+        }
+    }
+    const double iterate_seconds = bench_now() - start;
+    bench_keep(sum);
+
+    sum = 0;
+    start = bench_now();
+    for (int r = 0; r < p_reps; r++) {
+        for (const BenchStdMap::value_type& E : std_maps[r]) {
+            sum += E.second;
+        }
+    }
+    const double std_iterate_seconds = bench_now() - start;
+    bench_keep(sum);
+    snprintf(name, sizeof(name), "iterate %lld x%d", (long long)p_size, p_reps);
+    bench_compare(name, "HashMap", iterate_seconds, "std", std_iterate_seconds);
+
+    snprintf(name, sizeof(name), "HashMap insert %lld", (long long)p_size);
+    bench_report(name, ops, insert_seconds);
+    snprintf(name, sizeof(name), "HashMap lookup %lld", (long long)p_size);
+    bench_report(name, ops, lookup_seconds);
+    snprintf(name, sizeof(name), "HashMap iterate %lld", (long long)p_size);
+    bench_report(name, ops, iterate_seconds);
+
+    memdelete_arr(std_maps);
+    memdelete_arr(maps);
+}
+
+/** HashMap against std::unordered_map with int64_t keys and values: inserting
+ *  into an empty map (growing as it goes), looking up keys of which half are
+ *  missing, and iterating. Small maps stay in cache, the 1M one doesn't. */
+void bench_hash_map() {
+    _bench_hash_map(1000, 1000);
+    _bench_hash_map(1000000, 3);
+}
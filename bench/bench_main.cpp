@@ -0,0 +1,47 @@
+#include "./bench.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+void drivers();
+
+void bench_safe_numeric();
+void bench_object_db();
+void bench_method_bind();
+void bench_sort();
+void bench_array_hash();
+void bench_hash_map();
+void bench_float_conversion();
+
+struct BenchEntry {
+    const char* name;
+    void (*function)();
+};
+
+static const BenchEntry benchmarks[] = {
+    { "safe_numeric", &bench_safe_numeric },
+    { "object_db", &bench_object_db },
+    { "method_bind", &bench_method_bind },
+    { "sort", &bench_sort },
+    { "array_hash", &bench_array_hash },
+    { "hash_map", &bench_hash_map },
+    { "float_conversion", &bench_float_conversion },
+};
+
+/** Runs the benchmarks whose name contains one of the arguments, or all of
+ *  them without arguments. */
+int main(int argc, char** argv) {
+    drivers();
+
+    for (const BenchEntry& entry : benchmarks) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc && !selected; i++) {
+            selected = strstr(entry.name, argv[i]) != nullptr;
+        }
+        if (selected) {
+            printf("== %s\n", entry.name);
+            entry.function();
+        }
+    }
+    return 0;
+}
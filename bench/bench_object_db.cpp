@@ -0,0 +1,72 @@
+#include "./bench.hpp"
+
+#include "../core/object/object.hpp"
+
+#include <stdio.h>
+
+#define BENCH_OBJECT_DB_LOOKUPS 10000000
+#define BENCH_OBJECT_DB_OBJECTS 65536
+
+/** ObjectDB::get_instance() throughput, 10M lookups split across threads:
+ *  of live objects in a random order, then of freed ones, whose slots were
+ *  recycled by objects made since. */
+void bench_object_db() {
+    Object** objects = memnew_arr(Object*, BENCH_OBJECT_DB_OBJECTS);
+    ObjectID* ids = memnew_arr(ObjectID, BENCH_OBJECT_DB_OBJECTS);
+    for (int i = 0; i < BENCH_OBJECT_DB_OBJECTS; i++) {
+        objects[i] = memnew(Object);
+        ids[i] = objects[i]->get_instance_id();
+    }
+
+    /** Looked up in a shuffled order, so slots aren't read one after the other. */
+    uint32_t seed = 0x9E3779B9u;
+    for (int i = BENCH_OBJECT_DB_OBJECTS - 1; i > 0; i--) {
+        seed = seed * 1664525u + 1013904223u;
+        SWAP(ids[i], ids[(seed >> 8) % uint32_t(i + 1)]);
+    }
+
+    for (int threads = 1; threads > 0; threads = bench_next_threads(threads)) {
+        const int per_thread = BENCH_OBJECT_DB_LOOKUPS / threads;
+        char name[96];
+
+        const double seconds = bench_run_threads(threads, [ids, per_thread](int p_thread) {
+            uint64_t found = 0;
+            int index = (p_thread * 7919) & (BENCH_OBJECT_DB_OBJECTS - 1);
+            for (int i = 0; i < per_thread; i++) {
+                found += ObjectDB::get_instance(ids[index]) != nullptr;
+                index = (index + 1) & (BENCH_OBJECT_DB_OBJECTS - 1);
+            }
+            bench_keep(found);
+        });
+        snprintf(name, sizeof(name), "ObjectDB get_instance live, %d threads", threads);
+        bench_report(name, int64_t(per_thread) * threads, seconds);
+    }
+
+    for (int i = 0; i < BENCH_OBJECT_DB_OBJECTS; i++) {
+        memdelete(objects[i]);
+        objects[i] = memnew(Object);
+    }
+
+    for (int threads = 1; threads > 0; threads = bench_next_threads(threads)) {
+        const int per_thread = BENCH_OBJECT_DB_LOOKUPS / threads;
+        char name[96];
+
+        const double seconds = bench_run_threads(threads, [ids, per_thread](int p_thread) {
+            uint64_t found = 0;
+            int index = (p_thread * 7919) & (BENCH_OBJECT_DB_OBJECTS - 1);
+            for (int i = 0; i < per_thread; i++) {
+                found += ObjectDB::get_instance(ids[index]) != nullptr;
+                index = (index + 1) & (BENCH_OBJECT_DB_OBJECTS - 1);
+            }
+            bench_keep(found);
+        });
+        snprintf(name, sizeof(name), "ObjectDB get_instance stale, %d threads", threads);
+        bench_report(name, int64_t(per_thread) * threads, seconds);
+    }
+
+    for (int i = 0; i < BENCH_OBJECT_DB_OBJECTS; i++) {
+        memdelete(objects[i]);
+    }
+    memdelete_arr(ids);
+    memdelete_arr(objects);
+}
@@ -0,0 +1,93 @@
+#include "./bench.hpp"
+
+#include <stdio.h>
+
+#define BENCH_SAFE_NUMERIC_OPS 5000000
+
+/** Per-op cost of SafeNumeric under contention, for each memory ordering:
+ *  all threads on a single counter, then each thread on its own counter,
+ *  packed next to the others or padded to a cache line. */
+void bench_safe_numeric() {
+    for (int threads = 1; threads > 0; threads = bench_next_threads(threads)) {
+        const int64_t ops = int64_t(BENCH_SAFE_NUMERIC_OPS) * threads;
+        char name[96];
+
+        SafeNumeric<uint64_t> shared;
+        double seconds = bench_run_threads(threads, [&shared](int) {
+            for (int i = 0; i < BENCH_SAFE_NUMERIC_OPS; i++) {
+                shared.increment();
+            }
+        });
+        snprintf(name, sizeof(name), "SafeNumeric shared increment acq_rel, %d threads", threads);
+        bench_report(name, ops, seconds);
+
+        seconds = bench_run_threads(threads, [&shared](int) {
+            for (int i = 0; i < BENCH_SAFE_NUMERIC_OPS; i++) {
+                shared.increment_relaxed();
+            }
+        });
+        snprintf(name, sizeof(name), "SafeNumeric shared increment relaxed, %d threads", threads);
+        bench_report(name, ops, seconds);
+
+        seconds = bench_run_threads(threads, [&shared](int) {
+            uint64_t sum = 0;
+            for (int i = 0; i < BENCH_SAFE_NUMERIC_OPS; i++) {
+                sum += shared.get();
+            }
+            bench_keep(sum);
+        });
+        snprintf(name, sizeof(name), "SafeNumeric shared get acquire, %d threads", threads);
+        bench_report(name, ops, seconds);
+
+        seconds = bench_run_threads(threads, [&shared](int) {
+            uint64_t sum = 0;
+            for (int i = 0; i < BENCH_SAFE_NUMERIC_OPS; i++) {
+                sum += shared.get_relaxed();
+            }
+            bench_keep(sum);
+        });
+        snprintf(name, sizeof(name), "SafeNumeric shared get relaxed, %d threads", threads);
+        bench_report(name, ops, seconds);
+
+        SafeNumeric<uint64_t>* packed = memnew_arr(SafeNumeric<uint64_t>, threads);
+        seconds = bench_run_threads(threads, [packed](int p_thread) {
+            for (int i = 0; i < BENCH_SAFE_NUMERIC_OPS; i++) {
+                packed[p_thread].increment();
+            }
+        });
+        snprintf(name, sizeof(name), "SafeNumeric own increment acq_rel, %d threads", threads);
+        bench_report(name, ops, seconds);
+
+        seconds = bench_run_threads(threads, [packed](int p_thread) {
+            for (int i = 0; i < BENCH_SAFE_NUMERIC_OPS; i++) {
+                packed[p_thread].increment_relaxed();
+            }
+        });
+        snprintf(name, sizeof(name), "SafeNumeric own increment relaxed, %d threads", threads);
+        bench_report(name, ops, seconds);
+        memdelete_arr(packed);
+
+        // memnew_arr() only aligns to 16 bytes; the counters must each start
+        // a cache line, or neighbours could still share one.
+        SafeNumericPadded<uint64_t>* padded = (SafeNumericPadded<uint64_t>*)Memory::alloc_aligned_static(sizeof(SafeNumericPadded<uint64_t>) * threads, SAFE_NUMERIC_CACHE_LINE_SIZE);
+        for (int i = 0; i < threads; i++) {
+            memnew_placement(&padded[i], SafeNumericPadded<uint64_t>);
+        }
+        seconds = bench_run_threads(threads, [padded](int p_thread) {
+            for (int i = 0; i < BENCH_SAFE_NUMERIC_OPS; i++) {
+                padded[p_thread].increment();
+            }
+        });
+        snprintf(name, sizeof(name), "SafeNumericPadded own increment acq_rel, %d threads", threads);
+        bench_report(name, ops, seconds);
+
+        seconds = bench_run_threads(threads, [padded](int p_thread) {
+            for (int i = 0; i < BENCH_SAFE_NUMERIC_OPS; i++) {
+                padded[p_thread].increment_relaxed();
+            }
+        });
+        snprintf(name, sizeof(name), "SafeNumericPadded own increment relaxed, %d threads", threads);
+        bench_report(name, ops, seconds);
+        Memory::free_aligned_static(padded);
+    }
+}
@@ -0,0 +1,71 @@
+#include "./bench.hpp"
+
+#include "../core/templates/sort_array.hpp"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+/** Sorts p_reps copies of p_source with p_sort, timing only the sorts. */
+template <typename F>
+static double _bench_sort_time(const int64_t* p_source, int64_t* p_work, int64_t p_size, int p_reps, const F& p_sort) {
+    double seconds = 0;
+    for (int r = 0; r < p_reps; r++) {
+        memcpy(p_work, p_source, p_size * sizeof(int64_t));
+        const double start = bench_now();
+        p_sort(p_work, p_size);
+        seconds += bench_now() - start;
+        bench_keep(p_work[p_size / 2]);
+    }
+    return seconds;
+}
+
+/** Random int64 keys, 1K, 1M and 100M of them, through each sort the engine
+ *  has and std::sort. Reported per element; the 1K case repeats to run
+ *  long enough to time. 100M takes about 2.4GB. */
+void bench_sort() {
+    static const int64_t sizes[] = { 1000, 1000000, 100000000 };
+    static const int reps[] = { 2000, 5, 1 };
+
+    for (int s = 0; s < 3; s++) {
+        const int64_t size = sizes[s];
+        int64_t* source = memnew_arr(int64_t, size);
+        int64_t* work = memnew_arr(int64_t, size);
+        uint64_t seed = 0x9E3779B97F4A7C15ull;
+        for (int64_t i = 0; i < size; i++) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            source[i] = int64_t(seed >> 1);
+        }
+
+        const int64_t elements = size * reps[s];
+        char name[96];
+
+        SortArray<int64_t> sorter;
+        double seconds = _bench_sort_time(source, work, size, reps[s], [&sorter](int64_t* p_array, int64_t p_size) {
+            sorter.sort(p_array, p_size);
+        });
+        snprintf(name, sizeof(name), "SortArray::sort, %lld elements", (long long)size);
+        bench_report(name, elements, seconds);
+
+        seconds = _bench_sort_time(source, work, size, reps[s], [&sorter](int64_t* p_array, int64_t p_size) {
+            sorter.parallel_sort(p_array, p_size);
+        });
+        snprintf(name, sizeof(name), "SortArray::parallel_sort, %lld elements", (long long)size);
+        bench_report(name, elements, seconds);
+
+        seconds = _bench_sort_time(source, work, size, reps[s], [](int64_t* p_array, int64_t p_size) {
+            RadixSort<int64_t>::sort(p_array, p_size);
+        });
+        snprintf(name, sizeof(name), "RadixSort::sort, %lld elements", (long long)size);
+        bench_report(name, elements, seconds);
+
+        seconds = _bench_sort_time(source, work, size, reps[s], [](int64_t* p_array, int64_t p_size) {
+            std::sort(p_array, p_array + p_size);
+        });
+        snprintf(name, sizeof(name), "std::sort, %lld elements", (long long)size);
+        bench_report(name, elements, seconds);
+
+        memdelete_arr(work);
+        memdelete_arr(source);
+    }
+}
@@ -1,7 +1,150 @@
 #include "./error_macros.hpp"
 
+#include "../io/logger.hpp"
+#include "../string/ustring.hpp"
 
+#include <stdarg.h>
+#include <stdio.h>
 
-#if defined(DEBUG_ENABLED) && defined(TOOLS_ENABLED)
+static ErrorHandlerList *error_handler_list = nullptr;
 
-#endif
+void add_error_handler(ErrorHandlerList *p_handler) {
+    /** If p_handler is already in error_handler_list
+     *  we'd better remove it first then we can add it.
+     *  This prevent cyclic redundancy.
+     */
+    remove_error_handler(p_handler);
+
+    _global_lock();
+
+    p_handler->next = error_handler_list;
+    error_handler_list = p_handler;
+
+    _global_unlock();
+}
+
+void remove_error_handler(const ErrorHandlerList *p_handler) {
+    _global_lock();
+
+    ErrorHandlerList *prev = nullptr;
+    ErrorHandlerList *l = error_handler_list;
+
+    while (l) {
+        if (l == p_handler) {
+            if (prev) {
+                prev->next = l->next;
+            } else {
+                error_handler_list = l->next;
+            }
+            break;
+        }
+        prev = l;
+        l = l->next;
+    }
+
+    _global_unlock();
+}
+
+static const char *_error_type_string(ErrorHandlerType p_type) {
+    switch (p_type) {
+        case ErrorHandlerType::ERROR_HANDLER_WARNING:
+            return "WARNING";
+        case ErrorHandlerType::ERROR_HANDLER_SCRIPT:
+            return "SCRIPT ERROR";
+        case ErrorHandlerType::ERROR_HANDLER_SHADER:
+            return "SHADER ERROR";
+        case ErrorHandlerType::ERROR_HANDLER_ERROR:
+        default:
+            return "ERROR";
+    }
+}
+
+/** Through the Logger when there is one, so that the thread hitting the
+ *  error doesn't wait on the output. */
+static void _error_printf(const char *p_format, ...) {
+    va_list list;
+    va_start(list, p_format);
+    Logger *logger = Logger::get_singleton();
+    if (logger) {
+        logger->logv(p_format, list, Logger::STREAM_STDERR);
+    } else {
+        vfprintf(stderr, p_format, list);
+    }
+    va_end(list);
+}
+
+void _error_print_error(const char *p_function, const char *p_file, int p_line,
+                        const char *p_error, bool p_editor_notify, ErrorHandlerType p_type) {
+    _error_print_error(p_function, p_file, p_line, p_error, "", p_editor_notify, p_type);
+}
+
+void _error_print_error(const char *p_function, const char *p_file, int32_t p_line,
+                        const char *p_error, const char *p_message,
+                        bool p_editor_notify, ErrorHandlerType p_type) {
+    const char *err_details = (p_message && *p_message) ? p_message : p_error;
+    _error_printf("%s: %s\n   at: %s (%s:%i)\n", _error_type_string(p_type), err_details, p_function, p_file, p_line);
+
+    _global_lock();
+
+    ErrorHandlerList *l = error_handler_list;
+    while (l) {
+        l->error_function(l->user_data, p_function, p_file, p_line, p_error, p_message, p_editor_notify, p_type);
+        l = l->next;
+    }
+
+    _global_unlock();
+}
+
+void _error_print_error(const char *p_function, const char *p_file, int32_t p_line,
+                        const String &p_error, bool p_editor_notify, ErrorHandlerType p_type) {
+    _error_print_error(p_function, p_file, p_line, p_error.utf8().get_data(), "", p_editor_notify, p_type);
+}
+
+void _error_print_error(const char *p_function, const char *p_file, int32_t p_line,
+                        const String &p_error, const char *p_message,
+                        bool p_editor_notify, ErrorHandlerType p_type) {
+    _error_print_error(p_function, p_file, p_line, p_error.utf8().get_data(), p_message, p_editor_notify, p_type);
+}
+
+void _error_print_error(const char *p_function, const char *p_file, int32_t p_line,
+                        const char *p_error, const String &p_message,
+                        bool p_editor_notify, ErrorHandlerType p_type) {
+    _error_print_error(p_function, p_file, p_line, p_error, p_message.utf8().get_data(), p_editor_notify, p_type);
+}
+
+void _error_print_error(const char *p_function, const char *p_file, int32_t p_line,
+                        const String &p_error, const String &p_message,
+                        bool p_editor_notify, ErrorHandlerType p_type) {
+    _error_print_error(p_function, p_file, p_line, p_error.utf8().get_data(), p_message.utf8().get_data(), p_editor_notify, p_type);
+}
+
+void _error_print_error_asap(const String &p_error, ErrorHandlerType p_type) {
+    fprintf(stderr, "%s: %s\n", _error_type_string(p_type), p_error.utf8().get_data());
+}
+
+void _error_print_index_error(const char *p_function, const char *p_file, int32_t p_line,
+                              int64_t p_index, int64_t p_size, const char *p_index_str,
+                              const char *p_size_str, const char *p_message,
+                              bool p_editor_notify, bool fatal) {
+    char err[512];
+    snprintf(err, sizeof(err), "%sIndex %s = %lld is out of bounds (%s = %lld).",
+             fatal ? "FATAL: " : "", p_index_str, (long long)p_index, p_size_str, (long long)p_size);
+
+    _error_print_error(p_function, p_file, p_line, err, p_message, p_editor_notify, ErrorHandlerType::ERROR_HANDLER_ERROR);
+}
+
+void _error_print_index_error(const char *p_function, const char *p_file, int32_t p_line,
+                              int64_t p_index, int64_t p_size, const char *p_index_str,
+                              const char *p_size_str, const String &p_message,
+                              bool p_editor_notify, bool fatal) {
+    _error_print_index_error(p_function, p_file, p_line, p_index, p_size, p_index_str, p_size_str,
+                             p_message.utf8().get_data(), p_editor_notify, fatal);
+}
+
+void _error_flush_stdout() {
+    Logger *logger = Logger::get_singleton();
+    if (logger) {
+        logger->flush_on_crash();
+    }
+    fflush(stdout);
+}
@@ -139,9 +139,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         return;                                                                                                   \
     }                                                                                                             \
     else                                                                                                          \
-    {                                                                                                             \
-        ((void)0)                                                                                                 \
-    }
+        ((void)0)
 
 /**
  * Ensures an integer index `m_index` is less than `m_size` and greater than or equal to 0.
@@ -154,9 +152,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         return;                                                                                                          \
     }                                                                                                                    \
     else                                                                                                                 \
-    {                                                                                                                    \
-        ((void)0)                                                                                                        \
-    }
+        ((void)0)
 
 /**
  * Same as `ERROR_FAIL_INDEX_MSG` but also notifies the editor.
@@ -168,9 +164,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         return;                                                                                                                \
     }                                                                                                                          \
     else                                                                                                                       \
-    {                                                                                                                          \
-        ((void)0)                                                                                                              \
-    }
+        ((void)0)
 
 /**
  * Try using `ERROR_FAIL_INDEX_V_MSG`.
@@ -186,9 +180,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         return m_retval;                                                                                          \
     }                                                                                                             \
     else                                                                                                          \
-    {                                                                                                             \
-        ((void)0)                                                                                                 \
-    }
+        ((void)0)
 
 /**
  * Ensures an integer index `m_index` is less than `m_size` and greater than or equal to 0.
@@ -201,9 +193,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         return m_retval;                                                                                                 \
     }                                                                                                                    \
     else                                                                                                                 \
-    {                                                                                                                    \
-        ((void)0)                                                                                                        \
-    }
+        ((void)0)
 
 /**
  * Same as `ERROR_FAIL_INDEX_V_MSG` but also notifies the editor.
@@ -215,9 +205,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         return m_retval;                                                                                                       \
     }                                                                                                                          \
     else                                                                                                                       \
-    {                                                                                                                          \
-        ((void)0)                                                                                                              \
-    }
+        ((void)0)
 
 /**
  * Try using `ERROR_FAIL_INDEX_MSG` or `ERROR_FAIL_INDEX_V_MSG`.
@@ -235,9 +223,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         GENERATE_TRAP();                                                                                                           \
     }                                                                                                                              \
     else                                                                                                                           \
-    {                                                                                                                              \
-        ((void)0)                                                                                                                  \
-    }
+        ((void)0)
 
 /**
  * Try using `ERROR_FAIL_INDEX_MSG` or `ERROR_FAIL_INDEX_V_MSG`.
@@ -254,9 +240,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         GENERATE_TRAP();                                                                                                              \
     }                                                                                                                                 \
     else                                                                                                                              \
-    {                                                                                                                                 \
-        ((void)0)                                                                                                                     \
-    }
+        ((void)0)
 
 /** Unsigned integer index out of bounds error macros. */
 
@@ -274,9 +258,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         return;                                                                                                   \
     }                                                                                                             \
     else                                                                                                          \
-    {                                                                                                             \
-        ((void)0)                                                                                                 \
-    }
+        ((void)0)
 
 /**
  * Ensures an unsigned integer index `m_index` is less than `m_size`.
@@ -289,9 +271,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         return;                                                                                                          \
     }                                                                                                                    \
     else                                                                                                                 \
-    {                                                                                                                    \
-        ((void)0)                                                                                                        \
-    }
+        ((void)0)
 
 /**
  * Same as `ERROR_FAIL_UNSIGNED_INDEX_MSG` but also notifies the editor.
@@ -303,9 +283,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         return;                                                                                                                \
     }                                                                                                                          \
     else                                                                                                                       \
-    {                                                                                                                          \
-        ((void)0)                                                                                                              \
-    }
+        ((void)0)
 
 /**
  * Try using `ERROR_FAIL_UNSIGNED_INDEX_V_MSG`.
@@ -321,9 +299,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         return m_retval;                                                                                          \
     }                                                                                                             \
     else                                                                                                          \
-    {                                                                                                             \
-        ((void)0)                                                                                                 \
-    }
+        ((void)0)
 
 /**
  * Ensures an unsigned integer index `m_index` is less than `m_size`.
@@ -336,9 +312,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         return m_retval;                                                                                                 \
     }                                                                                                                    \
     else                                                                                                                 \
-    {                                                                                                                    \
-        ((void)0)                                                                                                        \
-    }
+        ((void)0)
 
 /**
  * Same as `ERROR_FAIL_UNSIGNED_INDEX_V_EDMSG` but also notifies the editor.
@@ -824,13 +798,13 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
  * If warning about deprecated usage, use `WARNING_DEPRECATED` or `WARNING_DEPRECATED_MSG` instead.
  */
 #define WARNING_PRINT(m_msg) \
-    _error_print_error(FUNCTION_STR, __FILE__, __LINE__, m_msg, false, ERR_HANDLER_WARNING)
+    _error_print_error(FUNCTION_STR, __FILE__, __LINE__, m_msg, false, ErrorHandlerType::ERROR_HANDLER_WARNING)
 
 /**
  * Same as `WARNING_PRINT` but also notifies the editor.
  */
 #define WARNING_PRINT_ED(m_msg) \
-    _error_print_error(FUNCTION_STR, __FILE__, __LINE__, m_msg, true, ERR_HANDLER_WARNING)
+    _error_print_error(FUNCTION_STR, __FILE__, __LINE__, m_msg, true, ErrorHandlerType::ERROR_HANDLER_WARNING)
 
 /**
  * Prints `m_msg` once during the application lifetime.
@@ -843,7 +817,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         static bool first_print = true;                                                              \
         if (first_print)                                                                             \
         {                                                                                            \
-            _error_print_error(FUNCTION_STR, __FILE__, __LINE__, m_msg, false, ERR_HANDLER_WARNING); \
+            _error_print_error(FUNCTION_STR, __FILE__, __LINE__, m_msg, false, ErrorHandlerType::ERROR_HANDLER_WARNING); \
             first_print = false;                                                                     \
         }                                                                                            \
     }                                                                                                \
@@ -859,7 +833,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         static bool first_print = true;                                                             \
         if (first_print)                                                                            \
         {                                                                                           \
-            _error_print_error(FUNCTION_STR, __FILE__, __LINE__, m_msg, true, ERR_HANDLER_WARNING); \
+            _error_print_error(FUNCTION_STR, __FILE__, __LINE__, m_msg, true, ErrorHandlerType::ERROR_HANDLER_WARNING); \
             first_print = false;                                                                    \
         }                                                                                           \
     }                                                                                               \
@@ -873,7 +847,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
     {                                   \
         if (is_print_verbose_enabled()) \
         {                               \
-            WARN_PRINT(m_msg);          \
+            WARNING_PRINT(m_msg);          \
         }                               \
     }
 
@@ -888,7 +862,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         static std::atomic<bool> warning_shown;                                                                                                                     \
         if (!warning_shown.load())                                                                                                                                  \
         {                                                                                                                                                           \
-            _error_print_error(FUNCTION_STR, __FILE__, __LINE__, "This method has been deprecated and will be removed in the future.", false, ERR_HANDLER_WARNING); \
+            _error_print_error(FUNCTION_STR, __FILE__, __LINE__, "This method has been deprecated and will be removed in the future.", false, ErrorHandlerType::ERROR_HANDLER_WARNING); \
             warning_shown.store(true);                                                                                                                              \
         }                                                                                                                                                           \
     }                                                                                                                                                               \
@@ -904,7 +878,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         static std::atomic<bool> warning_shown;                                                                                                                            \
         if (!warning_shown.load())                                                                                                                                         \
         {                                                                                                                                                                  \
-            _error_print_error(FUNCTION_STR, __FILE__, __LINE__, "This method has been deprecated and will be removed in the future.", m_msg, false, ERR_HANDLER_WARNING); \
+            _error_print_error(FUNCTION_STR, __FILE__, __LINE__, "This method has been deprecated and will be removed in the future.", m_msg, false, ErrorHandlerType::ERROR_HANDLER_WARNING); \
             warning_shown.store(true);                                                                                                                                     \
         }                                                                                                                                                                  \
     }                                                                                                                                                                      \
@@ -966,9 +940,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         GENERATE_TRAP();                                                                                                  \
     }                                                                                                                     \
     else                                                                                                                  \
-    {                                                                                                                     \
-        ((void)0)                                                                                                         \
-    }
+        ((void)0)
 #else
 #define DEV_ASSERT(m_cond)
 #endif
@@ -980,9 +952,7 @@ void _physics_interpolation_warning(const char *p_function, const char *p_file,
         ERROR_PRINT_ONCE("DEV_CHECK_ONCE failed  \"" _STR(m_cond) "\" is false."); \
     }                                                                              \
     else                                                                           \
-    {                                                                              \
-        ((void)0)                                                                  \
-    }
+        ((void)0)
 #else
 #define DEV_CHECK_ONCE(m_cond)
 #endif
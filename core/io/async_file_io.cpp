@@ -0,0 +1,95 @@
+#include "./async_file_io.hpp"
+
+#include "../error/error_macros.hpp"
+#include "../os/memory.hpp"
+#include "./async_file_io_threaded.hpp"
+
+AsyncFileIO::CreateFunc AsyncFileIO::_create_func = nullptr;
+
+AsyncFileIO::Request* AsyncFileIO::_get_requests(AsyncFileBatch* p_batch) {
+    return p_batch->_writable;
+}
+
+void AsyncFileIO::_request_done(AsyncFileBatch* p_batch) {
+    if (p_batch->_pending.decrement() > 0) {
+        return;
+    }
+
+    {
+        MutexLock lock(p_batch->_mutex);
+        p_batch->_completed.set();
+    }
+    if (p_batch->_callback) {
+        p_batch->_callback(p_batch->_userdata, p_batch);
+    }
+    p_batch->_condition.notify_all();
+}
+
+AsyncFileIO* AsyncFileIO::create() {
+    if (_create_func) {
+        AsyncFileIO* io = _create_func();
+        if (io) {
+            return io;
+        }
+    }
+    return memnew(AsyncFileIOThreaded);
+}
+
+Ref<AsyncFileBatch> AsyncFileIO::submit(const Vector<Request>& p_requests, BatchCallback p_callback, void* p_userdata) {
+    Ref<AsyncFileBatch> batch;
+    batch.instantiate();
+    batch->_requests = p_requests;
+    batch->_writable = batch->_requests.ptrw();
+    batch->_callback = p_callback;
+    batch->_userdata = p_userdata;
+    batch->_pending.set(p_requests.size());
+
+    for (int64_t i = 0; i < p_requests.size(); i++) {
+        batch->_writable[i].error = Errors::NONE;
+        if (batch->_writable[i].operation == OP_READ) {
+            batch->_writable[i].data.clear();
+        }
+    }
+
+    if (p_requests.is_empty()) {
+        // Nothing for the backend: complete right away, callback included.
+        batch->_pending.set(1);
+        _request_done(batch.ptr());
+        return batch;
+    }
+    _submit(batch);
+    return batch;
+}
+
+Ref<AsyncFileBatch> AsyncFileIO::read_files(const Vector<String>& p_paths, BatchCallback p_callback, void* p_userdata) {
+    Vector<Request> requests;
+    requests.resize(p_paths.size());
+    Request* w = requests.ptrw();
+    for (int64_t i = 0; i < p_paths.size(); i++) {
+        w[i].operation = OP_READ;
+        w[i].path = p_paths[i];
+    }
+    return submit(requests, p_callback, p_userdata);
+}
+
+const AsyncFileIO::Request& AsyncFileBatch::get_request(int64_t p_index) const {
+    CRASH_COND_MSG(!is_completed(), "The batch hasn't completed yet.");
+    return _requests[p_index];
+}
+
+Errors AsyncFileBatch::get_error() const {
+    ERROR_FAIL_COND_V_MSG(!is_completed(), Errors::ERROR_BUSY, "The batch hasn't completed yet.");
+    for (int64_t i = 0; i < _requests.size(); i++) {
+        if (_requests[i].error != Errors::NONE) {
+            return _requests[i].error;
+        }
+    }
+    return Errors::NONE;
+}
+
+void AsyncFileBatch::wait() const {
+    MutexLock lock(_mutex);
+    while (!_completed.is_set()) {
+        _condition.wait(lock);
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef __ASYNC_FILE_IO_HPP__
+#define __ASYNC_FILE_IO_HPP__
+
+#include "../error/error_list.hpp"
+#include "../object/ref_counted.hpp"
+#include "../os/condition_variable.hpp"
+#include "../os/mutex.hpp"
+#include "../string/ustring.hpp"
+#include "../templates/safe_refcount.hpp"
+#include "../templates/vector.hpp"
+#include "../typedefs.hpp"
+
+#include <stdint.h>
+
+class AsyncFileBatch;
+
+/** Reads and writes whole batches of files without blocking the caller.
+ *
+ *  submit() hands a batch of requests to the backend and returns at once;
+ *  the AsyncFileBatch it returns completes when all of them are done, and can
+ *  be polled, waited on, or report through a callback. Keeping many requests
+ *  in flight is what keeps a fast drive busy when loading many small files,
+ *  which blocking reads one after the other can't.
+ *
+ *  create() picks the backend registered by the platform with
+ *  set_create_func(), io_uring on Linux, when it works on the running system,
+ *  and AsyncFileIOThreaded, blocking FileAccess calls on worker threads,
+ *  otherwise.
+ */
+class AsyncFileIO {
+public:
+    enum Operation {
+        /** Reads length bytes from offset, or up to the end for -1. Reading
+         *  less because the file is shorter isn't an error. */
+        OP_READ,
+        /** Replaces the file with data, creating it if needed. */
+        OP_WRITE,
+    };
+
+    struct Request {
+        Operation operation = OP_READ;
+        String path;
+        uint64_t offset = 0;
+        int64_t length = -1;
+        /** Written by OP_WRITE; what OP_READ read, once completed. */
+        Vector<uint8_t> data;
+        /** Set on completion. */
+        Errors error = Errors::NONE;
+    };
+
+    /** Called once the whole batch completed, on an I/O thread. It should
+     *  return quickly, and not wait for other batches. */
+    typedef void (*BatchCallback)(void* p_userdata, AsyncFileBatch* p_batch);
+    /** A backend, or nullptr when it can't work on this system. */
+    typedef AsyncFileIO* (*CreateFunc)();
+
+private:
+    static CreateFunc _create_func;
+
+protected:
+    /** The requests of p_batch, for the backend to fulfill. */
+    static Request* _get_requests(AsyncFileBatch* p_batch);
+    /** Marks a request of p_batch as done; the last one completes it. */
+    static void _request_done(AsyncFileBatch* p_batch);
+
+    /** Starts every request of p_batch, which isn't empty. */
+    virtual void _submit(const Ref<AsyncFileBatch>& p_batch) = 0;
+
+public:
+    static void set_create_func(CreateFunc p_func) { _create_func = p_func; }
+    /** A new AsyncFileIO, to memdelete() once done with it. Deleting it waits
+     *  for the submitted batches. */
+    static AsyncFileIO* create();
+
+    Ref<AsyncFileBatch> submit(const Vector<Request>& p_requests, BatchCallback p_callback = nullptr, void* p_userdata = nullptr);
+    /** Submits a whole file read for each path. */
+    Ref<AsyncFileBatch> read_files(const Vector<String>& p_paths, BatchCallback p_callback = nullptr, void* p_userdata = nullptr);
+
+    virtual String get_backend_name() const = 0;
+
+    virtual ~AsyncFileIO() {}
+};
+
+/** Requests submitted together, and their results once completed. */
+class AsyncFileBatch : public RefCounted {
+    GDCLASS(AsyncFileBatch, RefCounted);
+
+    friend class AsyncFileIO;
+
+    Vector<AsyncFileIO::Request> _requests;
+    /** _requests.ptrw(), taken once so that the I/O threads never touch the
+     *  copy on write. */
+    AsyncFileIO::Request* _writable = nullptr;
+    AsyncFileIO::BatchCallback _callback = nullptr;
+    void* _userdata = nullptr;
+
+    SafeNumeric<int64_t> _pending;
+    SafeFlag _completed;
+    BinaryMutex _mutex;
+    ConditionVariable _condition;
+
+public:
+    _FORCE_INLINE_ int64_t get_request_count() const { return _requests.size(); }
+    /** The request with its results; only once completed. */
+    const AsyncFileIO::Request& get_request(int64_t p_index) const;
+    /** The first error among the requests, or NONE; only once completed. */
+    Errors get_error() const;
+
+    _FORCE_INLINE_ bool is_completed() const { return _completed.is_set(); }
+    void wait() const;
+};
+
+#endif
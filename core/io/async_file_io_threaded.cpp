@@ -0,0 +1,92 @@
+#include "./async_file_io_threaded.hpp"
+
+#include "../os/memory.hpp"
+#include "./file_access.hpp"
+
+void AsyncFileIOThreaded::_run_request(Request& r_request) {
+    Errors err;
+    if (r_request.operation == OP_WRITE) {
+        Ref<FileAccess> file = FileAccess::open(r_request.path, FileAccess::WRITE, &err);
+        if (file.is_null()) {
+            r_request.error = err;
+            return;
+        }
+        file->store_buffer(r_request.data);
+        file->flush();
+        r_request.error = file->get_error();
+        return;
+    }
+
+    Ref<FileAccess> file = FileAccess::open(r_request.path, FileAccess::READ, &err);
+    if (file.is_null()) {
+        r_request.error = err;
+        return;
+    }
+    const uint64_t length = file->get_length();
+    const uint64_t available = r_request.offset < length ? length - r_request.offset : 0;
+    const uint64_t wanted = r_request.length < 0 ? available : MIN(uint64_t(r_request.length), available);
+    file->seek(r_request.offset);
+    r_request.data = file->get_buffer(int64_t(wanted));
+}
+
+void AsyncFileIOThreaded::_worker() {
+    while (true) {
+        Ref<AsyncFileBatch> batch;
+        int64_t index;
+        {
+            MutexLock lock(_mutex);
+            while (!_exiting && _queue_head == _queue.size()) {
+                _condition.wait(lock);
+            }
+            if (_queue_head == _queue.size()) {
+                // Exiting, and nothing left to do.
+                return;
+            }
+
+            Pending& pending = _queue.ptrw()[_queue_head];
+            batch = pending.batch;
+            index = pending.next++;
+            if (pending.next == batch->get_request_count()) {
+                pending.batch = Ref<AsyncFileBatch>();
+                _queue_head++;
+                if (_queue_head == _queue.size()) {
+                    _queue.clear();
+                    _queue_head = 0;
+                }
+            }
+        }
+
+        _run_request(_get_requests(batch.ptr())[index]);
+        _request_done(batch.ptr());
+    }
+}
+
+void AsyncFileIOThreaded::_submit(const Ref<AsyncFileBatch>& p_batch) {
+    Pending pending;
+    pending.batch = p_batch;
+    {
+        MutexLock lock(_mutex);
+        _queue.push_back(pending);
+    }
+    _condition.notify_all();
+}
+
+AsyncFileIOThreaded::AsyncFileIOThreaded(int p_threads) {
+    _thread_count = p_threads > 0 ? p_threads : CLAMP(int(std::thread::hardware_concurrency()) * 2, 4, 32);
+    _threads = memnew_arr(std::thread, _thread_count);
+    for (int i = 0; i < _thread_count; i++) {
+        _threads[i] = std::thread([this]() { _worker(); });
+    }
+}
+
+AsyncFileIOThreaded::~AsyncFileIOThreaded() {
+    {
+        MutexLock lock(_mutex);
+        _exiting = true;
+    }
+    _condition.notify_all();
+    for (int i = 0; i < _thread_count; i++) {
+        _threads[i].join();
+    }
+    memdelete_arr(_threads);
+}
@@ -0,0 +1,44 @@
+#ifndef __ASYNC_FILE_IO_THREADED_HPP__
+#define __ASYNC_FILE_IO_THREADED_HPP__
+
+#include "./async_file_io.hpp"
+
+#include <thread>
+
+/** AsyncFileIO for any platform: worker threads run the requests as blocking
+ *  FileAccess calls, as many at once as there are threads. Requests are
+ *  handed out in submission order. */
+class AsyncFileIOThreaded : public AsyncFileIO {
+    /** The requests of a batch not handed to a worker yet. */
+    struct Pending {
+        Ref<AsyncFileBatch> batch;
+        int64_t next = 0;
+    };
+
+    std::thread* _threads = nullptr;
+    int _thread_count = 0;
+
+    BinaryMutex _mutex;
+    ConditionVariable _condition;
+    /** FIFO, from _queue_head. */
+    Vector<Pending> _queue;
+    int64_t _queue_head = 0;
+    bool _exiting = false;
+
+    static void _run_request(Request& r_request);
+    void _worker();
+
+protected:
+    virtual void _submit(const Ref<AsyncFileBatch>& p_batch) override;
+
+public:
+    virtual String get_backend_name() const override { return "threads"; }
+
+    /** With p_threads workers, or by default twice as many as there are
+     *  cores, between 4 and 32: I/O threads mostly wait, and the more
+     *  requests in flight, the better the drive can schedule them. */
+    AsyncFileIOThreaded(int p_threads = -1);
+    virtual ~AsyncFileIOThreaded();
+};
+
+#endif
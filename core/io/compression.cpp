@@ -0,0 +1,715 @@
+#include "./compression.hpp"
+
+#include "../error/error_macros.hpp"
+#include "../os/memory.hpp"
+#include "../os/worker_pool.hpp"
+#include "../templates/safe_refcount.hpp"
+
+#include <string.h>
+
+#define COMPRESSION_MIN_MATCH 4
+#define COMPRESSION_MAX_OFFSET 65535
+/** The last bytes of a block are literals, so that the decoder can copy
+ *  matches without checking for the end. */
+#define COMPRESSION_LAST_LITERALS 5
+/** Matches start this far from the end of a block at least. */
+#define COMPRESSION_MATCH_LIMIT 12
+
+#define COMPRESSION_FAST_HASH_LOG 14
+#define COMPRESSION_HIGH_HASH_LOG 15
+/** Earlier positions MODE_HIGH compares per match, at most. */
+#define COMPRESSION_HIGH_ATTEMPTS 64
+
+/** Magic, version, mode, and base-2 logarithm of the block size. */
+#define COMPRESSION_HEADER_SIZE 8
+/** Size before, then after compression, little endian. */
+#define COMPRESSION_BLOCK_HEADER_SIZE 8
+/** Flags a block stored as it is, in its size after compression. */
+#define COMPRESSION_STORED 0x80000000u
+#define COMPRESSION_VERSION 1
+
+static const uint8_t COMPRESSION_MAGIC[4] = { 'C', 'M', 'P', 'F' };
+
+/** Hash tables of the compressors, one set per thread. */
+struct CompressionTables {
+    uint32_t fast[1 << COMPRESSION_FAST_HASH_LOG];
+    /** Last position of each hash, and for each position in the window,
+     *  the distance to the previous one with the same hash. */
+    uint32_t head[1 << COMPRESSION_HIGH_HASH_LOG];
+    uint16_t chain[COMPRESSION_MAX_OFFSET + 1];
+};
+
+/** Where a block is, in a frame and in the decompressed data. */
+struct CompressionBlock {
+    int64_t src = 0;
+    int64_t dst = 0;
+    uint32_t size = 0;
+    uint32_t packed_size = 0;
+    bool stored = false;
+};
+
+static _FORCE_INLINE_ uint32_t _read_32(const uint8_t* p_src) {
+    uint32_t value;
+    memcpy(&value, p_src, sizeof(value));
+    return value;
+}
+
+static _FORCE_INLINE_ uint32_t _hash_32(uint32_t p_value, int p_log) {
+    return (p_value * 2654435761u) >> (32 - p_log);
+}
+
+static _FORCE_INLINE_ void _encode_32(uint8_t* p_dst, uint32_t p_value) {
+    p_dst[0] = uint8_t(p_value);
+    p_dst[1] = uint8_t(p_value >> 8);
+    p_dst[2] = uint8_t(p_value >> 16);
+    p_dst[3] = uint8_t(p_value >> 24);
+}
+
+static _FORCE_INLINE_ uint32_t _decode_32(const uint8_t* p_src) {
+    return uint32_t(p_src[0]) | (uint32_t(p_src[1]) << 8) | (uint32_t(p_src[2]) << 16) | (uint32_t(p_src[3]) << 24);
+}
+
+/** How many bytes match at p_a and p_b, which is before p_a, up to p_a_end. */
+static _FORCE_INLINE_ int64_t _count_matching(const uint8_t* p_a, const uint8_t* p_b, const uint8_t* p_a_end) {
+    const uint8_t* const start = p_a;
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (p_a_end - p_a >= 8) {
+        uint64_t a;
+        uint64_t b;
+        memcpy(&a, p_a, sizeof(a));
+        memcpy(&b, p_b, sizeof(b));
+        if (a != b) {
+            return p_a - start + (__builtin_ctzll(a ^ b) >> 3);
+        }
+        p_a += 8;
+        p_b += 8;
+    }
+#endif
+    while (p_a < p_a_end && *p_a == *p_b) {
+        p_a++;
+        p_b++;
+    }
+    return p_a - start;
+}
+
+static _FORCE_INLINE_ uint8_t* _write_length(uint8_t* p_dst, int64_t p_length) {
+    while (p_length >= 255) {
+        *p_dst++ = 255;
+        p_length -= 255;
+    }
+    *p_dst++ = uint8_t(p_length);
+    return p_dst;
+}
+
+/** Writes a sequence: p_literal_count literals, then a match of p_length
+ *  bytes at p_offset back, or no match when p_length is 0. False when it
+ *  doesn't fit before p_dst_end. */
+static _FORCE_INLINE_ bool _write_sequence(uint8_t*& r_dst, uint8_t* p_dst_end, const uint8_t* p_literals, int64_t p_literal_count, int64_t p_offset, int64_t p_length) {
+    uint8_t* dst = r_dst;
+    if (p_dst_end - dst < 1 + p_literal_count / 255 + 1 + p_literal_count + 2 + p_length / 255 + 1) {
+        return false;
+    }
+
+    uint8_t* const token = dst++;
+    uint8_t value;
+    if (p_literal_count >= 15) {
+        value = 15 << 4;
+        dst = _write_length(dst, p_literal_count - 15);
+    } else {
+        value = uint8_t(p_literal_count << 4);
+    }
+    if (p_literal_count > 0) {
+        memcpy(dst, p_literals, p_literal_count);
+    }
+    dst += p_literal_count;
+
+    if (p_length > 0) {
+        dst[0] = uint8_t(p_offset);
+        dst[1] = uint8_t(p_offset >> 8);
+        dst += 2;
+        const int64_t extra = p_length - COMPRESSION_MIN_MATCH;
+        if (extra >= 15) {
+            value |= 15;
+            dst = _write_length(dst, extra - 15);
+        } else {
+            value |= uint8_t(extra);
+        }
+    }
+
+    *token = value;
+    r_dst = dst;
+    return true;
+}
+
+static int64_t _compress_fast(uint8_t* p_dst, int64_t p_dst_max, const uint8_t* p_src, int64_t p_size, uint32_t* p_table) {
+    uint8_t* dst = p_dst;
+    uint8_t* const dst_end = p_dst + p_dst_max;
+    const uint8_t* const end = p_src + p_size;
+    const uint8_t* anchor = p_src;
+
+    if (p_size > COMPRESSION_MATCH_LIMIT) {
+        const uint8_t* const limit = end - COMPRESSION_MATCH_LIMIT;
+        const uint8_t* const match_end = end - COMPRESSION_LAST_LITERALS;
+        // Zero points at the start of the block, a candidate like any other.
+        memset(p_table, 0, sizeof(uint32_t) << COMPRESSION_FAST_HASH_LOG);
+
+        const uint8_t* ip = p_src + 1;
+        while (true) {
+            const uint8_t* ref = nullptr;
+            // Steps further the longer nothing matches, to get through
+            // incompressible data quickly.
+            uint32_t step = 1 << 6;
+            while (ip < limit) {
+                const uint32_t hash = _hash_32(_read_32(ip), COMPRESSION_FAST_HASH_LOG);
+                const uint8_t* candidate = p_src + p_table[hash];
+                p_table[hash] = uint32_t(ip - p_src);
+                if (ip - candidate <= COMPRESSION_MAX_OFFSET && _read_32(candidate) == _read_32(ip)) {
+                    ref = candidate;
+                    break;
+                }
+                ip += step++ >> 6;
+            }
+            if (!ref) {
+                break;
+            }
+
+            while (ip > anchor && ref > p_src && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            }
+            const int64_t length = COMPRESSION_MIN_MATCH + _count_matching(ip + COMPRESSION_MIN_MATCH, ref + COMPRESSION_MIN_MATCH, match_end);
+            if (!_write_sequence(dst, dst_end, anchor, ip - anchor, ip - ref, length)) {
+                return -1;
+            }
+            ip += length;
+            anchor = ip;
+            if (ip >= limit) {
+                break;
+            }
+            // Of the positions matched over, only the last is indexed.
+            p_table[_hash_32(_read_32(ip - 2), COMPRESSION_FAST_HASH_LOG)] = uint32_t(ip - 2 - p_src);
+        }
+    }
+
+    if (!_write_sequence(dst, dst_end, anchor, end - anchor, 0, 0)) {
+        return -1;
+    }
+    return dst - p_dst;
+}
+
+static _FORCE_INLINE_ void _insert_high(const uint8_t* p_src, uint32_t p_pos, CompressionTables* p_tables) {
+    const uint32_t hash = _hash_32(_read_32(p_src + p_pos), COMPRESSION_HIGH_HASH_LOG);
+    const uint32_t delta = p_pos - p_tables->head[hash];
+    p_tables->chain[p_pos & COMPRESSION_MAX_OFFSET] = uint16_t(MIN(delta, uint32_t(COMPRESSION_MAX_OFFSET)));
+    p_tables->head[hash] = p_pos;
+}
+
+/** Indexes the positions up to p_ip, and returns the length of the longest
+ *  match for it, with its start in r_ref, or 0. */
+static int64_t _find_longest(const uint8_t* p_src, const uint8_t* p_ip, const uint8_t* p_match_end, uint32_t& r_indexed, CompressionTables* p_tables, const uint8_t*& r_ref) {
+    const uint32_t pos = uint32_t(p_ip - p_src);
+    for (; r_indexed < pos; r_indexed++) {
+        _insert_high(p_src, r_indexed, p_tables);
+    }
+
+    const uint32_t sequence = _read_32(p_ip);
+    int64_t best = 0;
+    uint32_t candidate = p_tables->head[_hash_32(sequence, COMPRESSION_HIGH_HASH_LOG)];
+    for (int attempts = COMPRESSION_HIGH_ATTEMPTS; attempts > 0 && candidate < pos && pos - candidate <= COMPRESSION_MAX_OFFSET; attempts--) {
+        const uint8_t* ref = p_src + candidate;
+        // The byte that would make it longer than the best one first.
+        if (ref[best] == p_ip[best] && _read_32(ref) == sequence) {
+            const int64_t length = COMPRESSION_MIN_MATCH + _count_matching(p_ip + COMPRESSION_MIN_MATCH, ref + COMPRESSION_MIN_MATCH, p_match_end);
+            if (length > best) {
+                best = length;
+                r_ref = ref;
+                if (p_ip + length == p_match_end) {
+                    break;
+                }
+            }
+        }
+        const uint16_t delta = p_tables->chain[candidate & COMPRESSION_MAX_OFFSET];
+        if (delta == 0) {
+            break;
+        }
+        candidate -= delta;
+    }
+
+    _insert_high(p_src, pos, p_tables);
+    r_indexed = pos + 1;
+    return best;
+}
+
+static int64_t _compress_high(uint8_t* p_dst, int64_t p_dst_max, const uint8_t* p_src, int64_t p_size, CompressionTables* p_tables) {
+    uint8_t* dst = p_dst;
+    uint8_t* const dst_end = p_dst + p_dst_max;
+    const uint8_t* const end = p_src + p_size;
+    const uint8_t* anchor = p_src;
+
+    if (p_size > COMPRESSION_MATCH_LIMIT) {
+        const uint8_t* const limit = end - COMPRESSION_MATCH_LIMIT;
+        const uint8_t* const match_end = end - COMPRESSION_LAST_LITERALS;
+        memset(p_tables->head, 0, sizeof(p_tables->head));
+        memset(p_tables->chain, 0, sizeof(p_tables->chain));
+
+        uint32_t indexed = 0;
+        const uint8_t* ip = p_src;
+        while (ip < limit) {
+            const uint8_t* ref = nullptr;
+            int64_t length = _find_longest(p_src, ip, match_end, indexed, p_tables, ref);
+            if (length < COMPRESSION_MIN_MATCH) {
+                ip++;
+                continue;
+            }
+            // Lazy matching: a longer match a byte later wins over this one.
+            while (ip + 1 < limit) {
+                const uint8_t* next_ref = nullptr;
+                const int64_t next_length = _find_longest(p_src, ip + 1, match_end, indexed, p_tables, next_ref);
+                if (next_length <= length) {
+                    break;
+                }
+                ip++;
+                length = next_length;
+                ref = next_ref;
+            }
+
+            if (!_write_sequence(dst, dst_end, anchor, ip - anchor, ip - ref, length)) {
+                return -1;
+            }
+            ip += length;
+            anchor = ip;
+        }
+    }
+
+    if (!_write_sequence(dst, dst_end, anchor, end - anchor, 0, 0)) {
+        return -1;
+    }
+    return dst - p_dst;
+}
+
+static _FORCE_INLINE_ int64_t _compress(uint8_t* p_dst, int64_t p_dst_max, const uint8_t* p_src, int64_t p_size, Compression::Mode p_mode, CompressionTables* p_tables) {
+    if (p_mode == Compression::MODE_HIGH) {
+        return _compress_high(p_dst, p_dst_max, p_src, p_size, p_tables);
+    }
+    return _compress_fast(p_dst, p_dst_max, p_src, p_size, p_tables->fast);
+}
+
+static _FORCE_INLINE_ bool _read_length(const uint8_t*& r_src, const uint8_t* p_src_end, int64_t& r_length) {
+    uint8_t value;
+    do {
+        if (r_src == p_src_end) {
+            return false;
+        }
+        value = *r_src++;
+        r_length += value;
+    } while (value == 255);
+    return true;
+}
+
+int64_t Compression::compress_block(uint8_t* p_dst, int64_t p_dst_max, const uint8_t* p_src, int64_t p_size, Mode p_mode) {
+    ERROR_FAIL_COND_V(p_size < 0 || p_size > UINT32_MAX, -1);
+    ERROR_FAIL_COND_V((!p_src && p_size > 0) || (!p_dst && p_dst_max > 0), -1);
+
+    CompressionTables* tables = memnew(CompressionTables);
+    const int64_t size = _compress(p_dst, p_dst_max, p_src, p_size, p_mode, tables);
+    memdelete(tables);
+    return size;
+}
+
+int64_t Compression::decompress_block(uint8_t* p_dst, int64_t p_dst_max, const uint8_t* p_src, int64_t p_size) {
+    const uint8_t* src = p_src;
+    const uint8_t* const src_end = p_src + p_size;
+    uint8_t* dst = p_dst;
+    uint8_t* const dst_end = p_dst + p_dst_max;
+
+    while (true) {
+        if (src == src_end) {
+            return -1;
+        }
+        const uint32_t token = *src++;
+
+        int64_t literal_count = token >> 4;
+        if (literal_count == 15 && !_read_length(src, src_end, literal_count)) {
+            return -1;
+        }
+        if (literal_count > src_end - src || literal_count > dst_end - dst) {
+            return -1;
+        }
+        if (literal_count <= 16 && src_end - src >= 16 && dst_end - dst >= 16) {
+            // Short runs, the most common, as a single fixed size copy.
+            memcpy(dst, src, 16);
+        } else {
+            memcpy(dst, src, literal_count);
+        }
+        src += literal_count;
+        dst += literal_count;
+        if (src == src_end) {
+            // The last sequence has no match.
+            break;
+        }
+
+        if (src_end - src < 2) {
+            return -1;
+        }
+        const int64_t offset = int64_t(src[0]) | (int64_t(src[1]) << 8);
+        src += 2;
+        if (offset == 0 || offset > dst - p_dst) {
+            return -1;
+        }
+        int64_t length = token & 15;
+        if (length == 15 && !_read_length(src, src_end, length)) {
+            return -1;
+        }
+        length += COMPRESSION_MIN_MATCH;
+        if (length > dst_end - dst) {
+            return -1;
+        }
+
+        const uint8_t* ref = dst - offset;
+        if (offset >= 8 && dst_end - dst >= length + 8) {
+            // Eight bytes at a time, running past the end of the match: with
+            // the match 8 bytes back at least, each copy only reads bytes
+            // written already.
+            uint8_t* out = dst;
+            uint8_t* const out_end = dst + length;
+            do {
+                memcpy(out, ref, 8);
+                out += 8;
+                ref += 8;
+            } while (out < out_end);
+        } else {
+            for (int64_t i = 0; i < length; i++) {
+                dst[i] = ref[i];
+            }
+        }
+        dst += length;
+    }
+    return dst - p_dst;
+}
+
+/** Calls p_func(index, tables) for each of p_count jobs on the WorkerPool,
+ *  on up to p_max_threads threads (all of them when 0) including the calling
+ *  one. Threads take the next job when done with one, as the time a block
+ *  takes depends on its contents. tables is nullptr until p_func allocates
+ *  it, once per thread. */
+template <typename F>
+static void _run_parallel(int64_t p_count, int p_max_threads, const F& p_func) {
+    const int threads = WorkerPool::get_thread_count();
+    CompressionTables** tables = memnew_arr(CompressionTables*, threads);
+    for (int t = 0; t < threads; t++) {
+        tables[t] = nullptr;
+    }
+
+    WorkerPool::parallel_for(p_count, p_max_threads, [&p_func, tables](int64_t p_index, int p_worker) {
+        p_func(p_index, tables[p_worker]);
+    });
+
+    for (int t = 0; t < threads; t++) {
+        if (tables[t]) {
+            memdelete(tables[t]);
+        }
+    }
+    memdelete_arr(tables);
+}
+
+static bool _is_block_size_valid(int64_t p_block_size) {
+    return p_block_size >= Compression::BLOCK_SIZE_MIN && p_block_size <= Compression::BLOCK_SIZE_MAX && (p_block_size & (p_block_size - 1)) == 0;
+}
+
+static void _write_header(uint8_t* p_dst, Compression::Mode p_mode, int64_t p_block_size) {
+    memcpy(p_dst, COMPRESSION_MAGIC, sizeof(COMPRESSION_MAGIC));
+    uint8_t block_size_log = 0;
+    while ((int64_t(1) << block_size_log) < p_block_size) {
+        block_size_log++;
+    }
+    p_dst[4] = COMPRESSION_VERSION;
+    p_dst[5] = uint8_t(p_mode);
+    p_dst[6] = block_size_log;
+    p_dst[7] = 0;
+}
+
+static bool _read_header(const uint8_t* p_src, int64_t& r_block_size) {
+    if (memcmp(p_src, COMPRESSION_MAGIC, sizeof(COMPRESSION_MAGIC)) != 0 || p_src[4] != COMPRESSION_VERSION || p_src[6] > 30) {
+        return false;
+    }
+    r_block_size = int64_t(1) << p_src[6];
+    return _is_block_size_valid(r_block_size);
+}
+
+/** Largest output of _compress_blocks() for p_size bytes. */
+static int64_t _get_blocks_bound(int64_t p_size, int64_t p_block_size) {
+    return (p_size + p_block_size - 1) / p_block_size * COMPRESSION_BLOCK_HEADER_SIZE + p_size;
+}
+
+/** Compresses p_size bytes in blocks of p_block_size, headers included,
+ *  to p_dst, returning the bytes written. */
+static int64_t _compress_blocks(uint8_t* p_dst, const uint8_t* p_src, int64_t p_size, int64_t p_block_size, Compression::Mode p_mode, int p_max_threads) {
+    const int64_t count = (p_size + p_block_size - 1) / p_block_size;
+    const int64_t slot_size = COMPRESSION_BLOCK_HEADER_SIZE + p_block_size;
+
+    // Each block goes to a slot big enough to store it as it is, and the
+    // slots are packed together once all are done.
+    _run_parallel(count, p_max_threads, [=](int64_t p_index, CompressionTables*& r_tables) {
+        const uint8_t* src = p_src + p_index * p_block_size;
+        const int64_t size = MIN(p_block_size, p_size - p_index * p_block_size);
+        uint8_t* slot = p_dst + p_index * slot_size;
+        if (!r_tables) {
+            r_tables = memnew(CompressionTables);
+        }
+
+        uint32_t packed_size = uint32_t(size);
+        uint32_t flags = COMPRESSION_STORED;
+        const int64_t compressed = _compress(slot + COMPRESSION_BLOCK_HEADER_SIZE, size - 1, src, size, p_mode, r_tables);
+        if (compressed > 0) {
+            packed_size = uint32_t(compressed);
+            flags = 0;
+        } else {
+            memcpy(slot + COMPRESSION_BLOCK_HEADER_SIZE, src, size);
+        }
+        _encode_32(slot, uint32_t(size));
+        _encode_32(slot + 4, packed_size | flags);
+    });
+
+    int64_t written = 0;
+    for (int64_t i = 0; i < count; i++) {
+        const uint8_t* slot = p_dst + i * slot_size;
+        const int64_t length = COMPRESSION_BLOCK_HEADER_SIZE + (_decode_32(slot + 4) & ~COMPRESSION_STORED);
+        if (slot != p_dst + written) {
+            memmove(p_dst + written, slot, length);
+        }
+        written += length;
+    }
+    return written;
+}
+
+/** Finds the whole blocks at the start of p_src, up to the end of the frame
+ *  if it's there. r_consumed is their size, end of frame included, and
+ *  r_size their size once decompressed. */
+static Errors _scan_blocks(const uint8_t* p_src, int64_t p_size, int64_t p_block_size, Vector<CompressionBlock>& r_blocks, int64_t& r_consumed, int64_t& r_size, bool& r_ended) {
+    int64_t pos = 0;
+    r_size = 0;
+    r_ended = false;
+    while (p_size - pos >= COMPRESSION_BLOCK_HEADER_SIZE) {
+        CompressionBlock block;
+        block.size = _decode_32(p_src + pos);
+        const uint32_t packed = _decode_32(p_src + pos + 4);
+        if (block.size == 0) {
+            if (packed != 0) {
+                return Errors::ERROR_FILE_CORRUPT;
+            }
+            pos += COMPRESSION_BLOCK_HEADER_SIZE;
+            r_ended = true;
+            break;
+        }
+
+        block.packed_size = packed & ~COMPRESSION_STORED;
+        block.stored = (packed & COMPRESSION_STORED) != 0;
+        if (block.size > p_block_size || block.packed_size == 0 || (block.stored ? block.packed_size != block.size : block.packed_size >= block.size)) {
+            return Errors::ERROR_FILE_CORRUPT;
+        }
+        if (p_size - pos - COMPRESSION_BLOCK_HEADER_SIZE < block.packed_size) {
+            break;
+        }
+
+        block.src = pos + COMPRESSION_BLOCK_HEADER_SIZE;
+        block.dst = r_size;
+        r_blocks.push_back(block);
+        pos += COMPRESSION_BLOCK_HEADER_SIZE + block.packed_size;
+        r_size += block.size;
+    }
+    r_consumed = pos;
+    return Errors::NONE;
+}
+
+static bool _decompress_blocks(uint8_t* p_dst, const uint8_t* p_src, const Vector<CompressionBlock>& p_blocks, int p_max_threads) {
+    const CompressionBlock* blocks = p_blocks.ptr();
+    SafeFlag failed;
+    _run_parallel(p_blocks.size(), p_max_threads, [=, &failed](int64_t p_index, CompressionTables*&) {
+        const CompressionBlock& block = blocks[p_index];
+        if (block.stored) {
+            memcpy(p_dst + block.dst, p_src + block.src, block.size);
+        } else if (Compression::decompress_block(p_dst + block.dst, block.size, p_src + block.src, block.packed_size) != block.size) {
+            failed.set();
+        }
+    });
+    return !failed.is_set();
+}
+
+Vector<uint8_t> Compression::compress(const Vector<uint8_t>& p_data, Mode p_mode, int64_t p_block_size, int p_max_threads) {
+    ERROR_FAIL_COND_V_MSG(!_is_block_size_valid(p_block_size), Vector<uint8_t>(), "The block size must be a power of two between BLOCK_SIZE_MIN and BLOCK_SIZE_MAX.");
+
+    const int64_t size = p_data.size();
+    Vector<uint8_t> result;
+    result.resize(COMPRESSION_HEADER_SIZE + _get_blocks_bound(size, p_block_size) + COMPRESSION_BLOCK_HEADER_SIZE);
+    uint8_t* w = result.ptrw();
+    _write_header(w, p_mode, p_block_size);
+    int64_t written = COMPRESSION_HEADER_SIZE + _compress_blocks(w + COMPRESSION_HEADER_SIZE, p_data.ptr(), size, p_block_size, p_mode, p_max_threads);
+    memset(w + written, 0, COMPRESSION_BLOCK_HEADER_SIZE);
+    written += COMPRESSION_BLOCK_HEADER_SIZE;
+    result.resize(written);
+    return result;
+}
+
+Errors Compression::decompress(const Vector<uint8_t>& p_data, Vector<uint8_t>& r_data, int p_max_threads) {
+    r_data.clear();
+    const int64_t size = p_data.size();
+    const uint8_t* r = p_data.ptr();
+    int64_t block_size = 0;
+    ERROR_FAIL_COND_V_MSG(size < COMPRESSION_HEADER_SIZE || !_read_header(r, block_size), Errors::ERROR_FILE_UNRECOGNIZED, "Not a compressed frame, or of an unknown version.");
+
+    Vector<CompressionBlock> blocks;
+    int64_t consumed = 0;
+    int64_t decompressed_size = 0;
+    bool ended = false;
+    const Errors err = _scan_blocks(r + COMPRESSION_HEADER_SIZE, size - COMPRESSION_HEADER_SIZE, block_size, blocks, consumed, decompressed_size, ended);
+    ERROR_FAIL_COND_V_MSG(err != Errors::NONE || !ended || COMPRESSION_HEADER_SIZE + consumed != size, Errors::ERROR_FILE_CORRUPT, "The compressed frame is corrupt or truncated.");
+
+    r_data.resize(decompressed_size);
+    if (!_decompress_blocks(r_data.ptrw(), r + COMPRESSION_HEADER_SIZE, blocks, p_max_threads)) {
+        r_data.clear();
+        ERROR_FAIL_V_MSG(Errors::ERROR_FILE_CORRUPT, "The compressed frame is corrupt.");
+    }
+    return Errors::NONE;
+}
+
+void CompressionStream::_consume_input(int64_t p_size) {
+    if (p_size > 0 && p_size < _input_size) {
+        memmove(_input.ptrw(), _input.ptr() + p_size, _input_size - p_size);
+    }
+    _input_size -= p_size;
+}
+
+uint8_t* CompressionStream::_reserve_output(int64_t p_size) {
+    if (_output_head > 0) {
+        memmove(_output.ptrw(), _output.ptr() + _output_head, _output_size - _output_head);
+        _output_size -= _output_head;
+        _output_head = 0;
+    }
+    if (_output.size() < _output_size + p_size) {
+        _output.resize(_output_size + p_size);
+    }
+    return _output.ptrw() + _output_size;
+}
+
+Errors CompressionStream::_process(bool p_final) {
+    if (_compressing) {
+        const int64_t count = p_final ? (_input_size + _block_size - 1) / _block_size : _input_size / _block_size;
+        const int64_t size = MIN(count * _block_size, _input_size);
+        if (size > 0) {
+            uint8_t* w = _reserve_output(_get_blocks_bound(size, _block_size));
+            _output_size += _compress_blocks(w, _input.ptr(), size, _block_size, _mode, _max_threads);
+            _consume_input(size);
+        }
+        if (p_final) {
+            memset(_reserve_output(COMPRESSION_BLOCK_HEADER_SIZE), 0, COMPRESSION_BLOCK_HEADER_SIZE);
+            _output_size += COMPRESSION_BLOCK_HEADER_SIZE;
+            _ended = true;
+        }
+        return Errors::NONE;
+    }
+
+    int64_t pos = 0;
+    if (_block_size == 0) {
+        if (_input_size < COMPRESSION_HEADER_SIZE) {
+            ERROR_FAIL_COND_V_MSG(p_final, Errors::ERROR_FILE_CORRUPT, "The compressed frame is truncated.");
+            return Errors::NONE;
+        }
+        int64_t block_size = 0;
+        ERROR_FAIL_COND_V_MSG(!_read_header(_input.ptr(), block_size), Errors::ERROR_FILE_UNRECOGNIZED, "Not a compressed frame, or of an unknown version.");
+        _block_size = block_size;
+        pos = COMPRESSION_HEADER_SIZE;
+    }
+
+    Vector<CompressionBlock> blocks;
+    int64_t consumed = 0;
+    int64_t decompressed_size = 0;
+    bool ended = false;
+    Errors err = _scan_blocks(_input.ptr() + pos, _input_size - pos, _block_size, blocks, consumed, decompressed_size, ended);
+    ERROR_FAIL_COND_V_MSG(err != Errors::NONE, err, "The compressed frame is corrupt.");
+
+    if (decompressed_size > 0) {
+        uint8_t* w = _reserve_output(decompressed_size);
+        ERROR_FAIL_COND_V_MSG(!_decompress_blocks(w, _input.ptr() + pos, blocks, _max_threads), Errors::ERROR_FILE_CORRUPT, "The compressed frame is corrupt.");
+        _output_size += decompressed_size;
+    }
+    _consume_input(pos + consumed);
+
+    if (ended) {
+        _ended = true;
+        ERROR_FAIL_COND_V_MSG(_input_size > 0, Errors::ERROR_FILE_CORRUPT, "Data follows the end of the compressed frame.");
+    }
+    ERROR_FAIL_COND_V_MSG(p_final && !_ended, Errors::ERROR_FILE_CORRUPT, "The compressed frame is truncated.");
+    return Errors::NONE;
+}
+
+Errors CompressionStream::start_compression(Compression::Mode p_mode, int64_t p_block_size, int p_max_threads) {
+    ERROR_FAIL_COND_V_MSG(!_is_block_size_valid(p_block_size), Errors::ERROR_INVALID_PARAMETER, "The block size must be a power of two between BLOCK_SIZE_MIN and BLOCK_SIZE_MAX.");
+    clear();
+    _compressing = true;
+    _started = true;
+    _mode = p_mode;
+    _block_size = p_block_size;
+    _max_threads = p_max_threads;
+    _write_header(_reserve_output(COMPRESSION_HEADER_SIZE), p_mode, p_block_size);
+    _output_size += COMPRESSION_HEADER_SIZE;
+    return Errors::NONE;
+}
+
+Errors CompressionStream::start_decompression(int p_max_threads) {
+    clear();
+    _started = true;
+    _max_threads = p_max_threads;
+    return Errors::NONE;
+}
+
+Errors CompressionStream::put_data(const uint8_t* p_data, int64_t p_size) {
+    ERROR_FAIL_COND_V_MSG(!_started, Errors::ERROR_UNCONFIGURED, "Start compressing or decompressing first.");
+    ERROR_FAIL_COND_V_MSG(_ended, Errors::ERROR_UNAVAILABLE, "The frame has ended.");
+    ERROR_FAIL_COND_V(p_size < 0 || (!p_data && p_size > 0), Errors::ERROR_INVALID_PARAMETER);
+
+    if (p_size == 0) {
+        return Errors::NONE;
+    }
+    if (_input.size() < _input_size + p_size) {
+        _input.resize(_input_size + p_size);
+    }
+    memcpy(_input.ptrw() + _input_size, p_data, p_size);
+    _input_size += p_size;
+    return _process(false);
+}
+
+Errors CompressionStream::finish() {
+    ERROR_FAIL_COND_V_MSG(!_started, Errors::ERROR_UNCONFIGURED, "Start compressing or decompressing first.");
+    if (_ended) {
+        return Errors::NONE;
+    }
+    return _process(true);
+}
+
+int64_t CompressionStream::get_data(uint8_t* p_dst, int64_t p_size) {
+    const int64_t size = MIN(p_size, get_available_bytes());
+    if (size <= 0) {
+        return 0;
+    }
+    memcpy(p_dst, _output.ptr() + _output_head, size);
+    _output_head += size;
+    if (_output_head == _output_size) {
+        _output_head = 0;
+        _output_size = 0;
+    }
+    return size;
+}
+
+void CompressionStream::clear() {
+    _compressing = false;
+    _started = false;
+    _ended = false;
+    _mode = Compression::MODE_FAST;
+    _block_size = 0;
+    _max_threads = 0;
+    _input.clear();
+    _input_size = 0;
+    _output.clear();
+    _output_head = 0;
+    _output_size = 0;
+}
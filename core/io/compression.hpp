@@ -1,4 +1,103 @@
 #ifndef __COMPRESSION_HPP__
 #define __COMPRESSION_HPP__
 
+#include "../error/error_list.hpp"
+#include "../templates/vector.hpp"
+#include "../typedefs.hpp"
+
+#include <stdint.h>
+
+/** A fast LZ77 codec, in the LZ4 block format, and a framing of it in
+ *  independent blocks.
+ *
+ *  A frame is an 8-byte header, the blocks, and an empty block to end it.
+ *  Each block starts with its size before and after compression, so the
+ *  blocks of a frame are found without decoding them and then compressed or
+ *  decompressed on as many threads as there are cores. Blocks that don't
+ *  shrink are stored as they are.
+ */
+class Compression {
+public:
+    enum Mode {
+        /** Greedy parsing over a single hash table: compresses at several
+         *  hundred megabytes per second. */
+        MODE_FAST,
+        /** Searches chains of earlier matches and defers each match by a
+         *  byte when the next one is longer: slower to compress, denser,
+         *  and just as fast to decompress. */
+        MODE_HIGH,
+    };
+
+    enum {
+        BLOCK_SIZE_MIN = 1 << 16,
+        BLOCK_SIZE_DEFAULT = 1 << 18,
+        BLOCK_SIZE_MAX = 1 << 22,
+    };
+
+    /** Largest output of compress_block() for p_size bytes. */
+    static int64_t get_block_bound(int64_t p_size) { return p_size + p_size / 255 + 16; }
+
+    /** Compresses p_size bytes of p_src into a single block, without frame.
+     *  Returns the compressed size, or -1 when it would exceed p_dst_max. */
+    static int64_t compress_block(uint8_t* p_dst, int64_t p_dst_max, const uint8_t* p_src, int64_t p_size, Mode p_mode = MODE_FAST);
+
+    /** Decompresses a block made by compress_block() into p_dst, which holds
+     *  p_dst_max bytes. Returns the decompressed size, or -1 when the block
+     *  is corrupt or doesn't fit; never reads or writes out of bounds. */
+    static int64_t decompress_block(uint8_t* p_dst, int64_t p_dst_max, const uint8_t* p_src, int64_t p_size);
+
+    /** Compresses p_data in a frame of blocks of p_block_size bytes (a power
+     *  of two between BLOCK_SIZE_MIN and BLOCK_SIZE_MAX), on up to
+     *  p_max_threads threads, or one per core when 0. */
+    static Vector<uint8_t> compress(const Vector<uint8_t>& p_data, Mode p_mode = MODE_FAST, int64_t p_block_size = BLOCK_SIZE_DEFAULT, int p_max_threads = 0);
+
+    /** Decompresses a frame made by compress() or CompressionStream into
+     *  r_data, on up to p_max_threads threads, or one per core when 0. */
+    static Errors decompress(const Vector<uint8_t>& p_data, Vector<uint8_t>& r_data, int p_max_threads = 0);
+};
+
+/** Compresses or decompresses a frame given in chunks of any size, keeping a
+ *  block and the output not read yet in memory.
+ *
+ *  Feed it with put_data(), take the output with get_data() as it comes,
+ *  and end with finish(). The blocks completed by a put_data() call are
+ *  processed in parallel, so large chunks go as fast as compress().
+ */
+class CompressionStream {
+    bool _compressing = false;
+    bool _started = false;
+    bool _ended = false;
+    Compression::Mode _mode = Compression::MODE_FAST;
+    int64_t _block_size = 0;
+    int _max_threads = 0;
+
+    /** Bytes not processed yet, at the start of _input. */
+    Vector<uint8_t> _input;
+    int64_t _input_size = 0;
+    /** Bytes not read yet, between _output_head and _output_size. */
+    Vector<uint8_t> _output;
+    int64_t _output_head = 0;
+    int64_t _output_size = 0;
+
+    void _consume_input(int64_t p_size);
+    uint8_t* _reserve_output(int64_t p_size);
+    Errors _process(bool p_final);
+
+public:
+    /** Starts a new frame, compressed in blocks of p_block_size bytes. */
+    Errors start_compression(Compression::Mode p_mode = Compression::MODE_FAST, int64_t p_block_size = Compression::BLOCK_SIZE_DEFAULT, int p_max_threads = 0);
+    Errors start_decompression(int p_max_threads = 0);
+
+    Errors put_data(const uint8_t* p_data, int64_t p_size);
+    /** Compressing, writes the last block and ends the frame; decompressing,
+     *  fails unless the frame ended. */
+    Errors finish();
+
+    int64_t get_available_bytes() const { return _output_size - _output_head; }
+    /** Moves up to p_size bytes of output to p_dst, returning how many. */
+    int64_t get_data(uint8_t* p_dst, int64_t p_size);
+
+    void clear();
+};
+
 #endif
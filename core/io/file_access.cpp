@@ -0,0 +1,85 @@
+#include "./file_access.hpp"
+
+FileAccess::CreateFunc FileAccess::_create_func = nullptr;
+
+Ref<FileAccess> FileAccess::create() {
+    ERROR_FAIL_NULL_V_MSG(_create_func, Ref<FileAccess>(), "No file access backend was made the default.");
+    return _create_func();
+}
+
+Ref<FileAccess> FileAccess::open(const String& p_path, ModeFlags p_mode, Errors* r_error) {
+    Ref<FileAccess> file = create();
+    if (file.is_null()) {
+        if (r_error) {
+            *r_error = Errors::ERROR_UNCONFIGURED;
+        }
+        return Ref<FileAccess>();
+    }
+
+    const Errors err = file->_open(p_path, p_mode);
+    if (r_error) {
+        *r_error = err;
+    }
+    if (err != Errors::NONE) {
+        return Ref<FileAccess>();
+    }
+    return file;
+}
+
+Vector<uint8_t> FileAccess::get_file_as_bytes(const String& p_path, Errors* r_error) {
+    Errors err;
+    Ref<FileAccess> file = open(p_path, READ, &err);
+    if (r_error) {
+        *r_error = err;
+    }
+    ERROR_FAIL_COND_V_MSG(file.is_null(), Vector<uint8_t>(), "Can't open file from path '" + p_path + "'.");
+    return file->get_buffer(int64_t(file->get_length()));
+}
+
+uint64_t FileAccess::get_buffer(uint8_t* p_dst, uint64_t p_length) {
+    ERROR_FAIL_COND_V(!p_dst && p_length > 0, 0);
+
+    uint64_t read = 0;
+    while (read < p_length) {
+        if (_read_pos == _read_end && !_refill()) {
+            _eof = true;
+            break;
+        }
+        const uint64_t chunk = MIN(p_length - read, uint64_t(_read_end - _read_pos));
+        memcpy(p_dst + read, _read_pos, chunk);
+        _read_pos += chunk;
+        read += chunk;
+    }
+    return read;
+}
+
+Vector<uint8_t> FileAccess::get_buffer(int64_t p_length) {
+    Vector<uint8_t> data;
+    ERROR_FAIL_COND_V_MSG(p_length < 0, data, "Length of buffer cannot be smaller than 0.");
+    if (p_length == 0) {
+        return data;
+    }
+
+    const Errors err = data.resize(p_length);
+    ERROR_FAIL_COND_V_MSG(err != Errors::NONE, data, "Can't resize data to " + String::num_int64(p_length) + " elements.");
+    const uint64_t read = get_buffer(data.ptrw(), uint64_t(p_length));
+    if (read < uint64_t(p_length)) {
+        data.resize(int64_t(read));
+    }
+    return data;
+}
+
+void FileAccess::store_buffer(const uint8_t* p_src, uint64_t p_length) {
+    ERROR_FAIL_COND(!p_src && p_length > 0);
+
+    uint64_t written = 0;
+    while (written < p_length) {
+        if (_write_pos == _write_end) {
+            ERROR_FAIL_COND_MSG(_flush_buffer() != Errors::NONE, "Can't write to file '" + get_path() + "'.");
+        }
+        const uint64_t chunk = MIN(p_length - written, uint64_t(_write_end - _write_pos));
+        memcpy(_write_pos, p_src + written, chunk);
+        _write_pos += chunk;
+        written += chunk;
+    }
+}
@@ -1,6 +1,200 @@
 #ifndef __FILE_ACCESS_HPP__
 #define __FILE_ACCESS_HPP__
 
+#include "../error/error_list.hpp"
+#include "../error/error_macros.hpp"
+#include "../object/ref_counted.hpp"
+#include "../string/ustring.hpp"
+#include "../templates/vector.hpp"
+#include "../typedefs.hpp"
 
+#include <stdint.h>
+#include <string.h>
+
+/** Reads and writes files, through a backend made the default with
+ *  make_default() by the platform.
+ *
+ *  Reads come out of a window of bytes the backend keeps filled, either the
+ *  whole file mapped in memory or a large buffer, and writes go into a buffer
+ *  the backend empties when it is full or on flush(). The typed accessors
+ *  only touch the backend when the window runs out, so get_32() and friends
+ *  are an unaligned load and a bounds check, plus a byte swap when the file's
+ *  endianness differs from the host's.
+ */
+class FileAccess : public RefCounted {
+    GDCLASS(FileAccess, RefCounted);
+
+public:
+    enum ModeFlags {
+        /** Maps the whole file in memory. Files that can't be mapped, like
+         *  pipes, are read as with READ_STREAMING. */
+        READ = 1,
+        /** Reads through a large buffer, asking the system to read ahead. */
+        READ_STREAMING = 2,
+        /** Creates or truncates the file, and writes through a buffer. */
+        WRITE = 3,
+    };
+
+    /** How the file will be read, for the system to schedule its reads. */
+    enum AccessHint {
+        HINT_NORMAL,
+        HINT_SEQUENTIAL,
+        HINT_RANDOM,
+        /** All of it, soon: start reading it now. */
+        HINT_WILL_NEED,
+    };
+
+    typedef Ref<FileAccess> (*CreateFunc)();
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    static constexpr bool HOST_BIG_ENDIAN = true;
+#else
+    static constexpr bool HOST_BIG_ENDIAN = false;
+#endif
+
+private:
+    static CreateFunc _create_func;
+
+    template <typename T>
+    static Ref<FileAccess> _create_builtin() {
+        return memnew(T);
+    }
+
+    template <typename T>
+    _FORCE_INLINE_ T _get_scalar() {
+        T value;
+        if (likely(_read_end - _read_pos >= int64_t(sizeof(T)))) {
+            memcpy(&value, _read_pos, sizeof(T));
+            _read_pos += sizeof(T);
+        } else if (get_buffer(reinterpret_cast<uint8_t*>(&value), sizeof(T)) != sizeof(T)) {
+            return 0;
+        }
+        return value;
+    }
+
+    template <typename T>
+    _FORCE_INLINE_ void _store_scalar(T p_value) {
+        if (likely(_write_end - _write_pos >= int64_t(sizeof(T)))) {
+            memcpy(_write_pos, &p_value, sizeof(T));
+            _write_pos += sizeof(T);
+        } else {
+            store_buffer(reinterpret_cast<const uint8_t*>(&p_value), sizeof(T));
+        }
+    }
+
+protected:
+    /** Bytes ready to read: the rest of the mapping, or of the buffer. */
+    const uint8_t* _read_pos = nullptr;
+    const uint8_t* _read_end = nullptr;
+    /** Room left in the write buffer. */
+    uint8_t* _write_pos = nullptr;
+    uint8_t* _write_end = nullptr;
+    bool _big_endian = false;
+    bool _eof = false;
+
+    virtual Errors _open(const String& p_path, ModeFlags p_mode) = 0;
+    /** Refills the read window once it is empty. False at the end of the
+     *  file, or when not reading. */
+    virtual bool _refill() = 0;
+    /** Writes out the write buffer and resets the window to all of it. */
+    virtual Errors _flush_buffer() = 0;
+
+public:
+    template <typename T>
+    static void make_default() {
+        _create_func = &_create_builtin<T>;
+    }
+
+    /** A closed file of the default backend. */
+    static Ref<FileAccess> create();
+    static Ref<FileAccess> open(const String& p_path, ModeFlags p_mode, Errors* r_error = nullptr);
+    /** The whole file, read through a mapping. */
+    static Vector<uint8_t> get_file_as_bytes(const String& p_path, Errors* r_error = nullptr);
+
+    /** Flushes what is left to write. */
+    virtual void close() = 0;
+    virtual bool is_open() const = 0;
+    virtual String get_path() const = 0;
+    /** The last error, ERROR_FILE_EOF once a read went past the end. */
+    virtual Errors get_error() const = 0;
+
+    virtual void seek(uint64_t p_position) = 0;
+    /** Seeks to p_position bytes from the end, usually zero or negative. */
+    virtual void seek_end(int64_t p_position = 0) = 0;
+    virtual uint64_t get_position() const = 0;
+    virtual uint64_t get_length() const = 0;
+    /** Whether a read went past the end. */
+    _FORCE_INLINE_ bool eof_reached() const { return _eof; }
+
+    /** Applies to the rest of the reads; ignored when writing. */
+    virtual void set_access_hint(AccessHint p_hint) = 0;
+    /** Hands the buffered writes to the system. */
+    virtual Errors flush() = 0;
+
+    /** Byte order of the typed accessors; little endian by default. */
+    _FORCE_INLINE_ void set_big_endian(bool p_big_endian) { _big_endian = p_big_endian; }
+    _FORCE_INLINE_ bool is_big_endian() const { return _big_endian; }
+
+    /** Past the end, these return 0 and set eof_reached(). */
+    _FORCE_INLINE_ uint8_t get_8() {
+        if (likely(_read_pos < _read_end)) {
+            return *_read_pos++;
+        }
+        return _get_scalar<uint8_t>();
+    }
+    _FORCE_INLINE_ uint16_t get_16() {
+        const uint16_t value = _get_scalar<uint16_t>();
+        return _big_endian != HOST_BIG_ENDIAN ? BSWAP16(value) : value;
+    }
+    _FORCE_INLINE_ uint32_t get_32() {
+        const uint32_t value = _get_scalar<uint32_t>();
+        return _big_endian != HOST_BIG_ENDIAN ? BSWAP32(value) : value;
+    }
+    _FORCE_INLINE_ uint64_t get_64() {
+        const uint64_t value = _get_scalar<uint64_t>();
+        return _big_endian != HOST_BIG_ENDIAN ? BSWAP64(value) : value;
+    }
+    _FORCE_INLINE_ float get_float() {
+        const uint32_t bits = get_32();
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    _FORCE_INLINE_ double get_double() {
+        const uint64_t bits = get_64();
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    /** Reads up to p_length bytes to p_dst, as stored. Returns the bytes read. */
+    uint64_t get_buffer(uint8_t* p_dst, uint64_t p_length);
+    Vector<uint8_t> get_buffer(int64_t p_length);
+
+    _FORCE_INLINE_ void store_8(uint8_t p_value) {
+        if (likely(_write_pos < _write_end)) {
+            *_write_pos++ = p_value;
+            return;
+        }
+        _store_scalar<uint8_t>(p_value);
+    }
+    _FORCE_INLINE_ void store_16(uint16_t p_value) { _store_scalar<uint16_t>(_big_endian != HOST_BIG_ENDIAN ? BSWAP16(p_value) : p_value); }
+    _FORCE_INLINE_ void store_32(uint32_t p_value) { _store_scalar<uint32_t>(_big_endian != HOST_BIG_ENDIAN ? BSWAP32(p_value) : p_value); }
+    _FORCE_INLINE_ void store_64(uint64_t p_value) { _store_scalar<uint64_t>(_big_endian != HOST_BIG_ENDIAN ? BSWAP64(p_value) : p_value); }
+    _FORCE_INLINE_ void store_float(float p_value) {
+        uint32_t bits;
+        memcpy(&bits, &p_value, sizeof(bits));
+        store_32(bits);
+    }
+    _FORCE_INLINE_ void store_double(double p_value) {
+        uint64_t bits;
+        memcpy(&bits, &p_value, sizeof(bits));
+        store_64(bits);
+    }
+    void store_buffer(const uint8_t* p_src, uint64_t p_length);
+    _FORCE_INLINE_ void store_buffer(const Vector<uint8_t>& p_buffer) { store_buffer(p_buffer.ptr(), p_buffer.size()); }
+
+    FileAccess() {}
+    virtual ~FileAccess() {}
+};
 
 #endif
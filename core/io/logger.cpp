@@ -0,0 +1,318 @@
+#include "./logger.hpp"
+
+#include "../error/error_macros.hpp"
+#include "../os/memory.hpp"
+#include "./file_access.hpp"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+/** Messages this long at most are formatted on the stack. */
+#define LOGGER_FORMAT_BUFFER_SIZE 512
+/** Each message starts with its length on 4 bytes and its stream on 1. */
+#define LOGGER_RECORD_HEADER_SIZE 5
+/** How long flush_on_crash() waits for a drain in progress. */
+#define LOGGER_CRASH_WAIT_MSEC 100
+
+/** A single-producer, single-consumer ring: the thread writes at tail, the
+ *  drain reads at head, and each publishes its end with release order. */
+struct Logger::Buffer {
+    uint8_t* data = nullptr;
+    uint64_t mask = 0;
+    SafeNumeric<uint64_t> head;
+    SafeNumeric<uint64_t> tail;
+    /** The thread exited: free the buffer once drained. */
+    SafeFlag abandoned;
+    Buffer* next = nullptr;
+};
+
+Logger* Logger::_singleton = nullptr;
+BinaryMutex Logger::_buffers_mutex;
+SafeNumeric<uint64_t> Logger::_last_generation;
+thread_local Logger::ThreadSlot Logger::_thread_slot;
+
+static _FORCE_INLINE_ void _ring_write(uint8_t* p_ring, uint64_t p_mask, uint64_t p_pos, const void* p_src, uint64_t p_length) {
+    const uint64_t start = p_pos & p_mask;
+    const uint64_t first = MIN(p_length, p_mask + 1 - start);
+    memcpy(p_ring + start, p_src, first);
+    memcpy(p_ring, static_cast<const uint8_t*>(p_src) + first, p_length - first);
+}
+
+static _FORCE_INLINE_ void _ring_read(const uint8_t* p_ring, uint64_t p_mask, uint64_t p_pos, void* p_dst, uint64_t p_length) {
+    const uint64_t start = p_pos & p_mask;
+    const uint64_t first = MIN(p_length, p_mask + 1 - start);
+    memcpy(p_dst, p_ring + start, first);
+    memcpy(static_cast<uint8_t*>(p_dst) + first, p_ring, p_length - first);
+}
+
+Logger::ThreadSlot::~ThreadSlot() {
+    MutexLock lock(_buffers_mutex);
+    if (buffer && _singleton && _singleton->_generation == generation) {
+        buffer->abandoned.set();
+    }
+}
+
+Logger::Buffer* Logger::_get_thread_buffer() {
+    ThreadSlot& slot = _thread_slot;
+    if (likely(slot.generation == _generation)) {
+        return slot.buffer;
+    }
+
+    Buffer* buffer = memnew(Buffer);
+    buffer->data = static_cast<uint8_t*>(memalloc(_buffer_size));
+    buffer->mask = uint64_t(_buffer_size) - 1;
+    {
+        MutexLock lock(_buffers_mutex);
+        buffer->next = _buffers;
+        _buffers = buffer;
+    }
+    slot.generation = _generation;
+    slot.buffer = buffer;
+    return buffer;
+}
+
+void Logger::_write(Stream p_stream, const char* p_text, int64_t p_length) {
+    Buffer* buffer = _get_thread_buffer();
+    const uint64_t size = LOGGER_RECORD_HEADER_SIZE + uint64_t(p_length);
+    const uint64_t tail = buffer->tail.get_relaxed();
+    if (size > buffer->mask + 1 - (tail - buffer->head.get())) {
+        _dropped.increment();
+        return;
+    }
+
+    uint8_t header[LOGGER_RECORD_HEADER_SIZE];
+    const uint32_t length = uint32_t(p_length);
+    memcpy(header, &length, sizeof(length));
+    header[4] = p_stream;
+    _ring_write(buffer->data, buffer->mask, tail, header, LOGGER_RECORD_HEADER_SIZE);
+    _ring_write(buffer->data, buffer->mask, tail + LOGGER_RECORD_HEADER_SIZE, p_text, p_length);
+    buffer->tail.set(tail + size);
+
+    // Only the first message since the last drain wakes the thread up; the
+    // lock orders the flag with the thread checking it before waiting.
+    if (!_pending.test_and_set()) {
+        {
+            MutexLock lock(_wake_mutex);
+        }
+        _wake_condition.notify_one();
+    }
+}
+
+void Logger::logf(const char* p_format, ...) {
+    va_list list;
+    va_start(list, p_format);
+    logv(p_format, list);
+    va_end(list);
+}
+
+void Logger::logv(const char* p_format, va_list p_list, Stream p_stream) {
+    va_list list_copy;
+    va_copy(list_copy, p_list);
+
+    char text[LOGGER_FORMAT_BUFFER_SIZE];
+    const int length = vsnprintf(text, sizeof(text), p_format, p_list);
+    if (length >= 0 && length < int(sizeof(text))) {
+        _write(p_stream, text, length);
+    } else if (length >= 0) {
+        char* long_text = static_cast<char*>(memalloc(length + 1));
+        vsnprintf(long_text, length + 1, p_format, list_copy);
+        _write(p_stream, long_text, length);
+        memfree(long_text);
+    }
+
+    va_end(list_copy);
+}
+
+uint8_t* Logger::_reserve(Vector<uint8_t>& r_batch, int64_t& r_size, int64_t p_length) {
+    if (r_batch.size() < r_size + p_length) {
+        r_batch.resize(r_size + p_length);
+    }
+    uint8_t* dst = r_batch.ptrw() + r_size;
+    r_size += p_length;
+    return dst;
+}
+
+void Logger::_collect(bool p_reclaim) {
+    Buffer** link = &_buffers;
+    while (*link) {
+        Buffer* buffer = *link;
+        // Before the tail, so that all the thread wrote is seen.
+        const bool abandoned = buffer->abandoned.is_set();
+        const uint64_t tail = buffer->tail.get();
+        uint64_t head = buffer->head.get_relaxed();
+
+        while (head != tail) {
+            uint8_t header[LOGGER_RECORD_HEADER_SIZE];
+            _ring_read(buffer->data, buffer->mask, head, header, LOGGER_RECORD_HEADER_SIZE);
+            uint32_t length;
+            memcpy(&length, header, sizeof(length));
+            const Stream stream = header[4] == STREAM_STDERR ? STREAM_STDERR : STREAM_STDOUT;
+
+            uint8_t* dst = _reserve(_batches[stream], _batch_sizes[stream], length);
+            _ring_read(buffer->data, buffer->mask, head + LOGGER_RECORD_HEADER_SIZE, dst, length);
+            if (_file.is_valid()) {
+                memcpy(_reserve(_file_batch, _file_batch_size, length), dst, length);
+            }
+            head += LOGGER_RECORD_HEADER_SIZE + length;
+        }
+        buffer->head.set(head);
+
+        if (abandoned && p_reclaim) {
+            *link = buffer->next;
+            memfree(buffer->data);
+            memdelete(buffer);
+        } else {
+            link = &buffer->next;
+        }
+    }
+
+    const uint64_t dropped = _dropped.get();
+    if (dropped != _dropped_reported) {
+        char text[96];
+        const int length = snprintf(text, sizeof(text), "Logger: %llu messages dropped, their threads' buffers being full.\n", (unsigned long long)(dropped - _dropped_reported));
+        memcpy(_reserve(_batches[STREAM_STDERR], _batch_sizes[STREAM_STDERR], length), text, length);
+        if (_file.is_valid()) {
+            memcpy(_reserve(_file_batch, _file_batch_size, length), text, length);
+        }
+        _dropped_reported = dropped;
+    }
+}
+
+void Logger::_open_file() {
+    // Each run starts a file; the older ones move up a suffix, the oldest
+    // falling off the end.
+    for (int i = _max_files - 1; i > 0; i--) {
+        const CharString from = (i == 1 ? _log_path : _log_path + "." + String::num_int64(i - 1)).utf8();
+        const CharString to = (_log_path + "." + String::num_int64(i)).utf8();
+        remove(to.get_data());
+        rename(from.get_data(), to.get_data());
+    }
+
+    _file = FileAccess::open(_log_path, FileAccess::WRITE);
+    _file_size = 0;
+    ERROR_FAIL_COND_MSG(_file.is_null(), "Can't open log file '" + _log_path + "', logging to stdout and stderr only.");
+}
+
+void Logger::_write_batches() {
+    if (_batch_sizes[STREAM_STDOUT] > 0) {
+        fwrite(_batches[STREAM_STDOUT].ptr(), 1, _batch_sizes[STREAM_STDOUT], stdout);
+        fflush(stdout);
+        _batch_sizes[STREAM_STDOUT] = 0;
+    }
+    if (_batch_sizes[STREAM_STDERR] > 0) {
+        fwrite(_batches[STREAM_STDERR].ptr(), 1, _batch_sizes[STREAM_STDERR], stderr);
+        fflush(stderr);
+        _batch_sizes[STREAM_STDERR] = 0;
+    }
+    if (_file_batch_size > 0 && _file.is_valid()) {
+        _file->store_buffer(_file_batch.ptr(), _file_batch_size);
+        _file->flush();
+        _file_size += _file_batch_size;
+        if (_max_file_size > 0 && _file_size >= _max_file_size) {
+            _file->close();
+            _open_file();
+        }
+    }
+    _file_batch_size = 0;
+}
+
+void Logger::flush() {
+    MutexLock drain_lock(_drain_mutex);
+    {
+        MutexLock lock(_buffers_mutex);
+        _collect(true);
+    }
+    _write_batches();
+}
+
+void Logger::flush_on_crash() {
+    // Waits a little for a drain in progress, then goes on without it: it
+    // may have been interrupted by this very crash.
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(LOGGER_CRASH_WAIT_MSEC);
+    bool drain_locked = false;
+    bool buffers_locked = false;
+    while (!(drain_locked = _drain_mutex.try_lock()) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    while (!(buffers_locked = _buffers_mutex.try_lock()) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+
+    _collect(false);
+    if (buffers_locked) {
+        _buffers_mutex.unlock();
+    }
+    _write_batches();
+    if (drain_locked) {
+        _drain_mutex.unlock();
+    }
+}
+
+void Logger::_run() {
+    // Registered up front: errors while draining log from this thread, and
+    // registering then would wait on the lock the drain holds.
+    _get_thread_buffer();
+    while (true) {
+        bool exiting;
+        {
+            MutexLock lock(_wake_mutex);
+            while (!_pending.is_set() && !_exiting) {
+                _wake_condition.wait(lock);
+            }
+            exiting = _exiting;
+        }
+        // Cleared before draining: a message written during the drain wakes
+        // the thread up again.
+        _pending.clear();
+        flush();
+        if (exiting) {
+            return;
+        }
+    }
+}
+
+Logger::Logger(const String& p_log_path, int p_max_files, int64_t p_max_file_size, int64_t p_buffer_size) {
+    CRASH_COND_MSG(_singleton, "Only one Logger can exist at a time.");
+
+    _buffer_size = 1 << 12;
+    while (_buffer_size < p_buffer_size) {
+        _buffer_size <<= 1;
+    }
+    _log_path = p_log_path;
+    _max_files = MAX(p_max_files, 1);
+    _max_file_size = p_max_file_size;
+    if (!_log_path.is_empty()) {
+        _open_file();
+    }
+
+    _generation = _last_generation.increment();
+    {
+        MutexLock lock(_buffers_mutex);
+        _singleton = this;
+    }
+    _thread = std::thread([this]() { _run(); });
+}
+
+Logger::~Logger() {
+    {
+        MutexLock lock(_wake_mutex);
+        _exiting = true;
+    }
+    _wake_condition.notify_one();
+    _thread.join();
+
+    {
+        MutexLock lock(_buffers_mutex);
+        _singleton = nullptr;
+        // Messages logged since the last drain, by threads still running.
+        _collect(false);
+        while (_buffers) {
+            Buffer* buffer = _buffers;
+            _buffers = buffer->next;
+            memfree(buffer->data);
+            memdelete(buffer);
+        }
+    }
+    _write_batches();
+}
@@ -1,4 +1,120 @@
 #ifndef __LOGGER_HPP__
 #define __LOGGER_HPP__
 
+#include "../object/ref_counted.hpp"
+#include "../os/condition_variable.hpp"
+#include "../os/mutex.hpp"
+#include "../string/ustring.hpp"
+#include "../templates/safe_refcount.hpp"
+#include "../typedefs.hpp"
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <thread>
+
+class FileAccess;
+
+/** Writes messages to stdout, stderr and optionally a log file from a
+ *  background thread, so that threads logging never wait on I/O.
+ *
+ *  Each thread formats its messages into a ring buffer of its own, taking no
+ *  lock: only the first message of a thread takes one, to register its
+ *  buffer. The logging thread drains every buffer, then writes what it found
+ *  in a single write per output. A message that doesn't fit in its thread's
+ *  buffer is dropped and counted, and the count is logged once there is room
+ *  again. Messages of a thread come out in order, but those of different
+ *  threads are only ordered by drain.
+ *
+ *  While a Logger exists, the error macros print through it, and
+ *  _error_flush_stdout() writes out whatever is buffered before crashing.
+ */
+class Logger {
+public:
+    enum Stream : uint8_t {
+        STREAM_STDOUT,
+        STREAM_STDERR,
+    };
+
+private:
+    struct Buffer;
+
+    /** The buffer of the calling thread, registered with the logger of
+     *  generation. */
+    struct ThreadSlot {
+        uint64_t generation = 0;
+        Buffer* buffer = nullptr;
+
+        ~ThreadSlot();
+    };
+
+    static Logger* _singleton;
+    /** Guards the buffer list, and the singleton for exiting threads. */
+    static BinaryMutex _buffers_mutex;
+    /** Tells the buffers of this logger from those of earlier ones. */
+    static SafeNumeric<uint64_t> _last_generation;
+    static thread_local ThreadSlot _thread_slot;
+
+    uint64_t _generation = 0;
+    int64_t _buffer_size = 0;
+    Buffer* _buffers = nullptr;
+    SafeNumeric<uint64_t> _dropped;
+    uint64_t _dropped_reported = 0;
+
+    /** One drain at a time, from the thread, flush() or a crash. Each
+     *  collects into a batch per stream, and one for the file with both
+     *  in order. */
+    BinaryMutex _drain_mutex;
+    Vector<uint8_t> _batches[2];
+    int64_t _batch_sizes[2] = {};
+    Vector<uint8_t> _file_batch;
+    int64_t _file_batch_size = 0;
+
+    String _log_path;
+    int _max_files = 0;
+    int64_t _max_file_size = 0;
+    Ref<FileAccess> _file;
+    int64_t _file_size = 0;
+
+    BinaryMutex _wake_mutex;
+    ConditionVariable _wake_condition;
+    SafeFlag _pending;
+    bool _exiting = false;
+    std::thread _thread;
+
+    Buffer* _get_thread_buffer();
+    void _write(Stream p_stream, const char* p_text, int64_t p_length);
+
+    /** Room for p_length more bytes in r_batch, returned. */
+    static uint8_t* _reserve(Vector<uint8_t>& r_batch, int64_t& r_size, int64_t p_length);
+    /** Moves the messages out of the buffers, freeing the buffers of exited
+     *  threads when p_reclaim. Needs _buffers_mutex. */
+    void _collect(bool p_reclaim);
+    void _open_file();
+    void _write_batches();
+    void _run();
+
+public:
+    _FORCE_INLINE_ static Logger* get_singleton() { return _singleton; }
+
+    /** printf() formatting, to stdout. */
+    void logf(const char* p_format, ...) _PRINTF_FORMAT_ATTRIBUTE_2_3;
+    void logv(const char* p_format, va_list p_list, Stream p_stream = STREAM_STDOUT) _PRINTF_FORMAT_ATTRIBUTE_2_0;
+
+    /** Writes out what was logged so far, on the calling thread. */
+    void flush();
+    /** Like flush(), for a thread about to crash: doesn't wait long for a
+     *  drain in progress, which may be the one that crashed. */
+    void flush_on_crash();
+
+    /** Messages dropped for lack of room in their thread's buffer. */
+    uint64_t get_dropped_count() const { return _dropped.get(); }
+
+    /** Logs to stdout and stderr, and to p_log_path too when not empty.
+     *  Past p_max_file_size bytes, the log file is renamed with a ".1"
+     *  suffix, the previous ".1" to ".2" and so on, keeping p_max_files
+     *  files in all. Each thread buffers up to p_buffer_size bytes. */
+    Logger(const String& p_log_path = String(), int p_max_files = 5, int64_t p_max_file_size = 8 << 20, int64_t p_buffer_size = 64 << 10);
+    ~Logger();
+};
+
 #endif
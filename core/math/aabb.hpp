@@ -0,0 +1,28 @@
+#ifndef __AABB_HPP__
+#define __AABB_HPP__
+
+#include "./vector3.hpp"
+
+/** Axis-aligned bounding box, stored as a corner and a size. */
+struct [[nodiscard]] AABB {
+    Vector3 position;
+    Vector3 size;
+
+    _FORCE_INLINE_ Vector3 get_end() const { return position + size; }
+    _FORCE_INLINE_ real_t get_volume() const { return size.x * size.y * size.z; }
+
+    _FORCE_INLINE_ bool has_point(const Vector3& p_point) const {
+        const Vector3 end = get_end();
+        return p_point.x >= position.x && p_point.y >= position.y && p_point.z >= position.z &&
+               p_point.x <= end.x && p_point.y <= end.y && p_point.z <= end.z;
+    }
+
+    _FORCE_INLINE_ bool operator==(const AABB& p_rval) const { return position == p_rval.position && size == p_rval.size; }
+    _FORCE_INLINE_ bool operator!=(const AABB& p_rval) const { return !(*this == p_rval); }
+
+    AABB() {}
+    AABB(const Vector3& p_position, const Vector3& p_size) :
+            position(p_position), size(p_size) {}
+};
+
+#endif
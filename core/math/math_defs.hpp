@@ -0,0 +1,19 @@
+#ifndef __MATH_DEFS_HPP__
+#define __MATH_DEFS_HPP__
+
+#include "../typedefs.hpp"
+
+#include <math.h>
+
+#define CMP_EPSILON 0.00001
+#define CMP_EPSILON2 (CMP_EPSILON * CMP_EPSILON)
+
+/** Scalar type of the math types. Builds that need double precision for
+ *  large worlds define REAL_T_IS_DOUBLE. */
+#ifdef REAL_T_IS_DOUBLE
+typedef double real_t;
+#else
+typedef float real_t;
+#endif
+
+#endif
@@ -0,0 +1,38 @@
+#include "./math_funcs.hpp"
+
+#include <chrono>
+
+#define PCG_DEFAULT_INC 1442695040888963407ULL
+#define PCG_MULTIPLIER 6364136223846793005ULL
+
+struct PCG32State {
+    uint64_t state = 0x853c49e6748fea9bULL;
+    uint64_t inc = PCG_DEFAULT_INC;
+};
+
+static thread_local PCG32State pcg_state;
+
+uint32_t Math::rand() {
+    uint64_t oldstate = pcg_state.state;
+    pcg_state.state = oldstate * PCG_MULTIPLIER + (pcg_state.inc | 1);
+    uint32_t xorshifted = (uint32_t)(((oldstate >> 18u) ^ oldstate) >> 27u);
+    uint32_t rot = (uint32_t)(oldstate >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+}
+
+double Math::randf() {
+    return (double)rand() / (double)UINT32_MAX;
+}
+
+void Math::seed(uint64_t p_seed) {
+    pcg_state.state = 0U;
+    pcg_state.inc = (PCG_DEFAULT_INC << 1u) | 1u;
+    rand();
+    pcg_state.state += p_seed;
+    rand();
+}
+
+void Math::randomize() {
+    uint64_t time_seed = (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    seed(time_seed ^ (uint64_t)(uintptr_t)&pcg_state);
+}
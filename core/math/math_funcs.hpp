@@ -0,0 +1,17 @@
+#ifndef __MATH_FUNCS_HPP__
+#define __MATH_FUNCS_HPP__
+
+#include "./math_defs.hpp"
+
+class Math {
+public:
+    Math() {} // useless to instance
+
+    /** Thread-local PCG32 generator: no locking, each thread has its own stream. */
+    static uint32_t rand();
+    static double randf();
+    static void seed(uint64_t p_seed);
+    static void randomize();
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef __TRANSFORM_2D_HPP__
+#define __TRANSFORM_2D_HPP__
+
+#include "./vector2.hpp"
+
+/** 2D affine transform: two basis columns and the origin. */
+struct [[nodiscard]] Transform2D {
+    Vector2 columns[3] = { Vector2(1, 0), Vector2(0, 1), Vector2() };
+
+    _FORCE_INLINE_ const Vector2& get_origin() const { return columns[2]; }
+    _FORCE_INLINE_ void set_origin(const Vector2& p_origin) { columns[2] = p_origin; }
+
+    _FORCE_INLINE_ Vector2 basis_xform(const Vector2& p_v) const { return columns[0] * p_v.x + columns[1] * p_v.y; }
+    _FORCE_INLINE_ Vector2 xform(const Vector2& p_v) const { return basis_xform(p_v) + columns[2]; }
+
+    Transform2D operator*(const Transform2D& p_transform) const {
+        Transform2D t;
+        t.columns[0] = basis_xform(p_transform.columns[0]);
+        t.columns[1] = basis_xform(p_transform.columns[1]);
+        t.columns[2] = xform(p_transform.columns[2]);
+        return t;
+    }
+
+    _FORCE_INLINE_ bool operator==(const Transform2D& p_transform) const {
+        return columns[0] == p_transform.columns[0] && columns[1] == p_transform.columns[1] && columns[2] == p_transform.columns[2];
+    }
+    _FORCE_INLINE_ bool operator!=(const Transform2D& p_transform) const { return !(*this == p_transform); }
+
+    Transform2D() {}
+    Transform2D(const Vector2& p_x, const Vector2& p_y, const Vector2& p_origin) :
+            columns{ p_x, p_y, p_origin } {}
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef __VECTOR2_HPP__
+#define __VECTOR2_HPP__
+
+#include "./math_defs.hpp"
+
+struct [[nodiscard]] Vector2 {
+    static const int AXIS_COUNT = 2;
+
+    real_t x = 0;
+    real_t y = 0;
+
+    _FORCE_INLINE_ real_t& operator[](int p_axis) { return (&x)[p_axis]; }
+    _FORCE_INLINE_ const real_t& operator[](int p_axis) const { return (&x)[p_axis]; }
+
+    _FORCE_INLINE_ real_t dot(const Vector2& p_other) const { return x * p_other.x + y * p_other.y; }
+    _FORCE_INLINE_ real_t length_squared() const { return dot(*this); }
+    _FORCE_INLINE_ real_t length() const { return sqrt(length_squared()); }
+
+    _FORCE_INLINE_ Vector2 operator+(const Vector2& p_v) const { return Vector2(x + p_v.x, y + p_v.y); }
+    _FORCE_INLINE_ Vector2 operator-(const Vector2& p_v) const { return Vector2(x - p_v.x, y - p_v.y); }
+    _FORCE_INLINE_ Vector2 operator*(const Vector2& p_v) const { return Vector2(x * p_v.x, y * p_v.y); }
+    _FORCE_INLINE_ Vector2 operator*(real_t p_scalar) const { return Vector2(x * p_scalar, y * p_scalar); }
+    _FORCE_INLINE_ Vector2 operator/(real_t p_scalar) const { return Vector2(x / p_scalar, y / p_scalar); }
+    _FORCE_INLINE_ Vector2 operator-() const { return Vector2(-x, -y); }
+
+    _FORCE_INLINE_ void operator+=(const Vector2& p_v) { x += p_v.x; y += p_v.y; }
+    _FORCE_INLINE_ void operator-=(const Vector2& p_v) { x -= p_v.x; y -= p_v.y; }
+    _FORCE_INLINE_ void operator*=(real_t p_scalar) { x *= p_scalar; y *= p_scalar; }
+
+    _FORCE_INLINE_ bool operator==(const Vector2& p_v) const { return x == p_v.x && y == p_v.y; }
+    _FORCE_INLINE_ bool operator!=(const Vector2& p_v) const { return x != p_v.x || y != p_v.y; }
+    _FORCE_INLINE_ bool operator<(const Vector2& p_v) const { return x == p_v.x ? (y < p_v.y) : (x < p_v.x); }
+
+    constexpr Vector2() {}
+    constexpr Vector2(real_t p_x, real_t p_y) :
+            x(p_x), y(p_y) {}
+};
+
+struct [[nodiscard]] Vector2i {
+    static const int AXIS_COUNT = 2;
+
+    int32_t x = 0;
+    int32_t y = 0;
+
+    _FORCE_INLINE_ int32_t& operator[](int p_axis) { return (&x)[p_axis]; }
+    _FORCE_INLINE_ const int32_t& operator[](int p_axis) const { return (&x)[p_axis]; }
+
+    _FORCE_INLINE_ Vector2i operator+(const Vector2i& p_v) const { return Vector2i(x + p_v.x, y + p_v.y); }
+    _FORCE_INLINE_ Vector2i operator-(const Vector2i& p_v) const { return Vector2i(x - p_v.x, y - p_v.y); }
+    _FORCE_INLINE_ Vector2i operator*(int32_t p_scalar) const { return Vector2i(x * p_scalar, y * p_scalar); }
+    _FORCE_INLINE_ Vector2i operator-() const { return Vector2i(-x, -y); }
+
+    _FORCE_INLINE_ bool operator==(const Vector2i& p_v) const { return x == p_v.x && y == p_v.y; }
+    _FORCE_INLINE_ bool operator!=(const Vector2i& p_v) const { return x != p_v.x || y != p_v.y; }
+    _FORCE_INLINE_ bool operator<(const Vector2i& p_v) const { return x == p_v.x ? (y < p_v.y) : (x < p_v.x); }
+
+    _FORCE_INLINE_ operator Vector2() const { return Vector2(x, y); }
+
+    constexpr Vector2i() {}
+    constexpr Vector2i(int32_t p_x, int32_t p_y) :
+            x(p_x), y(p_y) {}
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef __VECTOR3_HPP__
+#define __VECTOR3_HPP__
+
+#include "./math_defs.hpp"
+
+struct [[nodiscard]] Vector3 {
+    static const int AXIS_COUNT = 3;
+
+    real_t x = 0;
+    real_t y = 0;
+    real_t z = 0;
+
+    _FORCE_INLINE_ real_t& operator[](int p_axis) { return (&x)[p_axis]; }
+    _FORCE_INLINE_ const real_t& operator[](int p_axis) const { return (&x)[p_axis]; }
+
+    _FORCE_INLINE_ real_t dot(const Vector3& p_other) const { return x * p_other.x + y * p_other.y + z * p_other.z; }
+    _FORCE_INLINE_ Vector3 cross(const Vector3& p_other) const {
+        return Vector3(y * p_other.z - z * p_other.y, z * p_other.x - x * p_other.z, x * p_other.y - y * p_other.x);
+    }
+    _FORCE_INLINE_ real_t length_squared() const { return dot(*this); }
+    _FORCE_INLINE_ real_t length() const { return sqrt(length_squared()); }
+
+    _FORCE_INLINE_ Vector3 operator+(const Vector3& p_v) const { return Vector3(x + p_v.x, y + p_v.y, z + p_v.z); }
+    _FORCE_INLINE_ Vector3 operator-(const Vector3& p_v) const { return Vector3(x - p_v.x, y - p_v.y, z - p_v.z); }
+    _FORCE_INLINE_ Vector3 operator*(const Vector3& p_v) const { return Vector3(x * p_v.x, y * p_v.y, z * p_v.z); }
+    _FORCE_INLINE_ Vector3 operator*(real_t p_scalar) const { return Vector3(x * p_scalar, y * p_scalar, z * p_scalar); }
+    _FORCE_INLINE_ Vector3 operator/(real_t p_scalar) const { return Vector3(x / p_scalar, y / p_scalar, z / p_scalar); }
+    _FORCE_INLINE_ Vector3 operator-() const { return Vector3(-x, -y, -z); }
+
+    _FORCE_INLINE_ void operator+=(const Vector3& p_v) { x += p_v.x; y += p_v.y; z += p_v.z; }
+    _FORCE_INLINE_ void operator-=(const Vector3& p_v) { x -= p_v.x; y -= p_v.y; z -= p_v.z; }
+    _FORCE_INLINE_ void operator*=(real_t p_scalar) { x *= p_scalar; y *= p_scalar; z *= p_scalar; }
+
+    _FORCE_INLINE_ bool operator==(const Vector3& p_v) const { return x == p_v.x && y == p_v.y && z == p_v.z; }
+    _FORCE_INLINE_ bool operator!=(const Vector3& p_v) const { return !(*this == p_v); }
+    _FORCE_INLINE_ bool operator<(const Vector3& p_v) const {
+        if (x != p_v.x) {
+            return x < p_v.x;
+        }
+        return y == p_v.y ? (z < p_v.z) : (y < p_v.y);
+    }
+
+    constexpr Vector3() {}
+    constexpr Vector3(real_t p_x, real_t p_y, real_t p_z) :
+            x(p_x), y(p_y), z(p_z) {}
+};
+
+struct [[nodiscard]] Vector3i {
+    static const int AXIS_COUNT = 3;
+
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t z = 0;
+
+    _FORCE_INLINE_ int32_t& operator[](int p_axis) { return (&x)[p_axis]; }
+    _FORCE_INLINE_ const int32_t& operator[](int p_axis) const { return (&x)[p_axis]; }
+
+    _FORCE_INLINE_ Vector3i operator+(const Vector3i& p_v) const { return Vector3i(x + p_v.x, y + p_v.y, z + p_v.z); }
+    _FORCE_INLINE_ Vector3i operator-(const Vector3i& p_v) const { return Vector3i(x - p_v.x, y - p_v.y, z - p_v.z); }
+    _FORCE_INLINE_ Vector3i operator*(int32_t p_scalar) const { return Vector3i(x * p_scalar, y * p_scalar, z * p_scalar); }
+    _FORCE_INLINE_ Vector3i operator-() const { return Vector3i(-x, -y, -z); }
+
+    _FORCE_INLINE_ bool operator==(const Vector3i& p_v) const { return x == p_v.x && y == p_v.y && z == p_v.z; }
+    _FORCE_INLINE_ bool operator!=(const Vector3i& p_v) const { return !(*this == p_v); }
+    _FORCE_INLINE_ bool operator<(const Vector3i& p_v) const {
+        if (x != p_v.x) {
+            return x < p_v.x;
+        }
+        return y == p_v.y ? (z < p_v.z) : (y < p_v.y);
+    }
+
+    _FORCE_INLINE_ operator Vector3() const { return Vector3(x, y, z); }
+
+    constexpr Vector3i() {}
+    constexpr Vector3i(int32_t p_x, int32_t p_y, int32_t p_z) :
+            x(p_x), y(p_y), z(p_z) {}
+};
+
+#endif
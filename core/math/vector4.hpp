@@ -0,0 +1,75 @@
+#ifndef __VECTOR4_HPP__
+#define __VECTOR4_HPP__
+
+#include "./math_defs.hpp"
+
+struct [[nodiscard]] Vector4 {
+    static const int AXIS_COUNT = 4;
+
+    real_t x = 0;
+    real_t y = 0;
+    real_t z = 0;
+    real_t w = 0;
+
+    _FORCE_INLINE_ real_t& operator[](int p_axis) { return (&x)[p_axis]; }
+    _FORCE_INLINE_ const real_t& operator[](int p_axis) const { return (&x)[p_axis]; }
+
+    _FORCE_INLINE_ real_t dot(const Vector4& p_other) const { return x * p_other.x + y * p_other.y + z * p_other.z + w * p_other.w; }
+    _FORCE_INLINE_ real_t length_squared() const { return dot(*this); }
+    _FORCE_INLINE_ real_t length() const { return sqrt(length_squared()); }
+
+    _FORCE_INLINE_ Vector4 operator+(const Vector4& p_v) const { return Vector4(x + p_v.x, y + p_v.y, z + p_v.z, w + p_v.w); }
+    _FORCE_INLINE_ Vector4 operator-(const Vector4& p_v) const { return Vector4(x - p_v.x, y - p_v.y, z - p_v.z, w - p_v.w); }
+    _FORCE_INLINE_ Vector4 operator*(real_t p_scalar) const { return Vector4(x * p_scalar, y * p_scalar, z * p_scalar, w * p_scalar); }
+    _FORCE_INLINE_ Vector4 operator-() const { return Vector4(-x, -y, -z, -w); }
+
+    _FORCE_INLINE_ bool operator==(const Vector4& p_v) const { return x == p_v.x && y == p_v.y && z == p_v.z && w == p_v.w; }
+    _FORCE_INLINE_ bool operator!=(const Vector4& p_v) const { return !(*this == p_v); }
+    _FORCE_INLINE_ bool operator<(const Vector4& p_v) const {
+        for (int i = 0; i < AXIS_COUNT - 1; i++) {
+            if ((*this)[i] != p_v[i]) {
+                return (*this)[i] < p_v[i];
+            }
+        }
+        return w < p_v.w;
+    }
+
+    constexpr Vector4() {}
+    constexpr Vector4(real_t p_x, real_t p_y, real_t p_z, real_t p_w) :
+            x(p_x), y(p_y), z(p_z), w(p_w) {}
+};
+
+struct [[nodiscard]] Vector4i {
+    static const int AXIS_COUNT = 4;
+
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t z = 0;
+    int32_t w = 0;
+
+    _FORCE_INLINE_ int32_t& operator[](int p_axis) { return (&x)[p_axis]; }
+    _FORCE_INLINE_ const int32_t& operator[](int p_axis) const { return (&x)[p_axis]; }
+
+    _FORCE_INLINE_ Vector4i operator+(const Vector4i& p_v) const { return Vector4i(x + p_v.x, y + p_v.y, z + p_v.z, w + p_v.w); }
+    _FORCE_INLINE_ Vector4i operator-(const Vector4i& p_v) const { return Vector4i(x - p_v.x, y - p_v.y, z - p_v.z, w - p_v.w); }
+    _FORCE_INLINE_ Vector4i operator-() const { return Vector4i(-x, -y, -z, -w); }
+
+    _FORCE_INLINE_ bool operator==(const Vector4i& p_v) const { return x == p_v.x && y == p_v.y && z == p_v.z && w == p_v.w; }
+    _FORCE_INLINE_ bool operator!=(const Vector4i& p_v) const { return !(*this == p_v); }
+    _FORCE_INLINE_ bool operator<(const Vector4i& p_v) const {
+        for (int i = 0; i < AXIS_COUNT - 1; i++) {
+            if ((*this)[i] != p_v[i]) {
+                return (*this)[i] < p_v[i];
+            }
+        }
+        return w < p_v.w;
+    }
+
+    _FORCE_INLINE_ operator Vector4() const { return Vector4(x, y, z, w); }
+
+    constexpr Vector4i() {}
+    constexpr Vector4i(int32_t p_x, int32_t p_y, int32_t p_z, int32_t p_w) :
+            x(p_x), y(p_y), z(p_z), w(p_w) {}
+};
+
+#endif
@@ -0,0 +1,219 @@
+#include "./class_db.hpp"
+
+ClassDB::NameTable<ClassDB::ClassInfo*> ClassDB::classes;
+bool ClassDB::frozen = false;
+uint64_t ClassDB::generation = 1;
+
+void ClassDB::_add_class2(const StringName& p_class, const StringName& p_inherits) {
+    ERROR_FAIL_COND_MSG(frozen, "ClassDB is frozen, classes can't be added anymore.");
+    ERROR_FAIL_COND_MSG(classes.has(p_class), "Class already registered.");
+
+    ClassInfo* ti = memnew(ClassInfo);
+    ti->name = p_class;
+    ti->inherits = p_inherits;
+
+    if (!p_inherits.is_empty()) {
+        ClassInfo** parent = classes.lookup(p_inherits);
+        ERROR_FAIL_NULL_MSG(parent, "Parent class must be registered before its children.");
+        ti->inherits_ptr = *parent;
+    }
+
+    classes.insert(p_class, ti);
+}
+
+void ClassDB::bind_method_custom(const StringName& p_class, MethodBind* p_method) {
+    ERROR_FAIL_NULL(p_method);
+
+    ClassInfo** type = classes.lookup(p_class);
+    if (frozen || !type || !(*type)->method_map.insert(p_method->get_name(), p_method)) {
+        memdelete(p_method);
+        ERROR_FAIL_COND_MSG(frozen, "ClassDB is frozen, methods can't be bound anymore.");
+        ERROR_FAIL_NULL_MSG(type, "Binding a method to a class that is not registered.");
+        ERROR_FAIL_MSG("Method already bound.");
+    }
+
+    p_method->set_instance_class(p_class);
+}
+
+void ClassDB::add_property(const StringName& p_class, const StringName& p_name, const StringName& p_setter, const StringName& p_getter) {
+    ERROR_FAIL_COND_MSG(frozen, "ClassDB is frozen, properties can't be added anymore.");
+
+    ClassInfo** type = classes.lookup(p_class);
+    ERROR_FAIL_NULL(type);
+
+    PropertySetGet psg;
+    psg.setter = p_setter;
+    psg.getter = p_getter;
+    ERROR_FAIL_COND_MSG(!(*type)->property_map.insert(p_name, psg), "Property already exists.");
+}
+
+void ClassDB::add_signal(const StringName& p_class, const StringName& p_signal, const Vector<StringName>& p_arguments) {
+    ERROR_FAIL_COND_MSG(frozen, "ClassDB is frozen, signals can't be added anymore.");
+
+    ClassInfo** type = classes.lookup(p_class);
+    ERROR_FAIL_NULL(type);
+
+    SignalInfo si;
+    si.arguments = p_arguments;
+    ERROR_FAIL_COND_MSG(!(*type)->signal_map.insert(p_signal, si), "Signal already exists.");
+}
+
+void ClassDB::_freeze_class(ClassInfo* p_class) {
+    if (p_class->frozen) {
+        return;
+    }
+
+    ClassInfo* parent = p_class->inherits_ptr;
+    if (parent) {
+        _freeze_class(parent);
+        p_class->method_map.merge_parent(parent->method_map);
+        p_class->property_map.merge_parent(parent->property_map);
+        p_class->signal_map.merge_parent(parent->signal_map);
+    }
+
+    /** Accessors are resolved once instead of at every property access. */
+    NameTable<PropertySetGet>::Entry* props = p_class->property_map.ptrw();
+    for (int64_t i = 0; i < p_class->property_map.size(); i++) {
+        PropertySetGet& psg = props[i].value;
+        if (!psg.setter.is_empty()) {
+            MethodBind* const* setter = p_class->method_map.lookup(psg.setter);
+            psg._setptr = setter ? *setter : nullptr;
+            ERROR_CONTINUE_MSG(!setter, "Property setter is not a bound method.");
+        }
+        if (!psg.getter.is_empty()) {
+            MethodBind* const* getter = p_class->method_map.lookup(psg.getter);
+            psg._getptr = getter ? *getter : nullptr;
+            ERROR_CONTINUE_MSG(!getter, "Property getter is not a bound method.");
+        }
+    }
+
+    p_class->frozen = true;
+}
+
+void ClassDB::freeze() {
+    ERROR_FAIL_COND(frozen);
+
+    const NameTable<ClassInfo*>::Entry* e = classes.ptr();
+    for (int64_t i = 0; i < classes.size(); i++) {
+        _freeze_class(e[i].value);
+    }
+
+    frozen = true;
+}
+
+bool ClassDB::class_exists(const StringName& p_class) {
+    return classes.has(p_class);
+}
+
+StringName ClassDB::get_parent_class(const StringName& p_class) {
+    ClassInfo* const* ti = classes.lookup(p_class);
+    ERROR_FAIL_NULL_V(ti, StringName());
+    return (*ti)->inherits;
+}
+
+bool ClassDB::is_parent_class(const StringName& p_class, const StringName& p_inherits) {
+    ClassInfo* const* ti = classes.lookup(p_class);
+    const ClassInfo* c = ti ? *ti : nullptr;
+    while (c) {
+        if (c->name == p_inherits) {
+            return true;
+        }
+        c = c->inherits_ptr;
+    }
+
+    return false;
+}
+
+bool ClassDB::can_instantiate(const StringName& p_class) {
+    ClassInfo* const* ti = classes.lookup(p_class);
+    return ti && (*ti)->creation_func;
+}
+
+Object* ClassDB::instantiate(const StringName& p_class) {
+    ClassInfo* const* ti = classes.lookup(p_class);
+    ERROR_FAIL_NULL_V_MSG(ti, nullptr, "Cannot get class.");
+    ERROR_FAIL_NULL_V_MSG((*ti)->creation_func, nullptr, "Class can't be instantiated.");
+    return (*ti)->creation_func();
+}
+
+MethodBind* ClassDB::get_method(const StringName& p_class, const StringName& p_method) {
+    ClassInfo* const* ti = classes.lookup(p_class);
+    const ClassInfo* c = ti ? *ti : nullptr;
+    while (c) {
+        MethodBind* const* method = c->method_map.lookup(p_method);
+        if (method) {
+            return *method;
+        }
+        /** Once frozen, tables already hold inherited members. */
+        c = frozen ? nullptr : c->inherits_ptr;
+    }
+
+    return nullptr;
+}
+
+const ClassDB::PropertySetGet* ClassDB::get_property(const StringName& p_class, const StringName& p_property) {
+    ClassInfo* const* ti = classes.lookup(p_class);
+    const ClassInfo* c = ti ? *ti : nullptr;
+    while (c) {
+        const PropertySetGet* psg = c->property_map.lookup(p_property);
+        if (psg) {
+            return psg;
+        }
+        c = frozen ? nullptr : c->inherits_ptr;
+    }
+
+    return nullptr;
+}
+
+const ClassDB::SignalInfo* ClassDB::get_signal(const StringName& p_class, const StringName& p_signal) {
+    ClassInfo* const* ti = classes.lookup(p_class);
+    const ClassInfo* c = ti ? *ti : nullptr;
+    while (c) {
+        const SignalInfo* si = c->signal_map.lookup(p_signal);
+        if (si) {
+            return si;
+        }
+        c = frozen ? nullptr : c->inherits_ptr;
+    }
+
+    return nullptr;
+}
+
+MethodBind* ClassDB::_update_method_cache(MethodCache& r_cache, const StringName& p_class, const StringName& p_method) {
+    MethodBind* method = get_method(p_class, p_method);
+
+    /** Tables may still change while registering, only cache frozen results. */
+    if (frozen) {
+        r_cache.class_name = p_class;
+        r_cache.method_name = p_method;
+        r_cache.generation = generation;
+        r_cache.method = method;
+    }
+
+    return method;
+}
+
+void ClassDB::cleanup() {
+    NameTable<ClassInfo*>::Entry* e = classes.ptrw();
+    for (int64_t i = 0; i < classes.size(); i++) {
+        ClassInfo* ti = e[i].value;
+        const ClassInfo* parent = ti->inherits_ptr;
+
+        /** Inherited entries point to the parent's binds, only delete our own. */
+        const NameTable<MethodBind*>::Entry* m = ti->method_map.ptr();
+        for (int64_t j = 0; j < ti->method_map.size(); j++) {
+            MethodBind* const* inherited = parent ? parent->method_map.lookup(m[j].name) : nullptr;
+            if (!inherited || *inherited != m[j].value) {
+                memdelete(m[j].value);
+            }
+        }
+    }
+
+    for (int64_t i = 0; i < classes.size(); i++) {
+        memdelete(e[i].value);
+    }
+
+    classes.clear();
+    frozen = false;
+    generation++;
+}
@@ -1,4 +1,237 @@
 #ifndef __CLASS_DB_HPP__
 #define __CLASS_DB_HPP__
 
+#include "../string/string_name.hpp"
+#include "../templates/vector.hpp"
+#include "./method_bind.hpp"
+#include "./object.hpp"
+
+/** Registry of engine classes and of their methods, properties and signals.
+ *
+ *  Lifetime has two phases:
+ *  - Registration, single threaded, at startup: classes are added with
+ *    register_class<T>() and fill their tables from _bind_methods().
+ *  - Frozen, after freeze(): every class table is flattened with the tables of
+ *    its ancestors and becomes immutable, so lookups need no lock and no walk up
+ *    the hierarchy.
+ *
+ *  Tables are flat arrays sorted by the identity of the interned StringName,
+ *  so a lookup is a binary search over pointer compares; names are never hashed
+ *  nor compared as text. Call sites that resolve the same method repeatedly
+ *  keep a MethodCache, which makes a hit a few compares.
+ */
+class ClassDB {
+public:
+    /** Flat map keyed by interned StringName, kept sorted by data pointer. */
+    template <typename V>
+    class NameTable {
+    public:
+        struct Entry {
+            StringName name;
+            V value;
+        };
+
+    private:
+        Vector<Entry> entries;
+
+        int64_t _find_index(const void* p_key, bool& r_exact) const {
+            const Entry* e = entries.ptr();
+            int64_t low = 0;
+            int64_t high = entries.size();
+            while (low < high) {
+                const int64_t middle = (low + high) >> 1;
+                if (e[middle].name.data_unique_pointer() < p_key) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+
+            r_exact = low < entries.size() && e[low].name.data_unique_pointer() == p_key;
+            return low;
+        }
+
+    public:
+        _FORCE_INLINE_ const V* lookup(const StringName& p_name) const {
+            bool exact;
+            const int64_t idx = _find_index(p_name.data_unique_pointer(), exact);
+            return exact ? &entries.ptr()[idx].value : nullptr;
+        }
+
+        _FORCE_INLINE_ V* lookup(const StringName& p_name) {
+            bool exact;
+            const int64_t idx = _find_index(p_name.data_unique_pointer(), exact);
+            return exact ? &entries.ptrw()[idx].value : nullptr;
+        }
+
+        _FORCE_INLINE_ bool has(const StringName& p_name) const { return lookup(p_name) != nullptr; }
+
+        /** Returns false if the name was already there; the table is left untouched then. */
+        bool insert(const StringName& p_name, const V& p_value) {
+            bool exact;
+            const int64_t idx = _find_index(p_name.data_unique_pointer(), exact);
+            if (exact) {
+                return false;
+            }
+
+            entries.insert(idx, Entry{ p_name, p_value });
+            return true;
+        }
+
+        /** Adds every entry of p_parent that this table doesn't override. */
+        void merge_parent(const NameTable& p_parent) {
+            if (p_parent.entries.is_empty()) {
+                return;
+            }
+
+            Vector<Entry> merged;
+            merged.resize(entries.size() + p_parent.entries.size());
+            Entry* w = merged.ptrw();
+            const Entry* a = entries.ptr();
+            const Entry* b = p_parent.entries.ptr();
+            const int64_t a_size = entries.size();
+            const int64_t b_size = p_parent.entries.size();
+
+            int64_t i = 0;
+            int64_t j = 0;
+            int64_t k = 0;
+            while (i < a_size || j < b_size) {
+                if (j == b_size || (i < a_size && a[i].name.data_unique_pointer() < b[j].name.data_unique_pointer())) {
+                    w[k++] = a[i++];
+                } else if (i == a_size || b[j].name.data_unique_pointer() < a[i].name.data_unique_pointer()) {
+                    w[k++] = b[j++];
+                } else {
+                    /** Same name, the child wins. */
+                    w[k++] = a[i++];
+                    j++;
+                }
+            }
+
+            merged.resize(k);
+            entries = merged;
+        }
+
+        _FORCE_INLINE_ int64_t size() const { return entries.size(); }
+        _FORCE_INLINE_ const Entry* ptr() const { return entries.ptr(); }
+        _FORCE_INLINE_ Entry* ptrw() { return entries.ptrw(); }
+        _FORCE_INLINE_ void clear() { entries.clear(); }
+    };
+
+    struct PropertySetGet {
+        StringName setter;
+        StringName getter;
+        /** Resolved by freeze(). */
+        MethodBind* _setptr = nullptr;
+        MethodBind* _getptr = nullptr;
+    };
+
+    struct SignalInfo {
+        Vector<StringName> arguments;
+    };
+
+    struct ClassInfo {
+        StringName name;
+        StringName inherits;
+        ClassInfo* inherits_ptr = nullptr;
+        Object* (*creation_func)() = nullptr;
+
+        /** Own members while registering; own and inherited ones once frozen. */
+        NameTable<MethodBind*> method_map;
+        NameTable<PropertySetGet> property_map;
+        NameTable<SignalInfo> signal_map;
+
+        bool frozen = false;
+    };
+
+    /** Resolution cache for one call site.
+     *  Holds references to the names it was filled with, so that their data
+     *  can't be freed and its address reused by another name while cached,
+     *  and the generation of ClassDB, so that binds freed by cleanup() are
+     *  never returned.
+     *  Not synchronized: don't share an instance between threads.
+     */
+    struct MethodCache {
+        StringName class_name;
+        StringName method_name;
+        uint64_t generation = 0;
+        MethodBind* method = nullptr;
+    };
+
+private:
+    static NameTable<ClassInfo*> classes;
+    static bool frozen;
+    /** Bumped by cleanup(), invalidating every MethodCache. Never 0. */
+    static uint64_t generation;
+
+    template <typename T>
+    static Object* creator() {
+        return memnew(T);
+    }
+
+    static void _freeze_class(ClassInfo* p_class);
+    static MethodBind* _update_method_cache(MethodCache& r_cache, const StringName& p_class, const StringName& p_method);
+
+public:
+    template <typename T>
+    static void _add_class() {
+        _add_class2(T::get_class_static(), T::get_parent_class_static());
+    }
+
+    static void _add_class2(const StringName& p_class, const StringName& p_inherits);
+
+    template <typename T>
+    static void register_class() {
+        T::initialize_class();
+        ClassInfo** t = classes.lookup(T::get_class_static());
+        ERROR_FAIL_NULL(t);
+        (*t)->creation_func = &creator<T>;
+    }
+
+    template <typename T>
+    static void register_abstract_class() {
+        T::initialize_class();
+    }
+
+    /** Takes ownership of p_method. */
+    static void bind_method_custom(const StringName& p_class, MethodBind* p_method);
+
+    /** Binds a member function of the class being registered, e.g.
+     *  `ClassDB::bind_method(SNAME("get_value"), &MyClass::get_value);`. */
+    template <typename M>
+    static void bind_method(const StringName& p_name, M p_method) {
+        MethodBind* bind = create_method_bind(p_method);
+        bind->set_name(p_name);
+        StringName instance_class = bind->get_instance_class();
+        bind_method_custom(instance_class, bind);
+    }
+    static void add_property(const StringName& p_class, const StringName& p_name, const StringName& p_setter, const StringName& p_getter);
+    static void add_signal(const StringName& p_class, const StringName& p_signal, const Vector<StringName>& p_arguments = Vector<StringName>());
+
+    /** Ends registration. Everything after this point is read-only. */
+    static void freeze();
+    static bool is_frozen() { return frozen; }
+
+    static bool class_exists(const StringName& p_class);
+    static StringName get_parent_class(const StringName& p_class);
+    static bool is_parent_class(const StringName& p_class, const StringName& p_inherits);
+    static bool can_instantiate(const StringName& p_class);
+    static Object* instantiate(const StringName& p_class);
+
+    static MethodBind* get_method(const StringName& p_class, const StringName& p_method);
+    static const PropertySetGet* get_property(const StringName& p_class, const StringName& p_property);
+    static const SignalInfo* get_signal(const StringName& p_class, const StringName& p_signal);
+    static bool has_method(const StringName& p_class, const StringName& p_method) { return get_method(p_class, p_method) != nullptr; }
+    static bool has_signal(const StringName& p_class, const StringName& p_signal) { return get_signal(p_class, p_signal) != nullptr; }
+
+    /** Cached get_method(). A hit costs three compares. */
+    static _FORCE_INLINE_ MethodBind* get_method_cached(MethodCache& r_cache, const StringName& p_class, const StringName& p_method) {
+        if (likely(r_cache.generation == generation && r_cache.class_name == p_class && r_cache.method_name == p_method)) {
+            return r_cache.method;
+        }
+        return _update_method_cache(r_cache, p_class, p_method);
+    }
+
+    static void cleanup();
+};
+
 #endif
@@ -0,0 +1,139 @@
+#ifndef __METHOD_BIND_HPP__
+#define __METHOD_BIND_HPP__
+
+#include "../os/memory.hpp"
+#include "../string/string_name.hpp"
+#include "../typedefs.hpp"
+#include "../variant/binder_common.hpp"
+
+#include <type_traits>
+
+class Object;
+class Variant;
+
+/** Bound engine method, registered in ClassDB.
+ *
+ *  A bind exposes two entry points:
+ *  - call(): dynamic path, arguments and return value are Variants and the
+ *    argument count is checked.
+ *  - ptrcall(): typed path for callers that know the signature at compile
+ *    time. Arguments are pointers to values of the exact parameter types and
+ *    the return value is written to storage of the exact return type, see
+ *    PtrToArg. Nothing is boxed nor checked.
+ */
+class MethodBind {
+    StringName name;
+    StringName instance_class;
+    int argument_count = 0;
+    bool _const = false;
+    bool _returns = false;
+
+protected:
+    _FORCE_INLINE_ void set_argument_count(int p_count) { argument_count = p_count; }
+    _FORCE_INLINE_ void set_const(bool p_const) { _const = p_const; }
+    _FORCE_INLINE_ void set_returns(bool p_returns) { _returns = p_returns; }
+
+public:
+    _FORCE_INLINE_ const StringName& get_name() const { return name; }
+    _FORCE_INLINE_ void set_name(const StringName& p_name) { name = p_name; }
+
+    _FORCE_INLINE_ const StringName& get_instance_class() const { return instance_class; }
+    _FORCE_INLINE_ void set_instance_class(const StringName& p_class) { instance_class = p_class; }
+
+    _FORCE_INLINE_ int get_argument_count() const { return argument_count; }
+    _FORCE_INLINE_ bool is_const() const { return _const; }
+    _FORCE_INLINE_ bool has_return() const { return _returns; }
+
+    virtual void call(Object* p_object, const Variant** p_args, int p_argcount, Variant& r_ret, Callable::CallError& r_error) const = 0;
+    virtual void ptrcall(Object* p_object, const void** p_args, void* r_ret) const = 0;
+
+    MethodBind() {}
+    virtual ~MethodBind() {}
+};
+
+/** Bind for `R (T::*)(P...)` and `R (T::*)(P...) const`.
+ *
+ *  The object is downcast with static_cast: ClassDB only hands a bind objects
+ *  of the class it was registered on, so no dynamic check is needed.
+ */
+template <typename T, typename R, bool Const, typename... P>
+class MethodBindT : public MethodBind {
+    typedef std::conditional_t<Const, R (T::*)(P...) const, R (T::*)(P...)> MethodPtr;
+    typedef BuildIndexSequence<sizeof...(P)> Indices;
+
+    MethodPtr method;
+
+public:
+    virtual void call(Object* p_object, const Variant** p_args, int p_argcount, Variant& r_ret, Callable::CallError& r_error) const override {
+        if (unlikely(!p_object)) {
+            r_error.error = Callable::CallError::CALL_ERROR_INSTANCE_IS_NULL;
+            return;
+        }
+
+        if (!call_check_argument_count(p_argcount, sizeof...(P), r_error)) {
+            return;
+        }
+
+        T* instance = static_cast<T*>(p_object);
+        if constexpr (std::is_void_v<R>) {
+            if constexpr (Const) {
+                call_with_variant_argsc_helper(instance, method, p_args, Indices{});
+            } else {
+                call_with_variant_args_helper(instance, method, p_args, Indices{});
+            }
+        } else {
+            if constexpr (Const) {
+                call_with_variant_args_retc_helper(instance, method, p_args, r_ret, Indices{});
+            } else {
+                call_with_variant_args_ret_helper(instance, method, p_args, r_ret, Indices{});
+            }
+        }
+
+        r_error.error = Callable::CallError::CALL_OK;
+    }
+
+    virtual void ptrcall(Object* p_object, const void** p_args, void* r_ret) const override {
+        T* instance = static_cast<T*>(p_object);
+        if constexpr (std::is_void_v<R>) {
+            if constexpr (Const) {
+                call_with_ptr_argsc_helper(instance, method, p_args, Indices{});
+            } else {
+                call_with_ptr_args_helper(instance, method, p_args, Indices{});
+            }
+        } else {
+            if constexpr (Const) {
+                call_with_ptr_args_retc_helper(instance, method, p_args, r_ret, Indices{});
+            } else {
+                call_with_ptr_args_ret_helper(instance, method, p_args, r_ret, Indices{});
+            }
+        }
+    }
+
+    /** Direct typed call, for C++ callers holding the concrete bind type. */
+    _FORCE_INLINE_ R call_typed(T* p_instance, P... p_args) const {
+        return (p_instance->*method)(p_args...);
+    }
+
+    MethodBindT(MethodPtr p_method) :
+            method(p_method) {
+        set_argument_count(sizeof...(P));
+        set_const(Const);
+        set_returns(!std::is_void_v<R>);
+    }
+};
+
+template <typename T, typename R, typename... P>
+MethodBind* create_method_bind(R (T::*p_method)(P...)) {
+    MethodBind* bind = memnew((MethodBindT<T, R, false, P...>)(p_method));
+    bind->set_instance_class(T::get_class_static());
+    return bind;
+}
+
+template <typename T, typename R, typename... P>
+MethodBind* create_method_bind(R (T::*p_method)(P...) const) {
+    MethodBind* bind = memnew((MethodBindT<T, R, true, P...>)(p_method));
+    bind->set_instance_class(T::get_class_static());
+    return bind;
+}
+
+#endif
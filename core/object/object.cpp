@@ -0,0 +1,156 @@
+#include "./object.hpp"
+
+#include "./class_db.hpp"
+
+void Object::initialize_class() {
+    static bool initialized = false;
+    if (initialized) {
+        return;
+    }
+    ClassDB::_add_class<Object>();
+    _bind_methods();
+    initialized = true;
+}
+
+Object::Object(bool p_reference) {
+    _is_ref_counted = p_reference;
+    _instance_id = ObjectDB::add_instance(this);
+}
+
+Object::Object() :
+        Object(false) {}
+
+Object::~Object() {
+    ObjectDB::remove_instance(_instance_id);
+    _instance_id = ObjectID();
+}
+
+/** Constant-initialized to zero, so objects made by static initializers
+ *  of other files, whichever run first, are registered and kept. */
+SafeNumeric<ObjectDB::ObjectSlot*> ObjectDB::blocks[OBJECTDB_BLOCK_COUNT];
+SafeNumericPadded<uint64_t> ObjectDB::free_list_head;
+SafeNumericPadded<uint32_t> ObjectDB::slot_max;
+SafeNumericPadded<uint32_t> ObjectDB::object_count;
+
+uint32_t ObjectDB::_alloc_slot() {
+    /** Recycle a free slot first. */
+    uint64_t head = free_list_head.get();
+    while ((head & 0xFFFFFFFF) != 0) {
+        const uint32_t slot = uint32_t(head & 0xFFFFFFFF) - 1;
+        const uint64_t new_head = (((head >> 32) + 1) << 32) | _get_slot(slot).next_free.get();
+        if (free_list_head.compare_exchange(head, new_head)) {
+            return slot;
+        }
+    }
+
+    /** None left, take a fresh one. */
+    const uint32_t slot = slot_max.postincrement();
+    CRASH_COND_MSG(slot > OBJECTDB_SLOT_MASK, "Object slot limit reached, too many objects in existence.");
+
+    SafeNumeric<ObjectSlot*>& block = blocks[slot >> OBJECTDB_BLOCK_BITS];
+    if (unlikely(block.get() == nullptr)) {
+        /** First slot of a block. Several threads may get here, only one block is kept. */
+        ObjectSlot* new_block = memnew_arr(ObjectSlot, OBJECTDB_BLOCK_SIZE);
+        ObjectSlot* expected = nullptr;
+        while (!block.compare_exchange(expected, new_block)) {
+            if (expected != nullptr) {
+                memdelete_arr(new_block);
+                break;
+            }
+        }
+    }
+
+    return slot;
+}
+
+void ObjectDB::_free_slot(uint32_t p_slot) {
+    ObjectSlot& s = _get_slot(p_slot);
+
+    uint64_t head = free_list_head.get();
+    uint64_t new_head;
+    do {
+        s.next_free.set(uint32_t(head & 0xFFFFFFFF));
+        new_head = (((head >> 32) + 1) << 32) | (uint64_t(p_slot) + 1);
+    } while (!free_list_head.compare_exchange(head, new_head));
+}
+
+ObjectID ObjectDB::add_instance(Object* p_object) {
+    const uint32_t slot = _alloc_slot();
+    ObjectSlot& s = _get_slot(slot);
+
+    uint64_t validator = (s.generation + 1) & OBJECTDB_VALIDATOR_MASK;
+    if (unlikely(validator == 0)) {
+        /** 0 marks free slots, skip it on wrap around. */
+        validator = 1;
+    }
+    s.generation = validator;
+
+    s.object.set(p_object);
+    /** Publishes the object to lookups. */
+    s.validator.set(validator);
+
+    object_count.increment_relaxed();
+
+    uint64_t id = (validator << OBJECTDB_SLOT_BITS) | slot;
+    if (p_object->is_ref_counted()) {
+        id |= OBJECTDB_REFERENCE_BIT;
+    }
+
+    return ObjectID(id);
+}
+
+void ObjectDB::remove_instance(ObjectID p_instance_id) {
+    const uint64_t id = p_instance_id;
+    const uint64_t validator = (id >> OBJECTDB_SLOT_BITS) & OBJECTDB_VALIDATOR_MASK;
+    const uint32_t slot = uint32_t(id & OBJECTDB_SLOT_MASK);
+
+    ERROR_FAIL_COND(blocks[slot >> OBJECTDB_BLOCK_BITS].get() == nullptr);
+
+    ObjectSlot& s = _get_slot(slot);
+    ERROR_FAIL_COND(s.validator.get() != validator);
+
+    /** Invalidate first, so lookups racing with us fail their validator check. */
+    s.validator.set(0);
+    s.object.set(nullptr);
+
+    object_count.decrement_relaxed();
+
+    _free_slot(slot);
+}
+
+void ObjectDB::debug_objects(DebugFunc p_func) {
+    const uint32_t max = MIN(slot_max.get(), uint32_t(OBJECTDB_SLOT_MASK + 1));
+    for (uint32_t i = 0; i < max; i++) {
+        ObjectSlot* block = blocks[i >> OBJECTDB_BLOCK_BITS].get();
+        if (block == nullptr) {
+            continue;
+        }
+
+        ObjectSlot& s = block[i & OBJECTDB_BLOCK_MASK];
+        if (s.validator.get() != 0) {
+            p_func(s.object.get());
+        }
+    }
+}
+
+int ObjectDB::get_object_count() {
+    return object_count.get_relaxed();
+}
+
+void ObjectDB::cleanup() {
+    if (object_count.get() > 0) {
+        WARNING_PRINT("ObjectDB instances leaked at exit.");
+    }
+
+    for (uint32_t i = 0; i < OBJECTDB_BLOCK_COUNT; i++) {
+        ObjectSlot* block = blocks[i].get();
+        if (block != nullptr) {
+            memdelete_arr(block);
+            blocks[i].set(nullptr);
+        }
+    }
+
+    free_list_head.set(0);
+    slot_max.set(0);
+    object_count.set(0);
+}
@@ -0,0 +1,197 @@
+#ifndef __OBJECT_HPP__
+#define __OBJECT_HPP__
+
+#include "../os/memory.hpp"
+#include "../string/string_name.hpp"
+#include "../templates/safe_refcount.hpp"
+#include "../typedefs.hpp"
+#include "./object_id.hpp"
+
+class ClassDB;
+
+/** Declares an engine class: its name, its parent and its ClassDB registration.
+ *  Classes using it must include class_db.hpp.
+ */
+#define GDCLASS(m_class, m_inherits)                                             \
+private:                                                                         \
+    friend class ::ClassDB;                                                      \
+                                                                                 \
+public:                                                                          \
+    typedef m_class self_type;                                                   \
+    typedef m_inherits super_type;                                               \
+                                                                                 \
+    static const StringName& get_class_static() {                                \
+        static StringName _class_name_static(#m_class, true);                    \
+        return _class_name_static;                                               \
+    }                                                                            \
+    static const StringName& get_parent_class_static() {                         \
+        return m_inherits::get_class_static();                                   \
+    }                                                                            \
+    virtual const StringName& get_class_name() const override {                  \
+        return m_class::get_class_static();                                      \
+    }                                                                            \
+    static void initialize_class() {                                             \
+        static bool initialized = false;                                         \
+        if (initialized) {                                                       \
+            return;                                                              \
+        }                                                                        \
+        m_inherits::initialize_class();                                          \
+        ::ClassDB::_add_class<m_class>();                                        \
+        if (m_class::_get_bind_methods() != m_inherits::_get_bind_methods()) {   \
+            _bind_methods();                                                     \
+        }                                                                        \
+        initialized = true;                                                      \
+    }                                                                            \
+                                                                                 \
+protected:                                                                       \
+    static void (*_get_bind_methods())() {                                       \
+        return &m_class::_bind_methods;                                          \
+    }                                                                            \
+                                                                                 \
+private:
+
+class Object {
+    friend class ObjectDB;
+    friend class ClassDB;
+
+    ObjectID _instance_id;
+    bool _is_ref_counted = false;
+
+protected:
+    explicit Object(bool p_reference);
+
+    static void _bind_methods() {}
+    static void (*_get_bind_methods())() {
+        return &Object::_bind_methods;
+    }
+
+public:
+    typedef Object self_type;
+
+    static const StringName& get_class_static() {
+        static StringName _class_name_static("Object", true);
+        return _class_name_static;
+    }
+    static const StringName& get_parent_class_static() {
+        static StringName _parent_name_static;
+        return _parent_name_static;
+    }
+    virtual const StringName& get_class_name() const {
+        return get_class_static();
+    }
+    static void initialize_class();
+
+    template <typename T>
+    static T* cast_to(Object* p_object) {
+        return p_object ? dynamic_cast<T*>(p_object) : nullptr;
+    }
+
+    template <typename T>
+    static const T* cast_to(const Object* p_object) {
+        return p_object ? dynamic_cast<const T*>(p_object) : nullptr;
+    }
+
+    _FORCE_INLINE_ ObjectID get_instance_id() const { return _instance_id; }
+    _FORCE_INLINE_ bool is_ref_counted() const { return _is_ref_counted; }
+
+    Object();
+    virtual ~Object();
+};
+
+/** Resolves ObjectIDs to live objects.
+ *
+ *  Objects live in a generational slot table. An ObjectID packs the slot index
+ *  in its low bits and the slot generation (validator) above it:
+ *
+ *     63   62                    24 23                 0
+ *    ┌───┬────────────────────────┬────────────────────┐
+ *    │ R │ validator (39 bits)    │ slot (24 bits)     │
+ *    └───┴────────────────────────┴────────────────────┘
+ *    R: set for RefCounted objects (see ObjectID::is_ref_counted()).
+ *
+ *  The table is split in fixed-size blocks that are never moved nor freed
+ *  while the engine runs, so lookups need no lock: one indexed load and a
+ *  validator compare. Slots are taken and recycled through a lock-free free
+ *  list; a recycled slot gets a new validator, so stale IDs resolve to null.
+ */
+class ObjectDB {
+    static constexpr uint32_t OBJECTDB_SLOT_BITS = 24;
+    static constexpr uint32_t OBJECTDB_VALIDATOR_BITS = 39;
+    static constexpr uint64_t OBJECTDB_SLOT_MASK = (uint64_t(1) << OBJECTDB_SLOT_BITS) - 1;
+    static constexpr uint64_t OBJECTDB_VALIDATOR_MASK = (uint64_t(1) << OBJECTDB_VALIDATOR_BITS) - 1;
+    static constexpr uint64_t OBJECTDB_REFERENCE_BIT = uint64_t(1) << (OBJECTDB_SLOT_BITS + OBJECTDB_VALIDATOR_BITS);
+
+    static constexpr uint32_t OBJECTDB_BLOCK_BITS = 12;
+    static constexpr uint32_t OBJECTDB_BLOCK_SIZE = 1 << OBJECTDB_BLOCK_BITS;
+    static constexpr uint32_t OBJECTDB_BLOCK_MASK = OBJECTDB_BLOCK_SIZE - 1;
+    static constexpr uint32_t OBJECTDB_BLOCK_COUNT = 1 << (OBJECTDB_SLOT_BITS - OBJECTDB_BLOCK_BITS);
+
+    static_assert(OBJECTDB_SLOT_BITS + OBJECTDB_VALIDATOR_BITS == 63, "One bit is reserved for the reference flag.");
+
+    struct ObjectSlot {
+        /** 0 while the slot is free. Published last, so a matching validator implies a valid object. */
+        SafeNumeric<uint64_t> validator;
+        SafeNumeric<Object*> object;
+        /** Next free slot + 1, only meaningful while in the free list. */
+        SafeNumeric<uint32_t> next_free;
+        /** Last validator handed out, only touched by the thread owning the slot. */
+        uint64_t generation = 0;
+    };
+
+    static SafeNumeric<ObjectSlot*> blocks[OBJECTDB_BLOCK_COUNT];
+    /** Free list head: ABA tag in the high 32 bits, slot + 1 in the low ones (0 if empty). */
+    static SafeNumericPadded<uint64_t> free_list_head;
+    static SafeNumericPadded<uint32_t> slot_max;
+    static SafeNumericPadded<uint32_t> object_count;
+
+    friend class Object;
+
+    static _FORCE_INLINE_ ObjectSlot& _get_slot(uint32_t p_slot) {
+        return blocks[p_slot >> OBJECTDB_BLOCK_BITS].get()[p_slot & OBJECTDB_BLOCK_MASK];
+    }
+
+    static uint32_t _alloc_slot();
+    static void _free_slot(uint32_t p_slot);
+
+    static ObjectID add_instance(Object* p_object);
+    static void remove_instance(ObjectID p_instance_id);
+
+public:
+    typedef void (*DebugFunc)(Object* p_obj);
+
+    static _ALWAYS_INLINE_ Object* get_instance(ObjectID p_instance_id) {
+        const uint64_t id = p_instance_id;
+        const uint64_t validator = (id >> OBJECTDB_SLOT_BITS) & OBJECTDB_VALIDATOR_MASK;
+        const uint32_t slot = uint32_t(id & OBJECTDB_SLOT_MASK);
+
+        ObjectSlot* block = blocks[slot >> OBJECTDB_BLOCK_BITS].get();
+        if (unlikely(block == nullptr || validator == 0)) {
+            return nullptr;
+        }
+
+        ObjectSlot& s = block[slot & OBJECTDB_BLOCK_MASK];
+        if (unlikely(s.validator.get() != validator)) {
+            return nullptr;
+        }
+
+        Object* object = s.object.get();
+
+        /** The slot may have been recycled between both reads. */
+        if (unlikely(s.validator.get() != validator)) {
+            return nullptr;
+        }
+
+        return object;
+    }
+
+    template <typename T>
+    static T* get_instance(ObjectID p_instance_id) {
+        return Object::cast_to<T>(get_instance(p_instance_id));
+    }
+
+    static void debug_objects(DebugFunc p_func);
+    static int get_object_count();
+    static void cleanup();
+};
+
+#endif
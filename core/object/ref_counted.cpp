@@ -0,0 +1,27 @@
+#include "./ref_counted.hpp"
+
+bool RefCounted::init_ref() {
+    if (!refcount_init_claimed.is_set() && !refcount_init_claimed.test_and_set()) {
+        /** The count the object was born with becomes ours. */
+        return true;
+    }
+
+    return reference();
+}
+
+bool RefCounted::reference() {
+    return refcount.ref();
+}
+
+bool RefCounted::unreference() {
+    return refcount.unref();
+}
+
+int32_t RefCounted::get_reference_count() const {
+    return refcount.get();
+}
+
+RefCounted::RefCounted() :
+        Object(true) {
+    refcount.init();
+}
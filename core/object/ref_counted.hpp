@@ -1,6 +1,205 @@
 #ifndef __REF_COUNTED_HPP__
 #define __REF_COUNTED_HPP__
 
+#include "../templates/safe_refcount.hpp"
+#include "./class_db.hpp"
+#include "./object.hpp"
 
+#include <utility>
+
+class RefCounted : public Object {
+    GDCLASS(RefCounted, Object);
+
+    SafeRefCount refcount;
+    /** Set once a Ref has claimed the reference the object is born with. */
+    SafeFlag refcount_init_claimed;
+
+public:
+    _FORCE_INLINE_ bool is_referenced() const { return refcount_init_claimed.is_set(); }
+    /** Takes the first reference. It claims the initial count instead of
+     *  adding and removing one, so a freshly created object costs one atomic.
+     */
+    bool init_ref();
+    /** returns false if refcount is at zero and didn't get increased */
+    bool reference();
+    /** true if the object must be deleted */
+    bool unreference();
+    int32_t get_reference_count() const;
+
+    RefCounted();
+    ~RefCounted() {}
+};
+
+/** Intrusive strong reference to a RefCounted.
+ *
+ *  Passing convention, so hot paths don't pay for atomic increments:
+ *  - Take `const Ref<T> &` when the callee only uses the object.
+ *    Borrowing never touches the counter.
+ *  - Take `Ref<T>` by value and `std::move()` into it when the callee keeps the object.
+ *    Moves transfer ownership without touching the counter.
+ *  - Copy only when a second owner is really needed.
+ */
+template <typename T>
+class Ref {
+    template <typename T_Other>
+    friend class Ref;
+
+    T* reference = nullptr;
+
+    _FORCE_INLINE_ void ref(const Ref& p_from) {
+        ref_pointer<false>(p_from.reference);
+    }
+
+    template <bool Init>
+    _FORCE_INLINE_ void ref_pointer(T* p_refcounted) {
+        if (p_refcounted == reference) {
+            return;
+        }
+
+        /** This will go out of scope and get unref'd. */
+        Ref cleanup_ref;
+        cleanup_ref.reference = reference;
+        reference = p_refcounted;
+        if (reference) {
+            if constexpr (Init) {
+                if (!reference->init_ref()) {
+                    reference = nullptr;
+                }
+            } else {
+                if (!reference->reference()) {
+                    reference = nullptr;
+                }
+            }
+        }
+    }
+
+    /** Takes over p_refcounted, which already carries a reference for us. */
+    _FORCE_INLINE_ void adopt_pointer(T* p_refcounted) {
+        if (p_refcounted == reference) {
+            /** Both hold a reference to the same object, drop the extra one. */
+            if (p_refcounted) {
+                p_refcounted->unreference();
+            }
+            return;
+        }
+
+        unref();
+        reference = p_refcounted;
+    }
+
+public:
+    _FORCE_INLINE_ bool operator==(const T* p_ptr) const {
+        return reference == p_ptr;
+    }
+
+    _FORCE_INLINE_ bool operator!=(const T* p_ptr) const {
+        return reference != p_ptr;
+    }
+
+    _FORCE_INLINE_ bool operator<(const Ref<T>& p_r) const {
+        return reference < p_r.reference;
+    }
+
+    _FORCE_INLINE_ bool operator==(const Ref<T>& p_r) const {
+        return reference == p_r.reference;
+    }
+
+    _FORCE_INLINE_ bool operator!=(const Ref<T>& p_r) const {
+        return reference != p_r.reference;
+    }
+
+    _FORCE_INLINE_ T* operator*() const {
+        return reference;
+    }
+
+    _FORCE_INLINE_ T* operator->() const {
+        return reference;
+    }
+
+    _FORCE_INLINE_ T* ptr() const {
+        return reference;
+    }
+
+    void operator=(const Ref& p_from) {
+        ref(p_from);
+    }
+
+    void operator=(Ref&& p_from) {
+        if (reference == p_from.reference) {
+            return;
+        }
+
+        unref();
+        reference = p_from.reference;
+        p_from.reference = nullptr;
+    }
+
+    template <typename T_Other>
+    void operator=(const Ref<T_Other>& p_from) {
+        ref_pointer<false>(Object::cast_to<T>(p_from.ptr()));
+    }
+
+    template <typename T_Other>
+    void operator=(Ref<T_Other>&& p_from) {
+        T* r = Object::cast_to<T>(p_from.ptr());
+        if (!r) {
+            unref();
+            return;
+        }
+
+        p_from.reference = nullptr;
+        adopt_pointer(r);
+    }
+
+    void operator=(T* p_from) {
+        ref_pointer<true>(p_from);
+    }
+
+    Ref(const Ref& p_from) {
+        this->operator=(p_from);
+    }
+
+    Ref(Ref&& p_from) {
+        reference = p_from.reference;
+        p_from.reference = nullptr;
+    }
+
+    template <typename T_Other>
+    Ref(const Ref<T_Other>& p_from) {
+        this->operator=(p_from);
+    }
+
+    template <typename T_Other>
+    Ref(Ref<T_Other>&& p_from) {
+        this->operator=(std::move(p_from));
+    }
+
+    Ref(T* p_reference) {
+        if (p_reference) {
+            ref_pointer<true>(p_reference);
+        }
+    }
+
+    inline bool is_valid() const { return reference != nullptr; }
+    inline bool is_null() const { return reference == nullptr; }
+
+    void unref() {
+        if (reference && reference->unreference()) {
+            memdelete(reference);
+        }
+        reference = nullptr;
+    }
+
+    template <typename... VarArgs>
+    void instantiate(VarArgs&&... p_params) {
+        ref_pointer<true>(memnew(T(std::forward<VarArgs>(p_params)...)));
+    }
+
+    Ref() {}
+
+    ~Ref() {
+        unref();
+    }
+};
 
 #endif
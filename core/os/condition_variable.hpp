@@ -0,0 +1,29 @@
+#ifndef __CONDITION_VARIABLE_HPP__
+#define __CONDITION_VARIABLE_HPP__
+
+#include "../typedefs.hpp"
+#include "./mutex.hpp"
+
+#include <condition_variable>
+
+/** Thin wrapper over std::condition_variable, waited on through the
+ *  MutexLock of a BinaryMutex. Like the standard one, wait() can return
+ *  spuriously: check the condition in a loop. */
+class ConditionVariable {
+    mutable std::condition_variable condition;
+
+public:
+    _ALWAYS_INLINE_ void wait(const MutexLock<BinaryMutex>& p_lock) const {
+        condition.wait(p_lock.lock);
+    }
+
+    _ALWAYS_INLINE_ void notify_one() const {
+        condition.notify_one();
+    }
+
+    _ALWAYS_INLINE_ void notify_all() const {
+        condition.notify_all();
+    }
+};
+
+#endif
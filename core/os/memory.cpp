@@ -0,0 +1,202 @@
+#include "./memory.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+/** Allocation statistics don't order any other memory, so they are updated with relaxed atomics. */
+#ifdef DEBUG_ENABLED
+SafeNumeric<uint64_t> Memory::m_mem_usage;
+SafeNumeric<uint64_t> Memory::m_max_usage;
+#endif
+
+SafeNumeric<uint64_t> Memory::m_alloc_count;
+
+void* operator new(size_t p_size, const char* p_description) {
+    return Memory::alloc_static(p_size, false);
+}
+
+void* operator new(size_t p_size, void* (*p_allocfunc)(size_t p_size)) {
+    return p_allocfunc(p_size);
+}
+
+void* operator new(size_t p_size, void* p_pointer, size_t check, const char* p_description) {
+    return p_pointer;
+}
+
+#ifdef _MSC_VER
+void operator delete(void* p_mem, const char* p_description) {
+    CRASH_NOW_MSG("Call to placement delete should not happen.");
+}
+
+void operator delete(void* p_mem, void* (*p_allocfunc)(size_t p_size)) {
+    CRASH_NOW_MSG("Call to placement delete should not happen.");
+}
+
+void operator delete(void* p_mem, void* p_pointer, size_t check, const char* p_description) {
+    CRASH_NOW_MSG("Call to placement delete should not happen.");
+}
+#endif
+
+void* Memory::alloc_aligned_static(size_t p_bytes, size_t p_alignment) {
+    DEV_ASSERT(is_power_of_2(p_alignment));
+
+    void* p1 = nullptr;
+    void* p2 = nullptr;
+    if ((p1 = (void*)malloc(p_bytes + p_alignment - 1 + sizeof(uint32_t))) == nullptr) {
+        return nullptr;
+    }
+
+    p2 = (void*)(((uintptr_t)p1 + sizeof(uint32_t) + p_alignment - 1) & ~((p_alignment)-1));
+    *((uint32_t*)p2 - 1) = (uint32_t)((uintptr_t)p2 - (uintptr_t)p1);
+    return p2;
+}
+
+void* Memory::realloc_aligned_static(void* p_memory, size_t p_bytes,
+                                     size_t p_prev_bytes, size_t p_alignment) {
+    if (p_memory == nullptr) {
+        return alloc_aligned_static(p_bytes, p_alignment);
+    }
+
+    void* ret = alloc_aligned_static(p_bytes, p_alignment);
+    if (ret) {
+        memcpy(ret, p_memory, p_prev_bytes);
+    }
+    free_aligned_static(p_memory);
+    return ret;
+}
+
+void Memory::free_aligned_static(void* p_memory) {
+    if (unlikely(p_memory == nullptr)) {
+        return;
+    }
+
+    uint32_t offset = *((uint32_t*)p_memory - 1);
+    void* p = (void*)((uint8_t*)p_memory - offset);
+    free(p);
+}
+
+void* Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
+#ifdef DEBUG_ENABLED
+    bool prepad = true;
+#else
+    bool prepad = p_pad_align;
+#endif
+
+    void* mem = malloc(p_bytes + (prepad ? DATA_OFFSET : 0));
+
+    ERROR_FAIL_NULL_V(mem, nullptr);
+
+    m_alloc_count.increment_relaxed();
+
+    if (prepad) {
+        uint8_t* s8 = (uint8_t*)mem;
+
+        uint64_t* s = (uint64_t*)(s8 + SIZE_OFFSET);
+        *s = p_bytes;
+
+#ifdef DEBUG_ENABLED
+        uint64_t new_mem_usage = m_mem_usage.add_relaxed(p_bytes);
+        m_max_usage.exchange_if_greater_relaxed(new_mem_usage);
+#endif
+        return s8 + DATA_OFFSET;
+    } else {
+        return mem;
+    }
+}
+
+void* Memory::realloc_static(void* p_memory, size_t p_bytes, bool p_pad_align) {
+    if (p_memory == nullptr) {
+        return alloc_static(p_bytes, p_pad_align);
+    }
+
+    uint8_t* mem = (uint8_t*)p_memory;
+
+#ifdef DEBUG_ENABLED
+    bool prepad = true;
+#else
+    bool prepad = p_pad_align;
+#endif
+
+    if (prepad) {
+        mem -= DATA_OFFSET;
+        uint64_t* s = (uint64_t*)(mem + SIZE_OFFSET);
+
+#ifdef DEBUG_ENABLED
+        if (p_bytes > *s) {
+            uint64_t new_mem_usage = m_mem_usage.add_relaxed(p_bytes - *s);
+            m_max_usage.exchange_if_greater_relaxed(new_mem_usage);
+        } else {
+            m_mem_usage.sub_relaxed(*s - p_bytes);
+        }
+#endif
+
+        if (p_bytes == 0) {
+            free(mem);
+            return nullptr;
+        } else {
+            *s = p_bytes;
+
+            mem = (uint8_t*)realloc(mem, p_bytes + DATA_OFFSET);
+            ERROR_FAIL_NULL_V(mem, nullptr);
+
+            s = (uint64_t*)(mem + SIZE_OFFSET);
+
+            *s = p_bytes;
+
+            return mem + DATA_OFFSET;
+        }
+    } else {
+        mem = (uint8_t*)realloc(mem, p_bytes);
+
+        ERROR_FAIL_COND_V(mem == nullptr && p_bytes > 0, nullptr);
+
+        return mem;
+    }
+}
+
+void Memory::free_static(void* p_ptr, bool p_pad_align) {
+    ERROR_FAIL_NULL(p_ptr);
+
+    uint8_t* mem = (uint8_t*)p_ptr;
+
+#ifdef DEBUG_ENABLED
+    bool prepad = true;
+#else
+    bool prepad = p_pad_align;
+#endif
+
+    m_alloc_count.decrement_relaxed();
+
+    if (prepad) {
+        mem -= DATA_OFFSET;
+
+#ifdef DEBUG_ENABLED
+        const uint64_t s = *((uint64_t*)(mem + SIZE_OFFSET));
+        m_mem_usage.sub_relaxed(s);
+#endif
+
+        free(mem);
+    } else {
+        free(mem);
+    }
+}
+
+uint64_t Memory::get_mem_available() {
+    return -1; /** 0xFFFF... */
+}
+
+uint64_t Memory::get_mem_usage() {
+#ifdef DEBUG_ENABLED
+    return m_mem_usage.get_relaxed();
+#else
+    return 0;
+#endif
+}
+
+uint64_t Memory::get_mem_max_usage() {
+#ifdef DEBUG_ENABLED
+    return m_max_usage.get_relaxed();
+#else
+    return 0;
+#endif
+}
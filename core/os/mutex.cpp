@@ -0,0 +1,11 @@
+#include "./mutex.hpp"
+
+static Mutex _global_mutex;
+
+void _global_lock() {
+    _global_mutex.lock();
+}
+
+void _global_unlock() {
+    _global_mutex.unlock();
+}
@@ -0,0 +1,62 @@
+#ifndef __MUTEX_HPP__
+#define __MUTEX_HPP__
+
+#include "../typedefs.hpp"
+
+#include <mutex>
+
+/** Thin wrappers over the standard mutexes, so the engine can swap the
+ *  implementation per platform without touching the call sites.
+ *
+ *  - Mutex is recursive; use it when code may re-enter while holding it.
+ *  - BinaryMutex is not recursive and is cheaper; prefer it for short,
+ *    non-reentrant critical sections.
+ */
+template <typename StdMutexT>
+class MutexImpl {
+    friend class ConditionVariable;
+
+    template <typename T>
+    friend class MutexLock;
+
+    using StdMutexType = StdMutexT;
+
+    mutable StdMutexT mutex;
+
+public:
+    _ALWAYS_INLINE_ void lock() const {
+        mutex.lock();
+    }
+
+    _ALWAYS_INLINE_ void unlock() const {
+        mutex.unlock();
+    }
+
+    _ALWAYS_INLINE_ bool try_lock() const {
+        return mutex.try_lock();
+    }
+};
+
+using Mutex = MutexImpl<std::recursive_mutex>;
+using BinaryMutex = MutexImpl<std::mutex>;
+
+template <typename MutexT>
+class MutexLock {
+    friend class ConditionVariable;
+
+    mutable std::unique_lock<typename MutexT::StdMutexType> lock;
+
+public:
+    _ALWAYS_INLINE_ explicit MutexLock(const MutexT &p_mutex) :
+            lock(p_mutex.mutex) {}
+
+    _ALWAYS_INLINE_ void temp_relock() const {
+        lock.lock();
+    }
+
+    _ALWAYS_INLINE_ void temp_unlock() const {
+        lock.unlock();
+    }
+};
+
+#endif
@@ -0,0 +1,115 @@
+#include "./worker_pool.hpp"
+
+#include "./condition_variable.hpp"
+#include "./memory.hpp"
+#include "./mutex.hpp"
+
+#include <thread>
+
+/** The threads and the loops they can join, oldest first. */
+struct WorkerPoolState {
+    BinaryMutex mutex;
+    /** Signaled when a loop is added, or on exit. */
+    ConditionVariable work_condition;
+    /** Signaled when the last pool thread leaves a loop. */
+    ConditionVariable done_condition;
+    WorkerPool::Group* groups = nullptr;
+    bool exiting = false;
+
+    std::thread* threads = nullptr;
+    int thread_count = 0;
+
+    /** The oldest loop with indices left and room for one more thread. */
+    WorkerPool::Group* find_group() const {
+        for (WorkerPool::Group* g = groups; g; g = g->next_group) {
+            if (g->joined < g->max_workers && g->next.get() < g->count) {
+                return g;
+            }
+        }
+        return nullptr;
+    }
+
+    void run() {
+        MutexLock lock(mutex);
+        while (!exiting) {
+            WorkerPool::Group* group = find_group();
+            if (!group) {
+                work_condition.wait(lock);
+                continue;
+            }
+
+            const int worker = group->joined++;
+            group->running++;
+            lock.temp_unlock();
+            group->work(worker);
+            lock.temp_relock();
+            if (--group->running == 0) {
+                done_condition.notify_all();
+            }
+        }
+    }
+
+    WorkerPoolState() {
+        const int cores = int(std::thread::hardware_concurrency());
+        thread_count = MAX(cores, 1) - 1;
+        if (thread_count > 0) {
+            threads = memnew_arr(std::thread, thread_count);
+            for (int i = 0; i < thread_count; i++) {
+                threads[i] = std::thread([this]() { run(); });
+            }
+        }
+    }
+
+    ~WorkerPoolState() {
+        {
+            MutexLock lock(mutex);
+            exiting = true;
+            work_condition.notify_all();
+        }
+        for (int i = 0; i < thread_count; i++) {
+            threads[i].join();
+        }
+        if (threads) {
+            memdelete_arr(threads);
+        }
+    }
+};
+
+/** Started on first use rather than at static initialization, so programs
+ *  that never run a parallel loop don't pay for the threads. */
+static WorkerPoolState& _get_state() {
+    static WorkerPoolState state;
+    return state;
+}
+
+int WorkerPool::get_thread_count() {
+    return _get_state().thread_count + 1;
+}
+
+void WorkerPool::_run(Group& p_group) {
+    WorkerPoolState& state = _get_state();
+
+    {
+        MutexLock lock(state.mutex);
+        p_group.joined = 1;
+        Group** tail = &state.groups;
+        while (*tail) {
+            tail = &(*tail)->next_group;
+        }
+        *tail = &p_group;
+        state.work_condition.notify_all();
+    }
+
+    p_group.work(0);
+
+    /** No thread can join once the group is unlinked; wait for those in it. */
+    MutexLock lock(state.mutex);
+    Group** link = &state.groups;
+    while (*link != &p_group) {
+        link = &(*link)->next_group;
+    }
+    *link = p_group.next_group;
+    while (p_group.running > 0) {
+        state.done_condition.wait(lock);
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef __WORKER_POOL_HPP__
+#define __WORKER_POOL_HPP__
+
+#include "../templates/safe_refcount.hpp"
+#include "../typedefs.hpp"
+
+#include <stdint.h>
+
+/** Threads shared by the engine's parallel loops (sorting, Array's map() and
+ *  friends, block compression), started on first use and kept until exit, so
+ *  a parallel loop costs a wake-up instead of creating and joining threads.
+ *
+ *  The calling thread always takes part in its own loop, so a loop finishes
+ *  even if every pool thread is busy, and loops can nest: a job may start
+ *  another loop, which its thread then works on.
+ */
+class WorkerPool {
+    friend struct WorkerPoolState;
+
+    struct Group {
+        void (*call)(const void* p_func, int64_t p_index, int p_worker) = nullptr;
+        const void* func = nullptr;
+        int64_t count = 0;
+        int max_workers = 0;
+        SafeNumeric<int64_t> next;
+        /** Guarded by the pool mutex. */
+        int joined = 0;
+        int running = 0;
+        Group* next_group = nullptr;
+
+        void work(int p_worker) {
+            for (int64_t i = next.postincrement(); i < count; i = next.postincrement()) {
+                call(func, i, p_worker);
+            }
+        }
+    };
+
+    template <typename F>
+    static void _call(const void* p_func, int64_t p_index, int p_worker) {
+        (*static_cast<const F*>(p_func))(p_index, p_worker);
+    }
+
+    static void _run(Group& p_group);
+
+public:
+    /** Pool threads plus the calling one: the most threads a loop runs on. */
+    static int get_thread_count();
+
+    /** Calls p_func(index, worker) for every index in [0, p_count), on up to
+     *  p_max_threads threads (get_thread_count() when 0), the calling one
+     *  included, and returns once all calls returned. Threads take the next
+     *  index when done with one, so uneven jobs balance out. worker is below
+     *  the thread count the loop runs on and tells apart threads running at
+     *  the same time, for per-thread scratch data; the calling thread is 0. */
+    template <typename F>
+    static void parallel_for(int64_t p_count, int p_max_threads, const F& p_func) {
+        int64_t threads = get_thread_count();
+        if (p_max_threads > 0) {
+            threads = MIN(threads, int64_t(p_max_threads));
+        }
+        threads = MIN(threads, p_count);
+        if (threads < 2) {
+            for (int64_t i = 0; i < p_count; i++) {
+                p_func(i, 0);
+            }
+            return;
+        }
+
+        Group group;
+        group.call = &_call<F>;
+        group.func = &p_func;
+        group.count = p_count;
+        group.max_workers = int(threads);
+        _run(group);
+    }
+};
+
+#endif
@@ -0,0 +1,265 @@
+#include "./char_utils.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CHAR_UTILS_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define CHAR_UTILS_NEON
+#endif
+
+#if defined(CHAR_UTILS_SSE2) || defined(CHAR_UTILS_NEON)
+#define CHAR_UTILS_SIMD
+
+/** Characters classified per block. */
+#define CHAR_UTILS_BLOCK 16
+
+#if defined(CHAR_UTILS_SSE2)
+typedef __m128i Block;
+/** Bits per character in a block mask: SSE2 has movemask, NEON gets a nibble
+ *  per byte out of a shifting narrow. */
+#define CHAR_UTILS_LANE_BITS 1
+#define CHAR_UTILS_FULL_MASK uint64_t(0xFFFF)
+#else
+typedef uint8x16_t Block;
+#define CHAR_UTILS_LANE_BITS 4
+#define CHAR_UTILS_FULL_MASK ~uint64_t(0)
+#endif
+
+static _FORCE_INLINE_ uint32_t _ctz64(uint64_t p_mask) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(p_mask);
+#else
+    uint32_t n = 0;
+    while (!(p_mask & 1)) {
+        p_mask >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+static _FORCE_INLINE_ Block _load_utf8(const uint8_t* p_src) {
+#if defined(CHAR_UTILS_SSE2)
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_src));
+#else
+    return vld1q_u8(p_src);
+#endif
+}
+
+/** Narrows 16 characters to bytes, saturating, so everything past ASCII
+ *  stays out of the ASCII classes: the scans check those characters one at a
+ *  time anyway. */
+static _FORCE_INLINE_ Block _load_utf32(const char32_t* p_src) {
+#if defined(CHAR_UTILS_SSE2)
+    const __m128i* src = reinterpret_cast<const __m128i*>(p_src);
+    // Signed packs: characters past 0x7FFF come out as 0x7FFF or 0x8000, then
+    // as 0xFF or 0 bytes.
+    const __m128i low = _mm_packs_epi32(_mm_loadu_si128(src), _mm_loadu_si128(src + 1));
+    const __m128i high = _mm_packs_epi32(_mm_loadu_si128(src + 2), _mm_loadu_si128(src + 3));
+    return _mm_packus_epi16(low, high);
+#else
+    const uint32_t* src = reinterpret_cast<const uint32_t*>(p_src);
+    const uint16x8_t low = vcombine_u16(vqmovn_u32(vld1q_u32(src)), vqmovn_u32(vld1q_u32(src + 4)));
+    const uint16x8_t high = vcombine_u16(vqmovn_u32(vld1q_u32(src + 8)), vqmovn_u32(vld1q_u32(src + 12)));
+    return vcombine_u8(vqmovn_u16(low), vqmovn_u16(high));
+#endif
+}
+
+#if defined(CHAR_UTILS_SSE2)
+/** Bytes of p_bytes in [p_first, p_first + p_count). SSE2 only compares
+ *  signed bytes, so the range is moved to start at -128. */
+static _FORCE_INLINE_ __m128i _in_range(__m128i p_bytes, uint8_t p_first, uint8_t p_count) {
+    const __m128i shifted = _mm_add_epi8(p_bytes, _mm_set1_epi8(char(0x80 - p_first)));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8(char(0x80 + p_count)));
+}
+#else
+static _FORCE_INLINE_ uint8x16_t _in_range(uint8x16_t p_bytes, uint8_t p_first, uint8_t p_count) {
+    return vcltq_u8(vsubq_u8(p_bytes, vdupq_n_u8(p_first)), vdupq_n_u8(p_count));
+}
+#endif
+
+static _FORCE_INLINE_ uint64_t _mask(Block p_matches) {
+#if defined(CHAR_UTILS_SSE2)
+    return uint32_t(_mm_movemask_epi8(p_matches));
+#else
+    const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(p_matches), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+#endif
+}
+
+/** Characters at the start of a block that are in the class of p_mask. */
+static _FORCE_INLINE_ int64_t _leading(uint64_t p_mask) {
+    if (p_mask == CHAR_UTILS_FULL_MASK) {
+        return CHAR_UTILS_BLOCK;
+    }
+    return _ctz64(~p_mask) / CHAR_UTILS_LANE_BITS;
+}
+#endif // CHAR_UTILS_SIMD
+
+/** Decodes one valid, shortest form UTF-8 sequence. Returns its size, or 0
+ *  when p_src[0, p_len) doesn't start with one. */
+static int _decode_utf8_char(const uint8_t* p_src, int64_t p_len, char32_t& r_char) {
+    const uint8_t lead = p_src[0];
+    int size;
+    char32_t min;
+    if (lead < 0x80) {
+        r_char = lead;
+        return 1;
+    } else if (lead < 0xC2) {
+        return 0;
+    } else if (lead < 0xE0) {
+        size = 2;
+        min = 0x80;
+        r_char = lead & 0x1F;
+    } else if (lead < 0xF0) {
+        size = 3;
+        min = 0x800;
+        r_char = lead & 0x0F;
+    } else if (lead < 0xF5) {
+        size = 4;
+        min = 0x10000;
+        r_char = lead & 0x07;
+    } else {
+        return 0;
+    }
+
+    if (p_len < size) {
+        return 0;
+    }
+    for (int k = 1; k < size; k++) {
+        if ((p_src[k] & 0xC0) != 0x80) {
+            return 0;
+        }
+        r_char = (r_char << 6) | (p_src[k] & 0x3F);
+    }
+    if (r_char < min || r_char > 0x10FFFF || (r_char >= 0xD800 && r_char <= 0xDFFF)) {
+        return 0;
+    }
+    return size;
+}
+
+/** Character classes the scans can skip. ascii() and unicode() agree with
+ *  char_utils.hpp, block() with ascii() for every byte. */
+struct _WhitespaceClass {
+    static _FORCE_INLINE_ bool ascii(uint8_t p_char) { return p_char == ' ' || (p_char >= '\t' && p_char <= '\r'); }
+    static _FORCE_INLINE_ bool unicode(char32_t p_char) { return is_unicode_whitespace(p_char); }
+
+#if defined(CHAR_UTILS_SSE2)
+    static _FORCE_INLINE_ uint64_t block(Block p_bytes) {
+        return _mask(_mm_or_si128(_mm_cmpeq_epi8(p_bytes, _mm_set1_epi8(' ')), _in_range(p_bytes, '\t', 5)));
+    }
+#elif defined(CHAR_UTILS_NEON)
+    static _FORCE_INLINE_ uint64_t block(Block p_bytes) {
+        return _mask(vorrq_u8(vceqq_u8(p_bytes, vdupq_n_u8(' ')), _in_range(p_bytes, '\t', 5)));
+    }
+#endif
+};
+
+struct _IdentifierClass {
+    static _FORCE_INLINE_ bool ascii(uint8_t p_char) { return is_ascii_identifier_char(p_char); }
+    static _FORCE_INLINE_ bool unicode(char32_t p_char) { return is_unicode_identifier_continue(p_char); }
+
+    // Setting 0x20 folds upper case letters onto lower case ones; no other
+    // byte lands on a letter.
+#if defined(CHAR_UTILS_SSE2)
+    static _FORCE_INLINE_ uint64_t block(Block p_bytes) {
+        const __m128i letters = _in_range(_mm_or_si128(p_bytes, _mm_set1_epi8(0x20)), 'a', 26);
+        const __m128i digits = _in_range(p_bytes, '0', 10);
+        const __m128i underscores = _mm_cmpeq_epi8(p_bytes, _mm_set1_epi8('_'));
+        return _mask(_mm_or_si128(_mm_or_si128(letters, digits), underscores));
+    }
+#elif defined(CHAR_UTILS_NEON)
+    static _FORCE_INLINE_ uint64_t block(Block p_bytes) {
+        const uint8x16_t letters = _in_range(vorrq_u8(p_bytes, vdupq_n_u8(0x20)), 'a', 26);
+        const uint8x16_t digits = _in_range(p_bytes, '0', 10);
+        const uint8x16_t underscores = vceqq_u8(p_bytes, vdupq_n_u8('_'));
+        return _mask(vorrq_u8(vorrq_u8(letters, digits), underscores));
+    }
+#endif
+};
+
+template <typename C>
+static const char32_t* _skip_class(const char32_t* p_from, const char32_t* p_end) {
+    const char32_t* src = p_from;
+    while (src < p_end) {
+#ifdef CHAR_UTILS_SIMD
+        if (p_end - src >= CHAR_UTILS_BLOCK) {
+            const int64_t leading = _leading(C::block(_load_utf32(src)));
+            src += leading;
+            if (leading == CHAR_UTILS_BLOCK) {
+                continue;
+            }
+        }
+#endif
+        const char32_t c = *src;
+        if (c < 0x80 ? !C::ascii(uint8_t(c)) : !C::unicode(c)) {
+            break;
+        }
+        src++;
+    }
+    return src;
+}
+
+template <typename C>
+static const uint8_t* _skip_class(const uint8_t* p_from, const uint8_t* p_end) {
+    const uint8_t* src = p_from;
+    while (src < p_end) {
+#ifdef CHAR_UTILS_SIMD
+        if (p_end - src >= CHAR_UTILS_BLOCK) {
+            const int64_t leading = _leading(C::block(_load_utf8(src)));
+            src += leading;
+            if (leading == CHAR_UTILS_BLOCK) {
+                continue;
+            }
+        }
+#endif
+        if (*src < 0x80) {
+            if (!C::ascii(*src)) {
+                break;
+            }
+            src++;
+            continue;
+        }
+
+        char32_t c;
+        const int size = _decode_utf8_char(src, p_end - src, c);
+        if (size == 0 || !C::unicode(c)) {
+            break;
+        }
+        src += size;
+    }
+    return src;
+}
+
+const char32_t* skip_whitespace(const char32_t* p_from, const char32_t* p_end) {
+    return _skip_class<_WhitespaceClass>(p_from, p_end);
+}
+
+const char* skip_whitespace(const char* p_from, const char* p_end) {
+    const uint8_t* from = reinterpret_cast<const uint8_t*>(p_from);
+    const uint8_t* end = reinterpret_cast<const uint8_t*>(p_end);
+    return reinterpret_cast<const char*>(_skip_class<_WhitespaceClass>(from, end));
+}
+
+const char32_t* scan_identifier(const char32_t* p_from, const char32_t* p_end) {
+    if (p_from >= p_end || !is_unicode_identifier_start(*p_from)) {
+        return p_from;
+    }
+    return _skip_class<_IdentifierClass>(p_from + 1, p_end);
+}
+
+const char* scan_identifier(const char* p_from, const char* p_end) {
+    const uint8_t* from = reinterpret_cast<const uint8_t*>(p_from);
+    const uint8_t* end = reinterpret_cast<const uint8_t*>(p_end);
+    if (from >= end) {
+        return p_from;
+    }
+
+    char32_t first;
+    const int size = _decode_utf8_char(from, end - from, first);
+    if (size == 0 || !is_unicode_identifier_start(first)) {
+        return p_from;
+    }
+    return reinterpret_cast<const char*>(_skip_class<_IdentifierClass>(from + size, end));
+}
@@ -0,0 +1,113 @@
+#ifndef __CHAR_UTILS_HPP__
+#define __CHAR_UTILS_HPP__
+
+#include "../typedefs.hpp"
+#include "./char_range.inc"
+
+#include <stdint.h>
+
+/** Character classes and case mapping, looked up in the two-level tables of
+ *  char_range.inc: a byte picks the block of the character, and the block
+ *  holds its value. Two loads instead of a binary search over ranges, and
+ *  ASCII answers without touching the tables at all. */
+
+static _FORCE_INLINE_ bool is_ascii_char(char32_t p_char) {
+    return p_char < 0x80;
+}
+
+static _FORCE_INLINE_ bool is_digit(char32_t p_char) {
+    return p_char >= '0' && p_char <= '9';
+}
+
+static _FORCE_INLINE_ bool is_ascii_alphabet_char(char32_t p_char) {
+    return (p_char | 0x20) >= 'a' && (p_char | 0x20) <= 'z';
+}
+
+static _FORCE_INLINE_ bool is_ascii_identifier_char(char32_t p_char) {
+    return is_ascii_alphabet_char(p_char) || is_digit(p_char) || p_char == '_';
+}
+
+/** CharClass bits of p_char; 0 for anything that isn't a code point. */
+static _FORCE_INLINE_ uint8_t get_char_class(char32_t p_char) {
+    if (unlikely(p_char >= CHAR_CLASS_LIMIT)) {
+        return 0;
+    }
+    return char_class_blocks[char_class_index[p_char >> CHAR_CLASS_BLOCK_SHIFT]][p_char & CHAR_CLASS_BLOCK_MASK];
+}
+
+/** General category L. */
+static _FORCE_INLINE_ bool is_unicode_letter(char32_t p_char) {
+    if (p_char < 0x80) {
+        return is_ascii_alphabet_char(p_char);
+    }
+    return get_char_class(p_char) & CHAR_CLASS_LETTER;
+}
+
+/** General category Nd. */
+static _FORCE_INLINE_ bool is_unicode_digit(char32_t p_char) {
+    if (p_char < 0x80) {
+        return is_digit(p_char);
+    }
+    return get_char_class(p_char) & CHAR_CLASS_DIGIT;
+}
+
+/** White_Space property. */
+static _FORCE_INLINE_ bool is_unicode_whitespace(char32_t p_char) {
+    if (p_char < 0x80) {
+        return p_char == ' ' || (p_char >= '\t' && p_char <= '\r');
+    }
+    return get_char_class(p_char) & CHAR_CLASS_WHITESPACE;
+}
+
+/** XID_Start, and '_'. */
+static _FORCE_INLINE_ bool is_unicode_identifier_start(char32_t p_char) {
+    if (p_char < 0x80) {
+        return is_ascii_alphabet_char(p_char) || p_char == '_';
+    }
+    return get_char_class(p_char) & CHAR_CLASS_IDENTIFIER_START;
+}
+
+/** XID_Continue. */
+static _FORCE_INLINE_ bool is_unicode_identifier_continue(char32_t p_char) {
+    if (p_char < 0x80) {
+        return is_ascii_identifier_char(p_char);
+    }
+    return get_char_class(p_char) & CHAR_CLASS_IDENTIFIER_CONTINUE;
+}
+
+/** Simple (single character) case mappings; characters without one map to
+ *  themselves. */
+static _FORCE_INLINE_ char32_t unicode_to_lower(char32_t p_char) {
+    if (p_char < 0x80) {
+        return (p_char >= 'A' && p_char <= 'Z') ? p_char + ('a' - 'A') : p_char;
+    }
+    if (p_char >= CASE_LIMIT) {
+        return p_char;
+    }
+    return p_char + lower_case_blocks[lower_case_index[p_char >> CASE_BLOCK_SHIFT]][p_char & CASE_BLOCK_MASK];
+}
+
+static _FORCE_INLINE_ char32_t unicode_to_upper(char32_t p_char) {
+    if (p_char < 0x80) {
+        return (p_char >= 'a' && p_char <= 'z') ? p_char - ('a' - 'A') : p_char;
+    }
+    if (p_char >= CASE_LIMIT) {
+        return p_char;
+    }
+    return p_char + upper_case_blocks[upper_case_index[p_char >> CASE_BLOCK_SHIFT]][p_char & CASE_BLOCK_MASK];
+}
+
+/** Scans for tokenizers and parsers. They classify 16 characters at a time
+ *  while the text is ASCII, and look up the tables only for the rest. The
+ *  UTF-8 versions stop at invalid sequences, as at any other character that
+ *  doesn't belong. */
+
+/** First character of [p_from, p_end) that isn't whitespace, or p_end. */
+const char32_t* skip_whitespace(const char32_t* p_from, const char32_t* p_end);
+const char* skip_whitespace(const char* p_from, const char* p_end);
+
+/** End of the identifier starting at p_from, or p_from when there is none. */
+const char32_t* scan_identifier(const char32_t* p_from, const char32_t* p_end);
+const char* scan_identifier(const char* p_from, const char* p_end);
+
+#endif
@@ -0,0 +1,945 @@
+#include "./float_conversion.hpp"
+
+#include "../error/error_macros.hpp"
+#include "./float_tables.inc"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#include <intrin.h>
+#endif
+
+namespace FloatConversion {
+
+static const uint64_t DOUBLE_SIGN = uint64_t(1) << 63;
+static const uint64_t DOUBLE_INF = uint64_t(0x7FF) << 52;
+static const uint64_t DOUBLE_FRACTION_MASK = (uint64_t(1) << 52) - 1;
+static const uint32_t FLOAT_INF = uint32_t(0xFF) << 23;
+
+static const uint64_t MASK_63 = (uint64_t(1) << 63) - 1;
+static const uint64_t MASK_32 = 0xFFFFFFFF;
+
+static const char _digit_pairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+static _FORCE_INLINE_ uint64_t _double_bits(double p_value) {
+    uint64_t bits;
+    memcpy(&bits, &p_value, sizeof(bits));
+    return bits;
+}
+
+static _FORCE_INLINE_ double _bits_double(uint64_t p_bits) {
+    double value;
+    memcpy(&value, &p_bits, sizeof(value));
+    return value;
+}
+
+static _FORCE_INLINE_ uint32_t _float_bits(float p_value) {
+    uint32_t bits;
+    memcpy(&bits, &p_value, sizeof(bits));
+    return bits;
+}
+
+/** High 64 bits of p_a * p_b, with the low ones in r_low. */
+static _FORCE_INLINE_ uint64_t _mul_128(uint64_t p_a, uint64_t p_b, uint64_t& r_low) {
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 product = (unsigned __int128)p_a * p_b;
+    r_low = uint64_t(product);
+    return uint64_t(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    uint64_t high;
+    r_low = _umul128(p_a, p_b, &high);
+    return high;
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    r_low = p_a * p_b;
+    return __umulh(p_a, p_b);
+#else
+    const uint64_t a_low = uint32_t(p_a);
+    const uint64_t a_high = p_a >> 32;
+    const uint64_t b_low = uint32_t(p_b);
+    const uint64_t b_high = p_b >> 32;
+    const uint64_t low_low = a_low * b_low;
+    const uint64_t high_low = a_high * b_low;
+    const uint64_t cross = (low_low >> 32) + uint32_t(high_low) + a_low * b_high;
+    r_low = (cross << 32) | uint32_t(low_low);
+    return a_high * b_high + (high_low >> 32) + (cross >> 32);
+#endif
+}
+
+static _FORCE_INLINE_ uint64_t _mul_high(uint64_t p_a, uint64_t p_b) {
+    uint64_t low;
+    return _mul_128(p_a, p_b, low);
+}
+
+static _FORCE_INLINE_ int _clz64(uint64_t p_value) {
+#if defined(__GNUC__)
+    return __builtin_clzll(p_value);
+#else
+    int n = 0;
+    while (!(p_value & (uint64_t(1) << 63))) {
+        p_value <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+static _FORCE_INLINE_ int _count_digits(uint64_t p_value) {
+    int count = 1;
+    for (uint64_t limit = 10; count < 20 && p_value >= limit; limit *= 10) {
+        count++;
+    }
+    return count;
+}
+
+/** Writes the decimal digits of p_value so that they end at r_end. */
+static _FORCE_INLINE_ void _write_digits(uint64_t p_value, char* r_end) {
+    while (p_value >= 100) {
+        r_end -= 2;
+        memcpy(r_end, _digit_pairs + (p_value % 100) * 2, 2);
+        p_value /= 100;
+    }
+    if (p_value >= 10) {
+        memcpy(r_end - 2, _digit_pairs + p_value * 2, 2);
+    } else {
+        r_end[-1] = char('0' + p_value);
+    }
+}
+
+static int _write_special(bool p_negative, bool p_nan, char* r_buffer) {
+    if (p_nan) {
+        memcpy(r_buffer, "nan", 3);
+        return 3;
+    }
+    if (p_negative) {
+        memcpy(r_buffer, "-inf", 4);
+        return 4;
+    }
+    memcpy(r_buffer, "inf", 3);
+    return 3;
+}
+
+/** Arbitrary precision unsigned integer, just big enough for exact decimal
+ *  printing and for settling hard roundings when parsing. */
+class _BigInt {
+    enum {
+        /** 32-bit limbs. The largest operand, 800 digits scaled by 2^1075,
+         *  or 10^1123 scaled by a 54-bit significand, needs under 4000 bits. */
+        CAPACITY = 192,
+    };
+
+    uint32_t _limbs[CAPACITY];
+    int _size = 0;
+
+    _FORCE_INLINE_ void _trim() {
+        while (_size > 0 && _limbs[_size - 1] == 0) {
+            _size--;
+        }
+    }
+
+public:
+    _FORCE_INLINE_ bool is_zero() const { return _size == 0; }
+
+    void multiply(uint32_t p_factor) {
+        uint64_t carry = 0;
+        for (int i = 0; i < _size; i++) {
+            const uint64_t product = uint64_t(_limbs[i]) * p_factor + carry;
+            _limbs[i] = uint32_t(product);
+            carry = product >> 32;
+        }
+        if (carry) {
+            CRASH_COND(_size == CAPACITY);
+            _limbs[_size++] = uint32_t(carry);
+        }
+    }
+
+    void add(uint32_t p_value) {
+        uint64_t carry = p_value;
+        for (int i = 0; carry && i < _size; i++) {
+            const uint64_t sum = uint64_t(_limbs[i]) + carry;
+            _limbs[i] = uint32_t(sum);
+            carry = sum >> 32;
+        }
+        if (carry) {
+            CRASH_COND(_size == CAPACITY);
+            _limbs[_size++] = uint32_t(carry);
+        }
+    }
+
+    void shift_left(int p_bits) {
+        if (_size == 0 || p_bits == 0) {
+            return;
+        }
+        const int words = p_bits / 32;
+        const int bits = p_bits % 32;
+        CRASH_COND(_size + words + 1 > CAPACITY);
+        if (bits == 0) {
+            for (int i = _size - 1; i >= 0; i--) {
+                _limbs[i + words] = _limbs[i];
+            }
+        } else {
+            _limbs[_size + words] = _limbs[_size - 1] >> (32 - bits);
+            for (int i = _size - 1; i > 0; i--) {
+                _limbs[i + words] = (_limbs[i] << bits) | (_limbs[i - 1] >> (32 - bits));
+            }
+            _limbs[words] = _limbs[0] << bits;
+        }
+        for (int i = 0; i < words; i++) {
+            _limbs[i] = 0;
+        }
+        _size += words + (bits ? 1 : 0);
+        _trim();
+    }
+
+    void shift_right(int p_bits) {
+        const int words = p_bits / 32;
+        const int bits = p_bits % 32;
+        if (words >= _size) {
+            _size = 0;
+            return;
+        }
+        const int size = _size - words;
+        for (int i = 0; i < size; i++) {
+            uint32_t limb = _limbs[i + words] >> bits;
+            if (bits && i + words + 1 < _size) {
+                limb |= _limbs[i + words + 1] << (32 - bits);
+            }
+            _limbs[i] = limb;
+        }
+        _size = size;
+        _trim();
+    }
+
+    /** Multiplies by 10^p_exponent, as 5^p_exponent and a shift. */
+    void multiply_pow10(int p_exponent) {
+        // 5^13 is the largest power of five in 32 bits.
+        static const uint32_t pow5[14] = { 1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625,
+            48828125, 244140625, 1220703125 };
+        int remaining = p_exponent;
+        while (remaining >= 13) {
+            multiply(pow5[13]);
+            remaining -= 13;
+        }
+        if (remaining > 0) {
+            multiply(pow5[remaining]);
+        }
+        shift_left(p_exponent);
+    }
+
+    _FORCE_INLINE_ bool bit(int p_index) const {
+        const int word = p_index / 32;
+        return word < _size && ((_limbs[word] >> (p_index % 32)) & 1);
+    }
+
+    bool any_bit_below(int p_index) const {
+        const int words = MIN(p_index / 32, _size);
+        for (int i = 0; i < words; i++) {
+            if (_limbs[i]) {
+                return true;
+            }
+        }
+        const int bits = p_index % 32;
+        return bits && words < _size && (_limbs[words] & ((uint32_t(1) << bits) - 1));
+    }
+
+    /** Divides in place, returning the remainder. */
+    uint32_t divide(uint32_t p_divisor) {
+        uint64_t remainder = 0;
+        for (int i = _size - 1; i >= 0; i--) {
+            const uint64_t current = (remainder << 32) | _limbs[i];
+            _limbs[i] = uint32_t(current / p_divisor);
+            remainder = current % p_divisor;
+        }
+        _trim();
+        return uint32_t(remainder);
+    }
+
+    int compare(const _BigInt& p_other) const {
+        if (_size != p_other._size) {
+            return _size < p_other._size ? -1 : 1;
+        }
+        for (int i = _size - 1; i >= 0; i--) {
+            if (_limbs[i] != p_other._limbs[i]) {
+                return _limbs[i] < p_other._limbs[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    explicit _BigInt(uint64_t p_value) {
+        _limbs[0] = uint32_t(p_value);
+        _limbs[1] = uint32_t(p_value >> 32);
+        _size = 2;
+        _trim();
+    }
+};
+
+/* Shortest formatting, after Raffaello Giulietti's Schubfach. The digits are
+ * those of the decimal closest to the value among the shortest ones that round
+ * back to it. */
+
+static uint64_t _eisel_lemire(uint64_t p_w, int64_t p_q);
+
+struct _Decimal {
+    uint64_t significand;
+    int exponent;
+};
+
+static const int DOUBLE_Q_MIN = -1074;
+static const uint64_t DOUBLE_C_MIN = uint64_t(1) << 52;
+/** Subnormals below it are worked out a digit further: the algorithm needs
+ *  a wider rounding interval than they have. */
+static const uint64_t DOUBLE_C_TINY = 3;
+static const int FLOAT_Q_MIN = -149;
+static const uint32_t FLOAT_C_MIN = uint32_t(1) << 23;
+static const uint32_t FLOAT_C_TINY = 8;
+
+static _FORCE_INLINE_ int _floor_log10_pow2(int p_exponent) {
+    return int((int64_t(p_exponent) * 661971961083LL) >> 41);
+}
+
+static _FORCE_INLINE_ int _floor_log10_three_quarters_pow2(int p_exponent) {
+    return int((int64_t(p_exponent) * 661971961083LL - 274743187321LL) >> 41);
+}
+
+static _FORCE_INLINE_ int _floor_log2_pow10(int p_exponent) {
+    return int((int64_t(p_exponent) * 913124641741LL) >> 38);
+}
+
+/** p_g * p_cp scaled down by 2^126, rounded to odd. */
+static _FORCE_INLINE_ uint64_t _round_to_odd(uint64_t p_g1, uint64_t p_g0, uint64_t p_cp) {
+    const uint64_t x1 = _mul_high(p_g0, p_cp);
+    uint64_t y0;
+    const uint64_t y1 = _mul_128(p_g1, p_cp, y0);
+    const uint64_t z = (y0 >> 1) + x1;
+    const uint64_t vbp = y1 + (z >> 63);
+    return vbp | (((z & MASK_63) + MASK_63) >> 63);
+}
+
+static _FORCE_INLINE_ uint64_t _round_to_odd(uint64_t p_g, uint64_t p_cp) {
+    const uint64_t x1 = _mul_high(p_g, p_cp);
+    const uint64_t vbp = x1 >> 31;
+    return vbp | (((x1 & MASK_32) + MASK_32) >> 32);
+}
+
+/** The decimal for p_c * 2^p_q, times 10^-p_dk. */
+static _Decimal _schubfach(int p_q, uint64_t p_c, int p_dk) {
+    const uint64_t out = p_c & 1;
+    const uint64_t cb = p_c << 2;
+    const uint64_t cbr = cb + 2;
+    uint64_t cbl;
+    int k;
+    if (p_c != DOUBLE_C_MIN || p_q == DOUBLE_Q_MIN) {
+        cbl = cb - 2;
+        k = _floor_log10_pow2(p_q);
+    } else {
+        // The gap below a power of two is half the one above.
+        cbl = cb - 1;
+        k = _floor_log10_three_quarters_pow2(p_q);
+    }
+    const int h = p_q + _floor_log2_pow10(-k) + 2;
+    const uint64_t* g = pow10_g[k - POW10_G_MIN_EXPONENT];
+    const uint64_t vb = _round_to_odd(g[0], g[1], cb << h);
+    const uint64_t vbl = _round_to_odd(g[0], g[1], cbl << h);
+    const uint64_t vbr = _round_to_odd(g[0], g[1], cbr << h);
+
+    const uint64_t s = vb >> 2;
+    if (s >= 100) {
+        // One digit shorter, when exactly one of the neighbours is in range.
+        const uint64_t sp10 = 10 * _mul_high(s, uint64_t(115292150460684698) << 4);
+        const uint64_t tp10 = sp10 + 10;
+        const bool upin = vbl + out <= sp10 << 2;
+        const bool wpin = (tp10 << 2) + out <= vbr;
+        if (upin != wpin) {
+            return { upin ? sp10 : tp10, k };
+        }
+    }
+    const uint64_t t = s + 1;
+    const bool uin = vbl + out <= s << 2;
+    const bool win = (t << 2) + out <= vbr;
+    if (uin != win) {
+        return { uin ? s : t, k + p_dk };
+    }
+    const int64_t cmp = int64_t(vb - ((s + t) << 1));
+    return { (cmp < 0 || (cmp == 0 && (s & 1) == 0)) ? s : t, k + p_dk };
+}
+
+static _Decimal _schubfach_float(int p_q, uint32_t p_c, int p_dk) {
+    const uint64_t out = p_c & 1;
+    const uint64_t cb = uint64_t(p_c) << 2;
+    const uint64_t cbr = cb + 2;
+    uint64_t cbl;
+    int k;
+    if (p_c != FLOAT_C_MIN || p_q == FLOAT_Q_MIN) {
+        cbl = cb - 2;
+        k = _floor_log10_pow2(p_q);
+    } else {
+        cbl = cb - 1;
+        k = _floor_log10_three_quarters_pow2(p_q);
+    }
+    const int h = p_q + _floor_log2_pow10(-k) + 33;
+    const uint64_t g = pow10_g[k - POW10_G_MIN_EXPONENT][0] + 1;
+    const uint64_t vb = _round_to_odd(g, cb << h);
+    const uint64_t vbl = _round_to_odd(g, cbl << h);
+    const uint64_t vbr = _round_to_odd(g, cbr << h);
+
+    const uint64_t s = vb >> 2;
+    if (s >= 100) {
+        const uint64_t sp10 = 10 * ((s * 1717986919) >> 34);
+        const uint64_t tp10 = sp10 + 10;
+        const bool upin = vbl + out <= sp10 << 2;
+        const bool wpin = (tp10 << 2) + out <= vbr;
+        if (upin != wpin) {
+            return { upin ? sp10 : tp10, k };
+        }
+    }
+    const uint64_t t = s + 1;
+    const bool uin = vbl + out <= s << 2;
+    const bool win = (t << 2) + out <= vbr;
+    if (uin != win) {
+        return { uin ? s : t, k + p_dk };
+    }
+    const int64_t cmp = int64_t(vb - ((s + t) << 1));
+    return { (cmp < 0 || (cmp == 0 && (s & 1) == 0)) ? s : t, k + p_dk };
+}
+
+/** Schubfach only looks for a digit less from three digits up, which leaves
+ *  the smallest subnormals with two digits where one may read back the same.
+ *  p_reads_back tells whether a decimal does. */
+template <typename F>
+static _Decimal _shorten(_Decimal p_decimal, F p_reads_back) {
+    if (p_decimal.significand < 10 || p_decimal.significand >= 100) {
+        return p_decimal;
+    }
+    const uint64_t down = p_decimal.significand / 10;
+    const uint64_t nearest = p_decimal.significand % 10 >= 5 ? down + 1 : down;
+    const uint64_t other = nearest == down ? down + 1 : down;
+    if (p_reads_back(nearest, p_decimal.exponent + 1)) {
+        return { nearest, p_decimal.exponent + 1 };
+    }
+    if (other > 0 && p_reads_back(other, p_decimal.exponent + 1)) {
+        return { other, p_decimal.exponent + 1 };
+    }
+    return p_decimal;
+}
+
+/** p_bits is finite, positive and not zero. */
+static _Decimal _to_decimal(uint64_t p_bits) {
+    const uint64_t t = p_bits & DOUBLE_FRACTION_MASK;
+    const int bq = int(p_bits >> 52);
+    if (bq == 0) {
+        const _Decimal decimal = t < DOUBLE_C_TINY ? _schubfach(DOUBLE_Q_MIN, 10 * t, -1) : _schubfach(DOUBLE_Q_MIN, t, 0);
+        return _shorten(decimal, [p_bits](uint64_t p_digits, int p_exponent) {
+            return _eisel_lemire(p_digits, p_exponent) == p_bits;
+        });
+    }
+
+    const int mq = 1075 - bq;
+    const uint64_t c = DOUBLE_C_MIN | t;
+    if (mq > 0 && mq < 53) {
+        // Integers print as they are.
+        const uint64_t integer = c >> mq;
+        if ((integer << mq) == c) {
+            return { integer, 0 };
+        }
+    }
+    return _schubfach(-mq, c, 0);
+}
+
+static _Decimal _to_decimal(uint32_t p_bits) {
+    const uint32_t t = p_bits & (FLOAT_C_MIN - 1);
+    const int bq = int(p_bits >> 23);
+    if (bq == 0) {
+        const _Decimal decimal = t < FLOAT_C_TINY ? _schubfach_float(FLOAT_Q_MIN, 10 * t, -1) : _schubfach_float(FLOAT_Q_MIN, t, 0);
+        return _shorten(decimal, [p_bits](uint64_t p_digits, int p_exponent) {
+            return _float_bits(float(_bits_double(_eisel_lemire(p_digits, p_exponent)))) == p_bits;
+        });
+    }
+
+    const int mq = 150 - bq;
+    const uint32_t c = FLOAT_C_MIN | t;
+    if (mq > 0 && mq < 24) {
+        const uint32_t integer = c >> mq;
+        if ((integer << mq) == c) {
+            return { integer, 0 };
+        }
+    }
+    return _schubfach_float(-mq, c, 0);
+}
+
+static int _format_decimal(bool p_negative, _Decimal p_decimal, char* r_buffer) {
+    uint64_t digits = p_decimal.significand;
+    int exponent = p_decimal.exponent;
+    while (digits % 10 == 0) {
+        digits /= 10;
+        exponent++;
+    }
+
+    char* out = r_buffer;
+    if (p_negative) {
+        *out++ = '-';
+    }
+    const int count = _count_digits(digits);
+    // Digits before the point.
+    const int point = count + exponent;
+
+    if (point > 0 && point <= 21) {
+        if (exponent >= 0) {
+            _write_digits(digits, out + count);
+            memset(out + count, '0', exponent);
+            out += point;
+        } else {
+            _write_digits(digits, out + count + 1);
+            memmove(out, out + 1, point);
+            out[point] = '.';
+            out += count + 1;
+        }
+    } else if (point <= 0 && point > -7) {
+        out[0] = '0';
+        out[1] = '.';
+        memset(out + 2, '0', -point);
+        out += 2 - point;
+        _write_digits(digits, out + count);
+        out += count;
+    } else {
+        _write_digits(digits, out + count + 1);
+        out[0] = out[1];
+        if (count > 1) {
+            out[1] = '.';
+            out += count + 1;
+        } else {
+            out += 1;
+        }
+
+        int scientific = point - 1;
+        *out++ = 'e';
+        *out++ = scientific < 0 ? '-' : '+';
+        scientific = ABS(scientific);
+        if (scientific >= 100) {
+            *out++ = char('0' + scientific / 100);
+            scientific %= 100;
+        }
+        memcpy(out, _digit_pairs + scientific * 2, 2);
+        out += 2;
+    }
+    return int(out - r_buffer);
+}
+
+int format_shortest(double p_value, char* r_buffer) {
+    const uint64_t bits = _double_bits(p_value);
+    const bool negative = bits & DOUBLE_SIGN;
+    const uint64_t magnitude = bits & ~DOUBLE_SIGN;
+    if (magnitude >= DOUBLE_INF) {
+        return _write_special(negative, magnitude != DOUBLE_INF, r_buffer);
+    }
+    if (magnitude == 0) {
+        memcpy(r_buffer, "-0", 2);
+        return negative ? 2 : (r_buffer[0] = '0', 1);
+    }
+    return _format_decimal(negative, _to_decimal(magnitude), r_buffer);
+}
+
+int format_shortest(float p_value, char* r_buffer) {
+    const uint32_t bits = _float_bits(p_value);
+    const bool negative = bits >> 31;
+    const uint32_t magnitude = bits & ~(uint32_t(1) << 31);
+    if (magnitude >= FLOAT_INF) {
+        return _write_special(negative, magnitude != FLOAT_INF, r_buffer);
+    }
+    if (magnitude == 0) {
+        memcpy(r_buffer, "-0", 2);
+        return negative ? 2 : (r_buffer[0] = '0', 1);
+    }
+    return _format_decimal(negative, _to_decimal(magnitude), r_buffer);
+}
+
+int format_fixed(double p_value, int p_decimals, char* r_buffer) {
+    const int decimals = CLAMP(p_decimals, 0, int(MAX_DECIMALS));
+    const uint64_t bits = _double_bits(p_value);
+    const bool negative = bits & DOUBLE_SIGN;
+    const uint64_t magnitude = bits & ~DOUBLE_SIGN;
+    if (magnitude >= DOUBLE_INF) {
+        return _write_special(negative, magnitude != DOUBLE_INF, r_buffer);
+    }
+
+    // The value is m * 2^e exactly; print round(m * 2^e * 10^decimals).
+    uint64_t m = magnitude & DOUBLE_FRACTION_MASK;
+    int e = -1074;
+    if (magnitude >> 52) {
+        m |= DOUBLE_C_MIN;
+        e = int(magnitude >> 52) - 1075;
+    }
+    _BigInt scaled(m);
+    scaled.multiply_pow10(decimals);
+    if (e >= 0) {
+        scaled.shift_left(e);
+    } else {
+        const bool half = scaled.bit(-e - 1);
+        const bool above_half = scaled.any_bit_below(-e - 1);
+        scaled.shift_right(-e);
+        if (half && (above_half || scaled.bit(0))) {
+            scaled.add(1);
+        }
+    }
+
+    // Digits, nine at a time, from the last one.
+    char digits[FIXED_BUFFER_SIZE];
+    char* digits_end = digits + FIXED_BUFFER_SIZE;
+    char* first = digits_end;
+    while (!scaled.is_zero()) {
+        const uint32_t chunk = scaled.divide(1000000000);
+        _write_digits(chunk, first);
+        const int written = _count_digits(chunk);
+        if (scaled.is_zero()) {
+            first -= written;
+        } else {
+            memset(first - 9, '0', 9 - written);
+            first -= 9;
+        }
+    }
+    const int count = int(digits_end - first);
+
+    // Trailing zeros of the fraction go. Its digits past the printed ones are
+    // the zeros right after the point.
+    int kept = decimals;
+    while (kept > 0) {
+        const int from_end = decimals - kept;
+        if (from_end < count && digits_end[-from_end - 1] != '0') {
+            break;
+        }
+        kept--;
+    }
+
+    char* out = r_buffer;
+    if (negative) {
+        *out++ = '-';
+    }
+    const int integer_digits = count - decimals;
+    if (integer_digits > 0) {
+        memcpy(out, first, integer_digits);
+        out += integer_digits;
+    } else {
+        *out++ = '0';
+    }
+    if (kept > 0) {
+        *out++ = '.';
+        // Zeros between the point and the first digit.
+        const int leading = MAX(0, decimals - count);
+        const int shown_leading = MIN(leading, kept);
+        memset(out, '0', shown_leading);
+        out += shown_leading;
+        const int rest = kept - shown_leading;
+        memcpy(out, digits_end - decimals + leading, rest);
+        out += rest;
+    }
+    return int(out - r_buffer);
+}
+
+/* Parsing, after Daniel Lemire's fast_float: Clinger's exact fast path, then
+ * Eisel-Lemire, then a comparison with the exact halfway point for the inputs
+ * with more digits than fit in 64 bits whose rounding the truncated ones
+ * don't decide. */
+
+/** Digits Eisel-Lemire takes, all of them exactly in 64 bits. */
+static const int SIGNIFICANT_DIGITS = 19;
+/** Digits that can decide a rounding; beyond them only being non zero counts. */
+static const int EXACT_DIGITS = 800;
+
+static const double _exact_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/** The double nearest to p_w * 10^p_q, as its bits. p_w isn't zero. */
+static uint64_t _eisel_lemire(uint64_t p_w, int64_t p_q) {
+    if (p_q < POW5_128_MIN_EXPONENT) {
+        return 0;
+    }
+    if (p_q > POW5_128_MAX_EXPONENT) {
+        return DOUBLE_INF;
+    }
+    const int q = int(p_q);
+
+    const int lz = _clz64(p_w);
+    const uint64_t w = p_w << lz;
+    const uint64_t* power = pow5_128[q - POW5_128_MIN_EXPONENT];
+    uint64_t low;
+    uint64_t high = _mul_128(w, power[0], low);
+    if ((high & 0x1FF) == 0x1FF) {
+        // The bits below the significand might carry; refine with the rest of
+        // the power.
+        uint64_t second_low;
+        const uint64_t second_high = _mul_128(w, power[1], second_low);
+        low += second_high;
+        if (second_high > low) {
+            high++;
+        }
+    }
+
+    const int upper_bit = int(high >> 63);
+    uint64_t mantissa = high >> (upper_bit + 9);
+    int power2 = ((217706 * q) >> 16) + 63 + upper_bit - lz + 1023;
+
+    if (power2 <= 0) {
+        // Subnormal.
+        if (-power2 + 1 >= 64) {
+            return 0;
+        }
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        // Rounding up may have reached the smallest normal number.
+        power2 = mantissa < DOUBLE_C_MIN ? 0 : 1;
+        return (uint64_t(power2) << 52) | mantissa;
+    }
+
+    // Exactly halfway between two doubles: round to even, not up.
+    if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << (upper_bit + 9)) == high) {
+        mantissa &= ~uint64_t(1);
+    }
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= (DOUBLE_C_MIN << 1)) {
+        mantissa = DOUBLE_C_MIN;
+        power2++;
+    }
+    mantissa &= ~DOUBLE_C_MIN;
+    if (power2 >= 0x7FF) {
+        return DOUBLE_INF;
+    }
+    return (uint64_t(power2) << 52) | mantissa;
+}
+
+/** Compares p_digits * 10^p_exponent, plus a bit when p_sticky, with the
+ *  point halfway between the double p_bits and the next one up. */
+static int _compare_halfway(const _BigInt& p_digits, int64_t p_exponent, bool p_sticky, uint64_t p_bits) {
+    uint64_t m = p_bits & DOUBLE_FRACTION_MASK;
+    int e = -1074;
+    if (p_bits >> 52) {
+        m |= DOUBLE_C_MIN;
+        e = int(p_bits >> 52) - 1075;
+    }
+
+    // Halfway is (2m + 1) * 2^(e - 1); make both sides integers.
+    _BigInt decimal = p_digits;
+    _BigInt halfway(2 * m + 1);
+    if (p_exponent >= 0) {
+        decimal.multiply_pow10(int(p_exponent));
+    } else {
+        halfway.multiply_pow10(int(-p_exponent));
+    }
+    if (e - 1 >= 0) {
+        halfway.shift_left(e - 1);
+    } else {
+        decimal.shift_left(1 - e);
+    }
+
+    const int cmp = decimal.compare(halfway);
+    return (cmp == 0 && p_sticky) ? 1 : cmp;
+}
+
+/** The correctly rounded double for the p_significant digits at p_digits
+ *  (the first one not zero, maybe with a point among them), the first
+ *  SIGNIFICANT_DIGITS of which are worth 10^p_exponent each. p_candidate is
+ *  at most one double away. */
+template <typename C>
+static uint64_t _round_exact(const C* p_digits, int64_t p_significant, int64_t p_exponent, uint64_t p_candidate) {
+    const int64_t count = MIN(p_significant, int64_t(EXACT_DIGITS));
+    const int64_t exponent = p_exponent - (count - SIGNIFICANT_DIGITS);
+
+    _BigInt digits(0);
+    const C* src = p_digits;
+    uint32_t chunk = 0;
+    int chunk_digits = 0;
+    for (int64_t i = 0; i < count; src++) {
+        if (*src == '.') {
+            continue;
+        }
+        chunk = chunk * 10 + uint32_t(*src - '0');
+        chunk_digits++;
+        i++;
+        if (chunk_digits == 9 || i == count) {
+            static const uint32_t pow10[10] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+            digits.multiply(pow10[chunk_digits]);
+            digits.add(chunk);
+            chunk = 0;
+            chunk_digits = 0;
+        }
+    }
+    bool sticky = false;
+    for (; *src == '.' || (*src >= '0' && *src <= '9'); src++) {
+        sticky = sticky || (*src >= '1' && *src <= '9');
+    }
+
+    uint64_t bits = p_candidate;
+    while (bits < DOUBLE_INF) {
+        const int cmp = _compare_halfway(digits, exponent, sticky, bits);
+        if (cmp < 0 || (cmp == 0 && (bits & 1) == 0)) {
+            break;
+        }
+        bits++;
+    }
+    while (bits > 0) {
+        const int cmp = _compare_halfway(digits, exponent, sticky, bits - 1);
+        if (cmp > 0 || (cmp == 0 && ((bits - 1) & 1))) {
+            break;
+        }
+        bits--;
+    }
+    return bits;
+}
+
+template <typename C>
+static _FORCE_INLINE_ bool _is_digit(C p_char) {
+    return p_char >= '0' && p_char <= '9';
+}
+
+/** Matches p_word, in lower case, at r_src in any case, moving r_src past it. */
+template <typename C>
+static bool _match_word(const C*& r_src, const char* p_word) {
+    const C* src = r_src;
+    for (; *p_word; p_word++, src++) {
+        const C lower = C(*p_word);
+        const C upper = C(*p_word - ('a' - 'A'));
+        if (*src != lower && *src != upper) {
+            return false;
+        }
+    }
+    r_src = src;
+    return true;
+}
+
+template <typename C>
+static double _parse(const C* p_str, const C** r_end) {
+    const C* src = p_str;
+    while (*src == ' ' || (*src >= '\t' && *src <= '\r')) {
+        src++;
+    }
+    bool negative = false;
+    if (*src == '-' || *src == '+') {
+        negative = *src == '-';
+        src++;
+    }
+
+    if (!_is_digit(*src) && !(*src == '.' && _is_digit(src[1]))) {
+        double special;
+        if (_match_word(src, "infinity") || _match_word(src, "inf")) {
+            special = INFINITY;
+        } else if (_match_word(src, "nan")) {
+            special = NAN;
+        } else {
+            if (r_end) {
+                *r_end = p_str;
+            }
+            return 0;
+        }
+        if (r_end) {
+            *r_end = src;
+        }
+        return negative ? -special : special;
+    }
+
+    // The first SIGNIFICANT_DIGITS significant digits go to w, the value is
+    // w * 10^exponent plus whatever the others add.
+    uint64_t w = 0;
+    int64_t significant = 0;
+    int64_t exponent = 0;
+    bool truncated = false;
+    const C* first_significant = nullptr;
+    for (; _is_digit(*src); src++) {
+        const uint32_t digit = uint32_t(*src - '0');
+        if (significant == 0) {
+            if (digit == 0) {
+                continue;
+            }
+            first_significant = src;
+        }
+        if (significant < SIGNIFICANT_DIGITS) {
+            w = w * 10 + digit;
+        } else {
+            exponent++;
+            truncated = truncated || digit;
+        }
+        significant++;
+    }
+    if (*src == '.') {
+        src++;
+        for (; _is_digit(*src); src++) {
+            const uint32_t digit = uint32_t(*src - '0');
+            if (significant == 0) {
+                if (digit == 0) {
+                    exponent--;
+                    continue;
+                }
+                first_significant = src;
+            }
+            if (significant < SIGNIFICANT_DIGITS) {
+                w = w * 10 + digit;
+                exponent--;
+            } else {
+                truncated = truncated || digit;
+            }
+            significant++;
+        }
+    }
+
+    if (*src == 'e' || *src == 'E') {
+        const C* exponent_src = src + 1;
+        const bool exponent_negative = *exponent_src == '-';
+        if (*exponent_src == '-' || *exponent_src == '+') {
+            exponent_src++;
+        }
+        if (_is_digit(*exponent_src)) {
+            int64_t value = 0;
+            for (; _is_digit(*exponent_src); exponent_src++) {
+                // Anything this large underflows or overflows anyway.
+                if (value < 100000000) {
+                    value = value * 10 + (*exponent_src - '0');
+                }
+            }
+            exponent += exponent_negative ? -value : value;
+            src = exponent_src;
+        }
+    }
+    if (r_end) {
+        *r_end = src;
+    }
+
+    uint64_t bits;
+    if (w == 0) {
+        bits = 0;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    } else if (!truncated && w <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+        // Both operands are exact, so is the one rounding of the operation.
+        const double value = exponent < 0 ? double(w) / _exact_pow10[-exponent] : double(w) * _exact_pow10[exponent];
+        return negative ? -value : value;
+#endif
+    } else {
+        bits = _eisel_lemire(w, exponent);
+        if (truncated && bits != _eisel_lemire(w + 1, exponent)) {
+            bits = _round_exact(first_significant, significant, exponent, bits);
+        }
+    }
+    return _bits_double(negative ? bits | DOUBLE_SIGN : bits);
+}
+
+double parse(const char* p_str, const char** r_end) {
+    return _parse(p_str, r_end);
+}
+
+double parse(const char32_t* p_str, const char32_t** r_end) {
+    return _parse(p_str, r_end);
+}
+
+} // namespace FloatConversion
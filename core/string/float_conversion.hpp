@@ -0,0 +1,53 @@
+#ifndef __FLOAT_CONVERSION_HPP__
+#define __FLOAT_CONVERSION_HPP__
+
+#include "../typedefs.hpp"
+
+#include <stdint.h>
+
+/** Locale independent conversions between floating point numbers and text,
+ *  behind the String::num*() and to_float() family.
+ *
+ *  Formatting finds the shortest decimal that reads back as the same number
+ *  (Schubfach: three 128-bit products, no loop over digits), and prints exact
+ *  decimals through a small big integer only when a fixed count is asked.
+ *  Parsing converts up to 19 significant digits with a single 128-bit
+ *  product (Eisel-Lemire), and settles the rare inputs whose rounding it can't
+ *  decide by comparing against the exact halfway point, so results are always
+ *  correctly rounded.
+ */
+namespace FloatConversion {
+
+enum {
+    /** Room for any shortest form, sign and exponent included. */
+    SHORTEST_BUFFER_SIZE = 32,
+    /** Decimals format_fixed() prints at most. */
+    MAX_DECIMALS = 32,
+    /** Room for any format_fixed() output: 309 integer digits, the point and
+     *  MAX_DECIMALS decimals. */
+    FIXED_BUFFER_SIZE = 352,
+};
+
+/** Writes the shortest text that parses back to p_value to r_buffer, which
+ *  has SHORTEST_BUFFER_SIZE bytes, and returns its length. Positional below
+ *  1e21 and down to 1e-7, scientific ("1e+21") beyond; "inf", "-inf" and
+ *  "nan" for non finite values. Not terminated. */
+int format_shortest(double p_value, char* r_buffer);
+/** The shortest text that parses back to the same float. */
+int format_shortest(float p_value, char* r_buffer);
+
+/** Writes p_value rounded to p_decimals decimals (half to even on exact
+ *  ties, like printf), without trailing zeros, to r_buffer, which has
+ *  FIXED_BUFFER_SIZE bytes. Returns the length. Not terminated. */
+int format_fixed(double p_value, int p_decimals, char* r_buffer);
+
+/** Parses the number at p_str, after ASCII whitespace: an optional sign,
+ *  then digits with an optional point and exponent, or "inf", "infinity" or
+ *  "nan" in any case. Sets r_end past the number, or to p_str and returns 0
+ *  when there is none. Out of range values become infinity or zero. */
+double parse(const char* p_str, const char** r_end = nullptr);
+double parse(const char32_t* p_str, const char32_t** r_end = nullptr);
+
+} // namespace FloatConversion
+
+#endif
@@ -0,0 +1,142 @@
+#include "./multi_pattern_matcher.hpp"
+
+int MultiPatternMatcher::add_pattern(const String& p_pattern) {
+    ERROR_FAIL_COND_V_MSG(p_pattern.is_empty(), -1, "Patterns can't be empty.");
+    _patterns.push_back(p_pattern.utf8());
+    _pattern_lengths.push_back(p_pattern.length());
+    _built = false;
+    return int(_patterns.size() - 1);
+}
+
+Errors MultiPatternMatcher::build() {
+    _built = false;
+
+    // Classes in order of first appearance; class 0 takes every other byte.
+    // UTF-8 never has 0xC0, 0xC1 or 0xF5 and up, so they fit in a byte.
+    memset(_byte_classes, 0, sizeof(_byte_classes));
+    _class_count = 1;
+    for (int64_t p = 0; p < _patterns.size(); p++) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(_patterns[p].get_data());
+        for (int64_t i = 0; i < _patterns[p].length(); i++) {
+            if (_byte_classes[bytes[i]] == 0) {
+                _byte_classes[bytes[i]] = uint8_t(_class_count++);
+            }
+        }
+    }
+    const int64_t classes = _class_count;
+
+    // The trie. No trie edge leads back to the root, so 0 marks the missing
+    // ones until the failure links fill them in.
+    _transitions.clear();
+    _state_patterns.clear();
+    Errors err = _transitions.resize_zeroed(classes);
+    ERROR_FAIL_COND_V(err != Errors::NONE, err);
+    _state_patterns.push_back(-1);
+    _same_patterns.resize(_patterns.size());
+    int32_t state_count = 1;
+
+    for (int64_t p = 0; p < _patterns.size(); p++) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(_patterns[p].get_data());
+        int32_t state = 0;
+        for (int64_t i = 0; i < _patterns[p].length(); i++) {
+            const int64_t edge = state * classes + _byte_classes[bytes[i]];
+            int32_t next = _transitions[edge];
+            if (next == 0) {
+                next = state_count++;
+                err = _transitions.resize_zeroed(int64_t(state_count) * classes);
+                ERROR_FAIL_COND_V(err != Errors::NONE, err);
+                _transitions.ptrw()[edge] = next;
+                _state_patterns.push_back(-1);
+            }
+            state = next;
+        }
+
+        _same_patterns.ptrw()[p] = -1;
+        int32_t* patterns = _state_patterns.ptrw();
+        if (patterns[state] == -1) {
+            patterns[state] = int32_t(p);
+        } else {
+            int32_t last = patterns[state];
+            while (_same_patterns[last] != -1) {
+                last = _same_patterns[last];
+            }
+            _same_patterns.ptrw()[last] = int32_t(p);
+        }
+    }
+
+    // Breadth first, so that the failure link of a state, always shallower,
+    // has its row complete by the time the state copies the missing edges
+    // from it.
+    Vector<int32_t> failures;
+    Vector<int32_t> queue;
+    err = failures.resize_zeroed(state_count);
+    ERROR_FAIL_COND_V(err != Errors::NONE, err);
+    err = queue.resize(state_count);
+    ERROR_FAIL_COND_V(err != Errors::NONE, err);
+    _first_outputs.resize(state_count);
+    _next_outputs.resize(state_count);
+
+    int32_t* transitions = _transitions.ptrw();
+    int32_t* failure = failures.ptrw();
+    int32_t* pending = queue.ptrw();
+    const int32_t* patterns = _state_patterns.ptr();
+    int32_t* first_outputs = _first_outputs.ptrw();
+    int32_t* next_outputs = _next_outputs.ptrw();
+
+    first_outputs[0] = -1;
+    next_outputs[0] = -1;
+    int64_t head = 0;
+    int64_t tail = 0;
+    pending[tail++] = 0;
+    while (head < tail) {
+        const int32_t state = pending[head++];
+        int32_t* row = transitions + state * classes;
+        const int32_t* failure_row = transitions + failure[state] * classes;
+        for (int64_t c = 0; c < classes; c++) {
+            if (row[c] == 0) {
+                row[c] = state == 0 ? 0 : failure_row[c];
+                continue;
+            }
+
+            const int32_t child = row[c];
+            failure[child] = state == 0 ? 0 : failure_row[c];
+            next_outputs[child] = first_outputs[failure[child]];
+            first_outputs[child] = patterns[child] != -1 ? child : next_outputs[child];
+            pending[tail++] = child;
+        }
+    }
+
+    _built = true;
+    return Errors::NONE;
+}
+
+Vector<MultiPatternMatcher::Match> MultiPatternMatcher::find_all(const String& p_text) const {
+    Vector<Match> matches;
+    scan(p_text, [&matches](const Match& p_match) {
+        matches.push_back(p_match);
+        return true;
+    });
+    return matches;
+}
+
+bool MultiPatternMatcher::contains_any(const String& p_text) const {
+    bool found = false;
+    scan(p_text, [&found](const Match&) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+void MultiPatternMatcher::clear() {
+    _patterns.clear();
+    _pattern_lengths.clear();
+    memset(_byte_classes, 0, sizeof(_byte_classes));
+    _class_count = 0;
+    _transitions.clear();
+    _state_patterns.clear();
+    _same_patterns.clear();
+    _first_outputs.clear();
+    _next_outputs.clear();
+    _built = false;
+}
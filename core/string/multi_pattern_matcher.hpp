@@ -0,0 +1,166 @@
+#ifndef __MULTI_PATTERN_MATCHER_HPP__
+#define __MULTI_PATTERN_MATCHER_HPP__
+
+#include "../error/error_list.hpp"
+#include "../error/error_macros.hpp"
+#include "../templates/vector.hpp"
+#include "../typedefs.hpp"
+#include "./ustring.hpp"
+
+#include <stdint.h>
+#include <string.h>
+
+/** Finds every occurrence of many patterns in one pass over the text
+ *  (Aho-Corasick), however many patterns there are.
+ *
+ *  The automaton runs over UTF-8 bytes. Bytes are first mapped to classes,
+ *  one per byte that appears in some pattern and a shared one for all the
+ *  others, and every state keeps a full row of next states per class, the
+ *  failure links already followed. Scanning is then one table load per byte,
+ *  at the cost of states * classes * 4 bytes of memory, which stays small for
+ *  the keyword and identifier lists this is meant for.
+ *
+ *  Add the patterns, build(), then scan any number of texts. Adding a pattern
+ *  afterwards needs another build().
+ */
+class MultiPatternMatcher {
+public:
+    /** A pattern found at [start, end), in characters when scanning a String
+     *  and in bytes when scanning UTF-8. */
+    struct Match {
+        int64_t start = 0;
+        int64_t end = 0;
+        int pattern = -1;
+    };
+
+private:
+    /** Pattern texts, as UTF-8, and their lengths in characters. */
+    Vector<CharString> _patterns;
+    Vector<int64_t> _pattern_lengths;
+
+    /** Class of each byte; 0 for bytes no pattern has. */
+    uint8_t _byte_classes[256] = {};
+    int32_t _class_count = 0;
+    /** Next state, at state * _class_count + class. State 0 is the root. */
+    Vector<int32_t> _transitions;
+    /** First pattern ending at each state, or -1. Patterns added more than
+     *  once chain through _same_patterns. */
+    Vector<int32_t> _state_patterns;
+    Vector<int32_t> _same_patterns;
+    /** The state itself, or the nearest one down its failure links, where a
+     *  pattern ends; -1 if none. */
+    Vector<int32_t> _first_outputs;
+    /** _first_outputs of the failure link, for the matches of a state past
+     *  its own. */
+    Vector<int32_t> _next_outputs;
+    bool _built = false;
+
+    /** Writes the UTF-8 of p_char the way String::utf8() does, non
+     *  characters as U+FFFD, and returns its size. */
+    static _FORCE_INLINE_ int _encode_char(char32_t p_char, uint8_t* r_bytes) {
+        if (p_char < 0x80) {
+            r_bytes[0] = uint8_t(p_char);
+            return 1;
+        }
+        if (p_char > 0x10FFFF || (p_char & 0xFFFFF800) == 0xD800) {
+            p_char = 0xFFFD;
+        }
+        if (p_char < 0x800) {
+            r_bytes[0] = uint8_t(0xC0 | (p_char >> 6));
+            r_bytes[1] = uint8_t(0x80 | (p_char & 0x3F));
+            return 2;
+        }
+        if (p_char < 0x10000) {
+            r_bytes[0] = uint8_t(0xE0 | (p_char >> 12));
+            r_bytes[1] = uint8_t(0x80 | ((p_char >> 6) & 0x3F));
+            r_bytes[2] = uint8_t(0x80 | (p_char & 0x3F));
+            return 3;
+        }
+        r_bytes[0] = uint8_t(0xF0 | (p_char >> 18));
+        r_bytes[1] = uint8_t(0x80 | ((p_char >> 12) & 0x3F));
+        r_bytes[2] = uint8_t(0x80 | ((p_char >> 6) & 0x3F));
+        r_bytes[3] = uint8_t(0x80 | (p_char & 0x3F));
+        return 4;
+    }
+
+    /** Reports the matches ending at p_end in p_state; false when the
+     *  callback asked to stop. */
+    template <typename F>
+    bool _report(int32_t p_state, int64_t p_end, bool p_in_chars, F& p_callback) const {
+        const int32_t* state_patterns = _state_patterns.ptr();
+        const int32_t* same_patterns = _same_patterns.ptr();
+        for (int32_t state = _first_outputs.ptr()[p_state]; state != -1; state = _next_outputs.ptr()[state]) {
+            for (int32_t pattern = state_patterns[state]; pattern != -1; pattern = same_patterns[pattern]) {
+                Match match;
+                match.end = p_end;
+                match.start = p_end - (p_in_chars ? _pattern_lengths[pattern] : _patterns[pattern].length());
+                match.pattern = pattern;
+                if (!p_callback(static_cast<const Match&>(match))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+public:
+    /** Adds p_pattern and returns its index, as reported in matches. */
+    int add_pattern(const String& p_pattern);
+    _FORCE_INLINE_ int get_pattern_count() const { return int(_patterns.size()); }
+    _FORCE_INLINE_ bool is_built() const { return _built; }
+
+    /** Builds the automaton from the patterns added so far. */
+    Errors build();
+
+    /** Calls p_callback(const Match&) for every occurrence of every pattern,
+     *  overlapping ones included, in order of their end; at the same end, the
+     *  longer patterns first. Stops when the callback returns false. */
+    template <typename F>
+    void scan(const String& p_text, F p_callback) const {
+        ERROR_FAIL_COND_MSG(!_built, "Call build() before scanning.");
+        const char32_t* chars = p_text.ptr();
+        const int64_t len = p_text.length();
+        const int32_t* transitions = _transitions.ptr();
+        const int32_t* first_outputs = _first_outputs.ptr();
+        int32_t state = 0;
+        for (int64_t i = 0; i < len; i++) {
+            uint8_t bytes[4];
+            const int size = _encode_char(chars[i], bytes);
+            for (int k = 0; k < size; k++) {
+                state = transitions[state * _class_count + _byte_classes[bytes[k]]];
+            }
+            if (first_outputs[state] != -1 && !_report(state, i + 1, true, p_callback)) {
+                return;
+            }
+        }
+    }
+
+    /** scan() over p_len bytes of UTF-8, -1 up to the terminator, with
+     *  positions in bytes. Invalid sequences are matched byte for byte. */
+    template <typename F>
+    void scan_utf8(const char* p_utf8, int64_t p_len, F p_callback) const {
+        ERROR_FAIL_COND_MSG(!_built, "Call build() before scanning.");
+        ERROR_FAIL_NULL(p_utf8);
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(p_utf8);
+        const int64_t len = p_len < 0 ? int64_t(strlen(p_utf8)) : p_len;
+        const int32_t* transitions = _transitions.ptr();
+        const int32_t* first_outputs = _first_outputs.ptr();
+        int32_t state = 0;
+        for (int64_t i = 0; i < len; i++) {
+            state = transitions[state * _class_count + _byte_classes[bytes[i]]];
+            if (first_outputs[state] != -1 && !_report(state, i + 1, false, p_callback)) {
+                return;
+            }
+        }
+    }
+
+    /** Every match of scan(). */
+    Vector<Match> find_all(const String& p_text) const;
+    /** Whether any pattern occurs in p_text; stops at the first match. */
+    bool contains_any(const String& p_text) const;
+
+    /** Forgets the patterns and the automaton. */
+    void clear();
+};
+
+#endif
@@ -0,0 +1,145 @@
+#include "./string_builder.hpp"
+
+#include "../error/error_macros.hpp"
+#include "../os/memory.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+char32_t* StringBuilder::_reserve(int64_t p_chars) {
+    if (_last->capacity - _last->used >= p_chars) {
+        return _last->chars() + _last->used;
+    }
+
+    // Whatever is left in the last chunk stays unused.
+    const int64_t grown = MIN(int64_t(MAX_CHUNK_CAPACITY), MAX(int64_t(FIRST_CHUNK_CAPACITY), _last->capacity * 2));
+    const int64_t capacity = MAX(p_chars, grown);
+    void* mem = memalloc(sizeof(Chunk) + capacity * sizeof(char32_t));
+    ERROR_FAIL_NULL_V(mem, nullptr);
+
+    Chunk* chunk = new (mem) Chunk;
+    chunk->capacity = capacity;
+    _last->next = chunk;
+    _last = chunk;
+    return chunk->chars();
+}
+
+void StringBuilder::_free_chunks() {
+    Chunk* chunk = _first.header.next;
+    while (chunk) {
+        Chunk* next = chunk->next;
+        memfree(chunk);
+        chunk = next;
+    }
+    _first.header.next = nullptr;
+}
+
+void StringBuilder::append(const char32_t* p_chars, int64_t p_length) {
+    if (p_length <= 0) {
+        return;
+    }
+
+    // Fill the last chunk, then put the rest in a new one.
+    const int64_t head = MIN(p_length, _last->capacity - _last->used);
+    memcpy(_last->chars() + _last->used, p_chars, head * sizeof(char32_t));
+    _last->used += head;
+
+    if (head < p_length) {
+        char32_t* dst = _reserve(p_length - head);
+        ERROR_FAIL_NULL(dst);
+        memcpy(dst, p_chars + head, (p_length - head) * sizeof(char32_t));
+        _last->used += p_length - head;
+    }
+    _length += p_length;
+}
+
+void StringBuilder::append(const char* p_cstring) {
+    if (!p_cstring) {
+        return;
+    }
+
+    const int64_t len = strlen(p_cstring);
+    char32_t* dst = _reserve(len);
+    ERROR_FAIL_NULL(dst);
+    for (int64_t i = 0; i < len; i++) {
+        dst[i] = uint8_t(p_cstring[i]);
+    }
+    _last->used += len;
+    _length += len;
+}
+
+void StringBuilder::append(char32_t p_char) {
+    char32_t* dst = _reserve(1);
+    ERROR_FAIL_NULL(dst);
+    *dst = p_char;
+    _last->used++;
+    _length++;
+}
+
+void StringBuilder::append_utf8(const char* p_utf8, int64_t p_len) {
+    if (!p_utf8) {
+        return;
+    }
+    if (p_len < 0) {
+        p_len = strlen(p_utf8);
+    }
+
+    // Room for the worst case, a character per byte.
+    char32_t* dst = _reserve(p_len);
+    ERROR_FAIL_NULL(dst);
+    const int64_t written = String::decode_utf8(p_utf8, p_len, dst);
+    _last->used += written;
+    _length += written;
+}
+
+void StringBuilder::append_format(const char* p_format, ...) {
+    va_list args;
+    va_start(args, p_format);
+    append_vformat(p_format, args);
+    va_end(args);
+}
+
+void StringBuilder::append_vformat(const char* p_format, va_list p_args) {
+    char buffer[FORMAT_BUFFER_SIZE];
+    va_list args;
+    va_copy(args, p_args);
+    const int len = vsnprintf(buffer, sizeof(buffer), p_format, args);
+    va_end(args);
+    ERROR_FAIL_COND_MSG(len < 0, "Invalid format string.");
+
+    if (len < FORMAT_BUFFER_SIZE) {
+        append_utf8(buffer, len);
+        return;
+    }
+
+    char* large = (char*)memalloc(len + 1);
+    ERROR_FAIL_NULL(large);
+    va_copy(args, p_args);
+    vsnprintf(large, len + 1, p_format, args);
+    va_end(args);
+    append_utf8(large, len);
+    memfree(large);
+}
+
+String StringBuilder::as_string() const {
+    String result;
+    if (_length == 0) {
+        return result;
+    }
+
+    const Errors err = result.resize(_length + 1);
+    ERROR_FAIL_COND_V(err != Errors::NONE, String());
+    char32_t* dst = result.ptrw();
+    for (const Chunk* chunk = &_first.header; chunk; chunk = chunk->next) {
+        memcpy(dst, chunk->chars(), chunk->used * sizeof(char32_t));
+        dst += chunk->used;
+    }
+    return result;
+}
+
+void StringBuilder::clear() {
+    _free_chunks();
+    _first.header.used = 0;
+    _last = &_first.header;
+    _length = 0;
+}
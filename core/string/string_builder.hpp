@@ -0,0 +1,96 @@
+#ifndef __STRING_BUILDER_HPP__
+#define __STRING_BUILDER_HPP__
+
+#include "../typedefs.hpp"
+#include "./ustring.hpp"
+
+#include <stdarg.h>
+#include <stddef.h>
+
+/** Collects text and turns it into a String once, with a single allocation of
+ *  the exact size.
+ *
+ *  Appended text is copied into a chain of chunks, the first one inside the
+ *  builder itself and the next ones doubling up to MAX_CHUNK_CAPACITY, so
+ *  building a string costs linear copying and few allocations, instead of
+ *  reallocating and copying everything at every concatenation.
+ *
+ *  Not copyable; the chunks belong to the builder.
+ */
+class StringBuilder {
+    enum {
+        /** Characters of the chunk inside the builder. */
+        INLINE_CAPACITY = 64,
+        FIRST_CHUNK_CAPACITY = 256,
+        MAX_CHUNK_CAPACITY = 1 << 16,
+        /** Formatted output up to this many bytes doesn't allocate. */
+        FORMAT_BUFFER_SIZE = 256,
+    };
+
+    struct Chunk {
+        Chunk* next = nullptr;
+        int64_t used = 0;
+        int64_t capacity = 0;
+
+        _FORCE_INLINE_ char32_t* chars() { return reinterpret_cast<char32_t*>(this + 1); }
+        _FORCE_INLINE_ const char32_t* chars() const { return reinterpret_cast<const char32_t*>(this + 1); }
+    };
+
+    /** chars() of the header lands on the inline characters. */
+    struct InlineChunk {
+        Chunk header;
+        char32_t chars[INLINE_CAPACITY];
+    };
+    static_assert(offsetof(InlineChunk, chars) == sizeof(Chunk), "Inline characters must follow the chunk header.");
+
+    InlineChunk _first;
+
+    Chunk* _last = &_first.header;
+    int64_t _length = 0;
+
+    /** Makes the last chunk have room for p_chars more characters. */
+    char32_t* _reserve(int64_t p_chars);
+    void _free_chunks();
+
+public:
+    _FORCE_INLINE_ int64_t length() const { return _length; }
+    _FORCE_INLINE_ bool is_empty() const { return _length == 0; }
+
+    void append(const char32_t* p_chars, int64_t p_length);
+    _FORCE_INLINE_ void append(const String& p_string) { append(p_string.get_data(), p_string.length()); }
+    /** Latin-1, like String(const char*). */
+    void append(const char* p_cstring);
+    void append(char32_t p_char);
+    /** Decoded from UTF-8 straight into the builder. */
+    void append_utf8(const char* p_utf8, int64_t p_len = -1);
+
+    /** printf() formatting, UTF-8, written straight into the builder. */
+    void append_format(const char* p_format, ...) _PRINTF_FORMAT_ATTRIBUTE_2_3;
+    void append_vformat(const char* p_format, va_list p_args) _PRINTF_FORMAT_ATTRIBUTE_2_0;
+
+    _FORCE_INLINE_ StringBuilder& operator+=(const String& p_string) {
+        append(p_string);
+        return *this;
+    }
+    _FORCE_INLINE_ StringBuilder& operator+=(const char* p_cstring) {
+        append(p_cstring);
+        return *this;
+    }
+    _FORCE_INLINE_ StringBuilder& operator+=(char32_t p_char) {
+        append(p_char);
+        return *this;
+    }
+
+    /** Everything appended so far, in one String. */
+    String as_string() const;
+    /** Forgets the text, keeping the first chunk only. */
+    void clear();
+
+    StringBuilder(const StringBuilder&) = delete;
+    StringBuilder& operator=(const StringBuilder&) = delete;
+
+    StringBuilder() { _first.header.capacity = INLINE_CAPACITY; }
+    ~StringBuilder() { _free_chunks(); }
+};
+
+#endif
@@ -0,0 +1,244 @@
+#include "./string_name.hpp"
+
+#include "../os/memory.hpp"
+
+#include <atomic>
+#include <string.h>
+
+StringName::Shard StringName::_shards[STRING_TABLE_SHARD_COUNT];
+bool StringName::configured = true;
+
+void StringName::cleanup() {
+    for (int s = 0; s < STRING_TABLE_SHARD_COUNT; s++) {
+        Shard& shard = _shards[s];
+        MutexLock lock(shard.write_lock);
+
+        for (int i = 0; i < STRING_TABLE_BUCKET_COUNT; i++) {
+            _Data* d = shard.buckets[i].get();
+            while (d) {
+                _Data* next = d->next.get();
+                memdelete(d);
+                d = next;
+            }
+            shard.buckets[i].set(nullptr);
+        }
+
+        while (shard.retired) {
+            _Data* next = shard.retired->retired_next;
+            memdelete(shard.retired);
+            shard.retired = next;
+        }
+    }
+
+    configured = false;
+}
+
+StringName::_Data* StringName::_find_and_ref(Shard& p_shard, uint32_t p_hash, const char* p_name) {
+    p_shard.readers.increment();
+    /** Pairs with the fence in _reclaim_retired(): either the reclaimer sees us,
+     *  or we see the chains without the entries it's about to free. */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    _Data* data = _get_bucket(p_shard, p_hash).get();
+    while (data) {
+        /** compare hash first; entries that reached zero are dying, skip them */
+        if (data->hash == p_hash && strcmp(data->get_name(), p_name) == 0 && data->refcount.ref()) {
+            break;
+        }
+        data = data->next.get();
+    }
+
+    p_shard.readers.decrement();
+    return data;
+}
+
+StringName::_Data* StringName::_find_and_ref_locked(Shard& p_shard, uint32_t p_hash, const char* p_name) {
+    _Data* data = _get_bucket(p_shard, p_hash).get();
+    while (data) {
+        if (data->hash == p_hash && strcmp(data->get_name(), p_name) == 0 && data->refcount.ref()) {
+            break;
+        }
+        data = data->next.get();
+    }
+
+    return data;
+}
+
+void StringName::_reclaim_retired(Shard& p_shard) {
+    if (!p_shard.retired) {
+        return;
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (p_shard.readers.get() != 0) {
+        /** Someone may still be walking over them, try again next time. */
+        return;
+    }
+
+    while (p_shard.retired) {
+        _Data* next = p_shard.retired->retired_next;
+        memdelete(p_shard.retired);
+        p_shard.retired = next;
+    }
+}
+
+void StringName::unref() {
+    ERROR_FAIL_NULL(_data);
+
+    if (configured && _data->refcount.unref()) {
+        Shard& shard = _get_shard(_data->hash);
+        MutexLock lock(shard.write_lock);
+
+        _Data* next = _data->next.get();
+        if (_data->prev) {
+            _data->prev->next.set(next);
+        } else {
+            _get_bucket(shard, _data->hash).set(next);
+        }
+
+        if (next) {
+            next->prev = _data->prev;
+        }
+
+        /** Our own next pointer is left intact, so readers standing on us can move on. */
+        _data->retired_next = shard.retired;
+        shard.retired = _data;
+
+        _reclaim_retired(shard);
+    }
+
+    _data = nullptr;
+}
+
+bool StringName::operator==(const char* p_name) const {
+    if (!_data) {
+        return (!p_name || p_name[0] == 0);
+    }
+
+    return p_name && strcmp(_data->get_name(), p_name) == 0;
+}
+
+bool StringName::operator!=(const char* p_name) const {
+    return !(operator==(p_name));
+}
+
+bool StringName::AlphCompare::operator()(const StringName& l, const StringName& r) const {
+    return strcmp(l.get_data(), r.get_data()) < 0;
+}
+
+void StringName::operator=(const StringName& p_name) {
+    if (this == &p_name) {
+        return;
+    }
+
+    if (_data) {
+        unref();
+    }
+
+    if (p_name._data && p_name._data->refcount.ref()) {
+        _data = p_name._data;
+    }
+}
+
+void StringName::operator=(StringName&& p_name) {
+    if (_data == p_name._data) {
+        return;
+    }
+
+    if (_data) {
+        unref();
+    }
+
+    _data = p_name._data;
+    p_name._data = nullptr;
+}
+
+StringName::StringName(const StringName& p_name) {
+    _data = nullptr;
+
+    if (p_name._data && p_name._data->refcount.ref()) {
+        _data = p_name._data;
+    }
+}
+
+void StringName::_intern(const char* p_name, uint32_t p_hash, bool p_static) {
+    Shard& shard = _get_shard(p_hash);
+
+    if (!p_static) {
+        /** Fast path: already interned, no lock taken. */
+        _data = _find_and_ref(shard, p_hash, p_name);
+        if (_data) {
+            return;
+        }
+    }
+
+    MutexLock lock(shard.write_lock);
+
+    /** Someone may have inserted it while we weren't holding the lock. */
+    _data = _find_and_ref_locked(shard, p_hash, p_name);
+    if (_data) {
+        if (p_static && !_data->is_static) {
+            /** Static names are never released, keep an extra reference for them. */
+            _data->is_static = true;
+            _data->refcount.ref();
+        }
+        return;
+    }
+
+    /** The copy of the name lives in the same allocation as the entry. */
+    const size_t len = p_static ? 0 : strlen(p_name) + 1;
+    uint8_t* mem = (uint8_t*)memalloc(sizeof(_Data) + len);
+    _data = memnew_placement(mem, _Data);
+    _data->refcount.init(p_static ? 2 : 1);
+    _data->is_static = p_static;
+    if (p_static) {
+        _data->cname = p_name;
+    } else {
+        _data->name = (char*)(mem + sizeof(_Data));
+        memcpy(_data->name, p_name, len);
+    }
+    _data->hash = p_hash;
+
+    SafeNumeric<_Data*>& bucket = _get_bucket(shard, p_hash);
+    _Data* head = bucket.get();
+    _data->next.set(head);
+    if (head) {
+        head->prev = _data;
+    }
+
+    /** Publishes the fully built entry to lock-free readers. */
+    bucket.set(_data);
+
+    _reclaim_retired(shard);
+}
+
+StringName::StringName(const char* p_name, bool p_static) {
+    _data = nullptr;
+
+    if (!p_name || p_name[0] == 0 || !configured) {
+        return; /** empty, ignore */
+    }
+
+    _intern(p_name, hash_name(p_name), p_static);
+}
+
+StringName::StringName(const char* p_name, uint32_t p_hash, bool p_static) {
+    _data = nullptr;
+
+    if (!p_name || p_name[0] == 0 || !configured) {
+        return; /** empty, ignore */
+    }
+
+    DEV_ASSERT(p_hash == hash_name(p_name));
+    _intern(p_name, p_hash, p_static);
+}
+
+StringName StringName::search(const char* p_name) {
+    ERROR_FAIL_NULL_V(p_name, StringName());
+    if (!p_name[0] || !configured) {
+        return StringName();
+    }
+
+    const uint32_t hash = hash_name(p_name);
+    return StringName(_find_and_ref(_get_shard(hash), hash, p_name));
+}
@@ -0,0 +1,132 @@
+#ifndef __STRING_NAME_HPP__
+#define __STRING_NAME_HPP__
+
+#include "../os/mutex.hpp"
+#include "../templates/hashfuncs.hpp"
+#include "../templates/safe_refcount.hpp"
+#include "../typedefs.hpp"
+
+/** Interned, reference-counted name.
+ *  Two StringNames built from equal strings share the same data, so
+ *  comparing and hashing them only looks at the data pointer.
+ *
+ *  The intern table is split in shards selected by hash. Lookups walk the
+ *  shard's chains without locking; only inserting and unlinking take the
+ *  shard's lock. Unlinked entries are freed once no lookup is in flight in
+ *  their shard, so lock-free readers never touch freed memory.
+ */
+class StringName {
+    enum {
+        STRING_TABLE_SHARD_BITS = 6,
+        STRING_TABLE_SHARD_COUNT = 1 << STRING_TABLE_SHARD_BITS,
+        STRING_TABLE_BUCKET_BITS = 10,
+        STRING_TABLE_BUCKET_COUNT = 1 << STRING_TABLE_BUCKET_BITS,
+        STRING_TABLE_BUCKET_MASK = STRING_TABLE_BUCKET_COUNT - 1
+    };
+
+    struct _Data {
+        SafeRefCount refcount;
+        /** Written under the shard lock, read without it. */
+        SafeNumeric<_Data*> next;
+        /** Only used under the shard lock. */
+        _Data* prev = nullptr;
+        _Data* retired_next = nullptr;
+        /** Static names point to the literal they were built from, others own a copy. */
+        const char* cname = nullptr;
+        char* name = nullptr;
+        uint32_t hash = 0;
+        bool is_static = false;
+
+        _FORCE_INLINE_ const char* get_name() const { return cname ? cname : name; }
+    };
+
+    struct Shard {
+        SafeNumeric<_Data*> buckets[STRING_TABLE_BUCKET_COUNT];
+        /** Lookups currently walking this shard. */
+        SafeNumericPadded<uint32_t> readers;
+        BinaryMutex write_lock;
+        /** Unlinked entries waiting for readers to drain. */
+        _Data* retired = nullptr;
+    };
+
+    static Shard _shards[STRING_TABLE_SHARD_COUNT];
+    /** Cleared by cleanup(); names released afterwards (e.g. by static destructors) are left alone. */
+    static bool configured;
+
+    _Data* _data = nullptr;
+
+    static _FORCE_INLINE_ Shard& _get_shard(uint32_t p_hash) {
+        return _shards[p_hash >> (32 - STRING_TABLE_SHARD_BITS)];
+    }
+    static _FORCE_INLINE_ SafeNumeric<_Data*>& _get_bucket(Shard& p_shard, uint32_t p_hash) {
+        return p_shard.buckets[p_hash & STRING_TABLE_BUCKET_MASK];
+    }
+
+    static _Data* _find_and_ref(Shard& p_shard, uint32_t p_hash, const char* p_name);
+    static _Data* _find_and_ref_locked(Shard& p_shard, uint32_t p_hash, const char* p_name);
+    static void _reclaim_retired(Shard& p_shard);
+    void _intern(const char* p_name, uint32_t p_hash, bool p_static);
+    void unref();
+
+    StringName(_Data* p_data) { _data = p_data; }
+
+public:
+    /** Hash used by the intern table. constexpr, so SNAME() hashes at compile time. */
+    static _FORCE_INLINE_ constexpr uint32_t hash_name(const char* p_name) {
+        return hash_fmix32(hash_djb2(p_name));
+    }
+
+    _FORCE_INLINE_ bool operator==(const StringName& p_name) const { return _data == p_name._data; }
+    _FORCE_INLINE_ bool operator!=(const StringName& p_name) const { return _data != p_name._data; }
+    bool operator==(const char* p_name) const;
+    bool operator!=(const char* p_name) const;
+
+    /** Compares identities, not text. Only stable while both names are alive. */
+    _FORCE_INLINE_ bool operator<(const StringName& p_name) const { return _data < p_name._data; }
+
+    _FORCE_INLINE_ bool is_empty() const { return _data == nullptr; }
+    _FORCE_INLINE_ uint32_t hash() const { return _data ? _data->hash : 0; }
+    _FORCE_INLINE_ const void* data_unique_pointer() const { return (void*)_data; }
+
+    _FORCE_INLINE_ const char* get_data() const { return _data ? _data->get_name() : ""; }
+
+    /** Returns the name if it's already interned, an empty one otherwise. Never interns. */
+    static StringName search(const char* p_name);
+
+    struct AlphCompare {
+        bool operator()(const StringName& l, const StringName& r) const;
+    };
+
+    void operator=(const StringName& p_name);
+    void operator=(StringName&& p_name);
+
+    /** Static names must be built from string literals: they keep pointing to
+     *  p_name and are never released. Prefer SNAME() for them.
+     */
+    StringName(const char* p_name, bool p_static = false);
+    StringName(const char* p_name, uint32_t p_hash, bool p_static);
+    StringName(const StringName& p_name);
+    StringName(StringName&& p_name) {
+        _data = p_name._data;
+        p_name._data = nullptr;
+    }
+    StringName() {}
+
+    static void cleanup();
+
+    _FORCE_INLINE_ ~StringName() {
+        if (_data) {
+            unref();
+        }
+    }
+};
+
+/** Static name from a literal: hashed at compile time, interned once on first use,
+ *  then every evaluation just returns the cached name.
+ */
+#define SNAME(m_arg) ([]() -> const StringName& {                                               \
+    static StringName sname = StringName(m_arg, std::integral_constant<uint32_t, StringName::hash_name(m_arg)>::value, true); \
+    return sname;                                                                               \
+})()
+
+#endif
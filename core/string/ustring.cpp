@@ -0,0 +1,1228 @@
+#include "./ustring.hpp"
+
+#include "../templates/hashfuncs.hpp"
+#include "./char_utils.hpp"
+#include "./float_conversion.hpp"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USTRING_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define USTRING_NEON
+#endif
+
+static const char32_t _replacement_char = 0xFFFD;
+
+/** Code units the vector loops take at once: 16 UTF-8 bytes, 8 UTF-16 units
+ *  or 16 characters when writing UTF-8, 8 when writing UTF-16. */
+#define USTRING_BLOCK_8 16
+#define USTRING_BLOCK_16 8
+
+/** Widens p_src[0, 16) to characters if all 16 bytes are ASCII (and none is a
+ *  '\r' to skip). */
+static _FORCE_INLINE_ bool _ascii_block_to_utf32(const uint8_t* p_src, char32_t* p_dst, bool p_skip_cr) {
+#if defined(USTRING_SSE2)
+    const __m128i bytes = _mm_loadu_si128((const __m128i*)p_src);
+    int reject = _mm_movemask_epi8(bytes);
+    if (p_skip_cr) {
+        reject |= _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r')));
+    }
+    if (reject) {
+        return false;
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+    const __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+    _mm_storeu_si128((__m128i*)(p_dst + 0), _mm_unpacklo_epi16(lo, zero));
+    _mm_storeu_si128((__m128i*)(p_dst + 4), _mm_unpackhi_epi16(lo, zero));
+    _mm_storeu_si128((__m128i*)(p_dst + 8), _mm_unpacklo_epi16(hi, zero));
+    _mm_storeu_si128((__m128i*)(p_dst + 12), _mm_unpackhi_epi16(hi, zero));
+    return true;
+#elif defined(USTRING_NEON)
+    const uint8x16_t bytes = vld1q_u8(p_src);
+    if (vmaxvq_u8(bytes) >= 0x80 || (p_skip_cr && vmaxvq_u8(vceqq_u8(bytes, vdupq_n_u8('\r'))))) {
+        return false;
+    }
+    const uint16x8_t lo = vmovl_u8(vget_low_u8(bytes));
+    const uint16x8_t hi = vmovl_u8(vget_high_u8(bytes));
+    vst1q_u32((uint32_t*)p_dst + 0, vmovl_u16(vget_low_u16(lo)));
+    vst1q_u32((uint32_t*)p_dst + 4, vmovl_u16(vget_high_u16(lo)));
+    vst1q_u32((uint32_t*)p_dst + 8, vmovl_u16(vget_low_u16(hi)));
+    vst1q_u32((uint32_t*)p_dst + 12, vmovl_u16(vget_high_u16(hi)));
+    return true;
+#else
+    uint8_t any = 0;
+    for (int i = 0; i < USTRING_BLOCK_8; i++) {
+        any |= p_src[i];
+        any |= (p_skip_cr && p_src[i] == '\r') ? 0x80 : 0;
+    }
+    if (any & 0x80) {
+        return false;
+    }
+    for (int i = 0; i < USTRING_BLOCK_8; i++) {
+        p_dst[i] = p_src[i];
+    }
+    return true;
+#endif
+}
+
+/** Narrows p_src[0, 16) to bytes if all 16 characters are ASCII. */
+static _FORCE_INLINE_ bool _ascii_block_from_utf32(const char32_t* p_src, uint8_t* p_dst) {
+#if defined(USTRING_SSE2)
+    const __m128i a = _mm_loadu_si128((const __m128i*)(p_src + 0));
+    const __m128i b = _mm_loadu_si128((const __m128i*)(p_src + 4));
+    const __m128i c = _mm_loadu_si128((const __m128i*)(p_src + 8));
+    const __m128i d = _mm_loadu_si128((const __m128i*)(p_src + 12));
+    const __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+    const __m128i high = _mm_and_si128(any, _mm_set1_epi32(~0x7F));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+    }
+    // Below 0x80, so neither pack saturates.
+    _mm_storeu_si128((__m128i*)p_dst, _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+    return true;
+#elif defined(USTRING_NEON)
+    const uint32x4_t a = vld1q_u32((const uint32_t*)p_src + 0);
+    const uint32x4_t b = vld1q_u32((const uint32_t*)p_src + 4);
+    const uint32x4_t c = vld1q_u32((const uint32_t*)p_src + 8);
+    const uint32x4_t d = vld1q_u32((const uint32_t*)p_src + 12);
+    if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80) {
+        return false;
+    }
+    const uint16x8_t ab = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+    const uint16x8_t cd = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+    vst1q_u8(p_dst, vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+    return true;
+#else
+    char32_t any = 0;
+    for (int i = 0; i < USTRING_BLOCK_8; i++) {
+        any |= p_src[i];
+    }
+    if (any >= 0x80) {
+        return false;
+    }
+    for (int i = 0; i < USTRING_BLOCK_8; i++) {
+        p_dst[i] = uint8_t(p_src[i]);
+    }
+    return true;
+#endif
+}
+
+/** Widens p_src[0, 8) to characters if none is a surrogate. */
+static _FORCE_INLINE_ bool _bmp_block_to_utf32(const char16_t* p_src, char32_t* p_dst) {
+#if defined(USTRING_SSE2)
+    const __m128i units = _mm_loadu_si128((const __m128i*)p_src);
+    const __m128i surrogates = _mm_cmpeq_epi16(_mm_and_si128(units, _mm_set1_epi16(short(0xF800))), _mm_set1_epi16(short(0xD800)));
+    if (_mm_movemask_epi8(surrogates)) {
+        return false;
+    }
+    const __m128i zero = _mm_setzero_si128();
+    _mm_storeu_si128((__m128i*)(p_dst + 0), _mm_unpacklo_epi16(units, zero));
+    _mm_storeu_si128((__m128i*)(p_dst + 4), _mm_unpackhi_epi16(units, zero));
+    return true;
+#elif defined(USTRING_NEON)
+    const uint16x8_t units = vld1q_u16((const uint16_t*)p_src);
+    if (vmaxvq_u16(vceqq_u16(vandq_u16(units, vdupq_n_u16(0xF800)), vdupq_n_u16(0xD800)))) {
+        return false;
+    }
+    vst1q_u32((uint32_t*)p_dst + 0, vmovl_u16(vget_low_u16(units)));
+    vst1q_u32((uint32_t*)p_dst + 4, vmovl_u16(vget_high_u16(units)));
+    return true;
+#else
+    for (int i = 0; i < USTRING_BLOCK_16; i++) {
+        if ((p_src[i] & 0xF800) == 0xD800) {
+            return false;
+        }
+    }
+    for (int i = 0; i < USTRING_BLOCK_16; i++) {
+        p_dst[i] = p_src[i];
+    }
+    return true;
+#endif
+}
+
+/** Narrows p_src[0, 8) to UTF-16 units if all are in the BMP and none is a
+ *  surrogate. */
+static _FORCE_INLINE_ bool _bmp_block_from_utf32(const char32_t* p_src, char16_t* p_dst) {
+#if defined(USTRING_SSE2)
+    const __m128i a = _mm_loadu_si128((const __m128i*)(p_src + 0));
+    const __m128i b = _mm_loadu_si128((const __m128i*)(p_src + 4));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i high_mask = _mm_set1_epi32(int(0xFFFF0000));
+    const __m128i surrogate_mask = _mm_set1_epi32(0xF800);
+    const __m128i surrogate = _mm_set1_epi32(0xD800);
+    const __m128i reject = _mm_or_si128(
+            _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(a, high_mask), zero), _mm_set1_epi32(-1)),
+                    _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(b, high_mask), zero), _mm_set1_epi32(-1))),
+            _mm_or_si128(_mm_cmpeq_epi32(_mm_and_si128(a, surrogate_mask), surrogate),
+                    _mm_cmpeq_epi32(_mm_and_si128(b, surrogate_mask), surrogate)));
+    if (_mm_movemask_epi8(reject)) {
+        return false;
+    }
+    // SSE2 only packs with signed saturation: bias into the signed range and
+    // back.
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(a, bias32), _mm_sub_epi32(b, bias32));
+    _mm_storeu_si128((__m128i*)p_dst, _mm_add_epi16(packed, _mm_set1_epi16(short(0x8000))));
+    return true;
+#elif defined(USTRING_NEON)
+    const uint32x4_t a = vld1q_u32((const uint32_t*)p_src + 0);
+    const uint32x4_t b = vld1q_u32((const uint32_t*)p_src + 4);
+    const uint32x4_t surrogate_mask = vdupq_n_u32(0xF800);
+    const uint32x4_t surrogate = vdupq_n_u32(0xD800);
+    const uint32x4_t surrogates = vorrq_u32(vceqq_u32(vandq_u32(a, surrogate_mask), surrogate), vceqq_u32(vandq_u32(b, surrogate_mask), surrogate));
+    if (vmaxvq_u32(vorrq_u32(a, b)) > 0xFFFF || vmaxvq_u32(surrogates)) {
+        return false;
+    }
+    vst1q_u16((uint16_t*)p_dst, vcombine_u16(vmovn_u32(a), vmovn_u32(b)));
+    return true;
+#else
+    for (int i = 0; i < USTRING_BLOCK_16; i++) {
+        if (p_src[i] > 0xFFFF || (p_src[i] & 0xF800) == 0xD800) {
+            return false;
+        }
+    }
+    for (int i = 0; i < USTRING_BLOCK_16; i++) {
+        p_dst[i] = char16_t(p_src[i]);
+    }
+    return true;
+#endif
+}
+
+static _FORCE_INLINE_ bool _is_valid_char(char32_t p_char) {
+    return p_char <= 0x10FFFF && (p_char & 0xFFFFF800) != 0xD800;
+}
+
+static _FORCE_INLINE_ int64_t _utf8_char_size(char32_t p_char) {
+    if (p_char < 0x80) {
+        return 1;
+    }
+    if (p_char < 0x800) {
+        return 2;
+    }
+    // Invalid characters are written as U+FFFD, also 3 bytes.
+    return (p_char < 0x10000 || p_char > 0x10FFFF) ? 3 : 4;
+}
+
+/** Bytes of the UTF-8 encoding of p_src[0, p_len). */
+static int64_t _utf8_length(const char32_t* p_src, int64_t p_len) {
+    int64_t bytes = p_len;
+    int64_t i = 0;
+#if defined(USTRING_SSE2)
+    // Unsigned compares, by flipping the sign bit of both sides. Each lane
+    // gains at most 3 per step, far from overflowing for any string that fits
+    // in memory.
+    const __m128i sign = _mm_set1_epi32(int(0x80000000));
+    const __m128i above_7f = _mm_set1_epi32(int(0x7F ^ 0x80000000));
+    const __m128i above_7ff = _mm_set1_epi32(int(0x7FF ^ 0x80000000));
+    const __m128i above_ffff = _mm_set1_epi32(int(0xFFFF ^ 0x80000000));
+    const __m128i above_max = _mm_set1_epi32(int(0x10FFFF ^ 0x80000000));
+    __m128i extra = _mm_setzero_si128();
+    for (; i + 4 <= p_len; i += 4) {
+        const __m128i c = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(p_src + i)), sign);
+        extra = _mm_sub_epi32(extra, _mm_cmpgt_epi32(c, above_7f));
+        extra = _mm_sub_epi32(extra, _mm_cmpgt_epi32(c, above_7ff));
+        extra = _mm_sub_epi32(extra, _mm_andnot_si128(_mm_cmpgt_epi32(c, above_max), _mm_cmpgt_epi32(c, above_ffff)));
+    }
+    uint32_t lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, extra);
+    bytes += int64_t(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+#elif defined(USTRING_NEON)
+    uint32x4_t extra = vdupq_n_u32(0);
+    for (; i + 4 <= p_len; i += 4) {
+        const uint32x4_t c = vld1q_u32((const uint32_t*)p_src + i);
+        extra = vsubq_u32(extra, vcgtq_u32(c, vdupq_n_u32(0x7F)));
+        extra = vsubq_u32(extra, vcgtq_u32(c, vdupq_n_u32(0x7FF)));
+        extra = vsubq_u32(extra, vandq_u32(vcgtq_u32(c, vdupq_n_u32(0xFFFF)), vcleq_u32(c, vdupq_n_u32(0x10FFFF))));
+    }
+    bytes += vaddlvq_u32(extra);
+#endif
+    for (; i < p_len; i++) {
+        bytes += _utf8_char_size(p_src[i]) - 1;
+    }
+    return bytes;
+}
+
+/** Writes p_src[0, p_len) to p_dst, sized by _utf8_length(). */
+static void _encode_utf8(const char32_t* p_src, int64_t p_len, uint8_t* p_dst) {
+    int64_t i = 0;
+    while (i < p_len) {
+        if (i + USTRING_BLOCK_8 <= p_len && _ascii_block_from_utf32(p_src + i, p_dst)) {
+            i += USTRING_BLOCK_8;
+            p_dst += USTRING_BLOCK_8;
+            continue;
+        }
+
+        // Up to the end of the block the vector test gave up on.
+        const int64_t end = MIN(p_len, i + USTRING_BLOCK_8);
+        for (; i < end; i++) {
+            char32_t c = p_src[i];
+            if (c < 0x80) {
+                *p_dst++ = uint8_t(c);
+                continue;
+            }
+            if (!_is_valid_char(c)) {
+                c = _replacement_char;
+            }
+            if (c < 0x800) {
+                *p_dst++ = uint8_t(0xC0 | (c >> 6));
+            } else if (c < 0x10000) {
+                *p_dst++ = uint8_t(0xE0 | (c >> 12));
+                *p_dst++ = uint8_t(0x80 | ((c >> 6) & 0x3F));
+            } else {
+                *p_dst++ = uint8_t(0xF0 | (c >> 18));
+                *p_dst++ = uint8_t(0x80 | ((c >> 12) & 0x3F));
+                *p_dst++ = uint8_t(0x80 | ((c >> 6) & 0x3F));
+            }
+            *p_dst++ = uint8_t(0x80 | (c & 0x3F));
+        }
+    }
+}
+
+static _FORCE_INLINE_ bool _is_continuation(uint8_t p_byte) {
+    return (p_byte & 0xC0) == 0x80;
+}
+
+/** Decodes the sequence at p_src[0]; p_len is at least 1. Returns the bytes
+ *  consumed, and sets r_valid to false for a maximal invalid subsequence,
+ *  which decodes as U+FFFD (Unicode's "substitution of maximal subparts"). */
+static _FORCE_INLINE_ int _decode_utf8_char(const uint8_t* p_src, int64_t p_len, char32_t& r_char, bool& r_valid) {
+    const uint8_t lead = p_src[0];
+    r_valid = false;
+    r_char = _replacement_char;
+
+    int size;
+    uint8_t second_min = 0x80;
+    uint8_t second_max = 0xBF;
+    char32_t c;
+    if (lead < 0x80) {
+        r_valid = true;
+        r_char = lead;
+        return 1;
+    } else if (lead < 0xC2) {
+        // Stray continuation byte, or an overlong two byte sequence.
+        return 1;
+    } else if (lead < 0xE0) {
+        size = 2;
+        c = lead & 0x1F;
+    } else if (lead < 0xF0) {
+        size = 3;
+        c = lead & 0x0F;
+        // Excludes overlong sequences, and surrogates.
+        second_min = lead == 0xE0 ? 0xA0 : 0x80;
+        second_max = lead == 0xED ? 0x9F : 0xBF;
+    } else if (lead < 0xF5) {
+        size = 4;
+        c = lead & 0x07;
+        // Excludes overlong sequences, and anything past U+10FFFF.
+        second_min = lead == 0xF0 ? 0x90 : 0x80;
+        second_max = lead == 0xF4 ? 0x8F : 0xBF;
+    } else {
+        return 1;
+    }
+
+    if (p_len < 2 || p_src[1] < second_min || p_src[1] > second_max) {
+        return 1;
+    }
+    c = (c << 6) | (p_src[1] & 0x3F);
+    for (int k = 2; k < size; k++) {
+        if (k >= p_len || !_is_continuation(p_src[k])) {
+            return k;
+        }
+        c = (c << 6) | (p_src[k] & 0x3F);
+    }
+
+    r_valid = true;
+    r_char = c;
+    return size;
+}
+
+/** Decodes p_src[0, p_len) to p_dst, which has room for p_len characters.
+ *  Returns the characters written. */
+static int64_t _decode_utf8(const uint8_t* p_src, int64_t p_len, char32_t* p_dst, bool p_skip_cr, bool& r_valid) {
+    char32_t* dst = p_dst;
+    int64_t i = 0;
+    r_valid = true;
+    while (i < p_len) {
+        if (i + USTRING_BLOCK_8 <= p_len && _ascii_block_to_utf32(p_src + i, dst, p_skip_cr)) {
+            i += USTRING_BLOCK_8;
+            dst += USTRING_BLOCK_8;
+            continue;
+        }
+
+        // Through the block the vector test gave up on. A sequence may cross
+        // its end, so the next block starts wherever that sequence ends.
+        const int64_t end = MIN(p_len, i + USTRING_BLOCK_8);
+        while (i < end) {
+            if (p_src[i] < 0x80) {
+                if (!(p_skip_cr && p_src[i] == '\r')) {
+                    *dst++ = p_src[i];
+                }
+                i++;
+                continue;
+            }
+            bool valid;
+            i += _decode_utf8_char(p_src + i, p_len - i, *dst++, valid);
+            r_valid = r_valid && valid;
+        }
+    }
+    return dst - p_dst;
+}
+
+/** Units of the UTF-16 encoding of p_src[0, p_len). */
+static int64_t _utf16_length(const char32_t* p_src, int64_t p_len) {
+    int64_t units = p_len;
+    int64_t i = 0;
+#if defined(USTRING_SSE2)
+    const __m128i sign = _mm_set1_epi32(int(0x80000000));
+    const __m128i above_ffff = _mm_set1_epi32(int(0xFFFF ^ 0x80000000));
+    const __m128i above_max = _mm_set1_epi32(int(0x10FFFF ^ 0x80000000));
+    __m128i extra = _mm_setzero_si128();
+    for (; i + 4 <= p_len; i += 4) {
+        const __m128i c = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(p_src + i)), sign);
+        extra = _mm_sub_epi32(extra, _mm_andnot_si128(_mm_cmpgt_epi32(c, above_max), _mm_cmpgt_epi32(c, above_ffff)));
+    }
+    uint32_t lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, extra);
+    units += int64_t(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+#elif defined(USTRING_NEON)
+    uint32x4_t extra = vdupq_n_u32(0);
+    for (; i + 4 <= p_len; i += 4) {
+        const uint32x4_t c = vld1q_u32((const uint32_t*)p_src + i);
+        extra = vsubq_u32(extra, vandq_u32(vcgtq_u32(c, vdupq_n_u32(0xFFFF)), vcleq_u32(c, vdupq_n_u32(0x10FFFF))));
+    }
+    units += vaddlvq_u32(extra);
+#endif
+    for (; i < p_len; i++) {
+        units += (p_src[i] > 0xFFFF && p_src[i] <= 0x10FFFF) ? 1 : 0;
+    }
+    return units;
+}
+
+static void _encode_utf16(const char32_t* p_src, int64_t p_len, char16_t* p_dst) {
+    int64_t i = 0;
+    while (i < p_len) {
+        if (i + USTRING_BLOCK_16 <= p_len && _bmp_block_from_utf32(p_src + i, p_dst)) {
+            i += USTRING_BLOCK_16;
+            p_dst += USTRING_BLOCK_16;
+            continue;
+        }
+
+        const int64_t end = MIN(p_len, i + USTRING_BLOCK_16);
+        for (; i < end; i++) {
+            char32_t c = p_src[i];
+            if (!_is_valid_char(c)) {
+                c = _replacement_char;
+            }
+            if (c < 0x10000) {
+                *p_dst++ = char16_t(c);
+            } else {
+                c -= 0x10000;
+                *p_dst++ = char16_t(0xD800 | (c >> 10));
+                *p_dst++ = char16_t(0xDC00 | (c & 0x3FF));
+            }
+        }
+    }
+}
+
+/** Decodes p_src[0, p_len) to p_dst, which has room for p_len characters.
+ *  Unpaired surrogates decode as U+FFFD. Returns the characters written. */
+static int64_t _decode_utf16(const char16_t* p_src, int64_t p_len, char32_t* p_dst, bool& r_valid) {
+    char32_t* dst = p_dst;
+    int64_t i = 0;
+    r_valid = true;
+    while (i < p_len) {
+        if (i + USTRING_BLOCK_16 <= p_len && _bmp_block_to_utf32(p_src + i, dst)) {
+            i += USTRING_BLOCK_16;
+            dst += USTRING_BLOCK_16;
+            continue;
+        }
+
+        const int64_t end = MIN(p_len, i + USTRING_BLOCK_16);
+        while (i < end) {
+            const char16_t unit = p_src[i++];
+            if ((unit & 0xF800) != 0xD800) {
+                *dst++ = unit;
+            } else if (unit < 0xDC00 && i < p_len && (p_src[i] & 0xFC00) == 0xDC00) {
+                *dst++ = 0x10000 + ((char32_t(unit) - 0xD800) << 10) + (char32_t(p_src[i]) - 0xDC00);
+                i++;
+            } else {
+                *dst++ = _replacement_char;
+                r_valid = false;
+            }
+        }
+    }
+    return dst - p_dst;
+}
+
+/** Search. Candidates are the positions where the first and the last
+ *  character of the needle both match, checked USTRING_SEARCH_BLOCK at a
+ *  time; only those are compared in full. Two compares per position keep the
+ *  candidates rare even for needles starting with a common character. */
+#define USTRING_SEARCH_BLOCK 8
+
+static _FORCE_INLINE_ uint32_t _ctz32(uint32_t p_mask) {
+#if defined(__GNUC__)
+    return __builtin_ctz(p_mask);
+#else
+    uint32_t n = 0;
+    while (!(p_mask & 1)) {
+        p_mask >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+static _FORCE_INLINE_ uint32_t _highest_bit32(uint32_t p_mask) {
+#if defined(__GNUC__)
+    return 31 - __builtin_clz(p_mask);
+#else
+    uint32_t n = 31;
+    while (!(p_mask & 0x80000000u)) {
+        p_mask <<= 1;
+        n--;
+    }
+    return n;
+#endif
+}
+
+/** Bit i set when p_first[i] is p_a and p_last[i] is p_b, for 8 positions. */
+static _FORCE_INLINE_ uint32_t _candidates(const char32_t* p_first, const char32_t* p_last, char32_t p_a, char32_t p_b) {
+#if defined(USTRING_SSE2)
+    const __m128i a = _mm_set1_epi32(int(p_a));
+    const __m128i b = _mm_set1_epi32(int(p_b));
+    const __m128i lo = _mm_and_si128(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)p_first), a), _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)p_last), b));
+    const __m128i hi = _mm_and_si128(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(p_first + 4)), a), _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(p_last + 4)), b));
+    return uint32_t(_mm_movemask_ps(_mm_castsi128_ps(lo))) | (uint32_t(_mm_movemask_ps(_mm_castsi128_ps(hi))) << 4);
+#elif defined(USTRING_NEON)
+    static const uint32_t bits[4] = { 1, 2, 4, 8 };
+    const uint32x4_t a = vdupq_n_u32(p_a);
+    const uint32x4_t b = vdupq_n_u32(p_b);
+    const uint32x4_t weights = vld1q_u32(bits);
+    const uint32x4_t lo = vandq_u32(vceqq_u32(vld1q_u32((const uint32_t*)p_first), a), vceqq_u32(vld1q_u32((const uint32_t*)p_last), b));
+    const uint32x4_t hi = vandq_u32(vceqq_u32(vld1q_u32((const uint32_t*)p_first + 4), a), vceqq_u32(vld1q_u32((const uint32_t*)p_last + 4), b));
+    return vaddvq_u32(vandq_u32(lo, weights)) | (vaddvq_u32(vandq_u32(hi, weights)) << 4);
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < USTRING_SEARCH_BLOCK; i++) {
+        mask |= uint32_t(p_first[i] == p_a && p_last[i] == p_b) << i;
+    }
+    return mask;
+#endif
+}
+
+/** Bit i set when p_src[i] may fold to p_lower, for 8 positions: ASCII
+ *  characters that do, and every other one, left to the full compare. */
+static _FORCE_INLINE_ uint32_t _candidates_nocase(const char32_t* p_src, char32_t p_lower) {
+    // Setting 0x20 folds upper case ASCII letters onto lower case ones, and
+    // would fold other characters onto letters, so only letters get it.
+    const char32_t fold = is_ascii_alphabet_char(p_lower) ? 0x20 : 0;
+#if defined(USTRING_SSE2)
+    const __m128i f = _mm_set1_epi32(int(fold));
+    const __m128i c = _mm_set1_epi32(int(p_lower));
+    const __m128i high = _mm_set1_epi32(~0x7F);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i a = _mm_loadu_si128((const __m128i*)p_src);
+    const __m128i b = _mm_loadu_si128((const __m128i*)(p_src + 4));
+    // Equal, or not ASCII: "high bits zero" inverted by the xor with all ones.
+    const __m128i lo = _mm_or_si128(_mm_cmpeq_epi32(_mm_or_si128(a, f), c), _mm_xor_si128(_mm_cmpeq_epi32(_mm_and_si128(a, high), zero), _mm_cmpeq_epi32(zero, zero)));
+    const __m128i hi = _mm_or_si128(_mm_cmpeq_epi32(_mm_or_si128(b, f), c), _mm_xor_si128(_mm_cmpeq_epi32(_mm_and_si128(b, high), zero), _mm_cmpeq_epi32(zero, zero)));
+    return uint32_t(_mm_movemask_ps(_mm_castsi128_ps(lo))) | (uint32_t(_mm_movemask_ps(_mm_castsi128_ps(hi))) << 4);
+#elif defined(USTRING_NEON)
+    static const uint32_t bits[4] = { 1, 2, 4, 8 };
+    const uint32x4_t f = vdupq_n_u32(fold);
+    const uint32x4_t c = vdupq_n_u32(p_lower);
+    const uint32x4_t ascii_end = vdupq_n_u32(0x80);
+    const uint32x4_t weights = vld1q_u32(bits);
+    const uint32x4_t a = vld1q_u32((const uint32_t*)p_src);
+    const uint32x4_t b = vld1q_u32((const uint32_t*)p_src + 4);
+    const uint32x4_t lo = vorrq_u32(vceqq_u32(vorrq_u32(a, f), c), vcgeq_u32(a, ascii_end));
+    const uint32x4_t hi = vorrq_u32(vceqq_u32(vorrq_u32(b, f), c), vcgeq_u32(b, ascii_end));
+    return vaddvq_u32(vandq_u32(lo, weights)) | (vaddvq_u32(vandq_u32(hi, weights)) << 4);
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < USTRING_SEARCH_BLOCK; i++) {
+        mask |= uint32_t(p_src[i] >= 0x80 || (p_src[i] | fold) == p_lower) << i;
+    }
+    return mask;
+#endif
+}
+
+/** Whether p_src[1, p_len - 1) matches p_needle; the ends already did. */
+static _FORCE_INLINE_ bool _matches_inside(const char32_t* p_src, const char32_t* p_needle, int64_t p_len) {
+    return p_len <= 2 || memcmp(p_src + 1, p_needle + 1, (p_len - 2) * sizeof(char32_t)) == 0;
+}
+
+/** p_needle_lower is lower case already. */
+static _FORCE_INLINE_ bool _matches_nocase(const char32_t* p_src, const char32_t* p_needle_lower, int64_t p_len) {
+    for (int64_t i = 0; i < p_len; i++) {
+        if (unicode_to_lower(p_src[i]) != p_needle_lower[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** First position in [p_from, p_last] where p_needle starts in p_src, or -1.
+ *  p_last + p_needle_len can't pass the end of p_src. */
+static int64_t _find(const char32_t* p_src, int64_t p_from, int64_t p_last, const char32_t* p_needle, int64_t p_needle_len) {
+    const char32_t first = p_needle[0];
+    const char32_t last = p_needle[p_needle_len - 1];
+    int64_t i = p_from;
+    for (; i + USTRING_SEARCH_BLOCK - 1 <= p_last; i += USTRING_SEARCH_BLOCK) {
+        uint32_t mask = _candidates(p_src + i, p_src + i + p_needle_len - 1, first, last);
+        while (mask) {
+            const int64_t pos = i + _ctz32(mask);
+            if (_matches_inside(p_src + pos, p_needle, p_needle_len)) {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+    for (; i <= p_last; i++) {
+        if (p_src[i] == first && p_src[i + p_needle_len - 1] == last && _matches_inside(p_src + i, p_needle, p_needle_len)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/** Last position in [0, p_last] where p_needle starts in p_src, or -1. */
+static int64_t _rfind(const char32_t* p_src, int64_t p_last, const char32_t* p_needle, int64_t p_needle_len) {
+    const char32_t first = p_needle[0];
+    const char32_t last = p_needle[p_needle_len - 1];
+    int64_t i = p_last;
+    for (; i - (USTRING_SEARCH_BLOCK - 1) >= 0; i -= USTRING_SEARCH_BLOCK) {
+        const int64_t block = i - (USTRING_SEARCH_BLOCK - 1);
+        uint32_t mask = _candidates(p_src + block, p_src + block + p_needle_len - 1, first, last);
+        while (mask) {
+            const uint32_t bit = _highest_bit32(mask);
+            if (_matches_inside(p_src + block + bit, p_needle, p_needle_len)) {
+                return block + bit;
+            }
+            mask &= ~(uint32_t(1) << bit);
+        }
+    }
+    for (; i >= 0; i--) {
+        if (p_src[i] == first && p_src[i + p_needle_len - 1] == last && _matches_inside(p_src + i, p_needle, p_needle_len)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/** _find() ignoring case, for a lower case p_needle_lower. Filters on the
+ *  first character only: the last one may fold from anything. */
+static int64_t _findn(const char32_t* p_src, int64_t p_from, int64_t p_last, const char32_t* p_needle_lower, int64_t p_needle_len) {
+    int64_t i = p_from;
+    for (; i + USTRING_SEARCH_BLOCK - 1 <= p_last; i += USTRING_SEARCH_BLOCK) {
+        uint32_t mask = _candidates_nocase(p_src + i, p_needle_lower[0]);
+        while (mask) {
+            const int64_t pos = i + _ctz32(mask);
+            if (_matches_nocase(p_src + pos, p_needle_lower, p_needle_len)) {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+    for (; i <= p_last; i++) {
+        if (_matches_nocase(p_src + i, p_needle_lower, p_needle_len)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void String::_release() {
+    if (!_is_small()) {
+        _cowdata().~CowData<char32_t>();
+    }
+}
+
+void String::_copy_from(const String& p_other) {
+    if (p_other._is_small()) {
+        memcpy(_small, p_other._small, sizeof(_small));
+    } else {
+        new (_small) CowData<char32_t>(p_other._cowdata());
+        _small[SMALL_CAPACITY] = HEAP_TAG;
+    }
+}
+
+void String::_move_from(String& p_other) {
+    // A CowData is only its pointer, so moving the bytes moves the reference.
+    memcpy(_small, p_other._small, sizeof(_small));
+    p_other._set_small_empty();
+}
+
+void String::_copy_from(const char* p_latin1, int64_t p_length) {
+    _set_small_empty();
+    if (!p_latin1 || p_length <= 0) {
+        return;
+    }
+    resize(p_length + 1);
+    char32_t* dst = ptrw();
+    for (int64_t i = 0; i < p_length; i++) {
+        dst[i] = uint8_t(p_latin1[i]);
+    }
+}
+
+void String::_copy_from(const char32_t* p_chars, int64_t p_length) {
+    _set_small_empty();
+    if (!p_chars || p_length <= 0) {
+        return;
+    }
+    resize(p_length + 1);
+    memcpy(ptrw(), p_chars, p_length * sizeof(char32_t));
+}
+
+Errors String::resize(int64_t p_size) {
+    ERROR_FAIL_COND_V(p_size < 0, Errors::ERROR_INVALID_PARAMETER);
+
+    const int64_t old_length = length();
+    const int64_t new_length = p_size > 0 ? p_size - 1 : 0;
+    if (new_length == old_length) {
+        return Errors::NONE;
+    }
+
+    if (new_length <= SMALL_CAPACITY) {
+        if (!_is_small()) {
+            char32_t chars[SMALL_CAPACITY];
+            memcpy(chars, _cowdata().ptr(), new_length * sizeof(char32_t));
+            _cowdata().~CowData<char32_t>();
+            memcpy(_small, chars, new_length * sizeof(char32_t));
+        } else if (new_length > old_length) {
+            memset(_small + old_length, 0, (new_length - old_length) * sizeof(char32_t));
+        }
+        _small[new_length] = 0;
+        // Same slot as the terminator when new_length == SMALL_CAPACITY.
+        _small[SMALL_CAPACITY] = char32_t(SMALL_CAPACITY - new_length);
+        return Errors::NONE;
+    }
+
+    if (_is_small()) {
+        char32_t chars[SMALL_CAPACITY];
+        memcpy(chars, _small, old_length * sizeof(char32_t));
+        CowData<char32_t> cowdata;
+        const Errors err = cowdata.resize<true>(p_size);
+        ERROR_FAIL_COND_V(err != Errors::NONE, err);
+        memcpy(cowdata.ptrw(), chars, old_length * sizeof(char32_t));
+        new (_small) CowData<char32_t>(std::move(cowdata));
+        _small[SMALL_CAPACITY] = HEAP_TAG;
+    } else {
+        const Errors err = _cowdata().resize<true>(p_size);
+        ERROR_FAIL_COND_V(err != Errors::NONE, err);
+    }
+    _cowdata().ptrw()[new_length] = 0;
+    return Errors::NONE;
+}
+
+String String::substr(int64_t p_from, int64_t p_chars) const {
+    const int64_t len = length();
+    if (p_chars == -1) {
+        p_chars = len - p_from;
+    }
+    if (p_from < 0 || p_from >= len || p_chars <= 0) {
+        return String();
+    }
+    if (p_from == 0 && p_chars >= len) {
+        return *this;
+    }
+    return String(ptr() + p_from, MIN(p_chars, len - p_from));
+}
+
+int64_t String::find(const String& p_str, int64_t p_from) const {
+    const int64_t len = length();
+    const int64_t needle_len = p_str.length();
+    if (p_from < 0 || needle_len == 0 || p_from > len - needle_len) {
+        return -1;
+    }
+    return _find(ptr(), p_from, len - needle_len, p_str.ptr(), needle_len);
+}
+
+int64_t String::findn(const String& p_str, int64_t p_from) const {
+    const int64_t len = length();
+    const int64_t needle_len = p_str.length();
+    if (p_from < 0 || needle_len == 0 || p_from > len - needle_len) {
+        return -1;
+    }
+    String needle_lower = p_str;
+    char32_t* lower = needle_lower.ptrw();
+    for (int64_t i = 0; i < needle_len; i++) {
+        lower[i] = unicode_to_lower(lower[i]);
+    }
+    return _findn(ptr(), p_from, len - needle_len, needle_lower.ptr(), needle_len);
+}
+
+int64_t String::rfind(const String& p_str, int64_t p_from) const {
+    const int64_t len = length();
+    const int64_t needle_len = p_str.length();
+    if (needle_len == 0 || needle_len > len) {
+        return -1;
+    }
+    const int64_t last = p_from < 0 ? len - needle_len : MIN(p_from, len - needle_len);
+    return _rfind(ptr(), last, p_str.ptr(), needle_len);
+}
+
+int64_t String::count(const String& p_str, int64_t p_from, int64_t p_to) const {
+    const int64_t len = length();
+    const int64_t needle_len = p_str.length();
+    const int64_t to = p_to == 0 ? len : MIN(p_to, len);
+    if (p_from < 0 || p_to < 0 || needle_len == 0 || p_from > to - needle_len) {
+        return 0;
+    }
+
+    const char32_t* src = ptr();
+    const int64_t last = to - needle_len;
+    int64_t found = 0;
+    for (int64_t pos = _find(src, p_from, last, p_str.ptr(), needle_len); pos >= 0; pos = _find(src, pos, last, p_str.ptr(), needle_len)) {
+        found++;
+        pos += needle_len;
+    }
+    return found;
+}
+
+String String::replace(const String& p_key, const String& p_with) const {
+    const int64_t len = length();
+    const int64_t key_len = p_key.length();
+    const int64_t found = count(p_key);
+    if (found == 0) {
+        return *this;
+    }
+
+    // Sized once from the count, then filled between the matches.
+    const int64_t with_len = p_with.length();
+    const int64_t new_len = len + found * (with_len - key_len);
+    String result;
+    if (new_len == 0) {
+        return result;
+    }
+    result.resize(new_len + 1);
+
+    const char32_t* src = ptr();
+    char32_t* dst = result.ptrw();
+    int64_t from = 0;
+    for (int64_t i = 0; i < found; i++) {
+        const int64_t pos = _find(src, from, len - key_len, p_key.ptr(), key_len);
+        memcpy(dst, src + from, (pos - from) * sizeof(char32_t));
+        dst += pos - from;
+        memcpy(dst, p_with.ptr(), with_len * sizeof(char32_t));
+        dst += with_len;
+        from = pos + key_len;
+    }
+    memcpy(dst, src + from, (len - from) * sizeof(char32_t));
+    return result;
+}
+
+String& String::operator+=(const String& p_str) {
+    if (&p_str == this) {
+        const String copy = p_str;
+        return operator+=(copy);
+    }
+
+    const int64_t len = length();
+    const int64_t add = p_str.length();
+    if (add == 0) {
+        return *this;
+    }
+    resize(len + add + 1);
+    memcpy(ptrw() + len, p_str.ptr(), add * sizeof(char32_t));
+    return *this;
+}
+
+String& String::operator+=(const char* p_str) {
+    if (!p_str || !*p_str) {
+        return *this;
+    }
+
+    const int64_t len = length();
+    const int64_t add = strlen(p_str);
+    resize(len + add + 1);
+    char32_t* dst = ptrw() + len;
+    for (int64_t i = 0; i < add; i++) {
+        dst[i] = uint8_t(p_str[i]);
+    }
+    return *this;
+}
+
+String& String::operator+=(char32_t p_char) {
+    const int64_t len = length();
+    resize(len + 2);
+    ptrw()[len] = p_char;
+    return *this;
+}
+
+String String::operator+(const String& p_str) const {
+    String result = *this;
+    result += p_str;
+    return result;
+}
+
+String String::operator+(char32_t p_char) const {
+    String result = *this;
+    result += p_char;
+    return result;
+}
+
+String operator+(const char* p_left, const String& p_right) {
+    String result(p_left);
+    result += p_right;
+    return result;
+}
+
+bool String::operator==(const String& p_str) const {
+    const int64_t len = length();
+    if (len != p_str.length()) {
+        return false;
+    }
+    if (!_is_small() && !p_str._is_small() && _cowdata().ptr() == p_str._cowdata().ptr()) {
+        return true;
+    }
+    return memcmp(ptr(), p_str.ptr(), len * sizeof(char32_t)) == 0;
+}
+
+bool String::operator==(const char* p_str) const {
+    if (!p_str) {
+        return is_empty();
+    }
+    const char32_t* chars = ptr();
+    int64_t i = 0;
+    for (; chars[i] && p_str[i]; i++) {
+        if (chars[i] != char32_t(uint8_t(p_str[i]))) {
+            return false;
+        }
+    }
+    return !chars[i] && !p_str[i];
+}
+
+bool String::operator==(const char32_t* p_str) const {
+    if (!p_str) {
+        return is_empty();
+    }
+    const char32_t* chars = ptr();
+    int64_t i = 0;
+    for (; chars[i] && p_str[i]; i++) {
+        if (chars[i] != p_str[i]) {
+            return false;
+        }
+    }
+    return !chars[i] && !p_str[i];
+}
+
+bool String::operator<(const String& p_str) const {
+    const char32_t* a = ptr();
+    const char32_t* b = p_str.ptr();
+    while (*a && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a < *b;
+}
+
+uint32_t String::hash() const {
+    return hash_fold_64_32(hash_bytes_64(ptr(), length() * sizeof(char32_t)));
+}
+
+CharString String::ascii() const {
+    CharString result;
+    const int64_t len = length();
+    if (len == 0) {
+        return result;
+    }
+
+    result.resize(len + 1);
+    char* dst = result.ptrw();
+    const char32_t* src = ptr();
+    for (int64_t i = 0; i < len; i++) {
+        dst[i] = src[i] <= 0xFF ? char(src[i]) : '?';
+    }
+    dst[len] = 0;
+    return result;
+}
+
+CharString String::utf8() const {
+    CharString result;
+    const int64_t len = length();
+    if (len == 0) {
+        return result;
+    }
+
+    const char32_t* src = ptr();
+    const int64_t bytes = _utf8_length(src, len);
+    const Errors err = result.resize(bytes + 1);
+    ERROR_FAIL_COND_V(err != Errors::NONE, result);
+    char* dst = result.ptrw();
+    _encode_utf8(src, len, (uint8_t*)dst);
+    dst[bytes] = 0;
+    return result;
+}
+
+Errors String::parse_utf8(const char* p_utf8, int64_t p_len, bool p_skip_cr) {
+    clear();
+    if (!p_utf8) {
+        return Errors::NONE;
+    }
+    if (p_len < 0) {
+        p_len = strlen(p_utf8);
+    }
+
+    const uint8_t* src = (const uint8_t*)p_utf8;
+    if (p_len >= 3 && src[0] == 0xEF && src[1] == 0xBB && src[2] == 0xBF) {
+        src += 3;
+        p_len -= 3;
+    }
+    if (p_len == 0) {
+        return Errors::NONE;
+    }
+
+    // Never more characters than bytes; trimmed to the decoded length after.
+    const Errors err = resize(p_len + 1);
+    ERROR_FAIL_COND_V(err != Errors::NONE, err);
+    bool valid;
+    const int64_t written = _decode_utf8(src, p_len, ptrw(), p_skip_cr, valid);
+    resize(written + 1);
+    return valid ? Errors::NONE : Errors::ERROR_INVALID_DATA;
+}
+
+String String::utf8(const char* p_utf8, int64_t p_len) {
+    String result;
+    result.parse_utf8(p_utf8, p_len);
+    return result;
+}
+
+int64_t String::decode_utf8(const char* p_utf8, int64_t p_len, char32_t* r_chars, bool p_skip_cr, Errors* r_error) {
+    bool valid;
+    const int64_t written = _decode_utf8((const uint8_t*)p_utf8, p_len, r_chars, p_skip_cr, valid);
+    if (r_error) {
+        *r_error = valid ? Errors::NONE : Errors::ERROR_INVALID_DATA;
+    }
+    return written;
+}
+
+Char16String String::utf16() const {
+    Char16String result;
+    const int64_t len = length();
+    if (len == 0) {
+        return result;
+    }
+
+    const char32_t* src = ptr();
+    const int64_t units = _utf16_length(src, len);
+    const Errors err = result.resize(units + 1);
+    ERROR_FAIL_COND_V(err != Errors::NONE, result);
+    char16_t* dst = result.ptrw();
+    _encode_utf16(src, len, dst);
+    dst[units] = 0;
+    return result;
+}
+
+Errors String::parse_utf16(const char16_t* p_utf16, int64_t p_len) {
+    clear();
+    if (!p_utf16) {
+        return Errors::NONE;
+    }
+    if (p_len < 0) {
+        p_len = 0;
+        while (p_utf16[p_len]) {
+            p_len++;
+        }
+    }
+
+    if (p_len > 0 && p_utf16[0] == 0xFEFF) {
+        p_utf16++;
+        p_len--;
+    }
+    if (p_len == 0) {
+        return Errors::NONE;
+    }
+
+    const Errors err = resize(p_len + 1);
+    ERROR_FAIL_COND_V(err != Errors::NONE, err);
+    bool valid;
+    const int64_t written = _decode_utf16(p_utf16, p_len, ptrw(), valid);
+    resize(written + 1);
+    return valid ? Errors::NONE : Errors::ERROR_INVALID_DATA;
+}
+
+String String::utf16(const char16_t* p_utf16, int64_t p_len) {
+    String result;
+    result.parse_utf16(p_utf16, p_len);
+    return result;
+}
+
+String String::num(double p_num, int p_decimals) {
+    if (p_decimals < 0) {
+        char buffer[FloatConversion::SHORTEST_BUFFER_SIZE];
+        return String(buffer, FloatConversion::format_shortest(p_num, buffer));
+    }
+    char buffer[FloatConversion::FIXED_BUFFER_SIZE];
+    return String(buffer, FloatConversion::format_fixed(p_num, p_decimals, buffer));
+}
+
+/** Appends ".0" to p_len characters of a shortest form that read as an
+ *  integer. p_buffer has room for it. */
+static int64_t _add_real_trailing(char* p_buffer, int64_t p_len) {
+    for (int64_t i = 0; i < p_len; i++) {
+        if (p_buffer[i] == '.' || p_buffer[i] == 'e' || p_buffer[i] == 'n') {
+            return p_len;
+        }
+    }
+    p_buffer[p_len] = '.';
+    p_buffer[p_len + 1] = '0';
+    return p_len + 2;
+}
+
+String String::num_real(double p_num, bool p_trailing) {
+    char buffer[FloatConversion::SHORTEST_BUFFER_SIZE + 2];
+    int64_t len = FloatConversion::format_shortest(p_num, buffer);
+    if (p_trailing) {
+        len = _add_real_trailing(buffer, len);
+    }
+    return String(buffer, len);
+}
+
+String String::num_real(float p_num, bool p_trailing) {
+    char buffer[FloatConversion::SHORTEST_BUFFER_SIZE + 2];
+    int64_t len = FloatConversion::format_shortest(p_num, buffer);
+    if (p_trailing) {
+        len = _add_real_trailing(buffer, len);
+    }
+    return String(buffer, len);
+}
+
+/** Writes p_num in p_base so that it ends at r_end, returning its start. */
+static char* _write_uint64(uint64_t p_num, int p_base, bool p_capitalize_hex, char* r_end) {
+    const char a = p_capitalize_hex ? 'A' : 'a';
+    char* out = r_end;
+    do {
+        const uint32_t digit = uint32_t(p_num % p_base);
+        *--out = char(digit < 10 ? '0' + digit : a + digit - 10);
+        p_num /= p_base;
+    } while (p_num);
+    return out;
+}
+
+String String::num_int64(int64_t p_num, int p_base, bool p_capitalize_hex) {
+    ERROR_FAIL_COND_V_MSG(p_base < 2 || p_base > 36, String(), "Base must be between 2 and 36.");
+    // Sign and 64 binary digits.
+    char buffer[65];
+    char* end = buffer + sizeof(buffer);
+    const uint64_t magnitude = p_num < 0 ? 0 - uint64_t(p_num) : uint64_t(p_num);
+    char* start = _write_uint64(magnitude, p_base, p_capitalize_hex, end);
+    if (p_num < 0) {
+        *--start = '-';
+    }
+    return String(start, end - start);
+}
+
+String String::num_uint64(uint64_t p_num, int p_base, bool p_capitalize_hex) {
+    ERROR_FAIL_COND_V_MSG(p_base < 2 || p_base > 36, String(), "Base must be between 2 and 36.");
+    char buffer[64];
+    char* end = buffer + sizeof(buffer);
+    char* start = _write_uint64(p_num, p_base, p_capitalize_hex, end);
+    return String(start, end - start);
+}
+
+double String::to_float() const {
+    return FloatConversion::parse(get_data());
+}
+
+double String::to_float(const char* p_str, const char** r_end) {
+    return FloatConversion::parse(p_str, r_end);
+}
+
+double String::to_float(const char32_t* p_str, const char32_t** r_end) {
+    return FloatConversion::parse(p_str, r_end);
+}
+
+template <typename C>
+static int64_t _to_int(const C* p_str, int64_t p_len) {
+    if (!p_str) {
+        return 0;
+    }
+    // Without a length, stops at the terminator, which is no digit.
+    const C* end = p_len < 0 ? nullptr : p_str + p_len;
+    const C* src = p_str;
+    while ((!end || src < end) && (*src == ' ' || (*src >= '\t' && *src <= '\r'))) {
+        src++;
+    }
+    bool negative = false;
+    if ((!end || src < end) && (*src == '-' || *src == '+')) {
+        negative = *src == '-';
+        src++;
+    }
+
+    const uint64_t limit = negative ? uint64_t(INT64_MAX) + 1 : uint64_t(INT64_MAX);
+    uint64_t value = 0;
+    for (; (!end || src < end) && *src >= '0' && *src <= '9'; src++) {
+        const uint32_t digit = uint32_t(*src - '0');
+        ERROR_FAIL_COND_V_MSG(value > (limit - digit) / 10, negative ? INT64_MIN : INT64_MAX,
+                "Cannot represent the number as a 64-bit signed integer, it's too large.");
+        value = value * 10 + digit;
+    }
+    return negative ? int64_t(0 - value) : int64_t(value);
+}
+
+int64_t String::to_int() const {
+    return _to_int(get_data(), length());
+}
+
+int64_t String::to_int(const char* p_str, int64_t p_len) {
+    return _to_int(p_str, p_len);
+}
+
+int64_t String::to_int(const char32_t* p_str, int64_t p_len) {
+    return _to_int(p_str, p_len);
+}
+
+void String::operator=(const String& p_str) {
+    if (this == &p_str) {
+        return;
+    }
+    _release();
+    _copy_from(p_str);
+}
+
+void String::operator=(String&& p_str) {
+    if (this == &p_str) {
+        return;
+    }
+    _release();
+    _move_from(p_str);
+}
+
+void String::operator=(const char* p_str) {
+    // p_str may point into this string.
+    String copy(p_str);
+    _release();
+    _move_from(copy);
+}
+
+void String::operator=(const char32_t* p_str) {
+    String copy(p_str);
+    _release();
+    _move_from(copy);
+}
+
+String::String(const char* p_str) {
+    _copy_from(p_str, p_str ? int64_t(strlen(p_str)) : 0);
+}
+
+String::String(const char* p_str, int64_t p_length) {
+    _copy_from(p_str, p_length);
+}
+
+String::String(const char32_t* p_str) {
+    int64_t len = 0;
+    while (p_str && p_str[len]) {
+        len++;
+    }
+    _copy_from(p_str, len);
+}
+
+String::String(const char32_t* p_str, int64_t p_length) {
+    _copy_from(p_str, p_length);
+}
@@ -1,4 +1,251 @@
 #ifndef __USTRING_HPP__
 #define __USTRING_HPP__
 
+#include "../error/error_list.hpp"
+#include "../error/error_macros.hpp"
+#include "../templates/cowdata.hpp"
+#include "../typedefs.hpp"
+
+#include <stdint.h>
+#include <type_traits>
+
+using NS_Error::Errors;
+
+/** Null terminated copy-on-write array of code units, as returned by the
+ *  String conversions. size() counts the terminator, length() doesn't. */
+template <typename T>
+class CharStringBase {
+protected:
+    CowData<T> _cowdata;
+    static constexpr T _null = 0;
+
+    void _copy_from(const T* p_cstr, int64_t p_length);
+
+public:
+    _FORCE_INLINE_ T* ptrw() { return _cowdata.ptrw(); }
+    _FORCE_INLINE_ const T* ptr() const { return _cowdata.ptr(); }
+    _FORCE_INLINE_ int64_t size() const { return _cowdata.size(); }
+    _FORCE_INLINE_ int64_t length() const { return size() ? size() - 1 : 0; }
+    _FORCE_INLINE_ bool is_empty() const { return length() == 0; }
+    _FORCE_INLINE_ const T* get_data() const { return size() ? ptr() : &_null; }
+    Errors resize(int64_t p_size) { return _cowdata.resize(p_size); }
+
+    _FORCE_INLINE_ T get(int64_t p_index) const { return _cowdata.get(p_index); }
+    _FORCE_INLINE_ void set(int64_t p_index, const T& p_elem) { _cowdata.set(p_index, p_elem); }
+    _FORCE_INLINE_ const T& operator[](int64_t p_index) const {
+        if (unlikely(p_index == _cowdata.size())) {
+            return _null;
+        }
+        return _cowdata.get(p_index);
+    }
+
+    bool operator==(const CharStringBase& p_other) const;
+    _FORCE_INLINE_ bool operator!=(const CharStringBase& p_other) const { return !operator==(p_other); }
+    bool operator<(const CharStringBase& p_other) const;
+};
+
+class CharString : public CharStringBase<char> {
+public:
+    _FORCE_INLINE_ CharString() {}
+    CharString(const char* p_cstr) { _copy_from(p_cstr, p_cstr ? int64_t(strlen(p_cstr)) : 0); }
+    CharString(const char* p_cstr, int64_t p_length) { _copy_from(p_cstr, p_length); }
+};
+
+class Char16String : public CharStringBase<char16_t> {
+public:
+    _FORCE_INLINE_ Char16String() {}
+    Char16String(const char16_t* p_cstr, int64_t p_length) { _copy_from(p_cstr, p_length); }
+};
+
+/** Unicode string, stored as UTF-32.
+ *
+ *  Strings of up to SMALL_CAPACITY characters, most names and keys, are kept
+ *  inline and never allocate. Longer ones live in a CowData shared between
+ *  copies until one of them is modified.
+ *
+ *  Conversions from and to UTF-8 and UTF-16 validate and transcode runs of
+ *  ASCII (and for UTF-16, of the Basic Multilingual Plane) a vector register
+ *  at a time, and fall back to a scalar decoder for everything else. Invalid
+ *  input is decoded with one U+FFFD per maximal invalid subsequence, and
+ *  reported through the returned error.
+ */
+class String {
+    enum {
+        /** Characters stored without allocating. */
+        SMALL_CAPACITY = 7,
+    };
+
+    /** Last inline slot of a heap string. Can't be a small string's, that
+     *  holds SMALL_CAPACITY - length, so it doubles as the terminator once the
+     *  inline buffer is full. */
+    static constexpr char32_t HEAP_TAG = 0xFFFFFFFF;
+
+    /** Inline characters, or a CowData in the first bytes for heap strings. */
+    alignas(8) char32_t _small[SMALL_CAPACITY + 1];
+
+    _FORCE_INLINE_ bool _is_small() const { return _small[SMALL_CAPACITY] != HEAP_TAG; }
+    _FORCE_INLINE_ CowData<char32_t>& _cowdata() { return *reinterpret_cast<CowData<char32_t>*>(_small); }
+    _FORCE_INLINE_ const CowData<char32_t>& _cowdata() const { return *reinterpret_cast<const CowData<char32_t>*>(_small); }
+
+    _FORCE_INLINE_ void _set_small_empty() {
+        _small[0] = 0;
+        _small[SMALL_CAPACITY] = SMALL_CAPACITY;
+    }
+    void _release();
+    void _copy_from(const String& p_other);
+    void _move_from(String& p_other);
+    void _copy_from(const char* p_latin1, int64_t p_length);
+    void _copy_from(const char32_t* p_chars, int64_t p_length);
+
+public:
+    _FORCE_INLINE_ int64_t length() const {
+        return _is_small() ? int64_t(SMALL_CAPACITY - _small[SMALL_CAPACITY]) : _cowdata().size() - 1;
+    }
+    /** Counts the terminator, like CowData; 0 for the empty string. */
+    _FORCE_INLINE_ int64_t size() const {
+        const int64_t len = length();
+        return len ? len + 1 : 0;
+    }
+    _FORCE_INLINE_ bool is_empty() const { return length() == 0; }
+
+    /** Sets size(), and writes the terminator. New characters are zero. */
+    Errors resize(int64_t p_size);
+    _FORCE_INLINE_ void clear() { resize(0); }
+
+    _FORCE_INLINE_ const char32_t* ptr() const { return _is_small() ? _small : _cowdata().ptr(); }
+    _FORCE_INLINE_ char32_t* ptrw() { return _is_small() ? _small : _cowdata().ptrw(); }
+    /** Never null. */
+    _FORCE_INLINE_ const char32_t* get_data() const { return ptr(); }
+
+    _FORCE_INLINE_ char32_t get(int64_t p_index) const {
+        CRASH_BAD_INDEX(p_index, length());
+        return ptr()[p_index];
+    }
+    _FORCE_INLINE_ void set(int64_t p_index, char32_t p_char) {
+        ERROR_FAIL_INDEX(p_index, length());
+        ptrw()[p_index] = p_char;
+    }
+    /** Index length() reads the terminator. */
+    _FORCE_INLINE_ const char32_t& operator[](int64_t p_index) const {
+        CRASH_BAD_INDEX(p_index, length() + 1);
+        return ptr()[p_index];
+    }
+
+    String substr(int64_t p_from, int64_t p_chars = -1) const;
+
+    /** Index of the first p_str at or after p_from, or -1. */
+    int64_t find(const String& p_str, int64_t p_from = 0) const;
+    /** find() ignoring case, by simple case folding. */
+    int64_t findn(const String& p_str, int64_t p_from = 0) const;
+    /** Index of the last p_str starting at or before p_from, or anywhere when
+     *  p_from is negative; -1 if there is none. */
+    int64_t rfind(const String& p_str, int64_t p_from = -1) const;
+    _FORCE_INLINE_ bool contains(const String& p_str) const { return find(p_str) != -1; }
+    /** Non-overlapping occurrences of p_str in [p_from, p_to), p_to 0 meaning
+     *  the end. */
+    int64_t count(const String& p_str, int64_t p_from = 0, int64_t p_to = 0) const;
+    /** Copy with every non-overlapping p_key, from the left, replaced by
+     *  p_with. Allocates once. */
+    String replace(const String& p_key, const String& p_with) const;
+
+    String& operator+=(const String& p_str);
+    String& operator+=(const char* p_str);
+    String& operator+=(char32_t p_char);
+    String operator+(const String& p_str) const;
+    String operator+(char32_t p_char) const;
+    friend String operator+(const char* p_left, const String& p_right);
+
+    bool operator==(const String& p_str) const;
+    bool operator==(const char* p_str) const;
+    bool operator==(const char32_t* p_str) const;
+    _FORCE_INLINE_ bool operator!=(const String& p_str) const { return !operator==(p_str); }
+    _FORCE_INLINE_ bool operator!=(const char* p_str) const { return !operator==(p_str); }
+    _FORCE_INLINE_ bool operator!=(const char32_t* p_str) const { return !operator==(p_str); }
+    /** Code point order. */
+    bool operator<(const String& p_str) const;
+
+    uint32_t hash() const;
+
+    /** Latin-1, with '?' for characters it can't represent. */
+    CharString ascii() const;
+
+    CharString utf8() const;
+    Errors parse_utf8(const char* p_utf8, int64_t p_len = -1, bool p_skip_cr = false);
+    static String utf8(const char* p_utf8, int64_t p_len = -1);
+    /** Decodes p_len bytes of UTF-8 to r_chars, which needs room for p_len
+     *  characters. Returns the characters written. */
+    static int64_t decode_utf8(const char* p_utf8, int64_t p_len, char32_t* r_chars, bool p_skip_cr = false, Errors* r_error = nullptr);
+
+    Char16String utf16() const;
+    Errors parse_utf16(const char16_t* p_utf16, int64_t p_len = -1);
+    static String utf16(const char16_t* p_utf16, int64_t p_len = -1);
+
+    /** Shortest text that reads back as p_num or, for p_decimals >= 0, p_num
+     *  rounded to that many decimals without trailing zeros. Locale
+     *  independent; see FloatConversion. */
+    static String num(double p_num, int p_decimals = -1);
+    /** Shortest text that reads back as p_num, with ".0" after whole numbers
+     *  when p_trailing so that it still reads as a float. */
+    static String num_real(double p_num, bool p_trailing = true);
+    static String num_real(float p_num, bool p_trailing = true);
+    static String num_int64(int64_t p_num, int p_base = 10, bool p_capitalize_hex = false);
+    static String num_uint64(uint64_t p_num, int p_base = 10, bool p_capitalize_hex = false);
+
+    /** The number at the start, after whitespace, or 0. */
+    double to_float() const;
+    static double to_float(const char* p_str, const char** r_end = nullptr);
+    static double to_float(const char32_t* p_str, const char32_t** r_end = nullptr);
+    /** The decimal integer at the start, after whitespace, or 0. Values past
+     *  64 bits fail, returning the closest one. */
+    int64_t to_int() const;
+    static int64_t to_int(const char* p_str, int64_t p_len = -1);
+    static int64_t to_int(const char32_t* p_str, int64_t p_len = -1);
+
+    void operator=(const String& p_str);
+    void operator=(String&& p_str);
+    void operator=(const char* p_str);
+    void operator=(const char32_t* p_str);
+
+    _FORCE_INLINE_ String() { _set_small_empty(); }
+    String(const String& p_str) { _copy_from(p_str); }
+    String(String&& p_str) { _move_from(p_str); }
+    /** Latin-1; use utf8() for UTF-8 text. */
+    String(const char* p_str);
+    String(const char* p_str, int64_t p_length);
+    String(const char32_t* p_str);
+    String(const char32_t* p_str, int64_t p_length);
+    _FORCE_INLINE_ ~String() { _release(); }
+};
+
+template <typename T>
+void CharStringBase<T>::_copy_from(const T* p_cstr, int64_t p_length) {
+    if (!p_cstr || p_length <= 0) {
+        _cowdata.resize(0);
+        return;
+    }
+
+    const Errors err = _cowdata.resize(p_length + 1);
+    ERROR_FAIL_COND(err != Errors::NONE);
+    T* dst = _cowdata.ptrw();
+    memcpy(dst, p_cstr, p_length * sizeof(T));
+    dst[p_length] = 0;
+}
+
+template <typename T>
+bool CharStringBase<T>::operator==(const CharStringBase& p_other) const {
+    return length() == p_other.length() && memcmp(get_data(), p_other.get_data(), length() * sizeof(T)) == 0;
+}
+
+template <typename T>
+bool CharStringBase<T>::operator<(const CharStringBase& p_other) const {
+    const T* a = get_data();
+    const T* b = p_other.get_data();
+    while (*a && *a == *b) {
+        a++;
+        b++;
+    }
+    typedef typename std::make_unsigned<T>::type U;
+    return U(*a) < U(*b);
+}
+
 #endif
@@ -5,6 +5,7 @@
 #include "../os/memory.hpp"
 #include "./safe_refcount.hpp"
 
+#include <string.h>
 #include <string>
 #include <initializer_list>
 #include <type_traits>
@@ -186,7 +187,7 @@ public:
     _FORCE_INLINE_ bool is_empty() const { return _ptr == nullptr; }
 
     _FORCE_INLINE_ void set(Size p_index, const T& p_elem) {
-        ERR_FAIL_INDEX(p_index, size());
+        ERROR_FAIL_INDEX(p_index, size());
         _copy_on_write();
         _ptr[p_index] = p_elem;
     }
@@ -219,9 +220,9 @@ public:
 
     Errors insert(Size p_pos, const T &p_val) {
         Size new_size = size() + 1;
-        ERROR_FAIL_INDEX_V(p_pos, new_size, ERR_INVALID_PARAMETER);
+        ERROR_FAIL_INDEX_V(p_pos, new_size, Errors::ERROR_INVALID_PARAMETER);
         Errors err = resize(new_size);
-        ERROR_FAIL_COND_V(err, err);
+        ERROR_FAIL_COND_V(err != Errors::NONE, err);
         T *p = ptrw();
 
         for (Size i = new_size - 1; i > p_pos; --i) {
@@ -230,7 +231,7 @@ public:
 
         p[p_pos] = p_val;
 
-        return OK;
+        return Errors::NONE;
     }
 
     Size find(const T &p_val, Size p_from = 0) const;
@@ -338,13 +339,13 @@ Errors CowData<T>::resize(Size p_size) {
     Size current_size = size();
 
     if (p_size == current_size) {
-        return OK;
+        return Errors::NONE;
     }
 
     if (p_size == 0) {
         /** Wants to clean up. */
         _unref();
-        return OK;
+        return Errors::NONE;
     }
 
     /** possibly changing size, copy on write */
@@ -372,7 +373,7 @@ Errors CowData<T>::resize(Size p_size) {
             } else {
                 const Errors error = _realloc(alloc_size);
 
-                if (error) {
+                if (error != Errors::NONE) {
                     return error;
                 }
             }
@@ -401,7 +402,7 @@ Errors CowData<T>::resize(Size p_size) {
 
         if (alloc_size != current_alloc_size) {
             const Errors error = _realloc(alloc_size);
-            if (error) {
+            if (error != Errors::NONE) {
                 return error;
             }
         }
@@ -409,7 +410,7 @@ Errors CowData<T>::resize(Size p_size) {
         *_get_size() = p_size;
     }
 
-    return OK;
+    return Errors::NONE;
 }
 
 template <typename T>
@@ -503,7 +504,7 @@ void CowData<T>::_ref(const CowData& p_from) {
 template <typename T>
 CowData<T>::CowData(std::initializer_list<T> p_init) {
     Errors err = resize(p_init.size());
-    if (err != OK) {
+    if (err != Errors::NONE) {
         return;
     }
 
@@ -0,0 +1,137 @@
+#ifndef __HASH_MAP_HPP__
+#define __HASH_MAP_HPP__
+
+#include "../error/error_macros.hpp"
+#include "../os/memory.hpp"
+#include "./hash_table.hpp"
+#include "./hashfuncs.hpp"
+
+#include <initializer_list>
+
+template <typename TKey, typename TValue>
+struct KeyValue {
+    const TKey key;
+    TValue value;
+
+    KeyValue(const TKey& p_key, const TValue& p_value) :
+            key(p_key), value(p_value) {}
+    KeyValue(const TKey& p_key) :
+            key(p_key), value() {}
+};
+
+/** Hash map iterated in insertion order.
+ *
+ *  Lookups probe a Swiss table index; the key-value pairs themselves are
+ *  stored contiguously, so iterating is a linear walk. See HashTable.
+ *
+ *  Pointers and iterators to elements are invalidated by inserting (the
+ *  table may grow), not by erasing other keys. The insert itself may still
+ *  read them, so `m.insert(k, m.get(other))` is fine, but `m[a] = m[b]` is
+ *  not when a is new: copy m[b] first.
+ */
+template <typename TKey, typename TValue,
+        typename Hasher = HashMapHasherDefault,
+        typename Comparator = HashMapComparatorDefault<TKey>,
+        typename Allocator = DefaultAllocator>
+class HashMap {
+    struct KeyOf {
+        static _FORCE_INLINE_ const TKey& get(const KeyValue<TKey, TValue>& p_entry) { return p_entry.key; }
+    };
+
+    typedef HashTable<KeyValue<TKey, TValue>, TKey, KeyOf, Hasher, Comparator, Allocator> Table;
+
+    Table table;
+
+public:
+    typedef typename Table::Iterator Iterator;
+    typedef typename Table::ConstIterator ConstIterator;
+
+    _FORCE_INLINE_ uint32_t size() const { return table.size(); }
+    _FORCE_INLINE_ bool is_empty() const { return table.is_empty(); }
+    _FORCE_INLINE_ uint32_t get_capacity() const { return table.get_capacity(); }
+
+    /** Makes room for p_new_size elements, so inserting up to that many
+     *  doesn't rehash. */
+    _FORCE_INLINE_ void reserve(uint32_t p_new_size) { table.reserve(p_new_size); }
+    _FORCE_INLINE_ void clear() { table.clear(); }
+
+    _FORCE_INLINE_ bool has(const TKey& p_key) const { return table.find_index(p_key) >= 0; }
+
+    TValue* getptr(const TKey& p_key) {
+        const int64_t idx = table.find_index(p_key);
+        return idx < 0 ? nullptr : &table.get_entry(idx).value;
+    }
+
+    const TValue* getptr(const TKey& p_key) const {
+        const int64_t idx = table.find_index(p_key);
+        return idx < 0 ? nullptr : &table.get_entry(idx).value;
+    }
+
+    TValue& get(const TKey& p_key) {
+        TValue* value = getptr(p_key);
+        CRASH_COND_MSG(!value, "HashMap key not found.");
+        return *value;
+    }
+
+    const TValue& get(const TKey& p_key) const {
+        const TValue* value = getptr(p_key);
+        CRASH_COND_MSG(!value, "HashMap key not found.");
+        return *value;
+    }
+
+    /** Sets the value of p_key, appending it if it's new. */
+    Iterator insert(const TKey& p_key, const TValue& p_value) {
+        bool existed;
+        const uint32_t idx = table.emplace(p_key, existed, p_value);
+        if (existed) {
+            table.get_entry(idx).value = p_value;
+        }
+        return table.iterator_at(idx);
+    }
+
+    /** Returns true if p_key was there. */
+    _FORCE_INLINE_ bool erase(const TKey& p_key) { return table.erase(p_key); }
+
+    Iterator find(const TKey& p_key) {
+        const int64_t idx = table.find_index(p_key);
+        return idx < 0 ? table.end() : table.iterator_at(idx);
+    }
+
+    ConstIterator find(const TKey& p_key) const {
+        const int64_t idx = table.find_index(p_key);
+        return idx < 0 ? table.end() : table.iterator_at(idx);
+    }
+
+    /** Appends p_key with a default value if it's not there. */
+    TValue& operator[](const TKey& p_key) {
+        bool existed;
+        return table.get_entry(table.emplace(p_key, existed)).value;
+    }
+
+    const TValue& operator[](const TKey& p_key) const {
+        return get(p_key);
+    }
+
+    _FORCE_INLINE_ Iterator begin() { return table.begin(); }
+    _FORCE_INLINE_ Iterator end() { return table.end(); }
+    _FORCE_INLINE_ ConstIterator begin() const { return table.begin(); }
+    _FORCE_INLINE_ ConstIterator end() const { return table.end(); }
+
+    void operator=(const HashMap& p_other) { table = p_other.table; }
+    void operator=(HashMap&& p_other) { table = std::move(p_other.table); }
+
+    HashMap(const HashMap& p_other) :
+            table(p_other.table) {}
+    HashMap(HashMap&& p_other) :
+            table(std::move(p_other.table)) {}
+    explicit HashMap(uint32_t p_initial_capacity) { reserve(p_initial_capacity); }
+    HashMap(std::initializer_list<KeyValue<TKey, TValue>> p_init) {
+        reserve(p_init.size());
+        for (const KeyValue<TKey, TValue>& E : p_init) {
+            insert(E.key, E.value);
+        }
+    }
+    HashMap() {}
+};
+
+#endif
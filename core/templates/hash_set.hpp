@@ -0,0 +1,75 @@
+#ifndef __HASH_SET_HPP__
+#define __HASH_SET_HPP__
+
+#include "../os/memory.hpp"
+#include "./hash_table.hpp"
+#include "./hashfuncs.hpp"
+
+#include <initializer_list>
+
+/** Hash set iterated in insertion order. Same table as HashMap, storing the
+ *  keys alone. */
+template <typename TKey,
+        typename Hasher = HashMapHasherDefault,
+        typename Comparator = HashMapComparatorDefault<TKey>,
+        typename Allocator = DefaultAllocator>
+class HashSet {
+    struct KeyOf {
+        static _FORCE_INLINE_ const TKey& get(const TKey& p_entry) { return p_entry; }
+    };
+
+    typedef HashTable<TKey, TKey, KeyOf, Hasher, Comparator, Allocator> Table;
+
+    Table table;
+
+public:
+    /** Keys can't be modified in place, so both iterators are const. */
+    typedef typename Table::ConstIterator Iterator;
+
+    _FORCE_INLINE_ uint32_t size() const { return table.size(); }
+    _FORCE_INLINE_ bool is_empty() const { return table.is_empty(); }
+    _FORCE_INLINE_ uint32_t get_capacity() const { return table.get_capacity(); }
+
+    /** Makes room for p_new_size elements, so inserting up to that many
+     *  doesn't rehash. */
+    _FORCE_INLINE_ void reserve(uint32_t p_new_size) { table.reserve(p_new_size); }
+    _FORCE_INLINE_ void clear() { table.clear(); }
+
+    _FORCE_INLINE_ bool has(const TKey& p_key) const { return table.find_index(p_key) >= 0; }
+
+    /** Appends p_key if it's new. */
+    Iterator insert(const TKey& p_key) {
+        bool existed;
+        const uint32_t idx = table.emplace(p_key, existed);
+        return static_cast<const Table&>(table).iterator_at(idx);
+    }
+
+    /** Returns true if p_key was there. */
+    _FORCE_INLINE_ bool erase(const TKey& p_key) { return table.erase(p_key); }
+
+    Iterator find(const TKey& p_key) const {
+        const int64_t idx = table.find_index(p_key);
+        return idx < 0 ? table.end() : table.iterator_at(idx);
+    }
+
+    _FORCE_INLINE_ Iterator begin() const { return table.begin(); }
+    _FORCE_INLINE_ Iterator end() const { return table.end(); }
+
+    void operator=(const HashSet& p_other) { table = p_other.table; }
+    void operator=(HashSet&& p_other) { table = std::move(p_other.table); }
+
+    HashSet(const HashSet& p_other) :
+            table(p_other.table) {}
+    HashSet(HashSet&& p_other) :
+            table(std::move(p_other.table)) {}
+    explicit HashSet(uint32_t p_initial_capacity) { reserve(p_initial_capacity); }
+    HashSet(std::initializer_list<TKey> p_init) {
+        reserve(p_init.size());
+        for (const TKey& E : p_init) {
+            insert(E);
+        }
+    }
+    HashSet() {}
+};
+
+#endif
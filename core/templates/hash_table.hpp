@@ -0,0 +1,397 @@
+#ifndef __HASH_TABLE_HPP__
+#define __HASH_TABLE_HPP__
+
+#include "../error/error_macros.hpp"
+#include "../os/memory.hpp"
+#include "../typedefs.hpp"
+#include "./hashfuncs.hpp"
+
+#include <string.h>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HASH_TABLE_SSE2
+#endif
+
+/** Open addressing hash table that keeps its entries in insertion order.
+ *  Shared implementation of HashMap and HashSet, use those instead.
+ *
+ *  Entries live in a dense array, in the order they were inserted, next to
+ *  their full hashes. Erasing destroys the entry and leaves a hole that
+ *  iteration skips; holes are compacted away the next time the table grows.
+ *
+ *  The index is a Swiss table: one control byte per slot holds 7 bits of the
+ *  hash (or marks the slot empty or erased) and the slot holds the entry's
+ *  position. Lookups compare a whole group of 16 control bytes at once
+ *  (SSE2, or a plain loop elsewhere) and only look at the entries whose 7
+ *  bits match, so a miss rarely touches an entry at all. Groups are probed
+ *  triangularly. The control bytes are followed by a copy of the first
+ *  group, so a group can start at any slot.
+ *
+ *  The entry array holds at most 7/8 of the slot count, counting holes, so
+ *  every probe sequence ends at an empty slot. reserve() sizes both at once.
+ */
+template <typename TEntry, typename TKey, typename KeyOf, typename Hasher, typename Comparator, typename Allocator>
+class HashTable {
+public:
+    static constexpr uint32_t MIN_CAPACITY = 16;
+
+private:
+    static constexpr uint32_t GROUP_WIDTH = 16;
+    static constexpr uint8_t CTRL_EMPTY = 0x80;
+    static constexpr uint8_t CTRL_ERASED = 0xFE;
+    /** Hash stored for holes in the entry array. Keys never hash to it. */
+    static constexpr uint32_t HOLE_HASH = 0;
+
+    TEntry* entries = nullptr;
+    uint32_t* hashes = nullptr;
+    uint8_t* ctrl = nullptr;
+    uint32_t* slots = nullptr;
+    /** Slot count, 0 or a power of 2 no smaller than MIN_CAPACITY. */
+    uint32_t capacity = 0;
+    /** Entries appended since the last rebuild, holes included. */
+    uint32_t used = 0;
+    uint32_t num_elements = 0;
+
+    static _FORCE_INLINE_ uint32_t _max_entries(uint32_t p_capacity) {
+        return p_capacity - p_capacity / 8;
+    }
+
+    static _FORCE_INLINE_ uint32_t _hash(const TKey& p_key) {
+        const uint32_t h = hash_fmix32(Hasher::hash(p_key));
+        return h == HOLE_HASH ? 1 : h;
+    }
+
+    static _FORCE_INLINE_ uint8_t _h2(uint32_t p_hash) {
+        return p_hash & 0x7F;
+    }
+
+    static _FORCE_INLINE_ uint32_t _ctz(uint32_t p_mask) {
+#if defined(__GNUC__)
+        return __builtin_ctz(p_mask);
+#else
+        uint32_t n = 0;
+        while (!(p_mask & 1)) {
+            p_mask >>= 1;
+            n++;
+        }
+        return n;
+#endif
+    }
+
+    /** Bit i is set when control byte i of the group is p_byte. */
+    static _FORCE_INLINE_ uint32_t _match(const uint8_t* p_group, uint8_t p_byte) {
+#ifdef HASH_TABLE_SSE2
+        const __m128i group = _mm_loadu_si128((const __m128i*)p_group);
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)p_byte)));
+#else
+        uint32_t mask = 0;
+        for (uint32_t i = 0; i < GROUP_WIDTH; i++) {
+            mask |= uint32_t(p_group[i] == p_byte) << i;
+        }
+        return mask;
+#endif
+    }
+
+    /** Bit i is set when slot i of the group is empty or erased. */
+    static _FORCE_INLINE_ uint32_t _match_free(const uint8_t* p_group) {
+#ifdef HASH_TABLE_SSE2
+        return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)p_group));
+#else
+        uint32_t mask = 0;
+        for (uint32_t i = 0; i < GROUP_WIDTH; i++) {
+            mask |= uint32_t(p_group[i] >> 7) << i;
+        }
+        return mask;
+#endif
+    }
+
+    _FORCE_INLINE_ void _set_ctrl(uint32_t p_slot, uint8_t p_value) {
+        ctrl[p_slot] = p_value;
+        // Slots of the first group are mirrored after the last one.
+        ctrl[((p_slot - GROUP_WIDTH) & (capacity - 1)) + GROUP_WIDTH] = p_value;
+    }
+
+    /** Slot pointing to the entry with p_key, or -1. */
+    int64_t _find_slot(const TKey& p_key, uint32_t p_hash) const {
+        if (num_elements == 0) {
+            return -1;
+        }
+
+        const uint32_t mask = capacity - 1;
+        const uint8_t h2 = _h2(p_hash);
+        uint32_t pos = (p_hash >> 7) & mask;
+        for (uint32_t step = GROUP_WIDTH;; step += GROUP_WIDTH) {
+            const uint8_t* group = ctrl + pos;
+            for (uint32_t match = _match(group, h2); match; match &= match - 1) {
+                const uint32_t slot = (pos + _ctz(match)) & mask;
+                const uint32_t idx = slots[slot];
+                if (hashes[idx] == p_hash && Comparator::compare(KeyOf::get(entries[idx]), p_key)) {
+                    return slot;
+                }
+            }
+            if (_match(group, CTRL_EMPTY)) {
+                return -1;
+            }
+            pos = (pos + step) & mask;
+        }
+    }
+
+    uint32_t _find_free_slot(uint32_t p_hash) const {
+        const uint32_t mask = capacity - 1;
+        uint32_t pos = (p_hash >> 7) & mask;
+        for (uint32_t step = GROUP_WIDTH;; step += GROUP_WIDTH) {
+            const uint32_t match = _match_free(ctrl + pos);
+            if (match) {
+                return (pos + _ctz(match)) & mask;
+            }
+            pos = (pos + step) & mask;
+        }
+    }
+
+    /** Moves the entries, without holes, to arrays sized for p_capacity
+     *  slots and rebuilds the index. */
+    void _rebuild(uint32_t p_capacity) {
+        const uint32_t max_entries = _max_entries(p_capacity);
+        TEntry* new_entries = (TEntry*)Allocator::alloc(sizeof(TEntry) * max_entries);
+        uint32_t* new_hashes = (uint32_t*)Allocator::alloc(sizeof(uint32_t) * max_entries);
+
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < used; i++) {
+            if (hashes[i] == HOLE_HASH) {
+                continue;
+            }
+            memnew_placement(&new_entries[count], TEntry(std::move(entries[i])));
+            entries[i].~TEntry();
+            new_hashes[count++] = hashes[i];
+        }
+
+        if (entries) {
+            Allocator::free(entries);
+            Allocator::free(hashes);
+        }
+        entries = new_entries;
+        hashes = new_hashes;
+        used = count;
+
+        if (p_capacity != capacity) {
+            if (ctrl) {
+                Allocator::free(ctrl);
+                Allocator::free(slots);
+            }
+            ctrl = (uint8_t*)Allocator::alloc(p_capacity + GROUP_WIDTH);
+            slots = (uint32_t*)Allocator::alloc(sizeof(uint32_t) * p_capacity);
+            capacity = p_capacity;
+        }
+        memset(ctrl, CTRL_EMPTY, capacity + GROUP_WIDTH);
+
+        for (uint32_t i = 0; i < count; i++) {
+            const uint32_t slot = _find_free_slot(hashes[i]);
+            _set_ctrl(slot, _h2(hashes[i]));
+            slots[slot] = i;
+        }
+    }
+
+    static uint32_t _capacity_for(uint32_t p_elements) {
+        uint32_t capacity = MIN_CAPACITY;
+        while (_max_entries(capacity) < p_elements) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    /** p_args may refer to entries of this table: when growing, the new
+     *  entry is built before they move. */
+    template <typename... Args>
+    uint32_t _insert_new(uint32_t p_hash, Args&&... p_args) {
+        if (unlikely(used == _max_entries(capacity))) {
+            TEntry entry(std::forward<Args>(p_args)...);
+            // Leave room for half as many again, so erasing and inserting
+            // around a steady size doesn't rebuild over and over.
+            _rebuild(MAX(capacity, _capacity_for(num_elements + 1 + num_elements / 2)));
+            return _append(p_hash, std::move(entry));
+        }
+        return _append(p_hash, std::forward<Args>(p_args)...);
+    }
+
+    template <typename... Args>
+    _FORCE_INLINE_ uint32_t _append(uint32_t p_hash, Args&&... p_args) {
+        const uint32_t idx = used++;
+        memnew_placement(&entries[idx], TEntry(std::forward<Args>(p_args)...));
+        hashes[idx] = p_hash;
+        num_elements++;
+
+        const uint32_t slot = _find_free_slot(p_hash);
+        _set_ctrl(slot, _h2(p_hash));
+        slots[slot] = idx;
+        return idx;
+    }
+
+    void _destroy_entries() {
+        for (uint32_t i = 0; i < used; i++) {
+            if (hashes[i] != HOLE_HASH) {
+                entries[i].~TEntry();
+            }
+        }
+    }
+
+public:
+    /** Walks the entries in insertion order. Valid until the table is
+     *  modified, except for erasing entries, the current one included. */
+    template <typename TRef>
+    struct IteratorBase {
+        const HashTable* table = nullptr;
+        uint32_t index = 0;
+
+        _FORCE_INLINE_ TRef& operator*() const { return table->entries[index]; }
+        _FORCE_INLINE_ TRef* operator->() const { return &table->entries[index]; }
+
+        _FORCE_INLINE_ IteratorBase& operator++() {
+            do {
+                index++;
+            } while (index < table->used && table->hashes[index] == HOLE_HASH);
+            return *this;
+        }
+
+        _FORCE_INLINE_ IteratorBase& operator--() {
+            do {
+                index--;
+            } while (index > 0 && table->hashes[index] == HOLE_HASH);
+            return *this;
+        }
+
+        _FORCE_INLINE_ bool operator==(const IteratorBase& p_it) const { return index == p_it.index; }
+        _FORCE_INLINE_ bool operator!=(const IteratorBase& p_it) const { return index != p_it.index; }
+
+        _FORCE_INLINE_ explicit operator bool() const { return table && index < table->used; }
+
+        IteratorBase(const HashTable* p_table, uint32_t p_index) :
+                table(p_table), index(p_index) {}
+        IteratorBase() {}
+    };
+
+    typedef IteratorBase<TEntry> Iterator;
+    typedef IteratorBase<const TEntry> ConstIterator;
+
+    _FORCE_INLINE_ uint32_t size() const { return num_elements; }
+    _FORCE_INLINE_ bool is_empty() const { return num_elements == 0; }
+    _FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+
+    /** Position of p_key in the entry array, or -1. */
+    _FORCE_INLINE_ int64_t find_index(const TKey& p_key) const {
+        const int64_t slot = _find_slot(p_key, _hash(p_key));
+        return slot < 0 ? -1 : int64_t(slots[slot]);
+    }
+
+    _FORCE_INLINE_ TEntry& get_entry(uint32_t p_index) { return entries[p_index]; }
+    _FORCE_INLINE_ const TEntry& get_entry(uint32_t p_index) const { return entries[p_index]; }
+
+    /** Position of the entry with p_key, appending TEntry(p_key, p_args...)
+     *  first when there is none. */
+    template <typename... Args>
+    uint32_t emplace(const TKey& p_key, bool& r_existed, Args&&... p_args) {
+        const uint32_t h = _hash(p_key);
+        const int64_t slot = _find_slot(p_key, h);
+        r_existed = slot >= 0;
+        if (r_existed) {
+            return slots[slot];
+        }
+        return _insert_new(h, p_key, std::forward<Args>(p_args)...);
+    }
+
+    bool erase(const TKey& p_key) {
+        const int64_t slot = _find_slot(p_key, _hash(p_key));
+        if (slot < 0) {
+            return false;
+        }
+
+        const uint32_t idx = slots[slot];
+        _set_ctrl(slot, CTRL_ERASED);
+        entries[idx].~TEntry();
+        hashes[idx] = HOLE_HASH;
+        num_elements--;
+        // Holes stay until the next rebuild or clear(), iterators walk up
+        // to used and may be erasing as they go.
+        return true;
+    }
+
+    /** Makes room for p_elements in total, so inserting up to that many
+     *  doesn't rebuild the table. */
+    void reserve(uint32_t p_elements) {
+        if (p_elements <= num_elements || used + (p_elements - num_elements) <= _max_entries(capacity)) {
+            return;
+        }
+        _rebuild(MAX(capacity, _capacity_for(p_elements)));
+    }
+
+    /** Keeps the capacity. */
+    void clear() {
+        if (!entries) {
+            return;
+        }
+        _destroy_entries();
+        used = 0;
+        num_elements = 0;
+        memset(ctrl, CTRL_EMPTY, capacity + GROUP_WIDTH);
+    }
+
+    _FORCE_INLINE_ Iterator begin() {
+        Iterator it(this, 0);
+        if (used && hashes[0] == HOLE_HASH) {
+            ++it;
+        }
+        return it;
+    }
+    _FORCE_INLINE_ Iterator end() { return Iterator(this, used); }
+    _FORCE_INLINE_ ConstIterator begin() const {
+        ConstIterator it(this, 0);
+        if (used && hashes[0] == HOLE_HASH) {
+            ++it;
+        }
+        return it;
+    }
+    _FORCE_INLINE_ ConstIterator end() const { return ConstIterator(this, used); }
+    _FORCE_INLINE_ Iterator iterator_at(uint32_t p_index) { return Iterator(this, p_index); }
+    _FORCE_INLINE_ ConstIterator iterator_at(uint32_t p_index) const { return ConstIterator(this, p_index); }
+
+    void operator=(const HashTable& p_other) {
+        if (this == &p_other) {
+            return;
+        }
+        clear();
+        reserve(p_other.num_elements);
+        for (uint32_t i = 0; i < p_other.used; i++) {
+            if (p_other.hashes[i] != HOLE_HASH) {
+                _insert_new(p_other.hashes[i], p_other.entries[i]);
+            }
+        }
+    }
+
+    void operator=(HashTable&& p_other) {
+        if (this == &p_other) {
+            return;
+        }
+        this->~HashTable();
+        memcpy((void*)this, (const void*)&p_other, sizeof(HashTable));
+        memset((void*)&p_other, 0, sizeof(HashTable));
+    }
+
+    HashTable(const HashTable& p_other) { *this = p_other; }
+    HashTable(HashTable&& p_other) { *this = std::move(p_other); }
+    HashTable() {}
+
+    ~HashTable() {
+        if (!entries) {
+            return;
+        }
+        _destroy_entries();
+        Allocator::free(entries);
+        Allocator::free(hashes);
+        Allocator::free(ctrl);
+        Allocator::free(slots);
+        entries = nullptr;
+    }
+};
+
+#endif
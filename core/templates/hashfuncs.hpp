@@ -0,0 +1,307 @@
+#ifndef __HASHFUNCS_HPP__
+#define __HASHFUNCS_HPP__
+
+#include "../math/math_defs.hpp"
+#include "../typedefs.hpp"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HASH_BYTES_SSE2
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define HASH_BYTES_NEON
+#endif
+
+/**
+ * Hashing functions
+ */
+
+/**
+ * DJB2 Hash function
+ * @param C String
+ * @return 32-bits hashcode
+ */
+static _FORCE_INLINE_ constexpr uint32_t hash_djb2(const char* p_cstr) {
+    uint32_t hash = 5381;
+    uint32_t c = (unsigned char)*p_cstr++;
+
+    while (c) {
+        hash = ((hash << 5) + hash) ^ c; /* hash * 33 ^ c */
+        c = (unsigned char)*p_cstr++;
+    }
+
+    return hash;
+}
+
+static _FORCE_INLINE_ uint32_t hash_djb2_buffer(const uint8_t* p_buff, int p_len, uint32_t p_prev = 5381) {
+    uint32_t hash = p_prev;
+
+    for (int i = 0; i < p_len; i++) {
+        hash = ((hash << 5) + hash) ^ p_buff[i]; /* hash * 33 + c */
+    }
+
+    return hash;
+}
+
+/**
+ * Thomas Wang's 64-bit to 32-bit Hash function:
+ * https://web.archive.org/web/20071223173210/https:/www.concentric.net/~Ttwang/tech/inthash.htm
+ *
+ * @param p_int - 64-bit unsigned integer key to be hashed
+ * @return unsigned 32-bit value representing hashcode
+ */
+static _FORCE_INLINE_ uint32_t hash_one_uint64(const uint64_t p_int) {
+    uint64_t v = p_int;
+    v = (~v) + (v << 18); /** v = (v << 18) - v - 1; */
+    v = v ^ (v >> 31);
+    v = v * 21; /** v = (v + (v << 2)) + (v << 4); */
+    v = v ^ (v >> 11);
+    v = v + (v << 6);
+    v = v ^ (v >> 22);
+    return uint32_t(v);
+}
+
+#define HASH_MURMUR3_SEED 0x7F07C65
+
+static _FORCE_INLINE_ uint32_t hash_murmur3_one_32(uint32_t p_in, uint32_t p_seed = HASH_MURMUR3_SEED) {
+    p_in *= 0xcc9e2d51;
+    p_in = (p_in << 15) | (p_in >> 17);
+    p_in *= 0x1b873593;
+
+    p_seed ^= p_in;
+    p_seed = (p_seed << 13) | (p_seed >> 19);
+    p_seed = p_seed * 5 + 0xe6546b64;
+
+    return p_seed;
+}
+
+static _FORCE_INLINE_ uint32_t hash_murmur3_one_64(uint64_t p_in, uint32_t p_seed = HASH_MURMUR3_SEED) {
+    p_seed = hash_murmur3_one_32(p_in & 0xFFFFFFFF, p_seed);
+    return hash_murmur3_one_32(p_in >> 32, p_seed);
+}
+
+/** Floats hash by value: 0.0 and -0.0 hash the same, and so does every NaN. */
+static _FORCE_INLINE_ uint32_t hash_murmur3_one_float(float p_in, uint32_t p_seed = HASH_MURMUR3_SEED) {
+    if (p_in == 0.0f) {
+        p_in = 0.0f;
+    } else if (p_in != p_in) {
+        p_in = NAN;
+    }
+    uint32_t bits;
+    memcpy(&bits, &p_in, sizeof(bits));
+    return hash_murmur3_one_32(bits, p_seed);
+}
+
+static _FORCE_INLINE_ uint32_t hash_murmur3_one_double(double p_in, uint32_t p_seed = HASH_MURMUR3_SEED) {
+    if (p_in == 0.0) {
+        p_in = 0.0;
+    } else if (p_in != p_in) {
+        p_in = NAN;
+    }
+    uint64_t bits;
+    memcpy(&bits, &p_in, sizeof(bits));
+    return hash_murmur3_one_64(bits, p_seed);
+}
+
+static _FORCE_INLINE_ uint32_t hash_murmur3_one_real(real_t p_in, uint32_t p_seed = HASH_MURMUR3_SEED) {
+#ifdef REAL_T_IS_DOUBLE
+    return hash_murmur3_one_double(p_in, p_seed);
+#else
+    return hash_murmur3_one_float(p_in, p_seed);
+#endif
+}
+
+static _FORCE_INLINE_ constexpr uint32_t hash_fmix32(uint32_t p_h32) {
+    p_h32 ^= p_h32 >> 16;
+    p_h32 *= 0x85ebca6b;
+    p_h32 ^= p_h32 >> 13;
+    p_h32 *= 0xc2b2ae35;
+    p_h32 ^= p_h32 >> 16;
+
+    return p_h32;
+}
+
+/**
+ * 64-bit hash of a byte buffer, built like XXH3: 64 byte stripes feed eight
+ * 64-bit lanes with a 32x32->64 multiply each, the lanes are scrambled every
+ * 1KB block and folded together at the end. SSE2 and NEON process two lanes
+ * per instruction; the scalar fallback gives the same results. Inputs below
+ * one stripe take a short multiply-fold path.
+ *
+ * Not an implementation of XXH3 and not stable across versions, don't
+ * persist it.
+ */
+#define HASH_BYTES_PRIME64_1 0x9E3779B185EBCA87ULL
+#define HASH_BYTES_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define HASH_BYTES_PRIME64_3 0x165667B19E3779F9ULL
+#define HASH_BYTES_PRIME32_1 0x9E3779B1U
+#define HASH_BYTES_STRIPE 64
+#define HASH_BYTES_STRIPES_PER_BLOCK 16
+
+static const uint64_t _hash_bytes_keys[8] = {
+    0xbe4ba423396cfeb8ULL, 0x1cad21f72c81017cULL, 0xdb979083e96dd4deULL, 0x1f67b3b7a4a44072ULL,
+    0x78e5c0cc4ee679cbULL, 0x2172ffcc7dd05a82ULL, 0x8e2443f7744608b8ULL, 0x4c263a81e69035e0ULL,
+};
+
+static _FORCE_INLINE_ uint64_t _hash_read64(const uint8_t* p_ptr) {
+    uint64_t v;
+    memcpy(&v, p_ptr, 8);
+    return v;
+}
+
+static _FORCE_INLINE_ uint64_t _hash_mul128_fold64(uint64_t p_a, uint64_t p_b) {
+#if defined(__SIZEOF_INT128__)
+    const __uint128_t product = (__uint128_t)p_a * p_b;
+    return uint64_t(product) ^ uint64_t(product >> 64);
+#else
+    const uint64_t lo_lo = (p_a & 0xFFFFFFFF) * (p_b & 0xFFFFFFFF);
+    const uint64_t hi_lo = (p_a >> 32) * (p_b & 0xFFFFFFFF);
+    const uint64_t lo_hi = (p_a & 0xFFFFFFFF) * (p_b >> 32);
+    const uint64_t hi_hi = (p_a >> 32) * (p_b >> 32);
+    const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    const uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    const uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+    return lower ^ upper;
+#endif
+}
+
+static _FORCE_INLINE_ uint64_t _hash_avalanche64(uint64_t p_h) {
+    p_h ^= p_h >> 37;
+    p_h *= HASH_BYTES_PRIME64_3;
+    p_h ^= p_h >> 32;
+    return p_h;
+}
+
+static _FORCE_INLINE_ void _hash_accumulate_stripe(uint64_t* r_acc, const uint8_t* p_data) {
+#if defined(HASH_BYTES_SSE2)
+    for (int i = 0; i < 4; i++) {
+        const __m128i data = _mm_loadu_si128((const __m128i*)(p_data + 16 * i));
+        const __m128i key = _mm_loadu_si128((const __m128i*)(_hash_bytes_keys + 2 * i));
+        const __m128i mixed = _mm_xor_si128(data, key);
+        const __m128i product = _mm_mul_epu32(mixed, _mm_shuffle_epi32(mixed, _MM_SHUFFLE(0, 3, 0, 1)));
+        const __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        __m128i acc = _mm_loadu_si128((const __m128i*)(r_acc + 2 * i));
+        acc = _mm_add_epi64(acc, _mm_add_epi64(product, swapped));
+        _mm_storeu_si128((__m128i*)(r_acc + 2 * i), acc);
+    }
+#elif defined(HASH_BYTES_NEON)
+    for (int i = 0; i < 4; i++) {
+        const uint64x2_t data = vreinterpretq_u64_u8(vld1q_u8(p_data + 16 * i));
+        const uint64x2_t mixed = veorq_u64(data, vld1q_u64(_hash_bytes_keys + 2 * i));
+        const uint64x2_t product = vmull_u32(vmovn_u64(mixed), vshrn_n_u64(mixed, 32));
+        const uint64x2_t swapped = vextq_u64(data, data, 1);
+        vst1q_u64(r_acc + 2 * i, vaddq_u64(vld1q_u64(r_acc + 2 * i), vaddq_u64(product, swapped)));
+    }
+#else
+    for (int i = 0; i < 8; i++) {
+        const uint64_t data = _hash_read64(p_data + 8 * i);
+        const uint64_t mixed = data ^ _hash_bytes_keys[i];
+        r_acc[i ^ 1] += data;
+        r_acc[i] += (mixed & 0xFFFFFFFF) * (mixed >> 32);
+    }
+#endif
+}
+
+static _FORCE_INLINE_ void _hash_scramble(uint64_t* r_acc) {
+    for (int i = 0; i < 8; i++) {
+        uint64_t a = r_acc[i];
+        a ^= a >> 47;
+        a ^= _hash_bytes_keys[7 - i];
+        r_acc[i] = a * HASH_BYTES_PRIME32_1;
+    }
+}
+
+static inline uint64_t hash_bytes_64(const void* p_data, size_t p_len, uint64_t p_seed = HASH_MURMUR3_SEED) {
+    const uint8_t* data = (const uint8_t*)p_data;
+
+    if (p_len < HASH_BYTES_STRIPE) {
+        uint64_t h = p_seed ^ (p_len * HASH_BYTES_PRIME64_1);
+        size_t i = 0;
+        for (; i + 16 <= p_len; i += 16) {
+            h += _hash_mul128_fold64(_hash_read64(data + i) ^ (_hash_bytes_keys[(i / 8) & 7] + p_seed), _hash_read64(data + i + 8) ^ (_hash_bytes_keys[((i / 8) + 1) & 7] - p_seed));
+        }
+        if (i < p_len) {
+            uint8_t tail[16] = {};
+            memcpy(tail, data + i, p_len - i);
+            h += _hash_mul128_fold64(_hash_read64(tail) ^ (_hash_bytes_keys[6] + p_seed), _hash_read64(tail + 8) ^ (_hash_bytes_keys[7] - p_seed));
+        }
+        return _hash_avalanche64(h);
+    }
+
+    uint64_t acc[8] = {
+        HASH_BYTES_PRIME32_1, HASH_BYTES_PRIME64_1, HASH_BYTES_PRIME64_2, HASH_BYTES_PRIME64_3,
+        p_seed, HASH_BYTES_PRIME64_2 ^ p_seed, HASH_BYTES_PRIME64_1 + p_seed, HASH_BYTES_PRIME32_1 ^ p_seed
+    };
+
+    const size_t stripes = (p_len - 1) / HASH_BYTES_STRIPE;
+    for (size_t s = 0; s < stripes; s++) {
+        _hash_accumulate_stripe(acc, data + s * HASH_BYTES_STRIPE);
+        if ((s + 1) % HASH_BYTES_STRIPES_PER_BLOCK == 0) {
+            _hash_scramble(acc);
+        }
+    }
+    // The last stripe ends at the end of the input, overlapping the previous one.
+    _hash_accumulate_stripe(acc, data + p_len - HASH_BYTES_STRIPE);
+
+    uint64_t h = p_len * HASH_BYTES_PRIME64_1;
+    for (int i = 0; i < 8; i += 2) {
+        h += _hash_mul128_fold64(acc[i] ^ _hash_bytes_keys[i], acc[i + 1] ^ _hash_bytes_keys[i + 1]);
+    }
+    return _hash_avalanche64(h);
+}
+
+static _FORCE_INLINE_ uint32_t hash_fold_64_32(uint64_t p_h64) {
+    return hash_fmix32(uint32_t(p_h64 ^ (p_h64 >> 32)));
+}
+
+/** Default hasher of HashMap and HashSet keys: integers, enums, floats,
+ *  pointers, and any type with a `uint32_t hash() const` method. */
+struct HashMapHasherDefault {
+    template <typename T>
+    static _FORCE_INLINE_ typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, uint32_t>::type hash(const T p_value) {
+        return hash_one_uint64((uint64_t)p_value);
+    }
+
+    /** Hash by value, so 0.0 and -0.0 collide and every NaN hashes the same. */
+    template <typename T>
+    static _FORCE_INLINE_ typename std::enable_if<std::is_floating_point<T>::value, uint32_t>::type hash(const T p_value) {
+        double d = p_value;
+        if (d == 0.0) {
+            d = 0.0;
+        } else if (d != d) {
+            d = NAN;
+        }
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+        return hash_murmur3_one_64(bits);
+    }
+
+    template <typename T>
+    static _FORCE_INLINE_ uint32_t hash(const T* p_pointer) {
+        return hash_one_uint64((uint64_t)(uintptr_t)p_pointer);
+    }
+
+    template <typename T>
+    static _FORCE_INLINE_ auto hash(const T& p_value) -> decltype(uint32_t(p_value.hash())) {
+        return p_value.hash();
+    }
+};
+
+template <typename T>
+struct HashMapComparatorDefault {
+    static _FORCE_INLINE_ bool compare(const T& p_lhs, const T& p_rhs) {
+        if constexpr (std::is_floating_point<T>::value) {
+            // Consistent with the hasher: NaN keys find each other.
+            return p_lhs == p_rhs || (p_lhs != p_lhs && p_rhs != p_rhs);
+        } else {
+            return p_lhs == p_rhs;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef __PAGED_ALLOCATOR_HPP__
+#define __PAGED_ALLOCATOR_HPP__
+
+#include "../os/memory.hpp"
+#include "../os/mutex.hpp"
+#include "../typedefs.hpp"
+
+#include <type_traits>
+
+/** Fixed-size object pool.
+ *
+ *  Objects live in pages of page_size elements that are never returned to the
+ *  system until reset(), so alloc() and free() are a pop and a push on a free
+ *  stack. Meant for small objects with a high turnover, where going through
+ *  the general allocator every time costs more than the object itself.
+ */
+template <typename T, bool thread_safe = false, uint32_t DEFAULT_PAGE_SIZE = 4096>
+class PagedAllocator {
+    T** page_pool = nullptr;
+    T*** available_pool = nullptr;
+    uint32_t pages_allocated = 0;
+    uint32_t allocs_available = 0;
+
+    uint32_t page_shift = 0;
+    uint32_t page_mask = 0;
+    uint32_t page_size = 0;
+    BinaryMutex mutex;
+
+public:
+    template <typename... Args>
+    T* alloc(Args&&... p_args) {
+        if constexpr (thread_safe) {
+            mutex.lock();
+        }
+        if (unlikely(allocs_available == 0)) {
+            uint32_t pages_used = pages_allocated;
+
+            pages_allocated++;
+            page_pool = (T**)memrealloc(page_pool, sizeof(T*) * pages_allocated);
+            available_pool = (T***)memrealloc(available_pool, sizeof(T**) * pages_allocated);
+
+            page_pool[pages_used] = (T*)memalloc(sizeof(T) * page_size);
+            available_pool[pages_used] = (T**)memalloc(sizeof(T*) * page_size);
+
+            for (uint32_t i = 0; i < page_size; i++) {
+                available_pool[0][i] = &page_pool[pages_used][i];
+            }
+            allocs_available += page_size;
+        }
+
+        allocs_available--;
+        T* alloc = available_pool[allocs_available >> page_shift][allocs_available & page_mask];
+        if constexpr (thread_safe) {
+            mutex.unlock();
+        }
+        memnew_placement(alloc, T(std::forward<Args>(p_args)...));
+        return alloc;
+    }
+
+    void free(T* p_mem) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            p_mem->~T();
+        }
+
+        if constexpr (thread_safe) {
+            mutex.lock();
+        }
+        available_pool[allocs_available >> page_shift][allocs_available & page_mask] = p_mem;
+        allocs_available++;
+        if constexpr (thread_safe) {
+            mutex.unlock();
+        }
+    }
+
+    /** Releases every page. All objects must have been freed already. */
+    void reset(bool p_allow_unfreed = false) {
+        if constexpr (thread_safe) {
+            mutex.lock();
+        }
+        ERROR_FAIL_COND_MSG(!p_allow_unfreed && allocs_available < pages_allocated * page_size, "Pages in use exist at exit in PagedAllocator.");
+
+        for (uint32_t i = 0; i < pages_allocated; i++) {
+            memfree(page_pool[i]);
+            memfree(available_pool[i]);
+        }
+        if (pages_allocated) {
+            memfree(page_pool);
+            memfree(available_pool);
+            page_pool = nullptr;
+            available_pool = nullptr;
+            pages_allocated = 0;
+            allocs_available = 0;
+        }
+        if constexpr (thread_safe) {
+            mutex.unlock();
+        }
+    }
+
+    bool is_configured() const {
+        return page_size > 0;
+    }
+
+    void configure(uint32_t p_page_size) {
+        ERROR_FAIL_COND(page_pool != nullptr);
+        ERROR_FAIL_COND(p_page_size == 0);
+        page_size = nearest_power_of_2_templated(p_page_size);
+        page_mask = page_size - 1;
+        page_shift = get_shift_from_power_of_2(page_size);
+    }
+
+    PagedAllocator(uint32_t p_page_size = DEFAULT_PAGE_SIZE) {
+        configure(p_page_size);
+    }
+
+    ~PagedAllocator() {
+        reset(true);
+    }
+};
+
+#endif
@@ -13,14 +13,18 @@
 /** Design goals for these classes:
  * - No automatic conversions or arithmetic operators,
  *   to keep explicit the use of atomics everywhere.
- * - Using acquire-release semantics, even to set the first value.
- *   The first value may be set relaxedly in many cases, but adding the distinction
- *   between relaxed and unrelaxed operation to the interface would make it needlessly
- *   flexible. There's negligible waste in having release semantics for the initial
+ * - Using acquire-release semantics by default, even to set the first value.
+ *   There's negligible waste in having release semantics for the initial
  *   value and, as an important benefit, you can be sure the value is properly synchronized
  *   even with threads that are already running.
+ * - Relaxed operations are opt-in and spelled out at the call site (`*_relaxed()`).
+ *   They are meant for values that don't guard any other memory, such as statistics
+ *   counters, where the acquire-release fences are measurable on weakly ordered CPUs.
  */
 
+/** Size assumed for a cache line when padding values to avoid false sharing. */
+#define SAFE_NUMERIC_CACHE_LINE_SIZE 64
+
 /** These are used in very specific areas of the engine where it's critical that these guarantees are held */
 #define SAFE_NUMERIC_TYPE_PUN_GUARANTEES(m_type)                    \
     static_assert(sizeof(SafeNumeric<m_type>) == sizeof(m_type));   \
@@ -107,6 +111,14 @@ public:
         }
     }
 
+    /** Sets p_desired only if the value is still r_expected.
+     *  On failure r_expected is updated with the current value.
+     *  May fail spuriously, so call it in a loop.
+     */
+    _ALWAYS_INLINE_ bool compare_exchange(T &r_expected, T p_desired) {
+        return value.compare_exchange_weak(r_expected, p_desired, std::memory_order_acq_rel, std::memory_order_acquire);
+    }
+
     _ALWAYS_INLINE_ T conditional_increment() {
         while (true) {
             T c = value.load(std::memory_order_acquire);
@@ -120,11 +132,83 @@ public:
         }
     }
 
-    _ALWAYS_INLINE_ explicit SafeNumeric(T p_value = static_cast<T>(0)) {
+    /** Relaxed variants.
+     *  Atomicity is kept, ordering is not: never use them for anything that
+     *  publishes or consumes other data (refcounts, flags, indices into buffers...).
+     */
+    _ALWAYS_INLINE_ void set_relaxed(T p_value) {
+        value.store(p_value, std::memory_order_relaxed);
+    }
+
+    _ALWAYS_INLINE_ T get_relaxed() const {
+        return value.load(std::memory_order_relaxed);
+    }
+
+    _ALWAYS_INLINE_ T increment_relaxed() {
+        return value.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    /** Returns the original value instead of the new one */
+    _ALWAYS_INLINE_ T postincrement_relaxed() {
+        return value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    _ALWAYS_INLINE_ T decrement_relaxed() {
+        return value.fetch_sub(1, std::memory_order_relaxed) - 1;
+    }
+
+    _ALWAYS_INLINE_ T add_relaxed(T p_value) {
+        return value.fetch_add(p_value, std::memory_order_relaxed) + p_value;
+    }
+
+    /** Returns the original value instead of the new one */
+    _ALWAYS_INLINE_ T postadd_relaxed(T p_value) {
+        return value.fetch_add(p_value, std::memory_order_relaxed);
+    }
+
+    _ALWAYS_INLINE_ T sub_relaxed(T p_value) {
+        return value.fetch_sub(p_value, std::memory_order_relaxed) - p_value;
+    }
+
+    _ALWAYS_INLINE_ T exchange_if_greater_relaxed(T p_value) {
+        T tmp = value.load(std::memory_order_relaxed);
+        while (tmp < p_value) {
+            if (value.compare_exchange_weak(tmp, p_value, std::memory_order_relaxed)) {
+                return p_value;
+            }
+        }
+
+        /** already greater, or equal */
+        return tmp;
+    }
+
+    /** Zero, as a constant: statics start at zero before any code runs, so
+     *  other static initializers can use them regardless of order. */
+    constexpr SafeNumeric() :
+            value(static_cast<T>(0)) {}
+
+    _ALWAYS_INLINE_ explicit SafeNumeric(T p_value) {
         set(p_value);
     }
 };
 
+/** SafeNumeric taking a whole cache line, so that contended values placed next to
+ *  each other (per-thread counters, head/tail indices...) don't false-share.
+ *  Use it only for hot values; it's 64 bytes per instance.
+ */
+template <typename T>
+class alignas(SAFE_NUMERIC_CACHE_LINE_SIZE) SafeNumericPadded : public SafeNumeric<T> {
+public:
+    constexpr SafeNumericPadded() :
+            SafeNumeric<T>() {}
+
+    _ALWAYS_INLINE_ explicit SafeNumericPadded(T p_value) :
+            SafeNumeric<T>(p_value) {}
+};
+
+static_assert(sizeof(SafeNumericPadded<uint8_t>) == SAFE_NUMERIC_CACHE_LINE_SIZE);
+static_assert(sizeof(SafeNumericPadded<uint64_t>) == SAFE_NUMERIC_CACHE_LINE_SIZE);
+
 class SafeFlag {
     std::atomic_bool flag;
 
@@ -147,6 +231,11 @@ public:
         flag.store(p_value, std::memory_order_release);
     }
 
+    /** Returns the previous value */
+    _ALWAYS_INLINE_ bool test_and_set() {
+        return flag.exchange(true, std::memory_order_acq_rel);
+    }
+
     _ALWAYS_INLINE_ explicit SafeFlag(bool p_value = false) {
         set_to(p_value);
     }
@@ -1,4 +1,176 @@
 #ifndef __SEARCH_ARRAY_HPP__
 #define __SEARCH_ARRAY_HPP__
 
+#include "../typedefs.hpp"
+#include "./sort_array.hpp"
+#include "./vector.hpp"
+
+#if defined(__GNUC__)
+#define SEARCH_ARRAY_PREFETCH(m_ptr) __builtin_prefetch(m_ptr)
+#else
+#define SEARCH_ARRAY_PREFETCH(m_ptr)
+#endif
+
+/** Binary search over a sorted array.
+ *
+ *  The loop has no data dependent branch: each step halves the range and
+ *  picks a half with a conditional move, so the cost doesn't depend on how
+ *  well the branch predictor guesses the comparisons. Once the range no
+ *  longer fits in the cache, both candidate midpoints of the next step are
+ *  prefetched while the current comparison runs.
+ */
+template <typename T, typename Comparator = _DefaultComparator<T>>
+class SearchArray {
+    enum {
+        /** Ranges above this many bytes prefetch the next step. */
+        PREFETCH_BYTES = 1 << 14,
+        /** Queries bisect_many() walks in lockstep. */
+        BATCH_SIZE = 8,
+    };
+
+public:
+    Comparator compare;
+
+    /** Index of the first element not less than p_value when p_before,
+     *  of the first element greater than p_value otherwise. */
+    inline int64_t bisect(const T* p_array, int64_t p_len, const T& p_value, bool p_before) const {
+        if (p_len <= 0) {
+            return 0;
+        }
+
+        const T* base = p_array;
+        int64_t n = p_len;
+        const bool prefetch = int64_t(sizeof(T)) * p_len > PREFETCH_BYTES;
+        while (n > 1) {
+            const int64_t half = n / 2;
+            if (prefetch) {
+                SEARCH_ARRAY_PREFETCH(base + half / 2);
+                SEARCH_ARRAY_PREFETCH(base + half + half / 2);
+            }
+            const bool right = p_before ? compare(base[half], p_value) : !compare(p_value, base[half]);
+            base = right ? base + half : base;
+            n -= half;
+        }
+
+        const bool past = p_before ? compare(*base, p_value) : !compare(p_value, *base);
+        return (base - p_array) + past;
+    }
+
+    /** bisect() for p_count values at once. The range halves the same way for
+     *  every query, so BATCH_SIZE queries step together and their loads are
+     *  in flight at the same time instead of one after the other. */
+    void bisect_many(const T* p_array, int64_t p_len, const T* p_values, int64_t p_count, int64_t* r_results, bool p_before) const {
+        if (p_len <= 0) {
+            for (int64_t i = 0; i < p_count; i++) {
+                r_results[i] = 0;
+            }
+            return;
+        }
+
+        for (int64_t from = 0; from < p_count; from += BATCH_SIZE) {
+            const int64_t batch = MIN(int64_t(BATCH_SIZE), p_count - from);
+            const T* values = p_values + from;
+            const T* bases[BATCH_SIZE];
+            for (int64_t q = 0; q < batch; q++) {
+                bases[q] = p_array;
+            }
+
+            int64_t n = p_len;
+            while (n > 1) {
+                const int64_t half = n / 2;
+                for (int64_t q = 0; q < batch; q++) {
+                    const bool right = p_before ? compare(bases[q][half], values[q]) : !compare(values[q], bases[q][half]);
+                    bases[q] = right ? bases[q] + half : bases[q];
+                    SEARCH_ARRAY_PREFETCH(bases[q] + (n - half) / 2);
+                }
+                n -= half;
+            }
+
+            for (int64_t q = 0; q < batch; q++) {
+                const bool past = p_before ? compare(*bases[q], values[q]) : !compare(values[q], *bases[q]);
+                r_results[from + q] = (bases[q] - p_array) + past;
+            }
+        }
+    }
+};
+
+/** Read-only search index over a sorted array, for tables that are searched
+ *  far more often than they change.
+ *
+ *  Elements are stored in Eytzinger (breadth first) order: the children of
+ *  node k are 2k and 2k + 1. The first levels of the search tree are packed
+ *  together at the front and stay in cache, and the four levels below the
+ *  current node share a couple of cache lines, which are prefetched a few
+ *  steps ahead. Lookups return indices into the original sorted array.
+ */
+template <typename T, typename Comparator = _DefaultComparator<T>>
+class EytzingerIndex {
+    /** 1-based, slot 0 unused. */
+    Vector<T> tree;
+    /** Index in the sorted array of each tree node. */
+    Vector<int64_t> ranks;
+    int64_t count = 0;
+
+    int64_t _build(const T* p_sorted, T* p_tree, int64_t* p_ranks, int64_t p_next, int64_t p_node) {
+        if (p_node <= count) {
+            p_next = _build(p_sorted, p_tree, p_ranks, p_next, 2 * p_node);
+            p_tree[p_node] = p_sorted[p_next];
+            p_ranks[p_node] = p_next;
+            p_next = _build(p_sorted, p_tree, p_ranks, p_next + 1, 2 * p_node + 1);
+        }
+        return p_next;
+    }
+
+    static _FORCE_INLINE_ int64_t _trailing_ones(uint64_t p_value) {
+#if defined(__GNUC__)
+        return __builtin_ctzll(~p_value);
+#else
+        int64_t n = 0;
+        while (p_value & 1) {
+            p_value >>= 1;
+            n++;
+        }
+        return n;
+#endif
+    }
+
+    template <bool p_before>
+    int64_t _search(const T& p_value) const {
+        const T* t = tree.ptr();
+        int64_t k = 1;
+        while (k <= count) {
+            SEARCH_ARRAY_PREFETCH(t + MIN(k * 16, count));
+            const bool right = p_before ? compare(t[k], p_value) : !compare(p_value, t[k]);
+            k = 2 * k + right;
+        }
+        // Undo the trailing right turns (and the last left one) to reach the
+        // node the search last went left at: the answer.
+        k >>= _trailing_ones(k) + 1;
+        return k == 0 ? count : ranks[k];
+    }
+
+public:
+    Comparator compare;
+
+    /** p_sorted must be sorted by Comparator. */
+    void build(const T* p_sorted, int64_t p_len) {
+        count = p_len;
+        tree.resize(p_len + 1);
+        ranks.resize(p_len + 1);
+        _build(p_sorted, tree.ptrw(), ranks.ptrw(), 0, 1);
+    }
+
+    _FORCE_INLINE_ int64_t size() const { return count; }
+
+    /** Same results as SearchArray::bisect() on the sorted array. */
+    _FORCE_INLINE_ int64_t lower_bound(const T& p_value) const { return _search<true>(p_value); }
+    _FORCE_INLINE_ int64_t upper_bound(const T& p_value) const { return _search<false>(p_value); }
+    _FORCE_INLINE_ int64_t bisect(const T& p_value, bool p_before) const {
+        return p_before ? _search<true>(p_value) : _search<false>(p_value);
+    }
+
+    EytzingerIndex() {}
+    EytzingerIndex(const T* p_sorted, int64_t p_len) { build(p_sorted, p_len); }
+};
+
 #endif
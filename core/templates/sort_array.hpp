@@ -1,4 +1,494 @@
 #ifndef __SORT_ARRAY_HPP__
 #define __SORT_ARRAY_HPP__
 
+#include "../error/error_macros.hpp"
+#include "../os/memory.hpp"
+#include "../os/worker_pool.hpp"
+#include "../typedefs.hpp"
+
+#include <string.h>
+#include <type_traits>
+#include <utility>
+
+#define ERR_BAD_COMPARE(cond)                                         \
+    if (unlikely(cond)) {                                             \
+        ERROR_PRINT("bad comparison function; sorting will be broken"); \
+        break;                                                        \
+    }
+
+template <typename T>
+struct _DefaultComparator {
+    _FORCE_INLINE_ bool operator()(const T& a, const T& b) const { return (a < b); }
+};
+
+#ifdef DEBUG_ENABLED
+#define SORT_ARRAY_DEFAULT_VALIDATE true
+#else
+#define SORT_ARRAY_DEFAULT_VALIDATE false
+#endif
+
+/** Introsort: quicksort with a median of three pivot, falling back to
+ *  heapsort past 2 * log2(n) levels and leaving runs shorter than
+ *  INTROSORT_THRESHOLD to a final insertion sort.
+ *
+ *  Not stable. Validate makes the unguarded loops check their bounds and
+ *  report comparators that aren't a strict weak ordering instead of running
+ *  off the array.
+ *
+ *  parallel_sort() sorts large arrays in chunks on worker threads and merges
+ *  them back, so the comparator must be safe to call concurrently.
+ */
+template <typename T, typename Comparator = _DefaultComparator<T>, bool Validate = SORT_ARRAY_DEFAULT_VALIDATE>
+class SortArray {
+    enum {
+        INTROSORT_THRESHOLD = 16,
+        /** Below this, threads cost more than they save. */
+        PARALLEL_THRESHOLD = 1 << 16,
+        /** Smallest chunk a worker thread is given. */
+        PARALLEL_MIN_CHUNK = 1 << 14,
+    };
+
+public:
+    Comparator compare;
+
+    inline const T& median_of_3(const T& a, const T& b, const T& c) const {
+        if (compare(a, b)) {
+            if (compare(b, c)) {
+                return b;
+            } else if (compare(a, c)) {
+                return c;
+            } else {
+                return a;
+            }
+        } else if (compare(a, c)) {
+            return a;
+        } else if (compare(b, c)) {
+            return c;
+        } else {
+            return b;
+        }
+    }
+
+    inline int64_t bitlog(int64_t n) const {
+        int64_t k;
+        for (k = 0; n != 1; n >>= 1) {
+            ++k;
+        }
+        return k;
+    }
+
+    /* Heap / Heapsort functions */
+
+    inline void push_heap(int64_t p_first, int64_t p_hole_idx, int64_t p_top_index, T p_value, T* p_array) const {
+        int64_t parent = (p_hole_idx - 1) / 2;
+        while (p_hole_idx > p_top_index && compare(p_array[p_first + parent], p_value)) {
+            p_array[p_first + p_hole_idx] = std::move(p_array[p_first + parent]);
+            p_hole_idx = parent;
+            parent = (p_hole_idx - 1) / 2;
+        }
+        p_array[p_first + p_hole_idx] = std::move(p_value);
+    }
+
+    inline void pop_heap(int64_t p_first, int64_t p_last, int64_t p_result, T p_value, T* p_array) const {
+        p_array[p_result] = std::move(p_array[p_first]);
+        adjust_heap(p_first, 0, p_last - p_first, std::move(p_value), p_array);
+    }
+
+    inline void pop_heap(int64_t p_first, int64_t p_last, T* p_array) const {
+        pop_heap(p_first, p_last - 1, p_last - 1, p_array[p_last - 1], p_array);
+    }
+
+    inline void adjust_heap(int64_t p_first, int64_t p_hole_idx, int64_t p_len, T p_value, T* p_array) const {
+        int64_t top_index = p_hole_idx;
+        int64_t second_child = 2 * p_hole_idx + 2;
+
+        while (second_child < p_len) {
+            if (compare(p_array[p_first + second_child], p_array[p_first + (second_child - 1)])) {
+                second_child--;
+            }
+
+            p_array[p_first + p_hole_idx] = std::move(p_array[p_first + second_child]);
+            p_hole_idx = second_child;
+            second_child = 2 * (second_child + 1);
+        }
+
+        if (second_child == p_len) {
+            p_array[p_first + p_hole_idx] = std::move(p_array[p_first + (second_child - 1)]);
+            p_hole_idx = second_child - 1;
+        }
+        push_heap(p_first, p_hole_idx, top_index, std::move(p_value), p_array);
+    }
+
+    inline void sort_heap(int64_t p_first, int64_t p_last, T* p_array) const {
+        while (p_last - p_first > 1) {
+            pop_heap(p_first, p_last--, p_array);
+        }
+    }
+
+    inline void make_heap(int64_t p_first, int64_t p_last, T* p_array) const {
+        if (p_last - p_first < 2) {
+            return;
+        }
+        int64_t len = p_last - p_first;
+        int64_t parent = (len - 2) / 2;
+
+        while (true) {
+            adjust_heap(p_first, parent, len, p_array[p_first + parent], p_array);
+            if (parent == 0) {
+                return;
+            }
+            parent--;
+        }
+    }
+
+    inline void partial_sort(int64_t p_first, int64_t p_last, int64_t p_middle, T* p_array) const {
+        make_heap(p_first, p_middle, p_array);
+        for (int64_t i = p_middle; i < p_last; i++) {
+            if (compare(p_array[i], p_array[p_first])) {
+                pop_heap(p_first, p_middle, i, p_array[i], p_array);
+            }
+        }
+        sort_heap(p_first, p_middle, p_array);
+    }
+
+    inline void partial_select(int64_t p_first, int64_t p_last, int64_t p_middle, T* p_array) const {
+        make_heap(p_first, p_middle, p_array);
+        for (int64_t i = p_middle; i < p_last; i++) {
+            if (compare(p_array[i], p_array[p_first])) {
+                pop_heap(p_first, p_middle, i, p_array[i], p_array);
+            }
+        }
+    }
+
+    inline int64_t partitioner(int64_t p_first, int64_t p_last, T p_pivot, T* p_array) const {
+        const int64_t unmodified_first = p_first;
+        const int64_t unmodified_last = p_last;
+
+        while (true) {
+            while (compare(p_array[p_first], p_pivot)) {
+                if constexpr (Validate) {
+                    ERR_BAD_COMPARE(p_first == unmodified_last - 1);
+                }
+                p_first++;
+            }
+            p_last--;
+            while (compare(p_pivot, p_array[p_last])) {
+                if constexpr (Validate) {
+                    ERR_BAD_COMPARE(p_last == unmodified_first);
+                }
+                p_last--;
+            }
+
+            if (!(p_first < p_last)) {
+                return p_first;
+            }
+
+            SWAP(p_array[p_first], p_array[p_last]);
+            p_first++;
+        }
+    }
+
+    inline void introsort(int64_t p_first, int64_t p_last, T* p_array, int64_t p_max_depth) const {
+        while (p_last - p_first > INTROSORT_THRESHOLD) {
+            if (p_max_depth == 0) {
+                partial_sort(p_first, p_last, p_last, p_array);
+                return;
+            }
+
+            p_max_depth--;
+
+            int64_t cut = partitioner(
+                    p_first,
+                    p_last,
+                    median_of_3(
+                            p_array[p_first],
+                            p_array[p_first + (p_last - p_first) / 2],
+                            p_array[p_last - 1]),
+                    p_array);
+
+            introsort(cut, p_last, p_array, p_max_depth);
+            p_last = cut;
+        }
+    }
+
+    inline void introselect(int64_t p_first, int64_t p_nth, int64_t p_last, T* p_array, int64_t p_max_depth) const {
+        while (p_last - p_first > 3) {
+            if (p_max_depth == 0) {
+                // The heap's root is the largest of the p_nth + 1 smallest.
+                partial_select(p_first, p_last, p_nth + 1, p_array);
+                SWAP(p_array[p_first], p_array[p_nth]);
+                return;
+            }
+
+            p_max_depth--;
+
+            int64_t cut = partitioner(
+                    p_first,
+                    p_last,
+                    median_of_3(
+                            p_array[p_first],
+                            p_array[p_first + (p_last - p_first) / 2],
+                            p_array[p_last - 1]),
+                    p_array);
+
+            if (cut <= p_nth) {
+                p_first = cut;
+            } else {
+                p_last = cut;
+            }
+        }
+
+        insertion_sort(p_first, p_last, p_array);
+    }
+
+    inline void unguarded_linear_insert(int64_t p_last, T p_value, T* p_array) const {
+        int64_t next = p_last - 1;
+        while (compare(p_value, p_array[next])) {
+            if constexpr (Validate) {
+                ERR_BAD_COMPARE(next == 0);
+            }
+            p_array[p_last] = std::move(p_array[next]);
+            p_last = next;
+            next--;
+        }
+        p_array[p_last] = std::move(p_value);
+    }
+
+    inline void linear_insert(int64_t p_first, int64_t p_last, T* p_array) const {
+        T val = std::move(p_array[p_last]);
+        if (compare(val, p_array[p_first])) {
+            for (int64_t i = p_last; i > p_first; i--) {
+                p_array[i] = std::move(p_array[i - 1]);
+            }
+
+            p_array[p_first] = std::move(val);
+        } else {
+            unguarded_linear_insert(p_last, std::move(val), p_array);
+        }
+    }
+
+    inline void insertion_sort(int64_t p_first, int64_t p_last, T* p_array) const {
+        if (p_first == p_last) {
+            return;
+        }
+        for (int64_t i = p_first + 1; i != p_last; i++) {
+            linear_insert(p_first, i, p_array);
+        }
+    }
+
+    inline void unguarded_insertion_sort(int64_t p_first, int64_t p_last, T* p_array) const {
+        for (int64_t i = p_first; i != p_last; i++) {
+            unguarded_linear_insert(i, p_array[i], p_array);
+        }
+    }
+
+    inline void final_insertion_sort(int64_t p_first, int64_t p_last, T* p_array) const {
+        if (p_last - p_first > INTROSORT_THRESHOLD) {
+            insertion_sort(p_first, p_first + INTROSORT_THRESHOLD, p_array);
+            unguarded_insertion_sort(p_first + INTROSORT_THRESHOLD, p_last, p_array);
+        } else {
+            insertion_sort(p_first, p_last, p_array);
+        }
+    }
+
+    inline void sort_range(int64_t p_first, int64_t p_last, T* p_array) const {
+        if (p_first != p_last) {
+            introsort(p_first, p_last, p_array, bitlog(p_last - p_first) * 2);
+            final_insertion_sort(p_first, p_last, p_array);
+        }
+    }
+
+    inline void sort(T* p_array, int64_t p_len) const {
+        sort_range(0, p_len, p_array);
+    }
+
+    inline void nth_element(int64_t p_first, int64_t p_last, int64_t p_nth, T* p_array) const {
+        if (p_first == p_last || p_nth == p_last) {
+            return;
+        }
+        introselect(p_first, p_nth, p_last, p_array, bitlog(p_last - p_first) * 2);
+    }
+
+    /** Merges the sorted runs [p_first, p_middle) and [p_middle, p_last) of
+     *  p_src into p_dst. Takes from the left run on ties. */
+    inline void merge(int64_t p_first, int64_t p_middle, int64_t p_last, T* p_src, T* p_dst) const {
+        int64_t left = p_first;
+        int64_t right = p_middle;
+        int64_t out = p_first;
+        while (left < p_middle && right < p_last) {
+            if (compare(p_src[right], p_src[left])) {
+                p_dst[out++] = std::move(p_src[right++]);
+            } else {
+                p_dst[out++] = std::move(p_src[left++]);
+            }
+        }
+        while (left < p_middle) {
+            p_dst[out++] = std::move(p_src[left++]);
+        }
+        while (right < p_last) {
+            p_dst[out++] = std::move(p_src[right++]);
+        }
+    }
+
+    /** Same result as sort(). Arrays of at least PARALLEL_THRESHOLD elements
+     *  are split in one chunk per WorkerPool thread (a power of two, at most
+     *  p_max_threads when non zero); chunks are sorted concurrently and then
+     *  merged pairwise, each merge level running concurrently too. */
+    void parallel_sort(T* p_array, int64_t p_len, int p_max_threads = 0) const {
+        int64_t threads = WorkerPool::get_thread_count();
+        if (p_max_threads > 0) {
+            threads = MIN(threads, (int64_t)p_max_threads);
+        }
+        threads = MIN(threads, p_len / PARALLEL_MIN_CHUNK);
+        if (p_len < PARALLEL_THRESHOLD || threads < 2) {
+            sort(p_array, p_len);
+            return;
+        }
+
+        int64_t chunks = 1;
+        while (chunks * 2 <= threads) {
+            chunks *= 2;
+        }
+
+        // Chunk i spans [bounds[i], bounds[i + 1]).
+        int64_t* bounds = memnew_arr(int64_t, chunks + 1);
+        for (int64_t i = 0; i <= chunks; i++) {
+            bounds[i] = p_len * i / chunks;
+        }
+
+        WorkerPool::parallel_for(chunks, int(chunks), [this, p_array, bounds](int64_t p_chunk, int) {
+            sort_range(bounds[p_chunk], bounds[p_chunk + 1], p_array);
+        });
+
+        // Ping-pong between the array and a scratch buffer, halving the run
+        // count every level.
+        T* scratch = memnew_arr(T, p_len);
+        T* src = p_array;
+        T* dst = scratch;
+        for (int64_t width = 1; width < chunks; width *= 2) {
+            const int64_t merges = chunks / (width * 2);
+            WorkerPool::parallel_for(merges, int(merges), [this, src, dst, bounds, width](int64_t p_merge, int) {
+                const int64_t first = p_merge * width * 2;
+                merge(bounds[first], bounds[first + width], bounds[first + width * 2], src, dst);
+            });
+            SWAP(src, dst);
+        }
+
+        if (src != p_array) {
+            for (int64_t i = 0; i < p_len; i++) {
+                p_array[i] = std::move(src[i]);
+            }
+        }
+
+        memdelete_arr(scratch);
+        memdelete_arr(bounds);
+    }
+};
+
+/** Least significant digit radix sort for integer and floating point keys,
+ *  ordered like operator<. Keys are mapped to unsigned integers that sort the
+ *  same way (sign bit flipped for signed integers, all bits flipped for
+ *  negative floats), then sorted a byte at a time; bytes every key agrees on
+ *  are skipped. Small arrays go to SortArray instead.
+ *
+ *  Floats compare by bits: -0.0 sorts before 0.0 and NaNs go to the ends.
+ */
+template <typename T>
+class RadixSort {
+    static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, "RadixSort needs integer or floating point keys.");
+
+    enum {
+        /** Below this, the histograms cost more than the comparisons. */
+        RADIX_THRESHOLD = 256,
+        RADIX_BITS = 8,
+        RADIX_BUCKETS = 1 << RADIX_BITS,
+    };
+
+    typedef typename std::conditional<sizeof(T) == 1, uint8_t,
+            typename std::conditional<sizeof(T) == 2, uint16_t,
+                    typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type>::type>::type Key;
+
+    static constexpr Key SIGN_BIT = Key(1) << (sizeof(Key) * 8 - 1);
+
+    static _FORCE_INLINE_ Key to_key(T p_value) {
+        Key bits;
+        memcpy(&bits, &p_value, sizeof(Key));
+        if constexpr (std::is_floating_point<T>::value) {
+            return (bits & SIGN_BIT) ? Key(~bits) : Key(bits | SIGN_BIT);
+        } else if constexpr (std::is_signed<T>::value) {
+            return bits ^ SIGN_BIT;
+        } else {
+            return bits;
+        }
+    }
+
+    static _FORCE_INLINE_ T from_key(Key p_key) {
+        Key bits;
+        if constexpr (std::is_floating_point<T>::value) {
+            bits = (p_key & SIGN_BIT) ? Key(p_key & ~SIGN_BIT) : Key(~p_key);
+        } else if constexpr (std::is_signed<T>::value) {
+            bits = p_key ^ SIGN_BIT;
+        } else {
+            bits = p_key;
+        }
+        T value;
+        memcpy(&value, &bits, sizeof(Key));
+        return value;
+    }
+
+public:
+    static void sort(T* p_array, int64_t p_len) {
+        if (p_len < RADIX_THRESHOLD) {
+            SortArray<T> sorter;
+            sorter.sort(p_array, p_len);
+            return;
+        }
+
+        const int passes = sizeof(Key);
+        Key* keys = (Key*)memalloc(sizeof(Key) * p_len * 2);
+        ERROR_FAIL_NULL(keys);
+        Key* buffer = keys + p_len;
+
+        // All histograms in a single read of the input.
+        uint64_t* counts = (uint64_t*)memalloc(sizeof(uint64_t) * RADIX_BUCKETS * passes);
+        memset(counts, 0, sizeof(uint64_t) * RADIX_BUCKETS * passes);
+        for (int64_t i = 0; i < p_len; i++) {
+            const Key key = to_key(p_array[i]);
+            keys[i] = key;
+            for (int pass = 0; pass < passes; pass++) {
+                counts[pass * RADIX_BUCKETS + ((key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1))]++;
+            }
+        }
+
+        Key* src = keys;
+        Key* dst = buffer;
+        for (int pass = 0; pass < passes; pass++) {
+            uint64_t* count = counts + pass * RADIX_BUCKETS;
+            const int shift = pass * RADIX_BITS;
+            if (count[(src[0] >> shift) & (RADIX_BUCKETS - 1)] == (uint64_t)p_len) {
+                continue;
+            }
+
+            uint64_t offset = 0;
+            for (int b = 0; b < RADIX_BUCKETS; b++) {
+                const uint64_t c = count[b];
+                count[b] = offset;
+                offset += c;
+            }
+            for (int64_t i = 0; i < p_len; i++) {
+                const Key key = src[i];
+                dst[count[(key >> shift) & (RADIX_BUCKETS - 1)]++] = key;
+            }
+            SWAP(src, dst);
+        }
+
+        for (int64_t i = 0; i < p_len; i++) {
+            p_array[i] = from_key(src[i]);
+        }
+
+        memfree(counts);
+        memfree(keys);
+    }
+};
+
 #endif
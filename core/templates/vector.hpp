@@ -1,4 +1,241 @@
 #ifndef __VECTOR_HPP__
 #define __VECTOR_HPP__
 
+/**
+ * @class Vector
+ * Vector container. Simple copy-on-write container.
+ *
+ * LocalVector is an alternative available for internal use when COW is not
+ * required.
+ */
+
+#include "../error/error_macros.hpp"
+#include "../os/memory.hpp"
+#include "./cowdata.hpp"
+#include "./sort_array.hpp"
+
+#include <initializer_list>
+#include <utility>
+
+template <typename T>
+class VectorWriteProxy {
+public:
+    _FORCE_INLINE_ T& operator[](typename CowData<T>::Size p_index) {
+        CRASH_BAD_INDEX(p_index, ((Vector<T>*)(this))->_cowdata.size());
+
+        return ((Vector<T>*)(this))->_cowdata.ptrw()[p_index];
+    }
+};
+
+template <typename T>
+class Vector {
+    friend class VectorWriteProxy<T>;
+
+public:
+    VectorWriteProxy<T> write;
+    typedef typename CowData<T>::Size Size;
+
+private:
+    CowData<T> _cowdata;
+
+public:
+    /** Returns true on success. */
+    bool push_back(T p_elem) {
+        Errors err = _cowdata.resize(_cowdata.size() + 1);
+        ERROR_FAIL_COND_V(err != Errors::NONE, false);
+        set(_cowdata.size() - 1, p_elem);
+
+        return true;
+    }
+
+    _FORCE_INLINE_ bool append(const T& p_elem) { return push_back(p_elem); }
+
+    void append_array(const Vector<T>& p_other) {
+        const Size ds = p_other.size();
+        if (ds == 0) {
+            return;
+        }
+
+        const Size bs = size();
+        resize(bs + ds);
+        T* p = ptrw();
+        const T* src = p_other.ptr();
+        for (Size i = 0; i < ds; ++i) {
+            p[bs + i] = src[i];
+        }
+    }
+
+    void fill(const T& p_elem) {
+        T* p = ptrw();
+        for (Size i = 0; i < size(); i++) {
+            p[i] = p_elem;
+        }
+    }
+
+    void remove_at(Size p_index) { _cowdata.remove_at(p_index); }
+
+    _FORCE_INLINE_ bool erase(const T& p_val) {
+        Size idx = find(p_val);
+        if (idx >= 0) {
+            remove_at(idx);
+            return true;
+        }
+
+        return false;
+    }
+
+    void reverse() {
+        T* p = ptrw();
+        for (Size i = 0; i < size() / 2; i++) {
+            SWAP(p[i], p[size() - i - 1]);
+        }
+    }
+
+    _FORCE_INLINE_ T* ptrw() { return _cowdata.ptrw(); }
+    _FORCE_INLINE_ const T* ptr() const { return _cowdata.ptr(); }
+    _FORCE_INLINE_ void clear() { resize(0); }
+    _FORCE_INLINE_ bool is_empty() const { return _cowdata.is_empty(); }
+
+    _FORCE_INLINE_ T get(Size p_index) { return _cowdata.get(p_index); }
+    _FORCE_INLINE_ const T& get(Size p_index) const { return _cowdata.get(p_index); }
+    _FORCE_INLINE_ void set(Size p_index, const T& p_elem) { _cowdata.set(p_index, p_elem); }
+    _FORCE_INLINE_ Size size() const { return _cowdata.size(); }
+
+    Errors resize(Size p_size) { return _cowdata.resize(p_size); }
+    Errors resize_zeroed(Size p_size) { return _cowdata.template resize<true>(p_size); }
+
+    _FORCE_INLINE_ const T& operator[](Size p_index) const { return _cowdata.get(p_index); }
+
+    Errors insert(Size p_pos, T p_val) { return _cowdata.insert(p_pos, p_val); }
+
+    Size find(const T& p_val, Size p_from = 0) const { return _cowdata.find(p_val, p_from); }
+    Size rfind(const T& p_val, Size p_from = -1) const { return _cowdata.rfind(p_val, p_from); }
+    Size count(const T& p_val) const { return _cowdata.count(p_val); }
+    bool has(const T& p_val) const { return find(p_val) != -1; }
+
+    void sort() { sort_custom<_DefaultComparator<T>>(); }
+
+    template <typename Comparator, bool Validate = SORT_ARRAY_DEFAULT_VALIDATE, typename... Args>
+    void sort_custom(Args&&... args) {
+        Size len = _cowdata.size();
+        if (len == 0) {
+            return;
+        }
+
+        T* data = ptrw();
+        SortArray<T, Comparator, Validate> sorter{ args... };
+        sorter.sort(data, len);
+    }
+
+    Vector<T> slice(Size p_begin, Size p_end = CowData<T>::MAX_INT) const {
+        Vector<T> result;
+
+        const Size s = size();
+
+        Size begin = CLAMP(p_begin, -s, s);
+        if (begin < 0) {
+            begin += s;
+        }
+        Size end = CLAMP(p_end, -s, s);
+        if (end < 0) {
+            end += s;
+        }
+
+        ERROR_FAIL_COND_V(begin > end, result);
+
+        Size result_size = end - begin;
+        result.resize(result_size);
+
+        const T* const r = ptr();
+        T* const w = result.ptrw();
+        for (Size i = 0; i < result_size; ++i) {
+            w[i] = r[begin + i];
+        }
+
+        return result;
+    }
+
+    bool operator==(const Vector<T>& p_arr) const {
+        Size s = size();
+        if (s != p_arr.size()) {
+            return false;
+        }
+        for (Size i = 0; i < s; i++) {
+            if (operator[](i) != p_arr[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const Vector<T>& p_arr) const {
+        return !operator==(p_arr);
+    }
+
+    struct Iterator {
+        _FORCE_INLINE_ T& operator*() const { return *elem_ptr; }
+        _FORCE_INLINE_ T* operator->() const { return elem_ptr; }
+        _FORCE_INLINE_ Iterator& operator++() {
+            elem_ptr++;
+            return *this;
+        }
+        _FORCE_INLINE_ Iterator& operator--() {
+            elem_ptr--;
+            return *this;
+        }
+
+        _FORCE_INLINE_ bool operator==(const Iterator& b) const { return elem_ptr == b.elem_ptr; }
+        _FORCE_INLINE_ bool operator!=(const Iterator& b) const { return elem_ptr != b.elem_ptr; }
+
+        Iterator(T* p_ptr) { elem_ptr = p_ptr; }
+        Iterator() {}
+        Iterator(const Iterator& p_it) { elem_ptr = p_it.elem_ptr; }
+
+    private:
+        T* elem_ptr = nullptr;
+    };
+
+    struct ConstIterator {
+        _FORCE_INLINE_ const T& operator*() const { return *elem_ptr; }
+        _FORCE_INLINE_ const T* operator->() const { return elem_ptr; }
+        _FORCE_INLINE_ ConstIterator& operator++() {
+            elem_ptr++;
+            return *this;
+        }
+        _FORCE_INLINE_ ConstIterator& operator--() {
+            elem_ptr--;
+            return *this;
+        }
+
+        _FORCE_INLINE_ bool operator==(const ConstIterator& b) const { return elem_ptr == b.elem_ptr; }
+        _FORCE_INLINE_ bool operator!=(const ConstIterator& b) const { return elem_ptr != b.elem_ptr; }
+
+        ConstIterator(const T* p_ptr) { elem_ptr = p_ptr; }
+        ConstIterator() {}
+        ConstIterator(const ConstIterator& p_it) { elem_ptr = p_it.elem_ptr; }
+
+    private:
+        const T* elem_ptr = nullptr;
+    };
+
+    _FORCE_INLINE_ Iterator begin() { return Iterator(ptrw()); }
+    _FORCE_INLINE_ Iterator end() { return Iterator(ptrw() + size()); }
+
+    _FORCE_INLINE_ ConstIterator begin() const { return ConstIterator(ptr()); }
+    _FORCE_INLINE_ ConstIterator end() const { return ConstIterator(ptr() + size()); }
+
+    _FORCE_INLINE_ Vector() {}
+    _FORCE_INLINE_ Vector(std::initializer_list<T> p_init) :
+            _cowdata(p_init) {}
+    _FORCE_INLINE_ Vector(const Vector& p_from) :
+            _cowdata(p_from._cowdata) {}
+    _FORCE_INLINE_ Vector(Vector&& p_from) :
+            _cowdata(std::move(p_from._cowdata)) {}
+
+    _FORCE_INLINE_ void operator=(const Vector& p_from) { _cowdata = p_from._cowdata; }
+    _FORCE_INLINE_ void operator=(Vector&& p_from) { _cowdata = std::move(p_from._cowdata); }
+
+    _FORCE_INLINE_ ~Vector() {}
+};
+
 #endif
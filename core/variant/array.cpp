@@ -1,3 +1,1743 @@
 #include "./array.hpp"
 
+#include "../math/math_funcs.hpp"
+#include "../os/worker_pool.hpp"
+#include "../templates/cowdata.hpp"
+#include "../templates/hashfuncs.hpp"
+#include "../templates/search_array.hpp"
+#include "../templates/sort_array.hpp"
+#include "./container_type_validate.hpp"
+#include "./variant.hpp"
 
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+#include <type_traits>
+
+template <typename T>
+struct PackedTag {
+	typedef T Type;
+};
+
+/** Calls p_func with a PackedTag of the C++ type that stores p_type unboxed. */
+template <typename F>
+static _FORCE_INLINE_ void _packed_visit(Variant::Type p_type, F &&p_func) {
+	switch (p_type) {
+		case Variant::BOOL:
+			p_func(PackedTag<bool>());
+			break;
+		case Variant::INT:
+			p_func(PackedTag<int64_t>());
+			break;
+		case Variant::FLOAT:
+			p_func(PackedTag<double>());
+			break;
+		case Variant::VECTOR2:
+			p_func(PackedTag<Vector2>());
+			break;
+		case Variant::VECTOR2I:
+			p_func(PackedTag<Vector2i>());
+			break;
+		case Variant::VECTOR3:
+			p_func(PackedTag<Vector3>());
+			break;
+		case Variant::VECTOR3I:
+			p_func(PackedTag<Vector3i>());
+			break;
+		case Variant::VECTOR4:
+			p_func(PackedTag<Vector4>());
+			break;
+		case Variant::VECTOR4I:
+			p_func(PackedTag<Vector4i>());
+			break;
+		default:
+			break;
+	}
+}
+
+/** Element size when p_type can be stored unboxed, 0 otherwise. */
+static _FORCE_INLINE_ uint32_t _packed_stride(Variant::Type p_type) {
+	uint32_t stride = 0;
+	_packed_visit(p_type, [&](auto p_tag) {
+		stride = sizeof(typename decltype(p_tag)::Type);
+	});
+	return stride;
+}
+
+/** Storage shared by every Array that references the same array.
+ *
+ *  Elements live either boxed, in a CowData<Variant>, or unboxed, in a byte
+ *  CowData holding a contiguous run of the element type. Arrays typed to
+ *  bool, int, float or a vector type start unboxed: values are converted on
+ *  the way in and out, and find, sort, bsearch, min/max and friends run on
+ *  the raw elements. Taking a mutable reference to an element (operator[],
+ *  the iterators) needs a Variant to point to, so it switches the array to
+ *  boxed storage until it's cleared. The const accessors read unboxed
+ *  elements by value and never switch: other threads may be reading.
+ *
+ *  duplicate() and slice() hand the same buffer to a new ArrayPrivate and
+ *  only pay for a copy on the first write. A slice with step 1 is a view
+ *  (view_offset, view_size) over the shared buffer; it becomes a buffer of its
+ *  own on the first write. All writes go through the helpers below, which take
+ *  care of both.
+ *
+ *  The helpers also drop the cached hash. Arrays that contain other arrays
+ *  don't cache it, because writes to the nested arrays don't come through
+ *  here. Neither do arrays that handed out a mutable reference to an element,
+ *  until they're cleared.
+ */
+struct ArrayPrivate {
+	SafeRefCount refcount;
+	CowData<Variant> array;
+	CowData<uint8_t> packed;
+	Variant::Type packed_type = Variant::NIL; // NIL while boxed.
+	uint32_t packed_stride = 0;
+	int64_t view_offset = 0;
+	int64_t view_size = -1; // Negative when the whole buffer is used.
+	Variant *read_only = nullptr; // If enabled, a pointer is used to a temporary value that is used to return read-only values.
+	ContainerTypeValidate typed;
+	/** recursive_hash() in the low bits when HASH_CACHE_VALID is set. */
+	mutable SafeNumeric<uint64_t> hash_cache;
+	bool hash_cacheable = true;
+
+	static constexpr uint64_t HASH_CACHE_VALID = uint64_t(1) << 32;
+
+	_FORCE_INLINE_ void invalidate_hash() {
+		hash_cache.set_relaxed(0);
+	}
+
+	_FORCE_INLINE_ bool is_packed() const {
+		return packed_type != Variant::NIL;
+	}
+
+	_FORCE_INLINE_ int64_t size() const {
+		if (view_size >= 0) {
+			return view_size;
+		}
+		return is_packed() ? packed.size() / packed_stride : array.size();
+	}
+
+	/** Boxed storage only. */
+	_FORCE_INLINE_ const Variant *ptr() const {
+		return array.ptr() + view_offset;
+	}
+
+	_FORCE_INLINE_ Variant *ptrw() {
+		if (unlikely(view_size >= 0)) {
+			_detach_view();
+		}
+		invalidate_hash();
+		return array.ptrw();
+	}
+
+	/** Unboxed storage only, T must match packed_type. */
+	template <typename T>
+	_FORCE_INLINE_ const T *packed_ptr() const {
+		return reinterpret_cast<const T *>(packed.ptr()) + view_offset;
+	}
+
+	template <typename T>
+	_FORCE_INLINE_ T *packed_ptrw() {
+		if (unlikely(view_size >= 0)) {
+			_detach_view();
+		}
+		invalidate_hash();
+		return reinterpret_cast<T *>(packed.ptrw());
+	}
+
+	/** Reads element p_index. Boxed elements are returned in place, unboxed
+	 *  ones are boxed into r_scratch. */
+	_FORCE_INLINE_ const Variant &read(int64_t p_index, Variant &r_scratch) const {
+		if (!is_packed()) {
+			return ptr()[p_index];
+		}
+		_packed_visit(packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			r_scratch = packed_ptr<T>()[p_index];
+		});
+		return r_scratch;
+	}
+
+	/** p_value must have been validated against the element type. */
+	_FORCE_INLINE_ void write(int64_t p_index, const Variant &p_value) {
+		if (!is_packed()) {
+			ptrw()[p_index] = p_value;
+			return;
+		}
+		_packed_visit(packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			packed_ptrw<T>()[p_index] = p_value.operator T();
+		});
+	}
+
+	/** Shares p_from's buffer, including its view. */
+	void share(const ArrayPrivate *p_from) {
+		array = p_from->array;
+		packed = p_from->packed;
+		packed_type = p_from->packed_type;
+		packed_stride = p_from->packed_stride;
+		view_offset = p_from->view_offset;
+		view_size = p_from->view_size;
+		invalidate_hash();
+	}
+
+	/** New elements are zeroed when unboxed, which is the default value of
+	 *  every unboxed type. */
+	Errors resize(int64_t p_size) {
+		if (unlikely(view_size >= 0)) {
+			_detach_view();
+		}
+		invalidate_hash();
+		if (is_packed()) {
+			return packed.resize<true>(p_size * packed_stride);
+		}
+		return array.resize(p_size);
+	}
+
+	Errors insert(int64_t p_pos, const Variant &p_value) {
+		if (!is_packed()) {
+			if (unlikely(view_size >= 0)) {
+				_detach_view();
+			}
+			invalidate_hash();
+			return array.insert(p_pos, p_value);
+		}
+
+		const int64_t old_size = size();
+		ERROR_FAIL_INDEX_V(p_pos, old_size + 1, Errors::ERROR_INVALID_PARAMETER);
+		Errors err = resize(old_size + 1);
+		ERROR_FAIL_COND_V(err != Errors::NONE, err);
+		uint8_t *w = packed.ptrw();
+		memmove(w + (p_pos + 1) * packed_stride, w + p_pos * packed_stride, (old_size - p_pos) * packed_stride);
+		write(p_pos, p_value);
+		return Errors::NONE;
+	}
+
+	void remove_at(int64_t p_pos) {
+		if (!is_packed()) {
+			if (unlikely(view_size >= 0)) {
+				_detach_view();
+			}
+			invalidate_hash();
+			array.remove_at(p_pos);
+			return;
+		}
+
+		const int64_t old_size = size();
+		ERROR_FAIL_INDEX(p_pos, old_size);
+		if (unlikely(view_size >= 0)) {
+			_detach_view();
+		}
+		uint8_t *w = packed.ptrw();
+		memmove(w + p_pos * packed_stride, w + (p_pos + 1) * packed_stride, (old_size - p_pos - 1) * packed_stride);
+		resize(old_size - 1);
+	}
+
+	/** Appends every element of p_src, validating them when p_validate.
+	 *  p_src must not be this ArrayPrivate, but may share its buffer. */
+	bool append_from(const ArrayPrivate &p_src, bool p_validate, const char *p_operation) {
+		const int64_t count = p_src.size();
+		if (count == 0) {
+			return true;
+		}
+		const int64_t from = size();
+
+		if (is_packed() && p_src.packed_type == packed_type) {
+			ERROR_FAIL_COND_V(resize(from + count) != Errors::NONE, false);
+			memcpy(packed.ptrw() + from * packed_stride, p_src.packed.ptr() + p_src.view_offset * packed_stride, count * packed_stride);
+			return true;
+		}
+
+		if (!is_packed() && !p_src.is_packed() && !p_validate) {
+			ERROR_FAIL_COND_V(resize(from + count) != Errors::NONE, false);
+			Variant *w = array.ptrw() + from;
+			const Variant *r = p_src.ptr();
+			for (int64_t i = 0; i < count; i++) {
+				w[i] = r[i];
+			}
+			return true;
+		}
+
+		ERROR_FAIL_COND_V(resize(from + count) != Errors::NONE, false);
+		Variant scratch;
+		for (int64_t i = 0; i < count; i++) {
+			const Variant &element = p_src.read(i, scratch);
+			if (p_validate) {
+				Variant value = element;
+				if (unlikely(!typed.validate(value, p_operation))) {
+					resize(from);
+					return false;
+				}
+				write(from + i, value);
+			} else {
+				write(from + i, element);
+			}
+		}
+		return true;
+	}
+
+	/** Stores the elements unboxed from now on, if the element type allows. */
+	void set_packed(Variant::Type p_type) {
+		DEV_ASSERT(size() == 0);
+		packed_stride = _packed_stride(p_type);
+		packed_type = packed_stride ? p_type : Variant::NIL;
+	}
+
+	/** Moves the elements to boxed storage. */
+	void box() {
+		if (!is_packed()) {
+			return;
+		}
+
+		const int64_t count = size();
+		CowData<Variant> boxed;
+		ERROR_FAIL_COND(boxed.resize(count) != Errors::NONE);
+		Variant *w = boxed.ptrw();
+		_packed_visit(packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			const T *r = packed_ptr<T>();
+			for (int64_t i = 0; i < count; i++) {
+				w[i] = r[i];
+			}
+		});
+
+		array = std::move(boxed);
+		packed = CowData<uint8_t>();
+		packed_type = Variant::NIL;
+		packed_stride = 0;
+		view_offset = 0;
+		view_size = -1;
+	}
+
+	void clear() {
+		array.clear();
+		packed.clear();
+		view_offset = 0;
+		view_size = -1;
+		invalidate_hash();
+		hash_cacheable = true;
+		set_packed(typed.type);
+	}
+
+	void _detach_view() {
+		if (is_packed()) {
+			CowData<uint8_t> detached;
+			ERROR_FAIL_COND(detached.resize(view_size * packed_stride) != Errors::NONE);
+			memcpy(detached.ptrw(), packed.ptr() + view_offset * packed_stride, view_size * packed_stride);
+			packed = std::move(detached);
+		} else {
+			CowData<Variant> detached;
+			ERROR_FAIL_COND(detached.resize(view_size) != Errors::NONE);
+			Variant *w = detached.ptrw();
+			const Variant *r = ptr();
+			for (int64_t i = 0; i < view_size; i++) {
+				w[i] = r[i];
+			}
+			array = std::move(detached);
+		}
+		view_offset = 0;
+		view_size = -1;
+	}
+};
+
+void Array::_ref(const Array &p_from) const {
+	ArrayPrivate *_fp = p_from._p;
+
+	ERROR_FAIL_NULL(_fp); // Should NOT happen.
+
+	if (_fp == _p) {
+		return; // whatever it is, nothing to do here move along
+	}
+
+	bool success = _fp->refcount.ref();
+
+	ERROR_FAIL_COND(!success); // should really not happen either
+
+	_unref();
+
+	_p = _fp;
+}
+
+void Array::_unref() const {
+	if (!_p) {
+		return;
+	}
+
+	if (_p->refcount.unref()) {
+		if (_p->read_only) {
+			memdelete(_p->read_only);
+		}
+		memdelete(_p);
+	}
+	_p = nullptr;
+}
+
+Array::Iterator Array::begin() {
+	_p->box();
+	_p->hash_cacheable = false;
+	Variant *ptr = _p->ptrw();
+	return Iterator(ptr, _p->read_only);
+}
+
+Array::Iterator Array::end() {
+	_p->box();
+	_p->hash_cacheable = false;
+	Variant *ptr = _p->ptrw();
+	return Iterator(ptr + _p->size(), _p->read_only);
+}
+
+Array::ConstIterator Array::begin() const {
+	if (_p->is_packed()) {
+		return ConstIterator(_p->packed.ptr() + _p->view_offset * _p->packed_stride, _p->packed_stride, uint8_t(_p->packed_type));
+	}
+	return ConstIterator(_p->ptr());
+}
+
+Array::ConstIterator Array::end() const {
+	if (_p->is_packed()) {
+		return ConstIterator(_p->packed.ptr() + (_p->view_offset + _p->size()) * _p->packed_stride, _p->packed_stride, uint8_t(_p->packed_type));
+	}
+	return ConstIterator(_p->ptr() + _p->size());
+}
+
+Variant Array::ConstIterator::_read_packed() const {
+	Variant value;
+	_packed_visit(Variant::Type(packed_type), [&](auto p_tag) {
+		typedef typename decltype(p_tag)::Type T;
+		value = *reinterpret_cast<const T *>(element_ptr);
+	});
+	return value;
+}
+
+Variant &Array::operator[](int p_idx) {
+	CRASH_BAD_INDEX(p_idx, _p->size());
+	_p->box();
+	if (unlikely(_p->read_only)) {
+		*_p->read_only = _p->ptr()[p_idx];
+		return *_p->read_only;
+	}
+	_p->hash_cacheable = false;
+	return _p->ptrw()[p_idx];
+}
+
+Variant Array::operator[](int p_idx) const {
+	return get(p_idx);
+}
+
+int Array::size() const {
+	return _p->size();
+}
+
+bool Array::is_empty() const {
+	return _p->size() == 0;
+}
+
+void Array::clear() {
+	ERROR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	_p->clear();
+}
+
+bool Array::operator==(const Array &p_array) const {
+	return recursive_equal(p_array, 0);
+}
+
+bool Array::operator!=(const Array &p_array) const {
+	return !recursive_equal(p_array, 0);
+}
+
+bool Array::recursive_equal(const Array &p_array, int recursion_count) const {
+	// Cheap checks
+	if (_p == p_array._p) {
+		return true;
+	}
+	const ArrayPrivate &a1 = *_p;
+	const ArrayPrivate &a2 = *p_array._p;
+	const int64_t size = a1.size();
+	if (size != a2.size()) {
+		return false;
+	}
+
+	if (a1.is_packed() && a1.packed_type == a2.packed_type) {
+		bool equal = true;
+		_packed_visit(a1.packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			const T *r1 = a1.packed_ptr<T>();
+			const T *r2 = a2.packed_ptr<T>();
+			for (int64_t i = 0; i < size && equal; i++) {
+				equal = r1[i] == r2[i];
+			}
+		});
+		return equal;
+	}
+
+	if (!a1.is_packed() && !a2.is_packed() && a1.ptr() == a2.ptr()) {
+		return true;
+	}
+
+	// Heavy O(n) check
+	if (recursion_count > MAX_RECURSION) {
+		ERROR_PRINT("Max recursion reached");
+		return true;
+	}
+	recursion_count++;
+	Variant scratch1;
+	Variant scratch2;
+	for (int64_t i = 0; i < size; i++) {
+		if (!a1.read(i, scratch1).recursive_equal(a2.read(i, scratch2), recursion_count)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint32_t Array::hash() const {
+	return recursive_hash(0);
+}
+
+/** Elements hashed per hash_bytes_64() call. Fixed, so that boxed and
+ *  unboxed arrays holding the same values hash the same. */
+#define ARRAY_HASH_CHUNK 256
+
+/** Hashes an array whose elements are all of type p_type, which must be an
+ *  unboxed type, as runs of raw values. */
+static uint32_t _array_hash_values(const ArrayPrivate &p_array, Variant::Type p_type) {
+	const int64_t size = p_array.size();
+	uint64_t h = hash_murmur3_one_32(p_type, hash_murmur3_one_32(Variant::ARRAY));
+
+	_packed_visit(p_type, [&](auto p_tag) {
+		typedef typename decltype(p_tag)::Type T;
+		/** Floating point elements, and their components, hash by value. */
+		constexpr bool floating = std::is_same<T, double>::value || std::is_same<T, Vector2>::value || std::is_same<T, Vector3>::value || std::is_same<T, Vector4>::value;
+		typedef std::conditional_t<std::is_same<T, double>::value, double, real_t> Scalar;
+		T chunk[ARRAY_HASH_CHUNK];
+		for (int64_t from = 0; from < size; from += ARRAY_HASH_CHUNK) {
+			const int64_t count = MIN(int64_t(ARRAY_HASH_CHUNK), size - from);
+			const T *values = chunk;
+			if (!p_array.is_packed()) {
+				const Variant *r = p_array.ptr() + from;
+				for (int64_t i = 0; i < count; i++) {
+					chunk[i] = r[i].operator T();
+				}
+			} else if constexpr (!floating) {
+				values = p_array.packed_ptr<T>() + from;
+			} else {
+				memcpy(chunk, p_array.packed_ptr<T>() + from, count * sizeof(T));
+			}
+
+			if constexpr (floating) {
+				// Same as hashing a float or vector Variant: 0.0 and -0.0, and all NaNs, are equal.
+				Scalar *scalars = (Scalar *)chunk;
+				const int64_t scalar_count = count * int64_t(sizeof(T) / sizeof(Scalar));
+				for (int64_t i = 0; i < scalar_count; i++) {
+					if (scalars[i] == 0) {
+						scalars[i] = 0;
+					} else if (scalars[i] != scalars[i]) {
+						scalars[i] = NAN;
+					}
+				}
+			}
+
+			h = hash_bytes_64(values, count * sizeof(T), h);
+		}
+	});
+
+	return hash_fold_64_32(h);
+}
+
+uint32_t Array::recursive_hash(int recursion_count) const {
+	if (recursion_count > MAX_RECURSION) {
+		ERROR_PRINT("Max recursion reached");
+		return 0;
+	}
+
+	const uint64_t cached = _p->hash_cache.get_relaxed();
+	if (cached & ArrayPrivate::HASH_CACHE_VALID) {
+		return uint32_t(cached);
+	}
+
+	const int64_t size = _p->size();
+	if (size == 0) {
+		return hash_fmix32(hash_murmur3_one_32(Variant::ARRAY));
+	}
+
+	// Arrays of a single unboxed type hash their raw values, boxed or not.
+	Variant::Type run_type = _p->packed_type;
+	if (!_p->is_packed()) {
+		const Variant *r = _p->ptr();
+		run_type = r[0].get_type();
+		if (_packed_stride(run_type) == 0) {
+			run_type = Variant::NIL;
+		}
+		for (int64_t i = 1; i < size && run_type != Variant::NIL; i++) {
+			if (r[i].get_type() != run_type) {
+				run_type = Variant::NIL;
+			}
+		}
+	}
+
+	uint32_t h;
+	bool nested = false;
+	if (run_type != Variant::NIL) {
+		h = _array_hash_values(*_p, run_type);
+	} else {
+		h = hash_murmur3_one_32(Variant::ARRAY);
+		recursion_count++;
+		const Variant *r = _p->ptr();
+		for (int64_t i = 0; i < size; i++) {
+			nested |= r[i].get_type() == Variant::ARRAY;
+			h = hash_murmur3_one_32(r[i].recursive_hash(recursion_count), h);
+		}
+		h = hash_fmix32(h);
+	}
+
+	if (!nested && _p->hash_cacheable) {
+		_p->hash_cache.set_relaxed(ArrayPrivate::HASH_CACHE_VALID | h);
+	}
+	return h;
+}
+
+void Array::operator=(const Array &p_array) {
+	if (this == &p_array) {
+		return;
+	}
+	_ref(p_array);
+}
+
+void Array::assign(const Array &p_array) {
+	const ContainerTypeValidate &typed = _p->typed;
+	const ContainerTypeValidate &source_typed = p_array._p->typed;
+
+	ERROR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+
+	if (typed.can_skip_validation(source_typed)) {
+		// from same to same or
+		// from anything to variants or
+		// from subclasses to base classes
+		_p->share(p_array._p);
+		if (_p->is_packed() && _p->packed_type != typed.type) {
+			_p->box();
+		}
+		return;
+	}
+
+	ArrayPrivate source;
+	source.share(p_array._p);
+	_p->clear();
+	_p->append_from(source, true, "assign");
+}
+
+void Array::push_back(const Variant &p_value) {
+	ERROR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	Variant value = p_value;
+	ERROR_FAIL_COND(!_p->typed.validate(value, "push_back"));
+	const int64_t size = _p->size();
+	ERROR_FAIL_COND(_p->resize(size + 1) != Errors::NONE);
+	_p->write(size, value);
+}
+
+void Array::append_array(const Array &p_array) {
+	ERROR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+
+	// Keeps the source buffer alive and unchanged even when appending to itself.
+	ArrayPrivate source;
+	source.share(p_array._p);
+
+	const bool validate = !_p->typed.can_skip_validation(p_array._p->typed);
+	_p->append_from(source, validate, "append_array");
+}
+
+Errors Array::resize(int p_new_size) {
+	ERROR_FAIL_COND_V_MSG(_p->read_only, Errors::ERROR_LOCKED, "Array is in read-only state.");
+	Variant::Type variant_type = _p->typed.type;
+	int64_t old_size = _p->size();
+	Errors err = _p->resize(p_new_size);
+	if (err == Errors::NONE && !_p->is_packed() && variant_type != Variant::NIL && variant_type != Variant::OBJECT && p_new_size > old_size) {
+		const Variant value = Variant::construct_default(variant_type);
+		Variant *w = _p->ptrw();
+		for (int64_t i = old_size; i < p_new_size; i++) {
+			w[i] = value;
+		}
+	}
+	return err;
+}
+
+Errors Array::insert(int p_pos, const Variant &p_value) {
+	ERROR_FAIL_COND_V_MSG(_p->read_only, Errors::ERROR_LOCKED, "Array is in read-only state.");
+	Variant value = p_value;
+	ERROR_FAIL_COND_V(!_p->typed.validate(value, "insert"), Errors::ERROR_INVALID_PARAMETER);
+	return _p->insert(p_pos, value);
+}
+
+void Array::fill(const Variant &p_value) {
+	ERROR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	Variant value = p_value;
+	ERROR_FAIL_COND(!_p->typed.validate(value, "fill"));
+	const int64_t size = _p->size();
+
+	if (_p->is_packed()) {
+		_packed_visit(_p->packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			const T element = value.operator T();
+			T *w = _p->packed_ptrw<T>();
+			for (int64_t i = 0; i < size; i++) {
+				w[i] = element;
+			}
+		});
+		return;
+	}
+
+	Variant *w = _p->ptrw();
+	for (int64_t i = 0; i < size; i++) {
+		w[i] = value;
+	}
+}
+
+void Array::erase(const Variant &p_value) {
+	ERROR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	Variant value = p_value;
+	ERROR_FAIL_COND(!_p->typed.validate(value, "erase"));
+	int idx = find(value);
+	if (idx >= 0) {
+		_p->remove_at(idx);
+	}
+}
+
+Variant Array::front() const {
+	ERROR_FAIL_COND_V_MSG(_p->size() == 0, Variant(), "Can't take value from empty array.");
+	return get(0);
+}
+
+Variant Array::back() const {
+	ERROR_FAIL_COND_V_MSG(_p->size() == 0, Variant(), "Can't take value from empty array.");
+	return get(_p->size() - 1);
+}
+
+Variant Array::pick_random() const {
+	ERROR_FAIL_COND_V_MSG(_p->size() == 0, Variant(), "Can't take value from empty array.");
+	return get(Math::rand() % _p->size());
+}
+
+/** Index of the first element equal to p_value in [p_from, p_to), or -1.
+ *  p_value must have been validated against the element type. */
+static int _array_find(const ArrayPrivate &p_array, const Variant &p_value, int64_t p_from, int64_t p_to) {
+	int64_t found = -1;
+	if (p_array.is_packed()) {
+		_packed_visit(p_array.packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			const T value = p_value.operator T();
+			const T *r = p_array.packed_ptr<T>();
+			for (int64_t i = p_from; i < p_to; i++) {
+				if (r[i] == value) {
+					found = i;
+					break;
+				}
+			}
+		});
+		return found;
+	}
+
+	const Variant *r = p_array.ptr();
+	for (int64_t i = p_from; i < p_to; i++) {
+		if (r[i] == p_value) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+int Array::find(const Variant &p_value, int p_from) const {
+	if (_p->size() == 0) {
+		return -1;
+	}
+	Variant value = p_value;
+	ERROR_FAIL_COND_V(!_p->typed.validate(value, "find"), -1);
+
+	const int64_t size = _p->size();
+	if (p_from < 0) {
+		p_from = size + p_from;
+	}
+	if (p_from < 0) {
+		p_from = 0;
+	}
+
+	return _array_find(*_p, value, p_from, size);
+}
+
+int Array::find_custom(const Callable &p_callable, int p_from) const {
+	const int64_t size = _p->size();
+	if (size == 0) {
+		return -1;
+	}
+
+	if (p_from < 0) {
+		p_from = size + p_from;
+	}
+	if (p_from < 0) {
+		p_from = 0;
+	}
+
+	const Variant *argptrs[1];
+	Variant scratch;
+	for (int64_t i = p_from; i < size; i++) {
+		argptrs[0] = &_p->read(i, scratch);
+
+		Variant res;
+		Callable::CallError ce;
+		p_callable.callp(argptrs, 1, res, ce);
+		ERROR_FAIL_COND_V_MSG(ce.error != Callable::CallError::CALL_OK, -1, "Error calling method from 'find_custom'.");
+		ERROR_FAIL_COND_V_MSG(res.get_type() != Variant::Type::BOOL, -1, "Wrong return type from 'find_custom', should be 'bool'.");
+
+		if (res.operator bool()) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+int Array::rfind(const Variant &p_value, int p_from) const {
+	const int64_t size = _p->size();
+	if (size == 0) {
+		return -1;
+	}
+	Variant value = p_value;
+	ERROR_FAIL_COND_V(!_p->typed.validate(value, "rfind"), -1);
+
+	if (p_from < 0) {
+		// Relative offset from the end
+		p_from = size + p_from;
+	}
+	if (p_from < 0 || p_from >= size) {
+		// Limit to array boundaries
+		p_from = size - 1;
+	}
+
+	if (_p->is_packed()) {
+		int64_t found = -1;
+		_packed_visit(_p->packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			const T element = value.operator T();
+			const T *r = _p->packed_ptr<T>();
+			for (int64_t i = p_from; i >= 0; i--) {
+				if (r[i] == element) {
+					found = i;
+					break;
+				}
+			}
+		});
+		return found;
+	}
+
+	const Variant *r = _p->ptr();
+	for (int64_t i = p_from; i >= 0; i--) {
+		if (r[i] == value) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+int Array::rfind_custom(const Callable &p_callable, int p_from) const {
+	const int64_t size = _p->size();
+	if (size == 0) {
+		return -1;
+	}
+
+	if (p_from < 0) {
+		// Relative offset from the end.
+		p_from = size + p_from;
+	}
+	if (p_from < 0 || p_from >= size) {
+		// Limit to array boundaries.
+		p_from = size - 1;
+	}
+
+	const Variant *argptrs[1];
+	Variant scratch;
+	for (int64_t i = p_from; i >= 0; i--) {
+		argptrs[0] = &_p->read(i, scratch);
+
+		Variant res;
+		Callable::CallError ce;
+		p_callable.callp(argptrs, 1, res, ce);
+		ERROR_FAIL_COND_V_MSG(ce.error != Callable::CallError::CALL_OK, -1, "Error calling method from 'rfind_custom'.");
+		ERROR_FAIL_COND_V_MSG(res.get_type() != Variant::Type::BOOL, -1, "Wrong return type from 'rfind_custom', should be 'bool'.");
+
+		if (res.operator bool()) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+int Array::count(const Variant &p_value) const {
+	const int64_t size = _p->size();
+	if (size == 0) {
+		return 0;
+	}
+	Variant value = p_value;
+	ERROR_FAIL_COND_V(!_p->typed.validate(value, "count"), 0);
+
+	int amount = 0;
+	if (_p->is_packed()) {
+		_packed_visit(_p->packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			const T element = value.operator T();
+			const T *r = _p->packed_ptr<T>();
+			for (int64_t i = 0; i < size; i++) {
+				amount += r[i] == element;
+			}
+		});
+		return amount;
+	}
+
+	const Variant *r = _p->ptr();
+	for (int64_t i = 0; i < size; i++) {
+		if (r[i] == value) {
+			amount++;
+		}
+	}
+
+	return amount;
+}
+
+bool Array::has(const Variant &p_value) const {
+	Variant value = p_value;
+	ERROR_FAIL_COND_V(!_p->typed.validate(value, "use 'has'"), false);
+
+	return find(value) != -1;
+}
+
+void Array::remove_at(int p_pos) {
+	ERROR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	ERROR_FAIL_INDEX(p_pos, _p->size());
+	_p->remove_at(p_pos);
+}
+
+void Array::set(int p_idx, const Variant &p_value) {
+	ERROR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	ERROR_FAIL_INDEX(p_idx, _p->size());
+	Variant value = p_value;
+	ERROR_FAIL_COND(!_p->typed.validate(value, "set"));
+
+	_p->write(p_idx, value);
+}
+
+Variant Array::get(int p_idx) const {
+	CRASH_BAD_INDEX(p_idx, _p->size());
+	Variant scratch;
+	return _p->read(p_idx, scratch);
+}
+
+Array Array::duplicate(bool p_deep) const {
+	return recursive_duplicate(p_deep, 0);
+}
+
+Array Array::recursive_duplicate(bool p_deep, int recursion_count) const {
+	Array new_arr;
+	new_arr._p->typed = _p->typed;
+
+	if (recursion_count > MAX_RECURSION) {
+		ERROR_PRINT("Max recursion reached");
+		return new_arr;
+	}
+
+	// Shallow copies and deep copies alike start by sharing the buffer, so
+	// duplicating is O(1) until one of the arrays is written to.
+	new_arr._p->share(_p);
+
+	if (!p_deep || _p->is_packed() || (_p->typed.is_typed() && _p->typed.type != Variant::ARRAY)) {
+		return new_arr;
+	}
+
+	// Only nested containers need their own copy; writing the first one
+	// detaches the buffer, arrays of plain values stay shared.
+	recursion_count++;
+	const int64_t size = _p->size();
+	const Variant *r = _p->ptr();
+	for (int64_t i = 0; i < size; i++) {
+		if (r[i].get_type() == Variant::ARRAY) {
+			new_arr._p->ptrw()[i] = r[i].recursive_duplicate(true, recursion_count);
+		}
+	}
+
+	return new_arr;
+}
+
+Array Array::slice(int p_begin, int p_end, int p_step, bool p_deep) const {
+	Array result;
+	result._p->typed = _p->typed;
+	result._p->set_packed(_p->packed_type);
+
+	ERROR_FAIL_COND_V_MSG(p_step == 0, result, "Slice step cannot be zero.");
+
+	const int s = size();
+
+	if (s == 0 || (p_begin < -s && p_step < 0) || (p_begin >= s && p_step > 0)) {
+		return result;
+	}
+
+	int begin = CLAMP(p_begin, -s, s - 1);
+	if (begin < 0) {
+		begin += s;
+	}
+	int end = CLAMP(p_end, -s - 1, s);
+	if (end < 0) {
+		end += s;
+	}
+
+	ERROR_FAIL_COND_V_MSG(p_step > 0 && begin > end, result, "Slice step is positive, but bounds are decreasing.");
+	ERROR_FAIL_COND_V_MSG(p_step < 0 && begin < end, result, "Slice step is negative, but bounds are increasing.");
+
+	int result_size = (end - begin) / p_step + (((end - begin) % p_step != 0) ? 1 : 0);
+
+	if (p_step == 1 && (!p_deep || _p->is_packed())) {
+		// Contiguous shallow slices are views over the shared buffer.
+		result._p->share(_p);
+		if (result_size != s) {
+			result._p->view_offset = _p->view_offset + begin;
+			result._p->view_size = result_size;
+		}
+		return result;
+	}
+
+	ERROR_FAIL_COND_V(result._p->resize(result_size) != Errors::NONE, result);
+
+	if (_p->is_packed()) {
+		_packed_visit(_p->packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			T *w = result._p->packed_ptrw<T>();
+			const T *r = _p->packed_ptr<T>();
+			for (int src_idx = begin, dest_idx = 0; dest_idx < result_size; ++dest_idx) {
+				w[dest_idx] = r[src_idx];
+				src_idx += p_step;
+			}
+		});
+		return result;
+	}
+
+	Variant *w = result._p->ptrw();
+	const Variant *r = _p->ptr();
+	for (int src_idx = begin, dest_idx = 0; dest_idx < result_size; ++dest_idx) {
+		w[dest_idx] = p_deep ? r[src_idx].duplicate(true) : r[src_idx];
+		src_idx += p_step;
+	}
+
+	return result;
+}
+
+/** Arrays smaller than this run callables on the calling thread. */
+#define ARRAY_PARALLEL_THRESHOLD 2048
+/** Fewest elements a worker thread is given. */
+#define ARRAY_PARALLEL_MIN_CHUNK 512
+
+/** Splits [0, p_size) in one chunk per WorkerPool thread and calls
+ *  p_func(chunk, from, to) for each, concurrently; the calling thread takes
+ *  part. Returns the chunk count, or 0 without calling p_func when p_size is
+ *  too small to be worth splitting. */
+template <typename F>
+static int64_t _array_parallel_chunks(int64_t p_size, const F &p_func) {
+	const int64_t chunks = MIN(int64_t(WorkerPool::get_thread_count()), p_size / ARRAY_PARALLEL_MIN_CHUNK);
+	if (p_size < ARRAY_PARALLEL_THRESHOLD || chunks < 2) {
+		return 0;
+	}
+
+	WorkerPool::parallel_for(chunks, 0, [&p_func, chunks, p_size](int64_t p_chunk, int) {
+		p_func(p_chunk, p_size * p_chunk / chunks, p_size * (p_chunk + 1) / chunks);
+	});
+	return chunks;
+}
+
+/** Calls p_callable on the elements in [p_from, p_to) and stores whether
+ *  each returned true in r_accepted. */
+static bool _array_filter_range(const ArrayPrivate &p_array, const Callable &p_callable, int64_t p_from, int64_t p_to, uint8_t *r_accepted) {
+	const Variant *argptrs[1];
+	Variant scratch;
+	for (int64_t i = p_from; i < p_to; i++) {
+		argptrs[0] = &p_array.read(i, scratch);
+
+		Variant result;
+		Callable::CallError ce;
+		p_callable.callp(argptrs, 1, result, ce);
+		if (ce.error != Callable::CallError::CALL_OK) {
+			return false;
+		}
+		r_accepted[i] = result.operator bool();
+	}
+	return true;
+}
+
+Array Array::filter(const Callable &p_callable) const {
+	Array new_arr;
+	new_arr._p->typed = _p->typed;
+	new_arr._p->set_packed(_p->packed_type);
+
+	const int64_t size = _p->size();
+	if (size == 0) {
+		return new_arr;
+	}
+	ERROR_FAIL_COND_V(new_arr._p->resize(size) != Errors::NONE, new_arr);
+
+	// Callables run first, possibly in parallel; accepted elements are then
+	// copied over in order.
+	uint8_t *accepted = memnew_arr(uint8_t, size);
+	bool ok = true;
+	if (p_callable.is_thread_safe()) {
+		SafeFlag failed;
+		const int64_t chunks = _array_parallel_chunks(size, [&](int64_t, int64_t p_from, int64_t p_to) {
+			if (!_array_filter_range(*_p, p_callable, p_from, p_to, accepted)) {
+				failed.set();
+			}
+		});
+		ok = chunks ? !failed.is_set() : _array_filter_range(*_p, p_callable, 0, size, accepted);
+	} else {
+		ok = _array_filter_range(*_p, p_callable, 0, size, accepted);
+	}
+	if (!ok) {
+		memdelete_arr(accepted);
+		ERROR_FAIL_V_MSG(Array(), "Error calling method from 'filter'.");
+	}
+
+	int64_t accepted_count = 0;
+	Variant scratch;
+	for (int64_t i = 0; i < size; i++) {
+		if (accepted[i]) {
+			new_arr._p->write(accepted_count, _p->read(i, scratch));
+			accepted_count++;
+		}
+	}
+	memdelete_arr(accepted);
+
+	new_arr._p->resize(accepted_count);
+
+	return new_arr;
+}
+
+static bool _array_map_range(const ArrayPrivate &p_array, const Callable &p_callable, int64_t p_from, int64_t p_to, Variant *r_results) {
+	const Variant *argptrs[1];
+	Variant scratch;
+	for (int64_t i = p_from; i < p_to; i++) {
+		argptrs[0] = &p_array.read(i, scratch);
+
+		Callable::CallError ce;
+		p_callable.callp(argptrs, 1, r_results[i], ce);
+		if (ce.error != Callable::CallError::CALL_OK) {
+			return false;
+		}
+	}
+	return true;
+}
+
+Array Array::map(const Callable &p_callable) const {
+	Array new_arr;
+
+	const int64_t size = _p->size();
+	ERROR_FAIL_COND_V(new_arr._p->resize(size) != Errors::NONE, new_arr);
+	Variant *w = new_arr._p->ptrw();
+
+	bool ok = true;
+	if (p_callable.is_thread_safe()) {
+		SafeFlag failed;
+		const int64_t chunks = _array_parallel_chunks(size, [&](int64_t, int64_t p_from, int64_t p_to) {
+			if (!_array_map_range(*_p, p_callable, p_from, p_to, w)) {
+				failed.set();
+			}
+		});
+		ok = chunks ? !failed.is_set() : _array_map_range(*_p, p_callable, 0, size, w);
+	} else {
+		ok = _array_map_range(*_p, p_callable, 0, size, w);
+	}
+	if (!ok) {
+		ERROR_FAIL_V_MSG(Array(), "Error calling method from 'map'.");
+	}
+
+	return new_arr;
+}
+
+/** Folds r_accum with the elements in [p_from, p_to), left to right. */
+static bool _array_reduce_range(const ArrayPrivate &p_array, const Callable &p_callable, int64_t p_from, int64_t p_to, Variant &r_accum) {
+	const Variant *argptrs[2];
+	Variant scratch;
+	for (int64_t i = p_from; i < p_to; i++) {
+		argptrs[0] = &r_accum;
+		argptrs[1] = &p_array.read(i, scratch);
+
+		Variant result;
+		Callable::CallError ce;
+		p_callable.callp(argptrs, 2, result, ce);
+		if (ce.error != Callable::CallError::CALL_OK) {
+			return false;
+		}
+		r_accum = std::move(result);
+	}
+	return true;
+}
+
+static bool _array_combine(const Callable &p_callable, Variant &r_left, const Variant &p_right) {
+	const Variant *argptrs[2] = { &r_left, &p_right };
+	Variant result;
+	Callable::CallError ce;
+	p_callable.callp(argptrs, 2, result, ce);
+	if (ce.error != Callable::CallError::CALL_OK) {
+		return false;
+	}
+	r_left = std::move(result);
+	return true;
+}
+
+Variant Array::reduce(const Callable &p_callable, const Variant &p_accum) const {
+	const int64_t size = _p->size();
+	Variant scratch;
+
+	if (p_callable.is_thread_safe() && p_callable.is_associative()) {
+		// Every chunk folds its own elements, then the partial results are
+		// combined pairwise, in order: ((c0 c1) (c2 c3)) ...
+		Variant *partials = memnew_arr(Variant, WorkerPool::get_thread_count());
+		SafeFlag failed;
+		const int64_t chunks = _array_parallel_chunks(size, [&](int64_t p_chunk, int64_t p_from, int64_t p_to) {
+			Variant chunk_scratch;
+			partials[p_chunk] = _p->read(p_from, chunk_scratch);
+			if (!_array_reduce_range(*_p, p_callable, p_from + 1, p_to, partials[p_chunk])) {
+				failed.set();
+			}
+		});
+		if (chunks) {
+			for (int64_t width = 1; width < chunks && !failed.is_set(); width *= 2) {
+				for (int64_t i = 0; i + width < chunks; i += width * 2) {
+					if (!_array_combine(p_callable, partials[i], partials[i + width])) {
+						failed.set();
+						break;
+					}
+				}
+			}
+
+			Variant ret = p_accum;
+			if (ret == Variant()) {
+				ret = partials[0];
+			} else if (!failed.is_set() && !_array_combine(p_callable, ret, partials[0])) {
+				failed.set();
+			}
+			memdelete_arr(partials);
+			if (failed.is_set()) {
+				ERROR_FAIL_V_MSG(Variant(), "Error calling method from 'reduce'.");
+			}
+			return ret;
+		}
+		memdelete_arr(partials);
+	}
+
+	int64_t start = 0;
+	Variant ret = p_accum;
+	if (ret == Variant() && size > 0) {
+		ret = _p->read(0, scratch);
+		start = 1;
+	}
+
+	if (!_array_reduce_range(*_p, p_callable, start, size, ret)) {
+		ERROR_FAIL_V_MSG(Variant(), "Error calling method from 'reduce'.");
+	}
+
+	return ret;
+}
+
+/** Index of the first element in [p_from, p_to) for which p_callable returns
+ *  p_wanted, or -1. Gives up, returning -1, once r_stop is set. */
+static int64_t _array_find_result(const ArrayPrivate &p_array, const Callable &p_callable, int64_t p_from, int64_t p_to, bool p_wanted, const SafeFlag &p_stop, bool &r_failed) {
+	const Variant *argptrs[1];
+	Variant scratch;
+	for (int64_t i = p_from; i < p_to; i++) {
+		if (unlikely(p_stop.is_set())) {
+			return -1;
+		}
+		argptrs[0] = &p_array.read(i, scratch);
+
+		Variant result;
+		Callable::CallError ce;
+		p_callable.callp(argptrs, 1, result, ce);
+		if (ce.error != Callable::CallError::CALL_OK) {
+			r_failed = true;
+			return -1;
+		}
+
+		if (result.operator bool() == p_wanted) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/** Whether p_callable returns p_wanted for any element. Returns as early as
+ *  possible, on every thread, once it does. */
+static bool _array_has_result(const ArrayPrivate &p_array, const Callable &p_callable, bool p_wanted, bool &r_failed) {
+	const int64_t size = p_array.size();
+	SafeFlag stop;
+	r_failed = false;
+
+	if (p_callable.is_thread_safe()) {
+		SafeFlag found;
+		SafeFlag failed;
+		const int64_t chunks = _array_parallel_chunks(size, [&](int64_t, int64_t p_from, int64_t p_to) {
+			bool chunk_failed = false;
+			if (_array_find_result(p_array, p_callable, p_from, p_to, p_wanted, stop, chunk_failed) >= 0) {
+				found.set();
+				stop.set();
+			}
+			if (chunk_failed) {
+				failed.set();
+				stop.set();
+			}
+		});
+		if (chunks) {
+			r_failed = failed.is_set();
+			return found.is_set();
+		}
+	}
+
+	return _array_find_result(p_array, p_callable, 0, size, p_wanted, stop, r_failed) >= 0;
+}
+
+bool Array::any(const Callable &p_callable) const {
+	bool failed;
+	// Returns as soon as one of the conditions is `true`, unlike `filter(...).size() >= 1`.
+	const bool found = _array_has_result(*_p, p_callable, true, failed);
+	if (failed) {
+		ERROR_FAIL_V_MSG(false, "Error calling method from 'any'.");
+	}
+	return found;
+}
+
+bool Array::all(const Callable &p_callable) const {
+	bool failed;
+	// Returns as soon as one of the conditions is `false`, unlike `filter(...).size() >= array_size()`.
+	const bool found = _array_has_result(*_p, p_callable, false, failed);
+	if (failed) {
+		ERROR_FAIL_V_MSG(false, "Error calling method from 'all'.");
+	}
+	return !found;
+}
+
+struct _ArrayVariantSort {
+	_FORCE_INLINE_ bool operator()(const Variant &p_l, const Variant &p_r) const {
+		return p_l < p_r;
+	}
+};
+
+struct _ArrayVariantSortCustom {
+	Callable func;
+
+	_FORCE_INLINE_ bool operator()(const Variant &p_l, const Variant &p_r) const {
+		const Variant *args[2] = { &p_l, &p_r };
+		Callable::CallError err;
+		Variant res;
+		func.callp(args, 2, res, err);
+		if (err.error != Callable::CallError::CALL_OK) {
+			ERROR_PRINT("Error calling sorting method.");
+			return false;
+		}
+		return res;
+	}
+};
+
+/** _ArrayVariantSortCustom for unboxed elements, boxing the two compared. */
+template <typename T>
+struct _ArrayPackedSortCustom {
+	_ArrayVariantSortCustom compare;
+
+	_FORCE_INLINE_ bool operator()(const T &p_l, const T &p_r) const {
+		return compare(Variant(p_l), Variant(p_r));
+	}
+};
+
+void Array::sort() {
+	ERROR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	const int64_t size = _p->size();
+
+	if (_p->packed_type == Variant::INT) {
+		RadixSort<int64_t>::sort(_p->packed_ptrw<int64_t>(), size);
+		return;
+	}
+	if (_p->packed_type == Variant::FLOAT) {
+		RadixSort<double>::sort(_p->packed_ptrw<double>(), size);
+		return;
+	}
+	if (_p->is_packed()) {
+		_packed_visit(_p->packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			SortArray<T> sorter;
+			sorter.parallel_sort(_p->packed_ptrw<T>(), size);
+		});
+		return;
+	}
+
+	// Comparing Variants only reads them, so large arrays can be sorted in parallel.
+	SortArray<Variant, _ArrayVariantSort> sorter;
+	sorter.parallel_sort(_p->ptrw(), size);
+}
+
+void Array::sort_custom(const Callable &p_callable) {
+	ERROR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	// The callable takes Variants, sorting them boxed is cheaper than boxing
+	// at every comparison.
+	const bool packed = _p->is_packed();
+	_p->box();
+
+	SortArray<Variant, _ArrayVariantSortCustom, true> avs;
+	avs.compare.func = p_callable;
+	avs.sort(_p->ptrw(), _p->size());
+
+	if (packed) {
+		ArrayPrivate sorted;
+		sorted.share(_p);
+		_p->clear();
+		_p->append_from(sorted, false, "sort_custom");
+	}
+}
+
+void Array::shuffle() {
+	ERROR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	const int64_t n = _p->size();
+	if (n < 2) {
+		return;
+	}
+
+	if (_p->is_packed()) {
+		_packed_visit(_p->packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			T *data = _p->packed_ptrw<T>();
+			for (int64_t i = n - 1; i >= 1; i--) {
+				const int64_t j = Math::rand() % (i + 1);
+				SWAP(data[i], data[j]);
+			}
+		});
+		return;
+	}
+
+	Variant *data = _p->ptrw();
+	for (int64_t i = n - 1; i >= 1; i--) {
+		const int64_t j = Math::rand() % (i + 1);
+		SWAP(data[i], data[j]);
+	}
+}
+
+int Array::bsearch(const Variant &p_value, bool p_before) const {
+	Variant value = p_value;
+	ERROR_FAIL_COND_V(!_p->typed.validate(value, "binary search"), -1);
+
+	if (_p->is_packed()) {
+		int found = -1;
+		_packed_visit(_p->packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			SearchArray<T> avs;
+			found = avs.bisect(_p->packed_ptr<T>(), _p->size(), value.operator T(), p_before);
+		});
+		return found;
+	}
+
+	SearchArray<Variant, _ArrayVariantSort> avs;
+	return avs.bisect(_p->ptr(), _p->size(), value, p_before);
+}
+
+int Array::bsearch_custom(const Variant &p_value, const Callable &p_callable, bool p_before) const {
+	Variant value = p_value;
+	ERROR_FAIL_COND_V(!_p->typed.validate(value, "custom binary search"), -1);
+
+	if (_p->is_packed()) {
+		int found = -1;
+		_packed_visit(_p->packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			SearchArray<T, _ArrayPackedSortCustom<T>> avs;
+			avs.compare.compare.func = p_callable;
+			found = avs.bisect(_p->packed_ptr<T>(), _p->size(), value.operator T(), p_before);
+		});
+		return found;
+	}
+
+	SearchArray<Variant, _ArrayVariantSortCustom> avs;
+	avs.compare.func = p_callable;
+	return avs.bisect(_p->ptr(), _p->size(), value, p_before);
+}
+
+Array Array::bsearch_many(const Array &p_values, bool p_before) const {
+	Array results;
+	results.set_typed(Variant::INT, StringName(), Variant());
+
+	const int64_t count = p_values.size();
+	ERROR_FAIL_COND_V(results.resize(count) != Errors::NONE, results);
+	if (count == 0) {
+		return results;
+	}
+	int64_t *w = results._p->packed_ptrw<int64_t>();
+
+	ArrayPrivate values;
+	values.typed = _p->typed;
+	if (p_values._p->packed_type == _p->packed_type) {
+		values.share(p_values._p);
+	} else {
+		// Validates, and converts to the representation searched.
+		values.set_packed(_p->packed_type);
+		ERROR_FAIL_COND_V(!values.append_from(*p_values._p, true, "binary search"), Array());
+	}
+
+	if (_p->is_packed()) {
+		_packed_visit(_p->packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			SearchArray<T> avs;
+			avs.bisect_many(_p->packed_ptr<T>(), _p->size(), values.packed_ptr<T>(), count, w, p_before);
+		});
+		return results;
+	}
+
+	SearchArray<Variant, _ArrayVariantSort> avs;
+	avs.bisect_many(_p->ptr(), _p->size(), values.ptr(), count, w, p_before);
+	return results;
+}
+
+void Array::reverse() {
+	ERROR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	const int64_t n = _p->size();
+
+	if (_p->is_packed()) {
+		_packed_visit(_p->packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			T *p = _p->packed_ptrw<T>();
+			std::reverse(p, p + n);
+		});
+		return;
+	}
+
+	Variant *p = _p->ptrw();
+	for (int64_t i = 0; i < n / 2; i++) {
+		SWAP(p[i], p[n - i - 1]);
+	}
+}
+
+void Array::push_front(const Variant &p_value) {
+	ERROR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	Variant value = p_value;
+	ERROR_FAIL_COND(!_p->typed.validate(value, "push_front"));
+	_p->insert(0, value);
+}
+
+Variant Array::pop_back() {
+	ERROR_FAIL_COND_V_MSG(_p->read_only, Variant(), "Array is in read-only state.");
+	const int64_t n = _p->size();
+	if (n > 0) {
+		Variant scratch;
+		Variant ret = _p->read(n - 1, scratch);
+		_p->resize(n - 1);
+		return ret;
+	}
+	return Variant();
+}
+
+Variant Array::pop_front() {
+	ERROR_FAIL_COND_V_MSG(_p->read_only, Variant(), "Array is in read-only state.");
+	if (_p->size() > 0) {
+		Variant scratch;
+		Variant ret = _p->read(0, scratch);
+		_p->remove_at(0);
+		return ret;
+	}
+	return Variant();
+}
+
+Variant Array::pop_at(int p_pos) {
+	ERROR_FAIL_COND_V_MSG(_p->read_only, Variant(), "Array is in read-only state.");
+	const int64_t n = _p->size();
+	if (n == 0) {
+		// Return `null` without printing an error to mimic `pop_back()` and `pop_front()` behavior.
+		return Variant();
+	}
+
+	if (p_pos < 0) {
+		// Relative offset from the end
+		p_pos = n + p_pos;
+	}
+
+	ERROR_FAIL_INDEX_V_MSG(p_pos, n, Variant(), "Attempted to pop out of bounds of the array.");
+
+	Variant scratch;
+	Variant ret = _p->read(p_pos, scratch);
+	_p->remove_at(p_pos);
+	return ret;
+}
+
+Variant Array::min() const {
+	const int64_t n = _p->size();
+	if (n == 0) {
+		return Variant();
+	}
+
+	if (_p->is_packed()) {
+		Variant ret;
+		_packed_visit(_p->packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			const T *r = _p->packed_ptr<T>();
+			ret = *std::min_element(r, r + n, Comparator<T>());
+		});
+		return ret;
+	}
+
+	const Variant *r = _p->ptr();
+	const Variant *minval = &r[0];
+	for (int64_t i = 1; i < n; i++) {
+		if (r[i] < *minval) {
+			minval = &r[i];
+		}
+	}
+	return *minval;
+}
+
+Variant Array::max() const {
+	const int64_t n = _p->size();
+	if (n == 0) {
+		return Variant();
+	}
+
+	if (_p->is_packed()) {
+		Variant ret;
+		_packed_visit(_p->packed_type, [&](auto p_tag) {
+			typedef typename decltype(p_tag)::Type T;
+			const T *r = _p->packed_ptr<T>();
+			ret = *std::max_element(r, r + n, Comparator<T>());
+		});
+		return ret;
+	}
+
+	const Variant *r = _p->ptr();
+	const Variant *maxval = &r[0];
+	for (int64_t i = 1; i < n; i++) {
+		if (*maxval < r[i]) {
+			maxval = &r[i];
+		}
+	}
+	return *maxval;
+}
+
+bool Array::operator<(const Array &p_array) const {
+	int a_len = size();
+	int b_len = p_array.size();
+
+	int min_cmp = MIN(a_len, b_len);
+
+	Variant scratch_a;
+	Variant scratch_b;
+	for (int i = 0; i < min_cmp; i++) {
+		const Variant &a = _p->read(i, scratch_a);
+		const Variant &b = p_array._p->read(i, scratch_b);
+		if (a < b) {
+			return true;
+		} else if (b < a) {
+			return false;
+		}
+	}
+
+	return a_len < b_len;
+}
+
+bool Array::operator<=(const Array &p_array) const {
+	return !operator>(p_array);
+}
+
+bool Array::operator>(const Array &p_array) const {
+	return p_array < *this;
+}
+
+bool Array::operator>=(const Array &p_array) const {
+	return !operator<(p_array);
+}
+
+const void *Array::id() const {
+	return _p;
+}
+
+void Array::set_typed(const ContainerType &p_element_type) {
+	set_typed(p_element_type.builtin_type, p_element_type.class_name, p_element_type.script);
+}
+
+void Array::set_typed(uint32_t p_type, const StringName &p_class_name, const Variant &p_script) {
+	ERROR_FAIL_COND_MSG(_p->read_only, "Array is in read-only state.");
+	ERROR_FAIL_COND_MSG(_p->size() > 0, "Type can only be set when array is empty.");
+	ERROR_FAIL_COND_MSG(_p->refcount.get() > 1, "Type can only be set when array has no more than one user.");
+	ERROR_FAIL_COND_MSG(_p->typed.type != Variant::NIL, "Type can only be set once.");
+	ERROR_FAIL_COND_MSG(p_class_name != StringName() && p_type != Variant::OBJECT, "Class names can only be set for type OBJECT.");
+	ERROR_FAIL_INDEX_MSG(p_type, Variant::VARIANT_MAX, "Invalid element type.");
+
+	_p->typed.type = Variant::Type(p_type);
+	_p->typed.class_name = p_class_name;
+	_p->typed.script = p_script;
+	_p->typed.where = "TypedArray";
+	_p->clear();
+}
+
+bool Array::is_typed() const {
+	return _p->typed.type != Variant::NIL;
+}
+
+bool Array::is_same_typed(const Array &p_other) const {
+	return _p->typed == p_other._p->typed;
+}
+
+bool Array::is_same_instance(const Array &p_other) const {
+	return _p == p_other._p;
+}
+
+ContainerType Array::get_element_type() const {
+	ContainerType type;
+	type.builtin_type = _p->typed.type;
+	type.class_name = _p->typed.class_name;
+	type.script = _p->typed.script;
+	return type;
+}
+
+uint32_t Array::get_typed_builtin() const {
+	return _p->typed.type;
+}
+
+StringName Array::get_typed_class_name() const {
+	return _p->typed.class_name;
+}
+
+Variant Array::get_typed_script() const {
+	return _p->typed.script;
+}
+
+void Array::make_read_only() {
+	if (_p->read_only == nullptr) {
+		_p->read_only = memnew(Variant);
+	}
+}
+
+bool Array::is_read_only() const {
+	return _p->read_only != nullptr;
+}
+
+Array Array::create_read_only() {
+	Array array;
+	array.make_read_only();
+	return array;
+}
+
+Array::Array(const Array &p_base, uint32_t p_type, const StringName &p_class_name, const Variant &p_script) {
+	_p = memnew(ArrayPrivate);
+	_p->refcount.init();
+	set_typed(p_type, p_class_name, p_script);
+	assign(p_base);
+}
+
+Array::Array(const Array &p_from) {
+	_p = nullptr;
+	_ref(p_from);
+}
+
+Array::Array() {
+	_p = memnew(ArrayPrivate);
+	_p->refcount.init();
+}
+
+Array::~Array() {
+	_unref();
+}
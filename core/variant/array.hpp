@@ -20,9 +20,12 @@ class Array {
 	void _unref() const;
 
 public:
+	/** Reads boxed elements in place and unboxed ones from the unboxed
+	 *  storage, so iterating a const Array never changes how it stores its
+	 *  elements. Elements come by value: unboxed ones have no Variant to
+	 *  point to. */
 	struct ConstIterator {
-		_FORCE_INLINE_ const Variant &operator*() const;
-		_FORCE_INLINE_ const Variant *operator->() const;
+		_FORCE_INLINE_ Variant operator*() const;
 
 		_FORCE_INLINE_ ConstIterator &operator++();
 		_FORCE_INLINE_ ConstIterator &operator--();
@@ -30,21 +33,23 @@ public:
 		_FORCE_INLINE_ bool operator==(const ConstIterator &p_other) const { return element_ptr == p_other.element_ptr; }
 		_FORCE_INLINE_ bool operator!=(const ConstIterator &p_other) const { return element_ptr != p_other.element_ptr; }
 
-		_FORCE_INLINE_ ConstIterator(const Variant *p_element_ptr, Variant *p_read_only = nullptr) :
-				element_ptr(p_element_ptr), read_only(p_read_only) {}
+		_FORCE_INLINE_ ConstIterator(const Variant *p_element_ptr) :
+				element_ptr(reinterpret_cast<const uint8_t *>(p_element_ptr)) {}
 		_FORCE_INLINE_ ConstIterator() {}
-		_FORCE_INLINE_ ConstIterator(const ConstIterator &p_other) :
-				element_ptr(p_other.element_ptr), read_only(p_other.read_only) {}
-
-		_FORCE_INLINE_ ConstIterator &operator=(const ConstIterator &p_other) {
-			element_ptr = p_other.element_ptr;
-			read_only = p_other.read_only;
-			return *this;
-		}
 
 	private:
-		const Variant *element_ptr = nullptr;
-		Variant *read_only = nullptr;
+		friend class Array;
+
+		const uint8_t *element_ptr = nullptr;
+		/** Element size of unboxed storage, 0 when boxed. */
+		uint32_t packed_stride = 0;
+		/** Variant::Type of the unboxed elements. */
+		uint8_t packed_type = 0;
+
+		_FORCE_INLINE_ ConstIterator(const uint8_t *p_element_ptr, uint32_t p_packed_stride, uint8_t p_packed_type) :
+				element_ptr(p_element_ptr), packed_stride(p_packed_stride), packed_type(p_packed_type) {}
+
+		Variant _read_packed() const;
 	};
 
 	struct Iterator {
@@ -70,7 +75,7 @@ public:
 		}
 
 		operator ConstIterator() const {
-			return ConstIterator(element_ptr, read_only);
+			return ConstIterator(element_ptr);
 		}
 
 	private:
@@ -78,6 +83,10 @@ public:
 		Variant *read_only = nullptr;
 	};
 
+	/** Element references need boxed storage: the non-const iterators and
+	 *  operator[] switch arrays that store their elements unboxed (typed to
+	 *  bool, int, float or a vector type) to boxed storage. get(), set() and
+	 *  the const accessors, which return elements by value, don't. */
 	Iterator begin();
 	Iterator end();
 
@@ -87,10 +96,10 @@ public:
 	void _ref(const Array &p_from) const;
 
 	Variant &operator[](int p_idx);
-	const Variant &operator[](int p_idx) const;
+	Variant operator[](int p_idx) const;
 
 	void set(int p_idx, const Variant &p_value);
-	const Variant &get(int p_idx) const;
+	Variant get(int p_idx) const;
 
 	int size() const;
 	bool is_empty() const;
@@ -123,6 +132,9 @@ public:
 	void shuffle();
 	int bsearch(const Variant &p_value, bool p_before = true) const;
 	int bsearch_custom(const Variant &p_value, const Callable &p_callable, bool p_before = true) const;
+	/** bsearch() for each of p_values, as an Array of ints. The searches run
+	 *  interleaved, which hides most of the memory latency on large arrays. */
+	Array bsearch_many(const Array &p_values, bool p_before = true) const;
 	void reverse();
 
 	int find(const Variant &p_value, int p_from = 0) const;
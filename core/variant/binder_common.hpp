@@ -0,0 +1,88 @@
+#ifndef __BINDER_COMMON_HPP__
+#define __BINDER_COMMON_HPP__
+
+#include "../typedefs.hpp"
+#include "./callable.hpp"
+#include "./method_ptrcall.hpp"
+
+#include <type_traits>
+
+class Variant;
+
+/** Unboxes a Variant argument into the type a bound method expects. */
+template <typename T>
+struct VariantCaster {
+    static _FORCE_INLINE_ T cast(const Variant& p_variant) {
+        return p_variant;
+    }
+};
+
+template <typename T>
+struct VariantCaster<const T&> {
+    static _FORCE_INLINE_ T cast(const Variant& p_variant) {
+        return p_variant;
+    }
+};
+
+/** Argument count check shared by every Variant call path. */
+_FORCE_INLINE_ bool call_check_argument_count(int p_argcount, int p_expected, Callable::CallError& r_error) {
+    if (unlikely(p_argcount > p_expected)) {
+        r_error.error = Callable::CallError::CALL_ERROR_TOO_MANY_ARGUMENTS;
+        r_error.expected = p_expected;
+        return false;
+    }
+
+    if (unlikely(p_argcount < p_expected)) {
+        r_error.error = Callable::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
+        r_error.expected = p_expected;
+        return false;
+    }
+
+    return true;
+}
+
+/** Variant path: arguments are unboxed, the return value is boxed into r_ret. */
+
+template <typename T, typename... P, size_t... Is>
+void call_with_variant_args_helper(T* p_instance, void (T::*p_method)(P...), const Variant** p_args, IndexSequence<Is...>) {
+    (p_instance->*p_method)(VariantCaster<P>::cast(*p_args[Is])...);
+}
+
+template <typename T, typename... P, size_t... Is>
+void call_with_variant_argsc_helper(T* p_instance, void (T::*p_method)(P...) const, const Variant** p_args, IndexSequence<Is...>) {
+    (p_instance->*p_method)(VariantCaster<P>::cast(*p_args[Is])...);
+}
+
+template <typename T, typename R, typename... P, size_t... Is>
+void call_with_variant_args_ret_helper(T* p_instance, R (T::*p_method)(P...), const Variant** p_args, Variant& r_ret, IndexSequence<Is...>) {
+    r_ret = (p_instance->*p_method)(VariantCaster<P>::cast(*p_args[Is])...);
+}
+
+template <typename T, typename R, typename... P, size_t... Is>
+void call_with_variant_args_retc_helper(T* p_instance, R (T::*p_method)(P...) const, const Variant** p_args, Variant& r_ret, IndexSequence<Is...>) {
+    r_ret = (p_instance->*p_method)(VariantCaster<P>::cast(*p_args[Is])...);
+}
+
+/** ptrcall path: arguments and return value travel as raw typed pointers. */
+
+template <typename T, typename... P, size_t... Is>
+void call_with_ptr_args_helper(T* p_instance, void (T::*p_method)(P...), const void** p_args, IndexSequence<Is...>) {
+    (p_instance->*p_method)(PtrToArg<P>::convert(p_args[Is])...);
+}
+
+template <typename T, typename... P, size_t... Is>
+void call_with_ptr_argsc_helper(T* p_instance, void (T::*p_method)(P...) const, const void** p_args, IndexSequence<Is...>) {
+    (p_instance->*p_method)(PtrToArg<P>::convert(p_args[Is])...);
+}
+
+template <typename T, typename R, typename... P, size_t... Is>
+void call_with_ptr_args_ret_helper(T* p_instance, R (T::*p_method)(P...), const void** p_args, void* r_ret, IndexSequence<Is...>) {
+    PtrToArg<R>::encode((p_instance->*p_method)(PtrToArg<P>::convert(p_args[Is])...), r_ret);
+}
+
+template <typename T, typename R, typename... P, size_t... Is>
+void call_with_ptr_args_retc_helper(T* p_instance, R (T::*p_method)(P...) const, const void** p_args, void* r_ret, IndexSequence<Is...>) {
+    PtrToArg<R>::encode((p_instance->*p_method)(PtrToArg<P>::convert(p_args[Is])...), r_ret);
+}
+
+#endif
@@ -0,0 +1,188 @@
+#include "./callable.hpp"
+
+#include "../object/class_db.hpp"
+#include "../templates/hashfuncs.hpp"
+#include "./variant.hpp"
+
+void Callable::callp(const Variant** p_arguments, int p_argcount, Variant& r_return_value, CallError& r_call_error) const {
+    if (is_null()) {
+        r_call_error.error = CallError::CALL_ERROR_INSTANCE_IS_NULL;
+        r_call_error.argument = 0;
+        r_call_error.expected = 0;
+        r_return_value = Variant();
+    } else if (is_custom()) {
+        custom->call(p_arguments, p_argcount, r_return_value, r_call_error);
+    } else {
+        Object* obj = ObjectDB::get_instance(ObjectID(object));
+        if (unlikely(!obj)) {
+            r_call_error.error = CallError::CALL_ERROR_INSTANCE_IS_NULL;
+            r_call_error.argument = 0;
+            r_call_error.expected = 0;
+            r_return_value = Variant();
+            return;
+        }
+
+        MethodBind* bind = ClassDB::get_method(obj->get_class_name(), method);
+        if (unlikely(!bind)) {
+            r_call_error.error = CallError::CALL_ERROR_INVALID_METHOD;
+            r_call_error.argument = 0;
+            r_call_error.expected = 0;
+            r_return_value = Variant();
+            return;
+        }
+
+        bind->call(obj, p_arguments, p_argcount, r_return_value, r_call_error);
+    }
+}
+
+bool Callable::is_valid() const {
+    if (is_custom()) {
+        return get_custom()->is_valid();
+    }
+    Object* obj = get_object();
+    return obj && ClassDB::get_method(obj->get_class_name(), method) != nullptr;
+}
+
+Object* Callable::get_object() const {
+    if (is_null()) {
+        return nullptr;
+    } else if (is_custom()) {
+        return ObjectDB::get_instance(custom->get_object());
+    }
+    return ObjectDB::get_instance(ObjectID(object));
+}
+
+ObjectID Callable::get_object_id() const {
+    if (is_null()) {
+        return ObjectID();
+    } else if (is_custom()) {
+        return custom->get_object();
+    }
+    return ObjectID(object);
+}
+
+StringName Callable::get_method() const {
+    return method;
+}
+
+bool Callable::is_thread_safe() const {
+    return is_custom() && custom->is_thread_safe();
+}
+
+bool Callable::is_associative() const {
+    return is_custom() && custom->is_associative();
+}
+
+CallableCustom* Callable::get_custom() const {
+    ERROR_FAIL_COND_V_MSG(!is_custom(), nullptr, "Can't get custom on non-CallableCustom.");
+    return custom;
+}
+
+uint32_t Callable::hash() const {
+    if (is_custom()) {
+        return custom->hash();
+    }
+    uint32_t hash = method.hash();
+    return hash_murmur3_one_64(object, hash);
+}
+
+bool Callable::operator==(const Callable& p_callable) const {
+    bool custom_a = is_custom();
+    bool custom_b = p_callable.is_custom();
+
+    if (custom_a != custom_b) {
+        return false;
+    }
+    if (custom_a) {
+        return custom == p_callable.custom;
+    }
+    return object == p_callable.object && method == p_callable.method;
+}
+
+bool Callable::operator!=(const Callable& p_callable) const {
+    return !(*this == p_callable);
+}
+
+void Callable::operator=(const Callable& p_callable) {
+    if (is_custom()) {
+        if (p_callable.is_custom() && custom == p_callable.custom) {
+            return;
+        }
+        if (custom->ref_count.unref()) {
+            memdelete(custom);
+        }
+        object = 0;
+    }
+
+    if (p_callable.is_custom()) {
+        method = StringName();
+        if (p_callable.custom->ref_count.ref()) {
+            custom = p_callable.custom;
+        }
+    } else {
+        method = p_callable.method;
+        object = p_callable.object;
+    }
+}
+
+Callable::Callable(const Object* p_object, const StringName& p_method) {
+    if (unlikely(p_method == StringName())) {
+        object = 0;
+        ERROR_FAIL_MSG("Method argument to Callable constructor must be a non-empty string.");
+    }
+    if (unlikely(p_object == nullptr)) {
+        object = 0;
+        ERROR_FAIL_MSG("Object argument to Callable constructor must be non-null.");
+    }
+
+    object = p_object->get_instance_id();
+    method = p_method;
+}
+
+Callable::Callable(ObjectID p_object, const StringName& p_method) {
+    if (unlikely(p_method == StringName())) {
+        object = 0;
+        ERROR_FAIL_MSG("Method argument to Callable constructor must be a non-empty string.");
+    }
+
+    object = p_object;
+    method = p_method;
+}
+
+Callable::Callable(CallableCustom* p_custom) {
+    if (unlikely(p_custom->referenced)) {
+        object = 0;
+        ERROR_FAIL_MSG("Callable custom is already referenced.");
+    }
+    p_custom->referenced = true;
+    object = 0; /** Ensure everything else is cleared. */
+    custom = p_custom;
+}
+
+Callable::Callable(const Callable& p_callable) {
+    if (p_callable.is_custom()) {
+        if (p_callable.custom->ref_count.ref()) {
+            custom = p_callable.custom;
+        }
+    } else {
+        method = p_callable.method;
+        object = p_callable.object;
+    }
+}
+
+Callable::~Callable() {
+    if (is_custom()) {
+        if (custom->ref_count.unref()) {
+            memdelete(custom);
+        }
+    }
+}
+
+bool CallableCustom::is_valid() const {
+    /** Sensible default implementation so most custom callables don't need their own. */
+    return ObjectDB::get_instance(get_object()) != nullptr;
+}
+
+CallableCustom::CallableCustom() {
+    ref_count.init();
+}
@@ -0,0 +1,108 @@
+#ifndef __CALLABLE_HPP__
+#define __CALLABLE_HPP__
+
+#include "../object/object_id.hpp"
+#include "../string/string_name.hpp"
+#include "../templates/safe_refcount.hpp"
+#include "../typedefs.hpp"
+
+class Object;
+class Variant;
+class CallableCustom;
+
+/** Reference to a method: either an object and a bound method name, or a
+ *  custom callable (lambdas, binds) that implements call() itself.
+ *
+ *  Standard callables resolve the object through ObjectDB on every call, so
+ *  calling one whose object was freed fails with CALL_ERROR_INSTANCE_IS_NULL
+ *  instead of crashing.
+ */
+class Callable {
+    alignas(8) StringName method;
+    union {
+        uint64_t object = 0;
+        CallableCustom* custom;
+    };
+
+public:
+    struct CallError {
+        enum Error {
+            CALL_OK,
+            CALL_ERROR_INVALID_METHOD,
+            CALL_ERROR_INVALID_ARGUMENT, /** expected is variant type */
+            CALL_ERROR_TOO_MANY_ARGUMENTS, /** expected is number of arguments */
+            CALL_ERROR_TOO_FEW_ARGUMENTS, /** expected is number of arguments */
+            CALL_ERROR_INSTANCE_IS_NULL,
+            CALL_ERROR_METHOD_NOT_CONST,
+        };
+
+        Error error = Error::CALL_OK;
+        int argument = 0;
+        int expected = 0;
+    };
+
+    void callp(const Variant** p_arguments, int p_argcount, Variant& r_return_value, CallError& r_call_error) const;
+
+    /** Defined in variant.hpp, it needs Variant complete. */
+    template <typename... VarArgs>
+    Variant call(VarArgs... p_args) const;
+
+    _FORCE_INLINE_ bool is_null() const {
+        return method == StringName() && object == 0;
+    }
+    _FORCE_INLINE_ bool is_custom() const {
+        return method == StringName() && custom != nullptr;
+    }
+    _FORCE_INLINE_ bool is_standard() const {
+        return method != StringName();
+    }
+    bool is_valid() const;
+    /** Only custom callables can declare these, see CallableCustom. */
+    bool is_thread_safe() const;
+    bool is_associative() const;
+
+    Object* get_object() const;
+    ObjectID get_object_id() const;
+    StringName get_method() const;
+    CallableCustom* get_custom() const;
+
+    uint32_t hash() const;
+
+    bool operator==(const Callable& p_callable) const;
+    bool operator!=(const Callable& p_callable) const;
+
+    void operator=(const Callable& p_callable);
+
+    Callable(const Object* p_object, const StringName& p_method);
+    Callable(ObjectID p_object, const StringName& p_method);
+    Callable(CallableCustom* p_custom);
+    Callable(const Callable& p_callable);
+    Callable() {}
+    ~Callable();
+};
+
+/** Base of callables that carry their own state. Owned by the Callables that
+ *  reference it, released with the last one. */
+class CallableCustom {
+    friend class Callable;
+    SafeRefCount ref_count;
+    bool referenced = false;
+
+public:
+    virtual uint32_t hash() const = 0;
+    virtual bool is_valid() const;
+    /** Whether call() may run on several threads at once. Array's map(),
+     *  filter(), any() and all() split large arrays across threads if so. */
+    virtual bool is_thread_safe() const { return false; }
+    /** Whether, as a two argument function, f(f(a, b), c) == f(a, f(b, c)).
+     *  Array::reduce() combines partial results in parallel if this and
+     *  is_thread_safe() hold. */
+    virtual bool is_associative() const { return false; }
+    virtual ObjectID get_object() const = 0;
+    virtual void call(const Variant** p_arguments, int p_argcount, Variant& r_return_value, Callable::CallError& r_call_error) const = 0;
+
+    CallableCustom();
+    virtual ~CallableCustom() {}
+};
+
+#endif
@@ -1,6 +1,172 @@
 #ifndef __CONTAINER_TYPE_VALIDATE_HPP__
 #define __CONTAINER_TYPE_VALIDATE_HPP__
 
+#include "../object/class_db.hpp"
+#include "../templates/safe_refcount.hpp"
+#include "./variant.hpp"
 
+#include <stdio.h>
+
+struct ContainerType {
+    Variant::Type builtin_type = Variant::NIL;
+    StringName class_name;
+    Variant script;
+};
+
+/** Element type of a typed container, and the checks run when values go in.
+ *
+ *  Object containers remember the last few classes found to inherit
+ *  class_name, so filling one with objects of a handful of classes walks the
+ *  class hierarchy once per class instead of once per element. Entries are
+ *  compared by name identity; only names of registered classes can pass the
+ *  check, and ClassDB keeps those alive.
+ */
+struct ContainerTypeValidate {
+    Variant::Type type = Variant::NIL;
+    StringName class_name;
+    Variant script;
+    const char* where = "container";
+
+private:
+    enum {
+        INHERITS_CACHE_SIZE = 4
+    };
+
+    /** Relaxed atomics: validation runs from const methods, which may be
+     *  called from several threads at once. */
+    struct InheritsCache {
+        mutable SafeNumeric<const void*> classes[INHERITS_CACHE_SIZE];
+        mutable SafeNumeric<uint32_t> next;
+
+        _FORCE_INLINE_ bool has(const void* p_class) const {
+            for (int i = 0; i < INHERITS_CACHE_SIZE; i++) {
+                if (classes[i].get_relaxed() == p_class) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        _FORCE_INLINE_ void add(const void* p_class) const {
+            classes[next.postincrement_relaxed() % INHERITS_CACHE_SIZE].set_relaxed(p_class);
+        }
+
+        void operator=(const InheritsCache& p_from) {
+            for (int i = 0; i < INHERITS_CACHE_SIZE; i++) {
+                classes[i].set_relaxed(p_from.classes[i].get_relaxed());
+            }
+        }
+
+        InheritsCache(const InheritsCache& p_from) { *this = p_from; }
+        InheritsCache() {
+            for (int i = 0; i < INHERITS_CACHE_SIZE; i++) {
+                classes[i].set_relaxed(nullptr);
+            }
+        }
+    };
+
+    InheritsCache inherits_cache;
+
+    /** Whether p_class is class_name or inherits from it. */
+    _FORCE_INLINE_ bool _inherits(const StringName& p_class) const {
+        if (p_class == class_name || inherits_cache.has(p_class.data_unique_pointer())) {
+            return true;
+        }
+        if (!ClassDB::is_parent_class(p_class, class_name)) {
+            return false;
+        }
+        inherits_cache.add(p_class.data_unique_pointer());
+        return true;
+    }
+
+public:
+    _FORCE_INLINE_ bool is_typed() const { return type != Variant::NIL; }
+
+    /** Whether a container of type p_type can be used as-is where this type is expected. */
+    _FORCE_INLINE_ bool can_reference(const ContainerTypeValidate& p_type) const {
+        if (type != p_type.type) {
+            return false;
+        } else if (type != Variant::OBJECT) {
+            return true;
+        }
+
+        if (class_name == StringName()) {
+            return true;
+        } else if (p_type.class_name == StringName()) {
+            return false;
+        } else if (!_inherits(p_type.class_name)) {
+            return false;
+        }
+
+        return script == p_type.script;
+    }
+
+    /** Whether the elements of a container of type p_source can be taken
+     *  without validating them one by one. */
+    _FORCE_INLINE_ bool can_skip_validation(const ContainerTypeValidate& p_source) const {
+        return !is_typed() || can_reference(p_source);
+    }
+
+    _FORCE_INLINE_ bool operator==(const ContainerTypeValidate& p_type) const {
+        return type == p_type.type && class_name == p_type.class_name && script == p_type.script;
+    }
+    _FORCE_INLINE_ bool operator!=(const ContainerTypeValidate& p_type) const {
+        return type != p_type.type || class_name != p_type.class_name || script != p_type.script;
+    }
+
+    /** Checks p_variant can go into the container, converting it in place when
+     *  the conversion is lossless (int into a float container). */
+    _FORCE_INLINE_ bool validate(Variant& inout_variant, const char* p_operation = "use") const {
+        if (type == Variant::NIL) {
+            return true;
+        }
+
+        if (type != inout_variant.get_type()) {
+            if (inout_variant.get_type() == Variant::NIL && type == Variant::OBJECT) {
+                return true;
+            }
+            if (type == Variant::FLOAT && inout_variant.get_type() == Variant::INT) {
+                inout_variant = (double)inout_variant;
+                return true;
+            }
+
+            char message[256];
+            snprintf(message, sizeof(message), "Attempted to %s a variable of type '%s' into a %s of type '%s'.",
+                     p_operation, Variant::get_type_name(inout_variant.get_type()), where, Variant::get_type_name(type));
+            ERROR_FAIL_V_MSG(false, message);
+        }
+
+        if (type != Variant::OBJECT) {
+            return true;
+        }
+
+        return validate_object(inout_variant, p_operation);
+    }
+
+    _FORCE_INLINE_ bool validate_object(const Variant& p_variant, const char* p_operation = "use") const {
+        ERROR_FAIL_COND_V(p_variant.get_type() != Variant::OBJECT, false);
+
+        Object* object = p_variant.get_validated_object();
+        if (unlikely(!object && (Object*)p_variant != nullptr)) {
+            char message[256];
+            snprintf(message, sizeof(message), "Attempted to %s a previously freed instance into a %s.", p_operation, where);
+            ERROR_FAIL_V_MSG(false, message);
+        }
+
+        if (class_name == StringName() || !object) {
+            return true;
+        }
+
+        const StringName& obj_class = object->get_class_name();
+        if (!_inherits(obj_class)) {
+            char message[256];
+            snprintf(message, sizeof(message), "Attempted to %s an object of type '%s' into a %s, which does not inherit from '%s'.",
+                     p_operation, obj_class.get_data(), where, class_name.get_data());
+            ERROR_FAIL_V_MSG(false, message);
+        }
+
+        return true;
+    }
+};
 
 #endif
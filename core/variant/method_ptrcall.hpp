@@ -0,0 +1,31 @@
+#ifndef __METHOD_PTRCALL_HPP__
+#define __METHOD_PTRCALL_HPP__
+
+#include "../typedefs.hpp"
+
+#include <type_traits>
+
+/** Conversions for the ptrcall ABI.
+ *
+ *  Every argument is passed as a pointer to a value of the parameter's
+ *  decayed type, and the return value is written to a pointer to storage of
+ *  the decayed return type. Nothing is boxed: a ptrcall is a couple of loads
+ *  and the call itself.
+ */
+template <typename T>
+struct PtrToArg {
+    typedef std::remove_cv_t<std::remove_reference_t<T>> EncodeT;
+
+    static_assert(!std::is_reference_v<T> || std::is_const_v<std::remove_reference_t<T>>,
+                  "Bound methods can't take arguments by non-const reference.");
+
+    _FORCE_INLINE_ static const EncodeT& convert(const void* p_ptr) {
+        return *reinterpret_cast<const EncodeT*>(p_ptr);
+    }
+
+    _FORCE_INLINE_ static void encode(const EncodeT& p_val, void* p_ptr) {
+        *reinterpret_cast<EncodeT*>(p_ptr) = p_val;
+    }
+};
+
+#endif
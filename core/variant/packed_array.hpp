@@ -0,0 +1,153 @@
+#ifndef __PACKED_ARRAY_HPP__
+#define __PACKED_ARRAY_HPP__
+
+#include "../error/error_macros.hpp"
+#include "../math/vector3.hpp"
+#include "../templates/vector.hpp"
+#include "./packed_kernels.hpp"
+
+#include <type_traits>
+
+/** How a packed element maps onto the scalars the kernels work on. */
+template <typename T>
+struct PackedArrayTraits {
+    typedef T Scalar;
+    typedef typename PackedKernels::Wide<T>::Type Sum;
+    typedef Sum Dot;
+    enum {
+        STRIDE = 1,
+    };
+};
+
+template <>
+struct PackedArrayTraits<Vector3> {
+    typedef real_t Scalar;
+    /** Component-wise. */
+    typedef Vector3 Sum;
+    /** Sum of the dot products of the element pairs. */
+    typedef real_t Dot;
+    enum {
+        STRIDE = 3,
+    };
+};
+
+/** Copy-on-write array of numbers or vectors with bulk math.
+ *
+ *  Same storage as Vector<T>; the bulk operations run over the whole buffer
+ *  at once through PackedKernels, which is where simulation-sized data should
+ *  be transformed rather than element by element through Array. Vector
+ *  elements are treated component-wise, a Vector3 operand applying each of its
+ *  components to the matching component of every element.
+ *
+ *  Operations taking another array need it to have the same size; integer
+ *  arithmetic wraps on overflow.
+ */
+template <typename T>
+class PackedArray : public Vector<T> {
+    typedef PackedArrayTraits<T> Traits;
+
+public:
+    typedef typename Traits::Scalar Scalar;
+    typedef typename Traits::Sum Sum;
+    typedef typename Traits::Dot Dot;
+
+private:
+    static_assert(sizeof(T) == sizeof(Scalar) * Traits::STRIDE, "Packed elements must be made of their scalars only.");
+
+    _FORCE_INLINE_ int64_t _scalar_count() const { return int64_t(this->size()) * Traits::STRIDE; }
+    _FORCE_INLINE_ Scalar* _scalars_w() { return reinterpret_cast<Scalar*>(this->ptrw()); }
+    _FORCE_INLINE_ const Scalar* _scalars() const { return reinterpret_cast<const Scalar*>(this->ptr()); }
+    static _FORCE_INLINE_ const Scalar* _scalars(const T& p_value) { return reinterpret_cast<const Scalar*>(&p_value); }
+
+public:
+    void add(const PackedArray& p_other) {
+        ERROR_FAIL_COND_MSG(p_other.size() != this->size(), "Packed arrays must have the same size.");
+        Scalar* dst = _scalars_w();
+        PackedKernels::add(dst, p_other._scalars(), _scalar_count());
+    }
+
+    void add(const T& p_value) {
+        PackedKernels::add_value(_scalars_w(), _scalar_count(), _scalars(p_value), Traits::STRIDE);
+    }
+
+    void mul(const PackedArray& p_other) {
+        ERROR_FAIL_COND_MSG(p_other.size() != this->size(), "Packed arrays must have the same size.");
+        Scalar* dst = _scalars_w();
+        PackedKernels::mul(dst, p_other._scalars(), _scalar_count());
+    }
+
+    void mul(const T& p_value) {
+        PackedKernels::mul_value(_scalars_w(), _scalar_count(), _scalars(p_value), Traits::STRIDE);
+    }
+
+    /** Adds p_other scaled by p_scale. */
+    void fma(const PackedArray& p_other, const T& p_scale) {
+        ERROR_FAIL_COND_MSG(p_other.size() != this->size(), "Packed arrays must have the same size.");
+        Scalar* dst = _scalars_w();
+        PackedKernels::fma(dst, p_other._scalars(), _scalar_count(), _scalars(p_scale), Traits::STRIDE);
+    }
+
+    /** Multiplies every element by p_mul, then adds p_add. */
+    void fma(const T& p_mul, const T& p_add) {
+        PackedKernels::fma_value(_scalars_w(), _scalar_count(), _scalars(p_mul), _scalars(p_add), Traits::STRIDE);
+    }
+
+    void clamp(const T& p_min, const T& p_max) {
+        PackedKernels::clamp(_scalars_w(), _scalar_count(), _scalars(p_min), _scalars(p_max), Traits::STRIDE);
+    }
+
+    /** Moves every element toward the matching one of p_to by p_weight. */
+    void lerp(const PackedArray& p_to, Scalar p_weight) {
+        static_assert(std::is_floating_point<Scalar>::value, "lerp() is only defined for floating point arrays.");
+        ERROR_FAIL_COND_MSG(p_to.size() != this->size(), "Packed arrays must have the same size.");
+        Scalar* dst = _scalars_w();
+        PackedKernels::lerp(dst, p_to._scalars(), _scalar_count(), p_weight);
+    }
+
+    T min() const {
+        T result = T();
+        ERROR_FAIL_COND_V_MSG(this->is_empty(), result, "Can't take the minimum of an empty array.");
+        PackedKernels::min(_scalars(), _scalar_count(), reinterpret_cast<Scalar*>(&result), Traits::STRIDE);
+        return result;
+    }
+
+    T max() const {
+        T result = T();
+        ERROR_FAIL_COND_V_MSG(this->is_empty(), result, "Can't take the maximum of an empty array.");
+        PackedKernels::max(_scalars(), _scalar_count(), reinterpret_cast<Scalar*>(&result), Traits::STRIDE);
+        return result;
+    }
+
+    /** Accumulated in 64 bits for 32 bit integers. */
+    Sum sum() const {
+        Sum result = Sum();
+        PackedKernels::sum(_scalars(), _scalar_count(), reinterpret_cast<typename PackedKernels::Wide<Scalar>::Type*>(&result), Traits::STRIDE);
+        return result;
+    }
+
+    Dot dot(const PackedArray& p_other) const {
+        ERROR_FAIL_COND_V_MSG(p_other.size() != this->size(), Dot(), "Packed arrays must have the same size.");
+        return PackedKernels::dot(_scalars(), p_other._scalars(), _scalar_count());
+    }
+
+    _FORCE_INLINE_ PackedArray() {}
+    _FORCE_INLINE_ PackedArray(std::initializer_list<T> p_init) :
+            Vector<T>(p_init) {}
+    _FORCE_INLINE_ PackedArray(const Vector<T>& p_from) :
+            Vector<T>(p_from) {}
+    _FORCE_INLINE_ PackedArray(const PackedArray& p_from) :
+            Vector<T>(p_from) {}
+    _FORCE_INLINE_ PackedArray(PackedArray&& p_from) :
+            Vector<T>(std::move(p_from)) {}
+
+    _FORCE_INLINE_ void operator=(const PackedArray& p_from) { Vector<T>::operator=(p_from); }
+    _FORCE_INLINE_ void operator=(PackedArray&& p_from) { Vector<T>::operator=(std::move(p_from)); }
+};
+
+typedef PackedArray<int32_t> PackedInt32Array;
+typedef PackedArray<int64_t> PackedInt64Array;
+typedef PackedArray<float> PackedFloat32Array;
+typedef PackedArray<double> PackedFloat64Array;
+typedef PackedArray<Vector3> PackedVector3Array;
+
+#endif
@@ -0,0 +1,717 @@
+#include "./packed_kernels.hpp"
+
+#include "../error/error_macros.hpp"
+
+#include <string.h>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PACKED_KERNELS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PACKED_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+template <typename T>
+struct KernelTable {
+    typedef typename PackedKernels::Wide<T>::Type W;
+
+    // Strided kernels are indexed by p_stride == 3.
+    void (*add)(T*, const T*, int64_t) = nullptr;
+    void (*mul)(T*, const T*, int64_t) = nullptr;
+    void (*add_value[2])(T*, int64_t, const T*) = {};
+    void (*mul_value[2])(T*, int64_t, const T*) = {};
+    void (*fma[2])(T*, const T*, int64_t, const T*) = {};
+    void (*fma_value[2])(T*, int64_t, const T*, const T*) = {};
+    void (*clamp[2])(T*, int64_t, const T*, const T*) = {};
+    void (*lerp)(T*, const T*, int64_t, T) = nullptr;
+    void (*min[2])(const T*, int64_t, T*) = {};
+    void (*max[2])(const T*, int64_t, T*) = {};
+    void (*sum[2])(const T*, int64_t, W*) = {};
+    W (*dot)(const T*, const T*, int64_t) = nullptr;
+};
+
+/** One element at a time. Also finishes the remainders of the vector paths,
+ *  so it defines the results they must match: integers wrap instead of
+ *  overflowing, min and max keep the second operand on ties and NaNs. */
+template <typename T>
+struct ScalarLanes {
+    typedef T V;
+    typedef typename PackedKernels::Wide<T>::Type W;
+    typedef W Acc;
+    enum {
+        N = 1,
+        ACC_N = 1,
+    };
+
+    template <typename U>
+    struct Unsigned {
+        typedef typename std::conditional<std::is_integral<U>::value, std::make_unsigned<U>, std::common_type<U>>::type::type Type;
+    };
+
+    static _FORCE_INLINE_ V load(const T* p) { return *p; }
+    static _FORCE_INLINE_ void store(T* p, V v) { *p = v; }
+    static _FORCE_INLINE_ V set1(T v) { return v; }
+    static _FORCE_INLINE_ V add(V a, V b) { return T(typename Unsigned<T>::Type(a) + typename Unsigned<T>::Type(b)); }
+    static _FORCE_INLINE_ V sub(V a, V b) { return T(typename Unsigned<T>::Type(a) - typename Unsigned<T>::Type(b)); }
+    static _FORCE_INLINE_ V mul(V a, V b) { return T(typename Unsigned<T>::Type(a) * typename Unsigned<T>::Type(b)); }
+    static _FORCE_INLINE_ V min(V a, V b) { return a < b ? a : b; }
+    static _FORCE_INLINE_ V max(V a, V b) { return a > b ? a : b; }
+
+    static _FORCE_INLINE_ Acc acc_zero() { return 0; }
+    static _FORCE_INLINE_ Acc acc_add_wide(Acc a, W v) { return W(typename Unsigned<W>::Type(a) + typename Unsigned<W>::Type(v)); }
+    static _FORCE_INLINE_ Acc acc_add(Acc a, V v) { return acc_add_wide(a, W(v)); }
+    static _FORCE_INLINE_ Acc acc_mul_add(Acc a, V x, V y) {
+        return acc_add_wide(a, W(typename Unsigned<W>::Type(W(x)) * typename Unsigned<W>::Type(W(y))));
+    }
+    static _FORCE_INLINE_ void acc_store(W* p, Acc a) { *p = a; }
+};
+
+namespace PackedKernelsScalar {
+
+template <typename T>
+struct Lanes : ScalarLanes<T> {};
+
+#include "./packed_kernels.inc"
+
+} // namespace PackedKernelsScalar
+
+#if defined(PACKED_KERNELS_X86)
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse4.1"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+#endif
+
+namespace PackedKernelsSSE41 {
+
+/** SSE2 lacks a 64 bit multiply: put it together from 32 bit halves. */
+static _FORCE_INLINE_ __m128i _mul_epi64(__m128i a, __m128i b) {
+    const __m128i cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b), _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+    return _mm_add_epi64(_mm_mul_epu32(a, b), _mm_slli_epi64(cross, 32));
+}
+
+/** a > b on signed 64 bit lanes, which SSE4.2 added. The high halves decide
+ *  unless they're equal, then the borrow of b - a does. */
+static _FORCE_INLINE_ __m128i _cmpgt_epi64(__m128i a, __m128i b) {
+    __m128i r = _mm_and_si128(_mm_cmpeq_epi32(a, b), _mm_sub_epi64(b, a));
+    r = _mm_or_si128(r, _mm_cmpgt_epi32(a, b));
+    return _mm_shuffle_epi32(r, _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+template <typename T>
+struct Lanes;
+
+template <>
+struct Lanes<float> {
+    typedef __m128 V;
+    typedef V Acc;
+    typedef float W;
+    enum {
+        N = 4,
+        ACC_N = 4,
+    };
+
+    static _FORCE_INLINE_ V load(const float* p) { return _mm_loadu_ps(p); }
+    static _FORCE_INLINE_ void store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static _FORCE_INLINE_ V set1(float v) { return _mm_set1_ps(v); }
+    static _FORCE_INLINE_ V add(V a, V b) { return _mm_add_ps(a, b); }
+    static _FORCE_INLINE_ V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static _FORCE_INLINE_ V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static _FORCE_INLINE_ V min(V a, V b) { return _mm_min_ps(a, b); }
+    static _FORCE_INLINE_ V max(V a, V b) { return _mm_max_ps(a, b); }
+
+    static _FORCE_INLINE_ Acc acc_zero() { return _mm_setzero_ps(); }
+    static _FORCE_INLINE_ Acc acc_add(Acc a, V v) { return _mm_add_ps(a, v); }
+    static _FORCE_INLINE_ Acc acc_mul_add(Acc a, V x, V y) { return _mm_add_ps(a, _mm_mul_ps(x, y)); }
+    static _FORCE_INLINE_ void acc_store(W* p, Acc a) { _mm_storeu_ps(p, a); }
+};
+
+template <>
+struct Lanes<double> {
+    typedef __m128d V;
+    typedef V Acc;
+    typedef double W;
+    enum {
+        N = 2,
+        ACC_N = 2,
+    };
+
+    static _FORCE_INLINE_ V load(const double* p) { return _mm_loadu_pd(p); }
+    static _FORCE_INLINE_ void store(double* p, V v) { _mm_storeu_pd(p, v); }
+    static _FORCE_INLINE_ V set1(double v) { return _mm_set1_pd(v); }
+    static _FORCE_INLINE_ V add(V a, V b) { return _mm_add_pd(a, b); }
+    static _FORCE_INLINE_ V sub(V a, V b) { return _mm_sub_pd(a, b); }
+    static _FORCE_INLINE_ V mul(V a, V b) { return _mm_mul_pd(a, b); }
+    static _FORCE_INLINE_ V min(V a, V b) { return _mm_min_pd(a, b); }
+    static _FORCE_INLINE_ V max(V a, V b) { return _mm_max_pd(a, b); }
+
+    static _FORCE_INLINE_ Acc acc_zero() { return _mm_setzero_pd(); }
+    static _FORCE_INLINE_ Acc acc_add(Acc a, V v) { return _mm_add_pd(a, v); }
+    static _FORCE_INLINE_ Acc acc_mul_add(Acc a, V x, V y) { return _mm_add_pd(a, _mm_mul_pd(x, y)); }
+    static _FORCE_INLINE_ void acc_store(W* p, Acc a) { _mm_storeu_pd(p, a); }
+};
+
+template <>
+struct Lanes<int32_t> {
+    typedef __m128i V;
+    typedef int64_t W;
+    /** Widened to 64 bits: elements 0-1 in lo, 2-3 in hi. */
+    struct Acc {
+        __m128i lo;
+        __m128i hi;
+    };
+    enum {
+        N = 4,
+        ACC_N = 4,
+    };
+
+    static _FORCE_INLINE_ V load(const int32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static _FORCE_INLINE_ void store(int32_t* p, V v) { _mm_storeu_si128((__m128i*)p, v); }
+    static _FORCE_INLINE_ V set1(int32_t v) { return _mm_set1_epi32(v); }
+    static _FORCE_INLINE_ V add(V a, V b) { return _mm_add_epi32(a, b); }
+    static _FORCE_INLINE_ V sub(V a, V b) { return _mm_sub_epi32(a, b); }
+    static _FORCE_INLINE_ V mul(V a, V b) { return _mm_mullo_epi32(a, b); }
+    static _FORCE_INLINE_ V min(V a, V b) { return _mm_min_epi32(a, b); }
+    static _FORCE_INLINE_ V max(V a, V b) { return _mm_max_epi32(a, b); }
+
+    static _FORCE_INLINE_ Acc acc_zero() { return { _mm_setzero_si128(), _mm_setzero_si128() }; }
+    static _FORCE_INLINE_ Acc acc_add(Acc a, V v) {
+        return { _mm_add_epi64(a.lo, _mm_cvtepi32_epi64(v)), _mm_add_epi64(a.hi, _mm_cvtepi32_epi64(_mm_srli_si128(v, 8))) };
+    }
+    /** Even and odd elements multiplied apart, so the lanes end up out of
+     *  order; dot() doesn't mind. */
+    static _FORCE_INLINE_ Acc acc_mul_add(Acc a, V x, V y) {
+        return { _mm_add_epi64(a.lo, _mm_mul_epi32(x, y)), _mm_add_epi64(a.hi, _mm_mul_epi32(_mm_srli_epi64(x, 32), _mm_srli_epi64(y, 32))) };
+    }
+    static _FORCE_INLINE_ void acc_store(W* p, Acc a) {
+        _mm_storeu_si128((__m128i*)p, a.lo);
+        _mm_storeu_si128((__m128i*)(p + 2), a.hi);
+    }
+};
+
+template <>
+struct Lanes<int64_t> {
+    typedef __m128i V;
+    typedef V Acc;
+    typedef int64_t W;
+    enum {
+        N = 2,
+        ACC_N = 2,
+    };
+
+    static _FORCE_INLINE_ V load(const int64_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static _FORCE_INLINE_ void store(int64_t* p, V v) { _mm_storeu_si128((__m128i*)p, v); }
+    static _FORCE_INLINE_ V set1(int64_t v) { return _mm_set1_epi64x(v); }
+    static _FORCE_INLINE_ V add(V a, V b) { return _mm_add_epi64(a, b); }
+    static _FORCE_INLINE_ V sub(V a, V b) { return _mm_sub_epi64(a, b); }
+    static _FORCE_INLINE_ V mul(V a, V b) { return _mul_epi64(a, b); }
+    static _FORCE_INLINE_ V min(V a, V b) { return _mm_blendv_epi8(b, a, _cmpgt_epi64(b, a)); }
+    static _FORCE_INLINE_ V max(V a, V b) { return _mm_blendv_epi8(b, a, _cmpgt_epi64(a, b)); }
+
+    static _FORCE_INLINE_ Acc acc_zero() { return _mm_setzero_si128(); }
+    static _FORCE_INLINE_ Acc acc_add(Acc a, V v) { return _mm_add_epi64(a, v); }
+    static _FORCE_INLINE_ Acc acc_mul_add(Acc a, V x, V y) { return _mm_add_epi64(a, _mul_epi64(x, y)); }
+    static _FORCE_INLINE_ void acc_store(W* p, Acc a) { _mm_storeu_si128((__m128i*)p, a); }
+};
+
+#include "./packed_kernels.inc"
+
+} // namespace PackedKernelsSSE41
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace PackedKernelsAVX2 {
+
+static _FORCE_INLINE_ __m256i _mul_epi64(__m256i a, __m256i b) {
+    const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+}
+
+template <typename T>
+struct Lanes;
+
+template <>
+struct Lanes<float> {
+    typedef __m256 V;
+    typedef V Acc;
+    typedef float W;
+    enum {
+        N = 8,
+        ACC_N = 8,
+    };
+
+    static _FORCE_INLINE_ V load(const float* p) { return _mm256_loadu_ps(p); }
+    static _FORCE_INLINE_ void store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static _FORCE_INLINE_ V set1(float v) { return _mm256_set1_ps(v); }
+    static _FORCE_INLINE_ V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static _FORCE_INLINE_ V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static _FORCE_INLINE_ V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static _FORCE_INLINE_ V min(V a, V b) { return _mm256_min_ps(a, b); }
+    static _FORCE_INLINE_ V max(V a, V b) { return _mm256_max_ps(a, b); }
+
+    static _FORCE_INLINE_ Acc acc_zero() { return _mm256_setzero_ps(); }
+    static _FORCE_INLINE_ Acc acc_add(Acc a, V v) { return _mm256_add_ps(a, v); }
+    static _FORCE_INLINE_ Acc acc_mul_add(Acc a, V x, V y) { return _mm256_add_ps(a, _mm256_mul_ps(x, y)); }
+    static _FORCE_INLINE_ void acc_store(W* p, Acc a) { _mm256_storeu_ps(p, a); }
+};
+
+template <>
+struct Lanes<double> {
+    typedef __m256d V;
+    typedef V Acc;
+    typedef double W;
+    enum {
+        N = 4,
+        ACC_N = 4,
+    };
+
+    static _FORCE_INLINE_ V load(const double* p) { return _mm256_loadu_pd(p); }
+    static _FORCE_INLINE_ void store(double* p, V v) { _mm256_storeu_pd(p, v); }
+    static _FORCE_INLINE_ V set1(double v) { return _mm256_set1_pd(v); }
+    static _FORCE_INLINE_ V add(V a, V b) { return _mm256_add_pd(a, b); }
+    static _FORCE_INLINE_ V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+    static _FORCE_INLINE_ V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+    static _FORCE_INLINE_ V min(V a, V b) { return _mm256_min_pd(a, b); }
+    static _FORCE_INLINE_ V max(V a, V b) { return _mm256_max_pd(a, b); }
+
+    static _FORCE_INLINE_ Acc acc_zero() { return _mm256_setzero_pd(); }
+    static _FORCE_INLINE_ Acc acc_add(Acc a, V v) { return _mm256_add_pd(a, v); }
+    static _FORCE_INLINE_ Acc acc_mul_add(Acc a, V x, V y) { return _mm256_add_pd(a, _mm256_mul_pd(x, y)); }
+    static _FORCE_INLINE_ void acc_store(W* p, Acc a) { _mm256_storeu_pd(p, a); }
+};
+
+template <>
+struct Lanes<int32_t> {
+    typedef __m256i V;
+    typedef int64_t W;
+    /** Widened to 64 bits: elements 0-3 in lo, 4-7 in hi. */
+    struct Acc {
+        __m256i lo;
+        __m256i hi;
+    };
+    enum {
+        N = 8,
+        ACC_N = 8,
+    };
+
+    static _FORCE_INLINE_ V load(const int32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static _FORCE_INLINE_ void store(int32_t* p, V v) { _mm256_storeu_si256((__m256i*)p, v); }
+    static _FORCE_INLINE_ V set1(int32_t v) { return _mm256_set1_epi32(v); }
+    static _FORCE_INLINE_ V add(V a, V b) { return _mm256_add_epi32(a, b); }
+    static _FORCE_INLINE_ V sub(V a, V b) { return _mm256_sub_epi32(a, b); }
+    static _FORCE_INLINE_ V mul(V a, V b) { return _mm256_mullo_epi32(a, b); }
+    static _FORCE_INLINE_ V min(V a, V b) { return _mm256_min_epi32(a, b); }
+    static _FORCE_INLINE_ V max(V a, V b) { return _mm256_max_epi32(a, b); }
+
+    static _FORCE_INLINE_ Acc acc_zero() { return { _mm256_setzero_si256(), _mm256_setzero_si256() }; }
+    static _FORCE_INLINE_ Acc acc_add(Acc a, V v) {
+        return { _mm256_add_epi64(a.lo, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v))),
+            _mm256_add_epi64(a.hi, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1))) };
+    }
+    static _FORCE_INLINE_ Acc acc_mul_add(Acc a, V x, V y) {
+        return { _mm256_add_epi64(a.lo, _mm256_mul_epi32(x, y)),
+            _mm256_add_epi64(a.hi, _mm256_mul_epi32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32))) };
+    }
+    static _FORCE_INLINE_ void acc_store(W* p, Acc a) {
+        _mm256_storeu_si256((__m256i*)p, a.lo);
+        _mm256_storeu_si256((__m256i*)(p + 4), a.hi);
+    }
+};
+
+template <>
+struct Lanes<int64_t> {
+    typedef __m256i V;
+    typedef V Acc;
+    typedef int64_t W;
+    enum {
+        N = 4,
+        ACC_N = 4,
+    };
+
+    static _FORCE_INLINE_ V load(const int64_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static _FORCE_INLINE_ void store(int64_t* p, V v) { _mm256_storeu_si256((__m256i*)p, v); }
+    static _FORCE_INLINE_ V set1(int64_t v) { return _mm256_set1_epi64x(v); }
+    static _FORCE_INLINE_ V add(V a, V b) { return _mm256_add_epi64(a, b); }
+    static _FORCE_INLINE_ V sub(V a, V b) { return _mm256_sub_epi64(a, b); }
+    static _FORCE_INLINE_ V mul(V a, V b) { return _mul_epi64(a, b); }
+    static _FORCE_INLINE_ V min(V a, V b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(b, a)); }
+    static _FORCE_INLINE_ V max(V a, V b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+
+    static _FORCE_INLINE_ Acc acc_zero() { return _mm256_setzero_si256(); }
+    static _FORCE_INLINE_ Acc acc_add(Acc a, V v) { return _mm256_add_epi64(a, v); }
+    static _FORCE_INLINE_ Acc acc_mul_add(Acc a, V x, V y) { return _mm256_add_epi64(a, _mul_epi64(x, y)); }
+    static _FORCE_INLINE_ void acc_store(W* p, Acc a) { _mm256_storeu_si256((__m256i*)p, a); }
+};
+
+#include "./packed_kernels.inc"
+
+} // namespace PackedKernelsAVX2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+static bool _cpu_supports(const char* p_feature) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    // AVX state must also be enabled by the OS (OSXSAVE and XCR0 bits 1-2).
+    const bool avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    const bool avx2 = avx && (info[1] & (1 << 5)) != 0;
+    return p_feature[0] == 'a' ? avx2 : sse41;
+#else
+    __builtin_cpu_init();
+    return p_feature[0] == 'a' ? __builtin_cpu_supports("avx2") : __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+#elif defined(PACKED_KERNELS_NEON)
+
+namespace PackedKernelsNEON {
+
+template <typename T>
+struct Lanes;
+
+template <>
+struct Lanes<float> {
+    typedef float32x4_t V;
+    typedef V Acc;
+    typedef float W;
+    enum {
+        N = 4,
+        ACC_N = 4,
+    };
+
+    static _FORCE_INLINE_ V load(const float* p) { return vld1q_f32(p); }
+    static _FORCE_INLINE_ void store(float* p, V v) { vst1q_f32(p, v); }
+    static _FORCE_INLINE_ V set1(float v) { return vdupq_n_f32(v); }
+    static _FORCE_INLINE_ V add(V a, V b) { return vaddq_f32(a, b); }
+    static _FORCE_INLINE_ V sub(V a, V b) { return vsubq_f32(a, b); }
+    static _FORCE_INLINE_ V mul(V a, V b) { return vmulq_f32(a, b); }
+    // vminq/vmaxq return NaN if either is; select like the x86 paths instead.
+    static _FORCE_INLINE_ V min(V a, V b) { return vbslq_f32(vcltq_f32(a, b), a, b); }
+    static _FORCE_INLINE_ V max(V a, V b) { return vbslq_f32(vcgtq_f32(a, b), a, b); }
+
+    static _FORCE_INLINE_ Acc acc_zero() { return vdupq_n_f32(0); }
+    static _FORCE_INLINE_ Acc acc_add(Acc a, V v) { return vaddq_f32(a, v); }
+    static _FORCE_INLINE_ Acc acc_mul_add(Acc a, V x, V y) { return vaddq_f32(a, vmulq_f32(x, y)); }
+    static _FORCE_INLINE_ void acc_store(W* p, Acc a) { vst1q_f32(p, a); }
+};
+
+template <>
+struct Lanes<double> {
+    typedef float64x2_t V;
+    typedef V Acc;
+    typedef double W;
+    enum {
+        N = 2,
+        ACC_N = 2,
+    };
+
+    static _FORCE_INLINE_ V load(const double* p) { return vld1q_f64(p); }
+    static _FORCE_INLINE_ void store(double* p, V v) { vst1q_f64(p, v); }
+    static _FORCE_INLINE_ V set1(double v) { return vdupq_n_f64(v); }
+    static _FORCE_INLINE_ V add(V a, V b) { return vaddq_f64(a, b); }
+    static _FORCE_INLINE_ V sub(V a, V b) { return vsubq_f64(a, b); }
+    static _FORCE_INLINE_ V mul(V a, V b) { return vmulq_f64(a, b); }
+    static _FORCE_INLINE_ V min(V a, V b) { return vbslq_f64(vcltq_f64(a, b), a, b); }
+    static _FORCE_INLINE_ V max(V a, V b) { return vbslq_f64(vcgtq_f64(a, b), a, b); }
+
+    static _FORCE_INLINE_ Acc acc_zero() { return vdupq_n_f64(0); }
+    static _FORCE_INLINE_ Acc acc_add(Acc a, V v) { return vaddq_f64(a, v); }
+    static _FORCE_INLINE_ Acc acc_mul_add(Acc a, V x, V y) { return vaddq_f64(a, vmulq_f64(x, y)); }
+    static _FORCE_INLINE_ void acc_store(W* p, Acc a) { vst1q_f64(p, a); }
+};
+
+template <>
+struct Lanes<int32_t> {
+    typedef int32x4_t V;
+    typedef int64_t W;
+    /** Widened to 64 bits: elements 0-1 in lo, 2-3 in hi. */
+    struct Acc {
+        int64x2_t lo;
+        int64x2_t hi;
+    };
+    enum {
+        N = 4,
+        ACC_N = 4,
+    };
+
+    static _FORCE_INLINE_ V load(const int32_t* p) { return vld1q_s32(p); }
+    static _FORCE_INLINE_ void store(int32_t* p, V v) { vst1q_s32(p, v); }
+    static _FORCE_INLINE_ V set1(int32_t v) { return vdupq_n_s32(v); }
+    static _FORCE_INLINE_ V add(V a, V b) { return vaddq_s32(a, b); }
+    static _FORCE_INLINE_ V sub(V a, V b) { return vsubq_s32(a, b); }
+    static _FORCE_INLINE_ V mul(V a, V b) { return vmulq_s32(a, b); }
+    static _FORCE_INLINE_ V min(V a, V b) { return vminq_s32(a, b); }
+    static _FORCE_INLINE_ V max(V a, V b) { return vmaxq_s32(a, b); }
+
+    static _FORCE_INLINE_ Acc acc_zero() { return { vdupq_n_s64(0), vdupq_n_s64(0) }; }
+    static _FORCE_INLINE_ Acc acc_add(Acc a, V v) { return { vaddw_s32(a.lo, vget_low_s32(v)), vaddw_s32(a.hi, vget_high_s32(v)) }; }
+    static _FORCE_INLINE_ Acc acc_mul_add(Acc a, V x, V y) {
+        return { vmlal_s32(a.lo, vget_low_s32(x), vget_low_s32(y)), vmlal_s32(a.hi, vget_high_s32(x), vget_high_s32(y)) };
+    }
+    static _FORCE_INLINE_ void acc_store(W* p, Acc a) {
+        vst1q_s64(p, a.lo);
+        vst1q_s64(p + 2, a.hi);
+    }
+};
+
+template <>
+struct Lanes<int64_t> {
+    typedef int64x2_t V;
+    typedef V Acc;
+    typedef int64_t W;
+    enum {
+        N = 2,
+        ACC_N = 2,
+    };
+
+    static _FORCE_INLINE_ V load(const int64_t* p) { return vld1q_s64(p); }
+    static _FORCE_INLINE_ void store(int64_t* p, V v) { vst1q_s64(p, v); }
+    static _FORCE_INLINE_ V set1(int64_t v) { return vdupq_n_s64(v); }
+    static _FORCE_INLINE_ V add(V a, V b) { return vaddq_s64(a, b); }
+    static _FORCE_INLINE_ V sub(V a, V b) { return vsubq_s64(a, b); }
+    // No 64 bit vector multiply in NEON; two scalar ones in the register.
+    static _FORCE_INLINE_ V mul(V a, V b) {
+        const int64_t lo = ScalarLanes<int64_t>::mul(vgetq_lane_s64(a, 0), vgetq_lane_s64(b, 0));
+        const int64_t hi = ScalarLanes<int64_t>::mul(vgetq_lane_s64(a, 1), vgetq_lane_s64(b, 1));
+        return vcombine_s64(vcreate_s64(uint64_t(lo)), vcreate_s64(uint64_t(hi)));
+    }
+    static _FORCE_INLINE_ V min(V a, V b) { return vbslq_s64(vcltq_s64(a, b), a, b); }
+    static _FORCE_INLINE_ V max(V a, V b) { return vbslq_s64(vcgtq_s64(a, b), a, b); }
+
+    static _FORCE_INLINE_ Acc acc_zero() { return vdupq_n_s64(0); }
+    static _FORCE_INLINE_ Acc acc_add(Acc a, V v) { return vaddq_s64(a, v); }
+    static _FORCE_INLINE_ Acc acc_mul_add(Acc a, V x, V y) { return vaddq_s64(a, mul(x, y)); }
+    static _FORCE_INLINE_ void acc_store(W* p, Acc a) { vst1q_s64(p, a); }
+};
+
+#include "./packed_kernels.inc"
+
+} // namespace PackedKernelsNEON
+
+#endif
+
+enum PackedInstructionSet {
+    PACKED_SCALAR,
+    PACKED_SSE41,
+    PACKED_AVX2,
+    PACKED_NEON,
+    PACKED_MAX,
+};
+
+static const char* _instruction_set_names[PACKED_MAX] = { "scalar", "SSE4.1", "AVX2", "NEON" };
+
+static bool _instruction_set_supported(PackedInstructionSet p_instruction_set) {
+    switch (p_instruction_set) {
+#if defined(PACKED_KERNELS_X86)
+        case PACKED_AVX2:
+            return _cpu_supports("avx2");
+        case PACKED_SSE41:
+            return _cpu_supports("sse4.1");
+#elif defined(PACKED_KERNELS_NEON)
+        case PACKED_NEON:
+            return true;
+#endif
+        case PACKED_SCALAR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static PackedInstructionSet _detect_instruction_set() {
+#if defined(PACKED_KERNELS_X86)
+    if (_cpu_supports("avx2")) {
+        return PACKED_AVX2;
+    }
+    if (_cpu_supports("sse4.1")) {
+        return PACKED_SSE41;
+    }
+    return PACKED_SCALAR;
+#elif defined(PACKED_KERNELS_NEON)
+    return PACKED_NEON;
+#else
+    return PACKED_SCALAR;
+#endif
+}
+
+static PackedInstructionSet& _instruction_set() {
+    static PackedInstructionSet instruction_set = _detect_instruction_set();
+    return instruction_set;
+}
+
+template <typename T>
+static KernelTable<T> _make_table() {
+    KernelTable<T> table;
+    switch (_instruction_set()) {
+#if defined(PACKED_KERNELS_X86)
+        case PACKED_AVX2:
+            PackedKernelsAVX2::fill_table(table);
+            break;
+        case PACKED_SSE41:
+            PackedKernelsSSE41::fill_table(table);
+            break;
+#elif defined(PACKED_KERNELS_NEON)
+        case PACKED_NEON:
+            PackedKernelsNEON::fill_table(table);
+            break;
+#endif
+        default:
+            PackedKernelsScalar::fill_table(table);
+            break;
+    }
+    return table;
+}
+
+/** Filled for the detected instruction set on first use; only
+ *  set_instruction_set() writes it again. */
+template <typename T>
+static _FORCE_INLINE_ KernelTable<T>& _table() {
+    static KernelTable<T> table = _make_table<T>();
+    return table;
+}
+
+#define PACKED_KERNELS_CHECK_STRIDE(m_stride) \
+    ERROR_FAIL_COND_MSG((m_stride) != 1 && (m_stride) != 3, "Packed kernels only support a stride of 1 or 3.")
+
+namespace PackedKernels {
+
+template <typename T>
+void add(T* p_dst, const T* p_src, int64_t p_count) {
+    _table<T>().add(p_dst, p_src, p_count);
+}
+
+template <typename T>
+void mul(T* p_dst, const T* p_src, int64_t p_count) {
+    _table<T>().mul(p_dst, p_src, p_count);
+}
+
+template <typename T>
+void add_value(T* p_dst, int64_t p_count, const T* p_value, int p_stride) {
+    PACKED_KERNELS_CHECK_STRIDE(p_stride);
+    _table<T>().add_value[p_stride == 3](p_dst, p_count, p_value);
+}
+
+template <typename T>
+void mul_value(T* p_dst, int64_t p_count, const T* p_value, int p_stride) {
+    PACKED_KERNELS_CHECK_STRIDE(p_stride);
+    _table<T>().mul_value[p_stride == 3](p_dst, p_count, p_value);
+}
+
+template <typename T>
+void fma(T* p_dst, const T* p_src, int64_t p_count, const T* p_scale, int p_stride) {
+    PACKED_KERNELS_CHECK_STRIDE(p_stride);
+    _table<T>().fma[p_stride == 3](p_dst, p_src, p_count, p_scale);
+}
+
+template <typename T>
+void fma_value(T* p_dst, int64_t p_count, const T* p_mul, const T* p_add, int p_stride) {
+    PACKED_KERNELS_CHECK_STRIDE(p_stride);
+    _table<T>().fma_value[p_stride == 3](p_dst, p_count, p_mul, p_add);
+}
+
+template <typename T>
+void clamp(T* p_dst, int64_t p_count, const T* p_min, const T* p_max, int p_stride) {
+    PACKED_KERNELS_CHECK_STRIDE(p_stride);
+    _table<T>().clamp[p_stride == 3](p_dst, p_count, p_min, p_max);
+}
+
+template <typename T>
+void lerp(T* p_dst, const T* p_to, int64_t p_count, T p_weight) {
+    static_assert(std::is_floating_point<T>::value, "lerp() is only defined for floating point types.");
+    _table<T>().lerp(p_dst, p_to, p_count, p_weight);
+}
+
+template <typename T>
+void min(const T* p_src, int64_t p_count, T* r_min, int p_stride) {
+    PACKED_KERNELS_CHECK_STRIDE(p_stride);
+    ERROR_FAIL_COND_MSG(p_count < p_stride, "Can't take the minimum of an empty buffer.");
+    _table<T>().min[p_stride == 3](p_src, p_count, r_min);
+}
+
+template <typename T>
+void max(const T* p_src, int64_t p_count, T* r_max, int p_stride) {
+    PACKED_KERNELS_CHECK_STRIDE(p_stride);
+    ERROR_FAIL_COND_MSG(p_count < p_stride, "Can't take the maximum of an empty buffer.");
+    _table<T>().max[p_stride == 3](p_src, p_count, r_max);
+}
+
+template <typename T>
+void sum(const T* p_src, int64_t p_count, typename Wide<T>::Type* r_sum, int p_stride) {
+    PACKED_KERNELS_CHECK_STRIDE(p_stride);
+    _table<T>().sum[p_stride == 3](p_src, p_count, r_sum);
+}
+
+template <typename T>
+typename Wide<T>::Type dot(const T* p_a, const T* p_b, int64_t p_count) {
+    return _table<T>().dot(p_a, p_b, p_count);
+}
+
+const char* get_instruction_set() {
+    return _instruction_set_names[_instruction_set()];
+}
+
+bool has_instruction_set(const char* p_name) {
+    for (int i = 0; i < PACKED_MAX; i++) {
+        if (strcmp(p_name, _instruction_set_names[i]) == 0) {
+            return _instruction_set_supported(PackedInstructionSet(i));
+        }
+    }
+    return false;
+}
+
+void set_instruction_set(const char* p_name) {
+    ERROR_FAIL_COND_MSG(!has_instruction_set(p_name), "Packed kernels can't run on this instruction set.");
+    for (int i = 0; i < PACKED_MAX; i++) {
+        if (strcmp(p_name, _instruction_set_names[i]) == 0) {
+            _instruction_set() = PackedInstructionSet(i);
+        }
+    }
+    _table<int32_t>() = _make_table<int32_t>();
+    _table<int64_t>() = _make_table<int64_t>();
+    _table<float>() = _make_table<float>();
+    _table<double>() = _make_table<double>();
+}
+
+#define PACKED_KERNELS_INSTANTIATE(m_type)                                                                   \
+    template void add<m_type>(m_type*, const m_type*, int64_t);                                              \
+    template void mul<m_type>(m_type*, const m_type*, int64_t);                                              \
+    template void add_value<m_type>(m_type*, int64_t, const m_type*, int);                                   \
+    template void mul_value<m_type>(m_type*, int64_t, const m_type*, int);                                   \
+    template void fma<m_type>(m_type*, const m_type*, int64_t, const m_type*, int);                          \
+    template void fma_value<m_type>(m_type*, int64_t, const m_type*, const m_type*, int);                    \
+    template void clamp<m_type>(m_type*, int64_t, const m_type*, const m_type*, int);                        \
+    template void min<m_type>(const m_type*, int64_t, m_type*, int);                                         \
+    template void max<m_type>(const m_type*, int64_t, m_type*, int);                                         \
+    template void sum<m_type>(const m_type*, int64_t, typename Wide<m_type>::Type*, int);                    \
+    template typename Wide<m_type>::Type dot<m_type>(const m_type*, const m_type*, int64_t);
+
+PACKED_KERNELS_INSTANTIATE(int32_t)
+PACKED_KERNELS_INSTANTIATE(int64_t)
+PACKED_KERNELS_INSTANTIATE(float)
+PACKED_KERNELS_INSTANTIATE(double)
+
+template void lerp<float>(float*, const float*, int64_t, float);
+template void lerp<double>(double*, const double*, int64_t, double);
+
+} // namespace PackedKernels
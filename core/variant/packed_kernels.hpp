@@ -0,0 +1,80 @@
+#ifndef __PACKED_KERNELS_HPP__
+#define __PACKED_KERNELS_HPP__
+
+#include "../typedefs.hpp"
+
+#include <stdint.h>
+
+/** Bulk math over contiguous numeric buffers, behind the packed arrays.
+ *
+ *  Defined for int32_t, int64_t, float and double (lerp for the floating
+ *  point types only). The first call picks the widest instruction set the CPU
+ *  supports (AVX2, SSE4.1 or NEON, scalar otherwise) and every later call goes
+ *  straight to it. All paths give the same results for integers, which wrap
+ *  on overflow; floating point reductions may differ in the last bits, since
+ *  they add in a different order.
+ *
+ *  Functions taking a p_stride apply p_value[i % p_stride] to element i, so a
+ *  buffer of Vector3 is handled as 3 * size scalars with a stride of 3. Only 1
+ *  and 3 are supported. Reductions write one result per stride component;
+ *  p_count must be a multiple of p_stride.
+ */
+namespace PackedKernels {
+
+/** Type sums and dot products are accumulated in. */
+template <typename T>
+struct Wide {
+    typedef T Type;
+};
+
+template <>
+struct Wide<int32_t> {
+    typedef int64_t Type;
+};
+
+/** p_dst[i] += p_src[i] */
+template <typename T>
+void add(T* p_dst, const T* p_src, int64_t p_count);
+/** p_dst[i] *= p_src[i] */
+template <typename T>
+void mul(T* p_dst, const T* p_src, int64_t p_count);
+/** p_dst[i] += p_value[i % p_stride] */
+template <typename T>
+void add_value(T* p_dst, int64_t p_count, const T* p_value, int p_stride);
+/** p_dst[i] *= p_value[i % p_stride] */
+template <typename T>
+void mul_value(T* p_dst, int64_t p_count, const T* p_value, int p_stride);
+/** p_dst[i] += p_src[i] * p_scale[i % p_stride] */
+template <typename T>
+void fma(T* p_dst, const T* p_src, int64_t p_count, const T* p_scale, int p_stride);
+/** p_dst[i] = p_dst[i] * p_mul[i % p_stride] + p_add[i % p_stride] */
+template <typename T>
+void fma_value(T* p_dst, int64_t p_count, const T* p_mul, const T* p_add, int p_stride);
+/** Clamps p_dst[i] between p_min[i % p_stride] and p_max[i % p_stride]. */
+template <typename T>
+void clamp(T* p_dst, int64_t p_count, const T* p_min, const T* p_max, int p_stride);
+/** p_dst[i] += (p_to[i] - p_dst[i]) * p_weight */
+template <typename T>
+void lerp(T* p_dst, const T* p_to, int64_t p_count, T p_weight);
+
+template <typename T>
+void min(const T* p_src, int64_t p_count, T* r_min, int p_stride);
+template <typename T>
+void max(const T* p_src, int64_t p_count, T* r_max, int p_stride);
+template <typename T>
+void sum(const T* p_src, int64_t p_count, typename Wide<T>::Type* r_sum, int p_stride);
+template <typename T>
+typename Wide<T>::Type dot(const T* p_a, const T* p_b, int64_t p_count);
+
+/** Name of the instruction set the kernels run on, for diagnostics:
+ *  "AVX2", "SSE4.1", "NEON" or "scalar". */
+const char* get_instruction_set();
+/** Whether this CPU can run the kernels on the named instruction set. */
+bool has_instruction_set(const char* p_name);
+/** Switches every kernel to the named instruction set, so tests can check
+ *  the paths against each other. Not thread safe: no kernel may be running. */
+void set_instruction_set(const char* p_name);
+
+} // namespace PackedKernels
+
+#endif
@@ -0,0 +1,629 @@
+#include "./variant.hpp"
+
+#include "../object/ref_counted.hpp"
+#include "../templates/hashfuncs.hpp"
+
+#include <string.h>
+
+PagedAllocator<Variant::Pools::BucketSmall, true> Variant::Pools::_bucket_small;
+
+/** Per-type operations. Only called with both operands of the table's type;
+ *  copy() receives an uninitialized destination payload. */
+struct VariantTypeOps {
+    typedef void (*CopyFunc)(Variant& r_dst, const Variant& p_src);
+    typedef void (*DestroyFunc)(Variant& p_variant);
+    typedef bool (*CompareFunc)(const Variant& p_a, const Variant& p_b);
+    typedef uint32_t (*HashFunc)(const Variant& p_variant, int p_recursion_count);
+
+    struct Entry {
+        const char* name;
+        CopyFunc copy;
+        DestroyFunc destroy;
+        CompareFunc equal;
+        CompareFunc less;
+        HashFunc hash;
+    };
+
+    static const Entry table[Variant::VARIANT_MAX];
+
+    /** Hashes the raw bytes of a POD value. Only used for types without padding. */
+    static _FORCE_INLINE_ uint32_t hash_bytes(const void* p_ptr, size_t p_size) {
+        const uint8_t* bytes = (const uint8_t*)p_ptr;
+        uint32_t h = HASH_MURMUR3_SEED;
+        size_t i = 0;
+        for (; i + 4 <= p_size; i += 4) {
+            uint32_t word;
+            memcpy(&word, bytes + i, 4);
+            h = hash_murmur3_one_32(word, h);
+        }
+        for (; i < p_size; i++) {
+            h = hash_murmur3_one_32(bytes[i], h);
+        }
+        return hash_fmix32(h);
+    }
+
+    /** Hashes a math type made of real_t components, by value like floats. */
+    static _FORCE_INLINE_ uint32_t hash_reals(const void* p_ptr, size_t p_size) {
+        const real_t* reals = (const real_t*)p_ptr;
+        uint32_t h = HASH_MURMUR3_SEED;
+        for (size_t i = 0; i < p_size / sizeof(real_t); i++) {
+            h = hash_murmur3_one_real(reals[i], h);
+        }
+        return hash_fmix32(h);
+    }
+
+    /** Value stored inline in the payload, copied as bytes. */
+    template <typename T>
+    struct Inline {
+        static_assert(sizeof(T) <= sizeof(Variant::_data), "Type doesn't fit in the Variant payload.");
+
+        static _FORCE_INLINE_ const T& get(const Variant& p_variant) { return *p_variant._get_inline<T>(); }
+
+        static bool equal(const Variant& p_a, const Variant& p_b) { return get(p_a) == get(p_b); }
+        static bool less(const Variant& p_a, const Variant& p_b) { return get(p_a) < get(p_b); }
+        static uint32_t hash(const Variant& p_variant, int) { return hash_bytes(&get(p_variant), sizeof(T)); }
+        static uint32_t hash_real(const Variant& p_variant, int) { return hash_reals(&get(p_variant), sizeof(T)); }
+    };
+
+    /** Value stored inline that owns resources, so it has a real copy and destructor. */
+    template <typename T>
+    struct InlineManaged : public Inline<T> {
+        static void copy(Variant& r_dst, const Variant& p_src) {
+            memnew_placement(r_dst._get_inline<T>(), T(Inline<T>::get(p_src)));
+        }
+        static void destroy(Variant& p_variant) {
+            p_variant._get_inline<T>()->~T();
+        }
+    };
+
+    /** Value too large for the payload, kept in a pooled bucket. */
+    template <typename T, T Variant::Pools::BucketSmall::*Member>
+    struct Pooled {
+        static_assert(sizeof(T) <= sizeof(Variant::Pools::BucketSmall), "Type doesn't fit in the pool bucket.");
+
+        static _FORCE_INLINE_ const T& get(const Variant& p_variant) { return *(const T*)p_variant._data._ptr; }
+
+        static _FORCE_INLINE_ void store(Variant& r_dst, const T& p_value) {
+            Variant::Pools::BucketSmall* bucket = Variant::Pools::_bucket_small.alloc();
+            r_dst._data._ptr = memnew_placement(&(bucket->*Member), T(p_value));
+        }
+
+        static void copy(Variant& r_dst, const Variant& p_src) { store(r_dst, get(p_src)); }
+        static void destroy(Variant& p_variant) {
+            ((T*)p_variant._data._ptr)->~T();
+            Variant::Pools::_bucket_small.free((Variant::Pools::BucketSmall*)p_variant._data._ptr);
+        }
+        static bool equal(const Variant& p_a, const Variant& p_b) { return get(p_a) == get(p_b); }
+        /** Only math types made of real_t are pooled. */
+        static uint32_t hash(const Variant& p_variant, int) {
+            static_assert(sizeof(T) % sizeof(real_t) == 0);
+            return hash_reals(&get(p_variant), sizeof(T));
+        }
+    };
+
+    static bool nil_equal(const Variant&, const Variant&) { return true; }
+    static bool nil_less(const Variant&, const Variant&) { return false; }
+    static uint32_t nil_hash(const Variant&, int) { return 0; }
+
+    static uint32_t float_hash(const Variant& p_variant, int) { return hash_murmur3_one_double(p_variant._data._float); }
+
+    static uint32_t int_hash(const Variant& p_variant, int) { return hash_one_uint64((uint64_t)p_variant._data._int); }
+    static uint32_t bool_hash(const Variant& p_variant, int) { return p_variant._data._bool ? 1 : 0; }
+
+    static bool aabb_less(const Variant& p_a, const Variant& p_b) {
+        const ::AABB& a = Pooled<::AABB, &Variant::Pools::BucketSmall::_aabb>::get(p_a);
+        const ::AABB& b = Pooled<::AABB, &Variant::Pools::BucketSmall::_aabb>::get(p_b);
+        return a.position == b.position ? a.size < b.size : a.position < b.position;
+    }
+
+    static bool transform2d_less(const Variant& p_a, const Variant& p_b) {
+        const Transform2D& a = Pooled<Transform2D, &Variant::Pools::BucketSmall::_transform2d>::get(p_a);
+        const Transform2D& b = Pooled<Transform2D, &Variant::Pools::BucketSmall::_transform2d>::get(p_b);
+        for (int i = 0; i < 2; i++) {
+            if (a.columns[i] != b.columns[i]) {
+                return a.columns[i] < b.columns[i];
+            }
+        }
+        return a.columns[2] < b.columns[2];
+    }
+
+    static bool string_name_less(const Variant& p_a, const Variant& p_b) {
+        return StringName::AlphCompare()(Inline<StringName>::get(p_a), Inline<StringName>::get(p_b));
+    }
+    static uint32_t string_name_hash(const Variant& p_variant, int) { return Inline<StringName>::get(p_variant).hash(); }
+
+    static void object_copy(Variant& r_dst, const Variant& p_src) {
+        const Variant::ObjData& src = p_src._get_obj();
+        if (src.id.is_ref_counted()) {
+            RefCounted* ref_counted = static_cast<RefCounted*>(src.obj);
+            if (!ref_counted->reference()) {
+                memnew_placement(&r_dst._get_obj(), Variant::ObjData);
+                return;
+            }
+        }
+        memnew_placement(&r_dst._get_obj(), Variant::ObjData(src));
+    }
+
+    static void object_destroy(Variant& p_variant) {
+        Variant::ObjData& data = p_variant._get_obj();
+        if (data.id.is_ref_counted()) {
+            RefCounted* ref_counted = static_cast<RefCounted*>(data.obj);
+            if (ref_counted->unreference()) {
+                memdelete(ref_counted);
+            }
+        }
+        data.obj = nullptr;
+        data.id = ObjectID();
+    }
+
+    static bool object_equal(const Variant& p_a, const Variant& p_b) { return p_a._get_obj().obj == p_b._get_obj().obj; }
+    static bool object_less(const Variant& p_a, const Variant& p_b) { return p_a._get_obj().id < p_b._get_obj().id; }
+    static uint32_t object_hash(const Variant& p_variant, int) { return hash_one_uint64((uint64_t)p_variant._get_obj().id); }
+
+    static bool array_less(const Variant& p_a, const Variant& p_b) { return Inline<Array>::get(p_a) < Inline<Array>::get(p_b); }
+    static uint32_t array_hash(const Variant& p_variant, int p_recursion_count) { return Inline<Array>::get(p_variant).recursive_hash(p_recursion_count); }
+};
+
+#define VARIANT_INLINE_OPS(m_type) nullptr, nullptr, &VariantTypeOps::Inline<m_type>::equal, &VariantTypeOps::Inline<m_type>::less, &VariantTypeOps::Inline<m_type>::hash
+#define VARIANT_INLINE_REAL_OPS(m_type) nullptr, nullptr, &VariantTypeOps::Inline<m_type>::equal, &VariantTypeOps::Inline<m_type>::less, &VariantTypeOps::Inline<m_type>::hash_real
+#define VARIANT_POOLED_OPS(m_type, m_member, m_less) &VariantTypeOps::Pooled<m_type, &Variant::Pools::BucketSmall::m_member>::copy, &VariantTypeOps::Pooled<m_type, &Variant::Pools::BucketSmall::m_member>::destroy, \
+                                                     &VariantTypeOps::Pooled<m_type, &Variant::Pools::BucketSmall::m_member>::equal, m_less, &VariantTypeOps::Pooled<m_type, &Variant::Pools::BucketSmall::m_member>::hash
+
+const VariantTypeOps::Entry VariantTypeOps::table[Variant::VARIANT_MAX] = {
+    { "Nil", nullptr, nullptr, &nil_equal, &nil_less, &nil_hash },
+    { "bool", nullptr, nullptr, &Inline<bool>::equal, &Inline<bool>::less, &bool_hash },
+    { "int", nullptr, nullptr, &Inline<int64_t>::equal, &Inline<int64_t>::less, &int_hash },
+    { "float", nullptr, nullptr, &Inline<double>::equal, &Inline<double>::less, &float_hash },
+    { "Vector2", VARIANT_INLINE_REAL_OPS(Vector2) },
+    { "Vector2i", VARIANT_INLINE_OPS(Vector2i) },
+    { "Vector3", VARIANT_INLINE_REAL_OPS(Vector3) },
+    { "Vector3i", VARIANT_INLINE_OPS(Vector3i) },
+    { "Transform2D", VARIANT_POOLED_OPS(Transform2D, _transform2d, &transform2d_less) },
+    { "Vector4", VARIANT_INLINE_REAL_OPS(Vector4) },
+    { "Vector4i", VARIANT_INLINE_OPS(Vector4i) },
+    { "AABB", VARIANT_POOLED_OPS(::AABB, _aabb, &aabb_less) },
+    { "StringName", &InlineManaged<StringName>::copy, &InlineManaged<StringName>::destroy, &Inline<StringName>::equal, &string_name_less, &string_name_hash },
+    { "Object", &object_copy, &object_destroy, &object_equal, &object_less, &object_hash },
+    { "Array", &InlineManaged<Array>::copy, &InlineManaged<Array>::destroy, &Inline<Array>::equal, &array_less, &array_hash },
+};
+
+#undef VARIANT_INLINE_OPS
+#undef VARIANT_INLINE_REAL_OPS
+#undef VARIANT_POOLED_OPS
+
+const bool Variant::needs_deinit[Variant::VARIANT_MAX] = {
+    false, // NIL
+    false, // BOOL
+    false, // INT
+    false, // FLOAT
+    false, // VECTOR2
+    false, // VECTOR2I
+    false, // VECTOR3
+    false, // VECTOR3I
+    true, // TRANSFORM2D
+    false, // VECTOR4
+    false, // VECTOR4I
+    true, // AABB
+    true, // STRING_NAME
+    true, // OBJECT
+    true, // ARRAY
+};
+
+const char* Variant::get_type_name(Variant::Type p_type) {
+    ERROR_FAIL_INDEX_V(p_type, VARIANT_MAX, "");
+    return VariantTypeOps::table[p_type].name;
+}
+
+void Variant::reference(const Variant& p_variant) {
+    clear();
+    type = p_variant.type;
+    VariantTypeOps::CopyFunc copy = VariantTypeOps::table[type].copy;
+    if (copy) {
+        copy(*this, p_variant);
+    } else {
+        _data = p_variant._data;
+    }
+}
+
+void Variant::_clear_internal() {
+    VariantTypeOps::table[type].destroy(*this);
+}
+
+void Variant::operator=(const Variant& p_variant) {
+    if (unlikely(this == &p_variant)) {
+        return;
+    }
+
+    if (!needs_deinit[type] && !needs_deinit[p_variant.type]) {
+        type = p_variant.type;
+        _data = p_variant._data;
+        return;
+    }
+
+    /** Copy before releasing, p_variant may be owned by what this holds. */
+    Variant copy(p_variant);
+    *this = std::move(copy);
+}
+
+bool Variant::is_ref_counted() const {
+    return type == OBJECT && _get_obj().id.is_ref_counted();
+}
+
+Object* Variant::get_validated_object() const {
+    if (type != OBJECT) {
+        return nullptr;
+    }
+    return ObjectDB::get_instance(_get_obj().id);
+}
+
+bool Variant::booleanize() const {
+    switch (type) {
+        case NIL:
+            return false;
+        case BOOL:
+            return _data._bool;
+        case INT:
+            return _data._int != 0;
+        case FLOAT:
+            return _data._float != 0.0;
+        case VECTOR2:
+            return *_get_inline<Vector2>() != Vector2();
+        case VECTOR2I:
+            return *_get_inline<Vector2i>() != Vector2i();
+        case VECTOR3:
+            return *_get_inline<Vector3>() != Vector3();
+        case VECTOR3I:
+            return *_get_inline<Vector3i>() != Vector3i();
+        case TRANSFORM2D:
+            return *_data._transform2d != Transform2D();
+        case VECTOR4:
+            return *_get_inline<Vector4>() != Vector4();
+        case VECTOR4I:
+            return *_get_inline<Vector4i>() != Vector4i();
+        case AABB:
+            return *_data._aabb != ::AABB();
+        case STRING_NAME:
+            return !_get_inline<StringName>()->is_empty();
+        case OBJECT:
+            return _get_obj().obj != nullptr;
+        case ARRAY:
+            return !_get_inline<Array>()->is_empty();
+        default:
+            return false;
+    }
+}
+
+bool Variant::operator==(const Variant& p_variant) const {
+    if (type != p_variant.type) {
+        return false;
+    }
+    return VariantTypeOps::table[type].equal(*this, p_variant);
+}
+
+bool Variant::operator!=(const Variant& p_variant) const {
+    return !(*this == p_variant);
+}
+
+bool Variant::operator<(const Variant& p_variant) const {
+    if (type != p_variant.type) {
+        if (is_num() && p_variant.is_num()) {
+            return (double)*this < (double)p_variant;
+        }
+        return type < p_variant.type;
+    }
+    return VariantTypeOps::table[type].less(*this, p_variant);
+}
+
+bool Variant::recursive_equal(const Variant& p_variant, int p_recursion_count) const {
+    if (type != p_variant.type) {
+        return false;
+    }
+    if (type == ARRAY) {
+        return _get_inline<Array>()->recursive_equal(*p_variant._get_inline<Array>(), p_recursion_count);
+    }
+    return VariantTypeOps::table[type].equal(*this, p_variant);
+}
+
+uint32_t Variant::hash() const {
+    return recursive_hash(0);
+}
+
+uint32_t Variant::recursive_hash(int p_recursion_count) const {
+    return VariantTypeOps::table[type].hash(*this, p_recursion_count);
+}
+
+Variant Variant::duplicate(bool p_deep) const {
+    return recursive_duplicate(p_deep, 0);
+}
+
+Variant Variant::recursive_duplicate(bool p_deep, int p_recursion_count) const {
+    if (type == ARRAY) {
+        return _get_inline<Array>()->recursive_duplicate(p_deep, p_recursion_count);
+    }
+    return *this;
+}
+
+Variant Variant::construct_default(Variant::Type p_type) {
+    switch (p_type) {
+        case BOOL:
+            return false;
+        case INT:
+            return int64_t(0);
+        case FLOAT:
+            return 0.0;
+        case VECTOR2:
+            return Vector2();
+        case VECTOR2I:
+            return Vector2i();
+        case VECTOR3:
+            return Vector3();
+        case VECTOR3I:
+            return Vector3i();
+        case TRANSFORM2D:
+            return Transform2D();
+        case VECTOR4:
+            return Vector4();
+        case VECTOR4I:
+            return Vector4i();
+        case AABB:
+            return ::AABB();
+        case STRING_NAME:
+            return StringName();
+        case ARRAY:
+            return Array();
+        default:
+            return Variant();
+    }
+}
+
+/** Conversions. Numeric types convert between each other, anything else
+ *  that doesn't match yields the default value of the target type. */
+
+#define VARIANT_NUM_CONVERSION(m_type)       \
+    Variant::operator m_type() const {       \
+        switch (type) {                      \
+            case BOOL:                       \
+                return _data._bool;          \
+            case INT:                        \
+                return (m_type)_data._int;   \
+            case FLOAT:                      \
+                return (m_type)_data._float; \
+            default:                         \
+                return 0;                    \
+        }                                    \
+    }
+
+VARIANT_NUM_CONVERSION(int8_t)
+VARIANT_NUM_CONVERSION(uint8_t)
+VARIANT_NUM_CONVERSION(int16_t)
+VARIANT_NUM_CONVERSION(uint16_t)
+VARIANT_NUM_CONVERSION(int32_t)
+VARIANT_NUM_CONVERSION(uint32_t)
+VARIANT_NUM_CONVERSION(int64_t)
+VARIANT_NUM_CONVERSION(uint64_t)
+VARIANT_NUM_CONVERSION(float)
+VARIANT_NUM_CONVERSION(double)
+
+#undef VARIANT_NUM_CONVERSION
+
+Variant::operator bool() const {
+    return booleanize();
+}
+
+Variant::operator ObjectID() const {
+    if (type == INT) {
+        return ObjectID(_data._int);
+    }
+    if (type == OBJECT) {
+        return _get_obj().id;
+    }
+    return ObjectID();
+}
+
+Variant::operator Vector2() const {
+    if (type == VECTOR2) {
+        return *_get_inline<Vector2>();
+    }
+    if (type == VECTOR2I) {
+        return *_get_inline<Vector2i>();
+    }
+    return Vector2();
+}
+
+Variant::operator Vector2i() const {
+    if (type == VECTOR2I) {
+        return *_get_inline<Vector2i>();
+    }
+    if (type == VECTOR2) {
+        const Vector2& v = *_get_inline<Vector2>();
+        return Vector2i((int32_t)v.x, (int32_t)v.y);
+    }
+    return Vector2i();
+}
+
+Variant::operator Vector3() const {
+    if (type == VECTOR3) {
+        return *_get_inline<Vector3>();
+    }
+    if (type == VECTOR3I) {
+        return *_get_inline<Vector3i>();
+    }
+    return Vector3();
+}
+
+Variant::operator Vector3i() const {
+    if (type == VECTOR3I) {
+        return *_get_inline<Vector3i>();
+    }
+    if (type == VECTOR3) {
+        const Vector3& v = *_get_inline<Vector3>();
+        return Vector3i((int32_t)v.x, (int32_t)v.y, (int32_t)v.z);
+    }
+    return Vector3i();
+}
+
+Variant::operator Transform2D() const {
+    if (type == TRANSFORM2D) {
+        return *_data._transform2d;
+    }
+    return Transform2D();
+}
+
+Variant::operator Vector4() const {
+    if (type == VECTOR4) {
+        return *_get_inline<Vector4>();
+    }
+    if (type == VECTOR4I) {
+        return *_get_inline<Vector4i>();
+    }
+    return Vector4();
+}
+
+Variant::operator Vector4i() const {
+    if (type == VECTOR4I) {
+        return *_get_inline<Vector4i>();
+    }
+    if (type == VECTOR4) {
+        const Vector4& v = *_get_inline<Vector4>();
+        return Vector4i((int32_t)v.x, (int32_t)v.y, (int32_t)v.z, (int32_t)v.w);
+    }
+    return Vector4i();
+}
+
+Variant::operator ::AABB() const {
+    if (type == AABB) {
+        return *_data._aabb;
+    }
+    return ::AABB();
+}
+
+Variant::operator StringName() const {
+    if (type == STRING_NAME) {
+        return *_get_inline<StringName>();
+    }
+    return StringName();
+}
+
+Variant::operator Object*() const {
+    if (type == OBJECT) {
+        return _get_obj().obj;
+    }
+    return nullptr;
+}
+
+Variant::operator Array() const {
+    if (type == ARRAY) {
+        return *_get_inline<Array>();
+    }
+    return Array();
+}
+
+/** Constructors. */
+
+Variant::Variant(bool p_bool) :
+        type(BOOL) {
+    _data._bool = p_bool;
+}
+
+#define VARIANT_INT_CONSTRUCTOR(m_type)   \
+    Variant::Variant(m_type p_int) :      \
+            type(INT) {                   \
+        _data._int = (int64_t)p_int;      \
+    }
+
+VARIANT_INT_CONSTRUCTOR(int8_t)
+VARIANT_INT_CONSTRUCTOR(uint8_t)
+VARIANT_INT_CONSTRUCTOR(int16_t)
+VARIANT_INT_CONSTRUCTOR(uint16_t)
+VARIANT_INT_CONSTRUCTOR(int32_t)
+VARIANT_INT_CONSTRUCTOR(uint32_t)
+VARIANT_INT_CONSTRUCTOR(int64_t)
+VARIANT_INT_CONSTRUCTOR(uint64_t)
+
+#undef VARIANT_INT_CONSTRUCTOR
+
+Variant::Variant(float p_float) :
+        type(FLOAT) {
+    _data._float = p_float;
+}
+
+Variant::Variant(double p_double) :
+        type(FLOAT) {
+    _data._float = p_double;
+}
+
+Variant::Variant(const ObjectID& p_id) :
+        type(INT) {
+    _data._int = (int64_t)p_id;
+}
+
+Variant::Variant(const Vector2& p_vector2) :
+        type(VECTOR2) {
+    memnew_placement(_get_inline<Vector2>(), Vector2(p_vector2));
+}
+
+Variant::Variant(const Vector2i& p_vector2i) :
+        type(VECTOR2I) {
+    memnew_placement(_get_inline<Vector2i>(), Vector2i(p_vector2i));
+}
+
+Variant::Variant(const Vector3& p_vector3) :
+        type(VECTOR3) {
+    memnew_placement(_get_inline<Vector3>(), Vector3(p_vector3));
+}
+
+Variant::Variant(const Vector3i& p_vector3i) :
+        type(VECTOR3I) {
+    memnew_placement(_get_inline<Vector3i>(), Vector3i(p_vector3i));
+}
+
+Variant::Variant(const Transform2D& p_transform) :
+        type(TRANSFORM2D) {
+    VariantTypeOps::Pooled<Transform2D, &Pools::BucketSmall::_transform2d>::store(*this, p_transform);
+}
+
+Variant::Variant(const Vector4& p_vector4) :
+        type(VECTOR4) {
+    memnew_placement(_get_inline<Vector4>(), Vector4(p_vector4));
+}
+
+Variant::Variant(const Vector4i& p_vector4i) :
+        type(VECTOR4I) {
+    memnew_placement(_get_inline<Vector4i>(), Vector4i(p_vector4i));
+}
+
+Variant::Variant(const ::AABB& p_aabb) :
+        type(AABB) {
+    VariantTypeOps::Pooled<::AABB, &Pools::BucketSmall::_aabb>::store(*this, p_aabb);
+}
+
+Variant::Variant(const StringName& p_string) :
+        type(STRING_NAME) {
+    memnew_placement(_get_inline<StringName>(), StringName(p_string));
+}
+
+Variant::Variant(const Object* p_object) :
+        type(OBJECT) {
+    ObjData& data = _get_obj();
+    memnew_placement(&data, ObjData);
+
+    Object* object = const_cast<Object*>(p_object);
+    if (!object) {
+        return;
+    }
+
+    if (object->is_ref_counted()) {
+        RefCounted* ref_counted = static_cast<RefCounted*>(object);
+        if (!ref_counted->init_ref()) {
+            return;
+        }
+    }
+
+    data.obj = object;
+    data.id = object->get_instance_id();
+}
+
+Variant::Variant(const Array& p_array) :
+        type(ARRAY) {
+    memnew_placement(_get_inline<Array>(), Array(p_array));
+}
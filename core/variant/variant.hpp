@@ -0,0 +1,294 @@
+#ifndef __VARIANT_HPP__
+#define __VARIANT_HPP__
+
+#include "../math/aabb.hpp"
+#include "../math/transform_2d.hpp"
+#include "../math/vector2.hpp"
+#include "../math/vector3.hpp"
+#include "../math/vector4.hpp"
+#include "../object/object.hpp"
+#include "../object/object_id.hpp"
+#include "../string/string_name.hpp"
+#include "../templates/paged_allocator.hpp"
+#include "../typedefs.hpp"
+#include "./array.hpp"
+#include "./callable.hpp"
+
+/** Dynamically typed value.
+ *
+ *  A Variant is a type tag followed by a 16 byte payload. Scalars, vectors up
+ *  to four components, object references and interned names live inline in the
+ *  payload, so creating, copying or destroying them never allocates. Types
+ *  that don't fit (AABB, Transform2D) are kept in a pooled bucket and the
+ *  payload holds the pointer.
+ *
+ *  Copy, destruction, comparison and hashing go through per-type function
+ *  tables. Types that need no deinitialization are copied as raw bytes
+ *  without looking the table up, which is the common case in containers.
+ */
+class Variant {
+public:
+    enum Type {
+        NIL,
+
+        // atomic types
+        BOOL,
+        INT,
+        FLOAT,
+
+        // math types
+        VECTOR2,
+        VECTOR2I,
+        VECTOR3,
+        VECTOR3I,
+        TRANSFORM2D,
+        VECTOR4,
+        VECTOR4I,
+        AABB,
+
+        // misc types
+        STRING_NAME,
+        OBJECT,
+        ARRAY,
+
+        VARIANT_MAX
+    };
+
+private:
+    friend struct VariantTypeOps;
+
+    struct ObjData {
+        ObjectID id;
+        Object* obj = nullptr;
+    };
+
+    /** Pooled storage for the types larger than the payload. */
+    struct Pools {
+        union BucketSmall {
+            BucketSmall() {}
+            ~BucketSmall() {}
+            Transform2D _transform2d;
+            ::AABB _aabb;
+        };
+
+        static PagedAllocator<BucketSmall, true> _bucket_small;
+    };
+
+    Type type = NIL;
+
+    union {
+        bool _bool;
+        int64_t _int;
+        double _float;
+        Transform2D* _transform2d;
+        ::AABB* _aabb;
+        void* _ptr;
+        uint8_t _mem[sizeof(ObjData) > (sizeof(real_t) * 4) ? sizeof(ObjData) : (sizeof(real_t) * 4)]{ 0 };
+    } _data alignas(8);
+
+    /** Indexed by Type; false for types whose payload can be copied as bytes. */
+    static const bool needs_deinit[VARIANT_MAX];
+
+    void reference(const Variant& p_variant);
+    void _clear_internal();
+
+    _FORCE_INLINE_ ObjData& _get_obj() { return *reinterpret_cast<ObjData*>(&_data._mem[0]); }
+    _FORCE_INLINE_ const ObjData& _get_obj() const { return *reinterpret_cast<const ObjData*>(&_data._mem[0]); }
+
+    template <typename T>
+    _FORCE_INLINE_ T* _get_inline() { return reinterpret_cast<T*>(&_data._mem[0]); }
+    template <typename T>
+    _FORCE_INLINE_ const T* _get_inline() const { return reinterpret_cast<const T*>(&_data._mem[0]); }
+
+public:
+    _FORCE_INLINE_ Type get_type() const { return type; }
+    static const char* get_type_name(Variant::Type p_type);
+
+    bool is_ref_counted() const;
+    _FORCE_INLINE_ bool is_num() const { return type == INT || type == FLOAT; }
+    _FORCE_INLINE_ bool is_null() const { return type == NIL; }
+
+    /** Object only if it is still alive, checked through ObjectDB. */
+    Object* get_validated_object() const;
+
+    operator bool() const;
+    operator int8_t() const;
+    operator uint8_t() const;
+    operator int16_t() const;
+    operator uint16_t() const;
+    operator int32_t() const;
+    operator uint32_t() const;
+    operator int64_t() const;
+    operator uint64_t() const;
+    operator float() const;
+    operator double() const;
+
+    operator ObjectID() const;
+
+    operator Vector2() const;
+    operator Vector2i() const;
+    operator Vector3() const;
+    operator Vector3i() const;
+    operator Transform2D() const;
+    operator Vector4() const;
+    operator Vector4i() const;
+    operator ::AABB() const;
+
+    operator StringName() const;
+    operator Object*() const;
+    operator Array() const;
+
+    Variant(bool p_bool);
+    Variant(int8_t p_int);
+    Variant(uint8_t p_int);
+    Variant(int16_t p_int);
+    Variant(uint16_t p_int);
+    Variant(int32_t p_int);
+    Variant(uint32_t p_int);
+    Variant(int64_t p_int);
+    Variant(uint64_t p_int);
+    Variant(float p_float);
+    Variant(double p_double);
+    Variant(const ObjectID& p_id);
+
+    Variant(const Vector2& p_vector2);
+    Variant(const Vector2i& p_vector2i);
+    Variant(const Vector3& p_vector3);
+    Variant(const Vector3i& p_vector3i);
+    Variant(const Transform2D& p_transform);
+    Variant(const Vector4& p_vector4);
+    Variant(const Vector4i& p_vector4i);
+    Variant(const ::AABB& p_aabb);
+
+    Variant(const StringName& p_string);
+    Variant(const Object* p_object);
+    Variant(const Array& p_array);
+    /** Would silently become a bool otherwise. */
+    Variant(const char* p_cstring) = delete;
+
+    bool booleanize() const;
+
+    /** Strict equality: values of different types are never equal, so it
+     *  agrees with hash(). */
+    bool operator==(const Variant& p_variant) const;
+    bool operator!=(const Variant& p_variant) const;
+    /** Total order used for sorting. Ints and floats compare by value, any
+     *  other pair of different types by type. */
+    bool operator<(const Variant& p_variant) const;
+    /** Same as operator==, but walks into nested containers with a depth guard. */
+    bool recursive_equal(const Variant& p_variant, int p_recursion_count) const;
+
+    uint32_t hash() const;
+    uint32_t recursive_hash(int p_recursion_count) const;
+
+    Variant duplicate(bool p_deep = false) const;
+    Variant recursive_duplicate(bool p_deep, int p_recursion_count) const;
+
+    /** Default value of p_type, what a typed container fills new slots with. */
+    static Variant construct_default(Variant::Type p_type);
+
+    _FORCE_INLINE_ void clear() {
+        if (unlikely(needs_deinit[type])) {
+            _clear_internal();
+        }
+        type = NIL;
+    }
+
+    void operator=(const Variant& p_variant);
+    void operator=(Variant&& p_variant) {
+        if (unlikely(this == &p_variant)) {
+            return;
+        }
+        clear();
+        type = p_variant.type;
+        _data = p_variant._data;
+        p_variant.type = NIL;
+    }
+
+    _FORCE_INLINE_ Variant(const Variant& p_variant) {
+        if (likely(!needs_deinit[p_variant.type])) {
+            type = p_variant.type;
+            _data = p_variant._data;
+        } else {
+            reference(p_variant);
+        }
+    }
+
+    /** Every stored type is trivially relocatable, so moving is a byte copy. */
+    _FORCE_INLINE_ Variant(Variant&& p_variant) {
+        type = p_variant.type;
+        _data = p_variant._data;
+        p_variant.type = NIL;
+    }
+
+    _FORCE_INLINE_ Variant() {}
+
+    _FORCE_INLINE_ ~Variant() {
+        clear();
+    }
+};
+
+// Array iterators and Callable::call() need Variant complete.
+
+Variant& Array::Iterator::operator*() const {
+    if (unlikely(read_only)) {
+        *read_only = *element_ptr;
+        return *read_only;
+    }
+    return *element_ptr;
+}
+
+Variant* Array::Iterator::operator->() const {
+    if (unlikely(read_only)) {
+        *read_only = *element_ptr;
+        return read_only;
+    }
+    return element_ptr;
+}
+
+Array::Iterator& Array::Iterator::operator++() {
+    element_ptr++;
+    return *this;
+}
+
+Array::Iterator& Array::Iterator::operator--() {
+    element_ptr--;
+    return *this;
+}
+
+Variant Array::ConstIterator::operator*() const {
+    if (unlikely(packed_stride)) {
+        return _read_packed();
+    }
+    return *reinterpret_cast<const Variant*>(element_ptr);
+}
+
+Array::ConstIterator& Array::ConstIterator::operator++() {
+    element_ptr += packed_stride ? packed_stride : sizeof(Variant);
+    return *this;
+}
+
+Array::ConstIterator& Array::ConstIterator::operator--() {
+    element_ptr -= packed_stride ? packed_stride : sizeof(Variant);
+    return *this;
+}
+
+template <typename... VarArgs>
+Variant Callable::call(VarArgs... p_args) const {
+    Variant args[sizeof...(p_args) + 1] = { p_args..., Variant() }; // +1 makes sure zero sized arrays are also supported.
+    const Variant* argptrs[sizeof...(p_args) + 1];
+    for (uint32_t i = 0; i < sizeof...(p_args); i++) {
+        argptrs[i] = &args[i];
+    }
+
+    Variant ret;
+    CallError ce;
+    callp(sizeof...(p_args) == 0 ? nullptr : (const Variant**)argptrs, sizeof...(p_args), ret, ce);
+    return ret;
+}
+
+#ifndef REAL_T_IS_DOUBLE
+static_assert(sizeof(Variant) == 24, "Variant must stay a type tag plus a 16 byte payload.");
+#endif
+
+#endif
@@ -1 +1,11 @@
-void drivers() {}
+#include "./unix/async_file_io_uring.hpp"
+#include "./unix/file_access_unix.hpp"
+
+void drivers() {
+#if defined(__unix__) || defined(__APPLE__)
+    FileAccess::make_default<FileAccessUnix>();
+#endif
+#if defined(__linux__)
+    AsyncFileIO::set_create_func(&AsyncFileIOUring::try_create);
+#endif
+}
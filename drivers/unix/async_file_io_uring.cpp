@@ -0,0 +1,421 @@
+#include "./async_file_io_uring.hpp"
+
+#if defined(__linux__)
+
+#include "../../core/error/error_macros.hpp"
+#include "../../core/os/memory.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+enum Stage {
+    STAGE_OPEN,
+    STAGE_STAT,
+    STAGE_READ,
+    STAGE_WRITE,
+    STAGE_CLOSE,
+};
+
+struct AsyncFileIOUring::Job {
+    /** Keeps the batch alive until the request is done. */
+    Ref<AsyncFileBatch> batch;
+    Request* request = nullptr;
+    CharString path;
+    Stage stage = STAGE_OPEN;
+    int fd = -1;
+    /** Bytes read or written so far, out of total. */
+    uint64_t done = 0;
+    uint64_t total = 0;
+    struct statx stat;
+};
+
+static int _io_uring_setup(unsigned p_entries, io_uring_params* p_params) {
+    return int(syscall(__NR_io_uring_setup, p_entries, p_params));
+}
+
+static int _io_uring_enter(int p_fd, unsigned p_to_submit, unsigned p_min_complete, unsigned p_flags) {
+    return int(syscall(__NR_io_uring_enter, p_fd, p_to_submit, p_min_complete, p_flags, nullptr, 0));
+}
+
+static Errors _open_error(int p_errno, Errors p_default) {
+    switch (p_errno) {
+        case ENOENT:
+            return Errors::ERROR_FILE_NOT_FOUND;
+        case EACCES:
+        case EPERM:
+            return Errors::ERROR_FILE_NO_PERMISSION;
+        case ENOTDIR:
+        case ENAMETOOLONG:
+        case ELOOP:
+        case EISDIR:
+            return Errors::ERROR_FILE_BAD_PATH;
+        case EBUSY:
+        case ETXTBSY:
+            return Errors::ERROR_FILE_ALREADY_IN_USE;
+        default:
+            return p_default;
+    }
+}
+
+bool AsyncFileIOUring::_setup() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    _ring_fd = _io_uring_setup(RING_ENTRIES, &params);
+    if (_ring_fd < 0) {
+        return false;
+    }
+
+    // Every operation a request goes through must be there.
+    const size_t probe_size = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    io_uring_probe* probe = static_cast<io_uring_probe*>(memalloc(probe_size));
+    ERROR_FAIL_NULL_V(probe, false);
+    memset(probe, 0, probe_size);
+    bool supported = syscall(__NR_io_uring_register, _ring_fd, IORING_REGISTER_PROBE, probe, 256) >= 0;
+    const uint8_t needed[] = { IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_CLOSE, IORING_OP_NOP };
+    for (uint8_t op : needed) {
+        supported = supported && op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    }
+    memfree(probe);
+    if (!supported) {
+        return false;
+    }
+
+    _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        _sq_ring_size = MAX(_sq_ring_size, _cq_ring_size);
+    }
+
+    _sq_ring = mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQ_RING);
+    if (_sq_ring == MAP_FAILED) {
+        _sq_ring = nullptr;
+        return false;
+    }
+    if (single_mmap) {
+        _cq_ring = _sq_ring;
+    } else {
+        _cq_ring = mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_CQ_RING);
+        if (_cq_ring == MAP_FAILED) {
+            _cq_ring = nullptr;
+            return false;
+        }
+    }
+    _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return false;
+    }
+    _sqes = static_cast<io_uring_sqe*>(sqes);
+
+    uint8_t* sq = static_cast<uint8_t*>(_sq_ring);
+    _sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    _sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    _sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    _sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    _sq_entries = params.sq_entries;
+    uint8_t* cq = static_cast<uint8_t*>(_cq_ring);
+    _cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    _cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    return true;
+}
+
+void AsyncFileIOUring::_teardown() {
+    if (_sqes) {
+        munmap(_sqes, _sqes_size);
+        _sqes = nullptr;
+    }
+    if (_cq_ring && _cq_ring != _sq_ring) {
+        munmap(_cq_ring, _cq_ring_size);
+    }
+    _cq_ring = nullptr;
+    if (_sq_ring) {
+        munmap(_sq_ring, _sq_ring_size);
+        _sq_ring = nullptr;
+    }
+    if (_ring_fd >= 0) {
+        close(_ring_fd);
+        _ring_fd = -1;
+    }
+}
+
+io_uring_sqe* AsyncFileIOUring::_get_sqe() {
+    // The kernel consumes the entries when they are submitted, so a full
+    // ring only needs a submit; it can't be, with MAX_ACTIVE below its size.
+    if (*_sq_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) == _sq_entries) {
+        _submit_queued();
+    }
+
+    io_uring_sqe* sqe = _sqes + (*_sq_tail & _sq_mask);
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+void AsyncFileIOUring::_push_sqe() {
+    const unsigned tail = *_sq_tail;
+    _sq_array[tail & _sq_mask] = tail & _sq_mask;
+    __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+    _to_submit++;
+}
+
+void AsyncFileIOUring::_queue_operation(Job* p_job) {
+    static const char empty_path[] = "";
+
+    Request* request = p_job->request;
+    io_uring_sqe* sqe = _get_sqe();
+    sqe->user_data = uint64_t(uintptr_t(p_job));
+    switch (p_job->stage) {
+        case STAGE_OPEN:
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = uint64_t(uintptr_t(p_job->path.get_data()));
+            sqe->len = 0666;
+            sqe->open_flags = O_CLOEXEC | (request->operation == OP_WRITE ? O_WRONLY | O_CREAT | O_TRUNC : O_RDONLY);
+            break;
+        case STAGE_STAT:
+            sqe->opcode = IORING_OP_STATX;
+            sqe->fd = p_job->fd;
+            sqe->addr = uint64_t(uintptr_t(empty_path));
+            sqe->len = STATX_SIZE;
+            sqe->off = uint64_t(uintptr_t(&p_job->stat));
+            sqe->statx_flags = AT_EMPTY_PATH;
+            break;
+        case STAGE_READ:
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = p_job->fd;
+            sqe->addr = uint64_t(uintptr_t(request->data.ptrw() + p_job->done));
+            sqe->len = unsigned(MIN(p_job->total - p_job->done, uint64_t(MAX_CHUNK)));
+            sqe->off = request->offset + p_job->done;
+            break;
+        case STAGE_WRITE:
+            sqe->opcode = IORING_OP_WRITE;
+            sqe->fd = p_job->fd;
+            sqe->addr = uint64_t(uintptr_t(request->data.ptr() + p_job->done));
+            sqe->len = unsigned(MIN(p_job->total - p_job->done, uint64_t(MAX_CHUNK)));
+            sqe->off = p_job->done;
+            break;
+        case STAGE_CLOSE:
+            sqe->opcode = IORING_OP_CLOSE;
+            sqe->fd = p_job->fd;
+            break;
+    }
+    _push_sqe();
+}
+
+void AsyncFileIOUring::_submit_queued() {
+    while (_to_submit > 0) {
+        const int submitted = _io_uring_enter(_ring_fd, _to_submit, 0, 0);
+        if (submitted < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // Left queued for the next submit, once completions made room.
+            ERROR_FAIL_COND_MSG(errno != EAGAIN && errno != EBUSY, "io_uring submission failed.");
+            return;
+        }
+        _to_submit -= unsigned(submitted);
+    }
+}
+
+void AsyncFileIOUring::_start_waiting() {
+    while (_active < MAX_ACTIVE && _waiting_head < _waiting.size()) {
+        Waiting& waiting = _waiting.ptrw()[_waiting_head];
+        Job* job = memnew(Job);
+        job->batch = waiting.batch;
+        job->request = _get_requests(waiting.batch.ptr()) + waiting.next;
+        job->path = job->request->path.utf8();
+
+        waiting.next++;
+        if (waiting.next == waiting.batch->get_request_count()) {
+            waiting.batch = Ref<AsyncFileBatch>();
+            _waiting_head++;
+            if (_waiting_head == _waiting.size()) {
+                _waiting.clear();
+                _waiting_head = 0;
+            }
+        }
+
+        _active++;
+        _queue_operation(job);
+    }
+}
+
+bool AsyncFileIOUring::_advance(Job* p_job, int p_result) {
+    Request* request = p_job->request;
+    const bool writing = request->operation == OP_WRITE;
+    if (p_result == -EINTR || p_result == -EAGAIN) {
+        // Same operation again.
+        return false;
+    }
+
+    switch (p_job->stage) {
+        case STAGE_OPEN: {
+            if (p_result < 0) {
+                request->error = _open_error(-p_result, writing ? Errors::ERROR_FILE_CANT_WRITE : Errors::ERROR_FILE_CANT_OPEN);
+                return true;
+            }
+            p_job->fd = p_result;
+            if (writing) {
+                p_job->total = request->data.size();
+                p_job->stage = p_job->total > 0 ? STAGE_WRITE : STAGE_CLOSE;
+                return false;
+            }
+            if (request->length < 0) {
+                p_job->stage = STAGE_STAT;
+                return false;
+            }
+            p_job->total = uint64_t(request->length);
+        } break;
+
+        case STAGE_STAT: {
+            if (p_result < 0) {
+                request->error = Errors::ERROR_FILE_CANT_READ;
+                p_job->stage = STAGE_CLOSE;
+                return false;
+            }
+            const uint64_t size = p_job->stat.stx_size;
+            p_job->total = request->offset < size ? size - request->offset : 0;
+        } break;
+
+        case STAGE_READ: {
+            if (p_result < 0) {
+                request->error = Errors::ERROR_FILE_CANT_READ;
+                request->data.clear();
+                p_job->stage = STAGE_CLOSE;
+            } else if (p_result == 0) {
+                // Shorter than asked.
+                request->data.resize(int64_t(p_job->done));
+                p_job->stage = STAGE_CLOSE;
+            } else {
+                p_job->done += uint64_t(p_result);
+                if (p_job->done == p_job->total) {
+                    p_job->stage = STAGE_CLOSE;
+                }
+            }
+            return false;
+        }
+
+        case STAGE_WRITE: {
+            if (p_result <= 0) {
+                request->error = Errors::ERROR_FILE_CANT_WRITE;
+                p_job->stage = STAGE_CLOSE;
+            } else {
+                p_job->done += uint64_t(p_result);
+                if (p_job->done == p_job->total) {
+                    p_job->stage = STAGE_CLOSE;
+                }
+            }
+            return false;
+        }
+
+        case STAGE_CLOSE: {
+            if (p_result < 0 && writing && request->error == Errors::NONE) {
+                request->error = Errors::ERROR_FILE_CANT_WRITE;
+            }
+            return true;
+        }
+    }
+
+    // Opened or sized, for reading.
+    if (p_job->total == 0) {
+        p_job->stage = STAGE_CLOSE;
+    } else if (request->data.resize(int64_t(p_job->total)) != Errors::NONE) {
+        request->error = Errors::ERROR_OUT_OF_MEMORY;
+        p_job->stage = STAGE_CLOSE;
+    } else {
+        p_job->stage = STAGE_READ;
+    }
+    return false;
+}
+
+void AsyncFileIOUring::_reap() {
+    Job* finished[RING_ENTRIES * 2];
+    while (true) {
+        const int ret = _io_uring_enter(_ring_fd, 0, 1, IORING_ENTER_GETEVENTS);
+        if (ret < 0 && errno != EINTR) {
+            ERROR_PRINT("Waiting for io_uring completions failed.");
+        }
+
+        int finished_count = 0;
+        bool done = false;
+        {
+            MutexLock lock(_mutex);
+            unsigned head = *_cq_head;
+            const unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+            for (; head != tail; head++) {
+                const io_uring_cqe* cqe = _cqes + (head & _cq_mask);
+                Job* job = reinterpret_cast<Job*>(uintptr_t(cqe->user_data));
+                if (!job) {
+                    // The wake up at exit.
+                    continue;
+                }
+                if (_advance(job, cqe->res)) {
+                    finished[finished_count++] = job;
+                    _active--;
+                } else {
+                    _queue_operation(job);
+                }
+            }
+            __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+
+            _start_waiting();
+            _submit_queued();
+            done = _exiting && _active == 0 && _waiting_head == _waiting.size();
+        }
+
+        // Callbacks run without the lock, free to submit more.
+        for (int i = 0; i < finished_count; i++) {
+            _request_done(finished[i]->batch.ptr());
+            memdelete(finished[i]);
+        }
+        if (done) {
+            return;
+        }
+    }
+}
+
+void AsyncFileIOUring::_submit(const Ref<AsyncFileBatch>& p_batch) {
+    MutexLock lock(_mutex);
+    ERROR_FAIL_COND_MSG(_exiting, "Can't submit while exiting.");
+    Waiting waiting;
+    waiting.batch = p_batch;
+    _waiting.push_back(waiting);
+    _start_waiting();
+    _submit_queued();
+}
+
+AsyncFileIO* AsyncFileIOUring::try_create() {
+    AsyncFileIOUring* io = memnew(AsyncFileIOUring);
+    if (!io->_setup()) {
+        memdelete(io);
+        return nullptr;
+    }
+    io->_thread = std::thread([io]() { io->_reap(); });
+    return io;
+}
+
+AsyncFileIOUring::~AsyncFileIOUring() {
+    if (_thread.joinable()) {
+        {
+            MutexLock lock(_mutex);
+            _exiting = true;
+            // Wakes the reaper up, if it has nothing else in flight.
+            io_uring_sqe* sqe = _get_sqe();
+            sqe->opcode = IORING_OP_NOP;
+            sqe->user_data = 0;
+            _push_sqe();
+            _submit_queued();
+        }
+        _thread.join();
+    }
+    _teardown();
+}
+
+#endif
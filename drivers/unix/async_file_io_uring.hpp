@@ -0,0 +1,101 @@
+#ifndef __ASYNC_FILE_IO_URING_HPP__
+#define __ASYNC_FILE_IO_URING_HPP__
+
+#if defined(__linux__)
+
+#include "../../core/io/async_file_io.hpp"
+
+#include <linux/io_uring.h>
+#include <stddef.h>
+#include <thread>
+
+/** AsyncFileIO over io_uring, driven by raw system calls.
+ *
+ *  Each request runs as a chain of operations: open, statx when reading up
+ *  to the end, reads or writes until done, and close. Each operation is
+ *  queued when the previous one completes, by a single thread that reaps
+ *  the completions, so up to MAX_ACTIVE files are in flight at once without
+ *  a thread for each, and the drive sees a deep queue. Requests past
+ *  MAX_ACTIVE wait in submission order.
+ */
+class AsyncFileIOUring : public AsyncFileIO {
+    enum {
+        RING_ENTRIES = 256,
+        /** Requests in flight; each has one operation in the ring at most,
+         *  which leaves room for the wake up at exit. */
+        MAX_ACTIVE = 128,
+        /** Bytes per read or write operation, which takes a 32-bit length. */
+        MAX_CHUNK = 1 << 30,
+    };
+
+    struct Job;
+
+    /** Requests of a batch not started yet. */
+    struct Waiting {
+        Ref<AsyncFileBatch> batch;
+        int64_t next = 0;
+    };
+
+    int _ring_fd = -1;
+    void* _sq_ring = nullptr;
+    size_t _sq_ring_size = 0;
+    void* _cq_ring = nullptr;
+    size_t _cq_ring_size = 0;
+    io_uring_sqe* _sqes = nullptr;
+    size_t _sqes_size = 0;
+
+    unsigned* _sq_head = nullptr;
+    unsigned* _sq_tail = nullptr;
+    unsigned* _sq_array = nullptr;
+    unsigned _sq_mask = 0;
+    unsigned _sq_entries = 0;
+    unsigned* _cq_head = nullptr;
+    unsigned* _cq_tail = nullptr;
+    io_uring_cqe* _cqes = nullptr;
+    unsigned _cq_mask = 0;
+
+    /** Guards the submission queue and everything below. */
+    BinaryMutex _mutex;
+    unsigned _to_submit = 0;
+    int _active = 0;
+    /** FIFO, from _waiting_head. */
+    Vector<Waiting> _waiting;
+    int64_t _waiting_head = 0;
+    bool _exiting = false;
+
+    std::thread _thread;
+
+    bool _setup();
+    void _teardown();
+
+    /** These need _mutex. _get_sqe() hands out the next entry, cleared,
+     *  and _push_sqe() queues it once filled. */
+    io_uring_sqe* _get_sqe();
+    void _push_sqe();
+    void _queue_operation(Job* p_job);
+    void _submit_queued();
+    void _start_waiting();
+
+    /** Moves p_job on after its operation finished with p_result. True once
+     *  the request is done. */
+    bool _advance(Job* p_job, int p_result);
+    void _reap();
+
+    AsyncFileIOUring() {}
+
+protected:
+    virtual void _submit(const Ref<AsyncFileBatch>& p_batch) override;
+
+public:
+    /** For AsyncFileIO::set_create_func(): nullptr when the kernel lacks
+     *  io_uring or one of the operations, or forbids it. */
+    static AsyncFileIO* try_create();
+
+    virtual String get_backend_name() const override { return "io_uring"; }
+
+    virtual ~AsyncFileIOUring();
+};
+
+#endif
+
+#endif
@@ -0,0 +1,295 @@
+#include "./file_access_unix.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "../../core/os/memory.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static Errors _open_error(int p_errno, Errors p_default) {
+    switch (p_errno) {
+        case ENOENT:
+            return Errors::ERROR_FILE_NOT_FOUND;
+        case EACCES:
+        case EPERM:
+            return Errors::ERROR_FILE_NO_PERMISSION;
+        case ENOTDIR:
+        case ENAMETOOLONG:
+        case ELOOP:
+            return Errors::ERROR_FILE_BAD_PATH;
+        case EBUSY:
+        case ETXTBSY:
+            return Errors::ERROR_FILE_ALREADY_IN_USE;
+        default:
+            return p_default;
+    }
+}
+
+static int _madvise_advice(FileAccess::AccessHint p_hint) {
+    switch (p_hint) {
+        case FileAccess::HINT_SEQUENTIAL:
+            return MADV_SEQUENTIAL;
+        case FileAccess::HINT_RANDOM:
+            return MADV_RANDOM;
+        case FileAccess::HINT_WILL_NEED:
+            return MADV_WILLNEED;
+        default:
+            return MADV_NORMAL;
+    }
+}
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+static int _fadvise_advice(FileAccess::AccessHint p_hint) {
+    switch (p_hint) {
+        case FileAccess::HINT_SEQUENTIAL:
+            return POSIX_FADV_SEQUENTIAL;
+        case FileAccess::HINT_RANDOM:
+            return POSIX_FADV_RANDOM;
+        case FileAccess::HINT_WILL_NEED:
+            return POSIX_FADV_WILLNEED;
+        default:
+            return POSIX_FADV_NORMAL;
+    }
+}
+#endif
+
+Errors FileAccessUnix::_open(const String& p_path, ModeFlags p_mode) {
+    close();
+    _path = p_path;
+    _mode = p_mode;
+    _last_error = Errors::NONE;
+    _eof = false;
+    const CharString path = p_path.utf8();
+
+    if (p_mode == WRITE) {
+        _fd = ::open(path.get_data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        if (_fd < 0) {
+            _last_error = _open_error(errno, Errors::ERROR_FILE_CANT_WRITE);
+            return _last_error;
+        }
+        _buffer = static_cast<uint8_t*>(memalloc(WRITE_BUFFER_SIZE));
+        if (!_buffer) {
+            close();
+            ERROR_FAIL_V(Errors::ERROR_OUT_OF_MEMORY);
+        }
+        _write_pos = _buffer;
+        _write_end = _buffer + WRITE_BUFFER_SIZE;
+        return Errors::NONE;
+    }
+
+    ERROR_FAIL_COND_V_MSG(p_mode != READ && p_mode != READ_STREAMING, Errors::ERROR_INVALID_PARAMETER, "Invalid file access mode.");
+    _fd = ::open(path.get_data(), O_RDONLY | O_CLOEXEC);
+    if (_fd < 0) {
+        _last_error = _open_error(errno, Errors::ERROR_FILE_CANT_OPEN);
+        return _last_error;
+    }
+
+    struct stat st;
+    if (fstat(_fd, &st) != 0 || S_ISDIR(st.st_mode)) {
+        close();
+        _last_error = Errors::ERROR_FILE_CANT_OPEN;
+        return _last_error;
+    }
+    _length = S_ISREG(st.st_mode) ? uint64_t(st.st_size) : 0;
+
+    if (p_mode == READ && S_ISREG(st.st_mode) && _length > 0 && _length <= SIZE_MAX) {
+        void* map = mmap(nullptr, size_t(_length), PROT_READ, MAP_PRIVATE, _fd, 0);
+        if (map != MAP_FAILED) {
+            // The mapping keeps the file alive on its own.
+            ::close(_fd);
+            _fd = -1;
+            _map = static_cast<uint8_t*>(map);
+            madvise(_map, size_t(_length), MADV_SEQUENTIAL);
+            _read_pos = _map;
+            _read_end = _map + _length;
+            return Errors::NONE;
+        }
+    }
+
+    // Streaming, asked for or because the file can't be mapped (empty, not a
+    // regular file, or on a file system that doesn't support it).
+    _buffer = static_cast<uint8_t*>(memalloc(STREAM_BUFFER_SIZE));
+    if (!_buffer) {
+        close();
+        ERROR_FAIL_V(Errors::ERROR_OUT_OF_MEMORY);
+    }
+    _read_pos = _buffer;
+    _read_end = _buffer;
+#if defined(POSIX_FADV_SEQUENTIAL)
+    posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    return Errors::NONE;
+}
+
+bool FileAccessUnix::_refill() {
+    if (_fd < 0 || _mode == WRITE) {
+        return false;
+    }
+
+    // The descriptor is always at the end of the buffered bytes.
+    _buffer_offset += _read_end - _buffer;
+    ssize_t got;
+    do {
+        got = ::read(_fd, _buffer, STREAM_BUFFER_SIZE);
+    } while (got < 0 && errno == EINTR);
+
+    if (got <= 0) {
+        if (got < 0) {
+            _last_error = Errors::ERROR_FILE_CANT_READ;
+        }
+        _read_pos = _buffer;
+        _read_end = _buffer;
+        return false;
+    }
+
+    _read_pos = _buffer;
+    _read_end = _buffer + got;
+#if defined(POSIX_FADV_WILLNEED)
+    // Start on the next chunk while this one is consumed.
+    posix_fadvise(_fd, off_t(_buffer_offset + got), STREAM_BUFFER_SIZE, POSIX_FADV_WILLNEED);
+#endif
+    return true;
+}
+
+Errors FileAccessUnix::_flush_buffer() {
+    ERROR_FAIL_COND_V_MSG(_mode != WRITE || _fd < 0, Errors::ERROR_FILE_CANT_WRITE, "File is not open for writing.");
+
+    const uint8_t* src = _buffer;
+    uint64_t left = _write_pos - _buffer;
+    Errors err = Errors::NONE;
+    while (left > 0) {
+        const ssize_t written = ::write(_fd, src, left);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            err = Errors::ERROR_FILE_CANT_WRITE;
+            _last_error = err;
+            break;
+        }
+        src += written;
+        left -= written;
+    }
+
+    // What couldn't be written is dropped, with the error kept for
+    // get_error().
+    _buffer_offset += src - _buffer;
+    _length = MAX(_length, _buffer_offset);
+    _write_pos = _buffer;
+    return err;
+}
+
+void FileAccessUnix::close() {
+    if (_mode == WRITE && _fd >= 0) {
+        _flush_buffer();
+    }
+    if (_map) {
+        munmap(_map, size_t(_length));
+        _map = nullptr;
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+    if (_buffer) {
+        memfree(_buffer);
+        _buffer = nullptr;
+    }
+
+    _read_pos = nullptr;
+    _read_end = nullptr;
+    _write_pos = nullptr;
+    _write_end = nullptr;
+    _buffer_offset = 0;
+    _length = 0;
+}
+
+bool FileAccessUnix::is_open() const {
+    return _fd >= 0 || _map;
+}
+
+Errors FileAccessUnix::get_error() const {
+    if (_last_error != Errors::NONE) {
+        return _last_error;
+    }
+    return _eof ? Errors::ERROR_FILE_EOF : Errors::NONE;
+}
+
+void FileAccessUnix::seek(uint64_t p_position) {
+    ERROR_FAIL_COND_MSG(!is_open(), "File must be opened before use.");
+    _eof = false;
+
+    if (_map) {
+        _read_pos = _map + MIN(p_position, _length);
+        return;
+    }
+
+    if (_mode == WRITE) {
+        _flush_buffer();
+    } else if (p_position >= _buffer_offset && p_position <= _buffer_offset + (_read_end - _buffer)) {
+        // Still buffered.
+        _read_pos = _buffer + (p_position - _buffer_offset);
+        return;
+    }
+
+    if (lseek(_fd, off_t(p_position), SEEK_SET) < 0) {
+        _last_error = Errors::ERROR_FILE_CANT_READ;
+        return;
+    }
+    _buffer_offset = p_position;
+    if (_mode != WRITE) {
+        _read_pos = _buffer;
+        _read_end = _buffer;
+    }
+}
+
+void FileAccessUnix::seek_end(int64_t p_position) {
+    const int64_t position = int64_t(get_length()) + p_position;
+    seek(uint64_t(MAX(position, int64_t(0))));
+}
+
+uint64_t FileAccessUnix::get_position() const {
+    if (_map) {
+        return _read_pos - _map;
+    }
+    if (_mode == WRITE) {
+        return _buffer_offset + (_write_pos - _buffer);
+    }
+    return _buffer_offset + (_read_pos - _buffer);
+}
+
+uint64_t FileAccessUnix::get_length() const {
+    if (_mode == WRITE) {
+        return MAX(_length, get_position());
+    }
+    return _length;
+}
+
+void FileAccessUnix::set_access_hint(AccessHint p_hint) {
+    ERROR_FAIL_COND_MSG(!is_open(), "File must be opened before use.");
+    if (_map) {
+        madvise(_map, size_t(_length), _madvise_advice(p_hint));
+        return;
+    }
+#if defined(POSIX_FADV_SEQUENTIAL)
+    if (_mode != WRITE) {
+        posix_fadvise(_fd, 0, 0, _fadvise_advice(p_hint));
+    }
+#endif
+}
+
+Errors FileAccessUnix::flush() {
+    ERROR_FAIL_COND_V_MSG(_mode != WRITE || _fd < 0, Errors::ERROR_FILE_CANT_WRITE, "File is not open for writing.");
+    return _flush_buffer();
+}
+
+FileAccessUnix::~FileAccessUnix() {
+    close();
+}
+
+#endif
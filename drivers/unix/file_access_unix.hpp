@@ -0,0 +1,66 @@
+#ifndef __FILE_ACCESS_UNIX_HPP__
+#define __FILE_ACCESS_UNIX_HPP__
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "../../core/io/file_access.hpp"
+
+/** FileAccess over POSIX descriptors.
+ *
+ *  READ maps the file and closes the descriptor, so reading is plain memory
+ *  access and page faults, steered by madvise(). READ_STREAMING reads
+ *  STREAM_BUFFER_SIZE bytes at a time, and asks the kernel to start on the
+ *  next chunk while the current one is consumed. WRITE fills a buffer and
+ *  writes it out when full, on flush() or on close().
+ */
+class FileAccessUnix : public FileAccess {
+    GDCLASS(FileAccessUnix, FileAccess);
+
+    enum {
+        /** Large enough that the read ahead and the syscalls cost little next
+         *  to the copying. */
+        STREAM_BUFFER_SIZE = 256 * 1024,
+        WRITE_BUFFER_SIZE = 64 * 1024,
+    };
+
+    int _fd = -1;
+    ModeFlags _mode = READ;
+    String _path;
+    Errors _last_error = Errors::NONE;
+
+    /** The mapping, in READ mode. */
+    uint8_t* _map = nullptr;
+    /** Stream or write buffer. */
+    uint8_t* _buffer = nullptr;
+    /** File offset of _buffer[0]. */
+    uint64_t _buffer_offset = 0;
+    /** File size at open when reading, end of the flushed bytes when
+     *  writing. */
+    uint64_t _length = 0;
+
+protected:
+    virtual Errors _open(const String& p_path, ModeFlags p_mode) override;
+    virtual bool _refill() override;
+    virtual Errors _flush_buffer() override;
+
+public:
+    virtual void close() override;
+    virtual bool is_open() const override;
+    virtual String get_path() const override { return _path; }
+    virtual Errors get_error() const override;
+
+    virtual void seek(uint64_t p_position) override;
+    virtual void seek_end(int64_t p_position = 0) override;
+    virtual uint64_t get_position() const override;
+    virtual uint64_t get_length() const override;
+
+    virtual void set_access_hint(AccessHint p_hint) override;
+    virtual Errors flush() override;
+
+    FileAccessUnix() {}
+    virtual ~FileAccessUnix();
+};
+
+#endif
+
+#endif
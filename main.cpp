@@ -1,5 +1,15 @@
-int main() {
+#include <string.h>
 
+void drivers();
+int tests(int p_filter_count, const char* const* p_filters);
+
+int main(int argc, char** argv) {
+    drivers();
+
+    /** `--test [names...]` runs the tests, see tests/tests.cpp. */
+    if (argc > 1 && strcmp(argv[1], "--test") == 0) {
+        return tests(argc - 2, argv + 2) == 0 ? 0 : 1;
+    }
 
     return 0;
 }
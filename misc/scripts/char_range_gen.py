@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+
+"""Generates core/string/char_range.inc, the character class and case mapping
+tables behind core/string/char_utils.hpp.
+
+Character classes come from the Unicode character database shipped with
+Python (unicodedata), so the tables follow that Python's Unicode version.
+Case mappings are the simple, single character ones of UnicodeData.txt, which
+unicodedata doesn't expose (str.lower() and str.upper() apply the full
+mappings of SpecialCasing.txt instead). The UnicodeData.txt of the same
+version is downloaded from unicode.org, unless given. Run from the repository
+root:
+
+    python3 misc/scripts/char_range_gen.py [UnicodeData.txt [output]]
+"""
+
+import sys
+import unicodedata
+import urllib.request
+
+UNICODE_DATA_URL = "https://www.unicode.org/Public/%s/ucd/UnicodeData.txt"
+
+MAX_CHAR = 0x110000
+
+CLASS_BLOCK_SHIFT = 8
+CASE_BLOCK_SHIFT = 6
+
+LETTER = 1 << 0
+DIGIT = 1 << 1
+WHITESPACE = 1 << 2
+IDENTIFIER_START = 1 << 3
+IDENTIFIER_CONTINUE = 1 << 4
+
+# PropList.txt, White_Space; unicodedata doesn't expose it.
+WHITE_SPACE = [
+    (0x09, 0x0D),
+    (0x20, 0x20),
+    (0x85, 0x85),
+    (0xA0, 0xA0),
+    (0x1680, 0x1680),
+    (0x2000, 0x200A),
+    (0x2028, 0x2029),
+    (0x202F, 0x202F),
+    (0x205F, 0x205F),
+    (0x3000, 0x3000),
+]
+
+
+def char_class(c, white_space):
+    ch = chr(c)
+    category = unicodedata.category(ch)
+    flags = 0
+    if category.startswith("L"):
+        flags |= LETTER
+    if category == "Nd":
+        flags |= DIGIT
+    if c in white_space:
+        flags |= WHITESPACE
+    # str.isidentifier() follows XID_Start (plus '_') and XID_Continue.
+    if ch.isidentifier():
+        flags |= IDENTIFIER_START
+    if ("a" + ch).isidentifier():
+        flags |= IDENTIFIER_CONTINUE
+    return flags
+
+
+def read_unicode_data(path):
+    if path:
+        with open(path, encoding="utf-8") as data:
+            return data.read()
+    with urllib.request.urlopen(UNICODE_DATA_URL % unicodedata.unidata_version) as data:
+        return data.read().decode("utf-8")
+
+
+def case_deltas(unicode_data):
+    """Offsets to the simple lower and upper case mappings of every character,
+    fields 13 and 12 of UnicodeData.txt, 0 when there is none."""
+    lower = [0] * MAX_CHAR
+    upper = [0] * MAX_CHAR
+    for line in unicode_data.splitlines():
+        fields = line.split(";")
+        if len(fields) < 15:
+            continue
+        c = int(fields[0], 16)
+        if fields[12]:
+            upper[c] = int(fields[12], 16) - c
+        if fields[13]:
+            lower[c] = int(fields[13], 16) - c
+    return lower, upper
+
+
+def two_level(values, shift):
+    """Splits values into blocks of 1 << shift, returning the index of every
+    block and the distinct blocks, in order of first use."""
+    size = 1 << shift
+    index = []
+    blocks = []
+    known = {}
+    for start in range(0, len(values), size):
+        block = tuple(values[start : start + size])
+        if block not in known:
+            known[block] = len(blocks)
+            blocks.append(block)
+        index.append(known[block])
+    assert len(blocks) <= 256, "Block numbers must fit in a byte."
+    return index, blocks
+
+
+def write_values(out, values, per_line, fmt, indent="    "):
+    for start in range(0, len(values), per_line):
+        line = ", ".join(fmt % v for v in values[start : start + per_line])
+        out.write("%s%s,\n" % (indent, line))
+
+
+def write_index(out, name, index):
+    out.write("constexpr inline uint8_t %s[%d] = {\n" % (name, len(index)))
+    write_values(out, index, 16, "%d")
+    out.write("};\n\n")
+
+
+def write_blocks(out, type_name, name, blocks, per_line, fmt):
+    out.write("constexpr inline %s %s[%d][%d] = {\n" % (type_name, name, len(blocks), len(blocks[0])))
+    for block in blocks:
+        out.write("    {\n")
+        write_values(out, block, per_line, fmt, "        ")
+        out.write("    },\n")
+    out.write("};\n\n")
+
+
+def main(unicode_data_path, path):
+    white_space = set()
+    for start, end in WHITE_SPACE:
+        white_space.update(range(start, end + 1))
+
+    classes = [char_class(c, white_space) for c in range(MAX_CHAR)]
+    class_index, class_blocks = two_level(classes, CLASS_BLOCK_SHIFT)
+
+    lower, upper = case_deltas(read_unicode_data(unicode_data_path))
+    # Characters whose full mappings have several characters still have a
+    # simple one: U+0130 lowers to 'i', U+1F80 uppers to U+1F88.
+    assert 0x130 + lower[0x130] == 0x69 and 0x1F80 + upper[0x1F80] == 0x1F88
+    # Nothing maps past the last cased character; end the tables there.
+    case_block = 1 << CASE_BLOCK_SHIFT
+    last_cased = max(c for c in range(MAX_CHAR) if lower[c] or upper[c])
+    case_limit = (last_cased // case_block + 1) * case_block
+    lower_index, lower_blocks = two_level(lower[:case_limit], CASE_BLOCK_SHIFT)
+    upper_index, upper_blocks = two_level(upper[:case_limit], CASE_BLOCK_SHIFT)
+
+    with open(path, "w", newline="\n") as out:
+        out.write("#ifndef __CHAR_RANGE_INC__\n#define __CHAR_RANGE_INC__\n\n")
+        out.write("// Generated by misc/scripts/char_range_gen.py from Unicode %s. Do not edit.\n\n" % unicodedata.unidata_version)
+        out.write("#include <stdint.h>\n\n")
+
+        out.write("/** Bits of char_class_blocks. */\n")
+        out.write("enum CharClass : uint8_t {\n")
+        out.write("    CHAR_CLASS_LETTER = %d,\n" % LETTER)
+        out.write("    CHAR_CLASS_DIGIT = %d,\n" % DIGIT)
+        out.write("    CHAR_CLASS_WHITESPACE = %d,\n" % WHITESPACE)
+        out.write("    CHAR_CLASS_IDENTIFIER_START = %d,\n" % IDENTIFIER_START)
+        out.write("    CHAR_CLASS_IDENTIFIER_CONTINUE = %d,\n" % IDENTIFIER_CONTINUE)
+        out.write("};\n\n")
+
+        out.write("/** The classes of c are char_class_blocks[char_class_index[c >> CHAR_CLASS_BLOCK_SHIFT]][c & CHAR_CLASS_BLOCK_MASK]. */\n")
+        out.write("constexpr inline uint32_t CHAR_CLASS_BLOCK_SHIFT = %d;\n" % CLASS_BLOCK_SHIFT)
+        out.write("constexpr inline uint32_t CHAR_CLASS_BLOCK_MASK = %d;\n" % ((1 << CLASS_BLOCK_SHIFT) - 1))
+        out.write("constexpr inline char32_t CHAR_CLASS_LIMIT = 0x%x;\n\n" % MAX_CHAR)
+        write_index(out, "char_class_index", class_index)
+        write_blocks(out, "uint8_t", "char_class_blocks", class_blocks, 32, "%d")
+
+        out.write("/** c + *_case_blocks[*_case_index[c >> CASE_BLOCK_SHIFT]][c & CASE_BLOCK_MASK] is the\n")
+        out.write(" *  case mapping of c, for c below CASE_LIMIT; no character past it has one. */\n")
+        out.write("constexpr inline uint32_t CASE_BLOCK_SHIFT = %d;\n" % CASE_BLOCK_SHIFT)
+        out.write("constexpr inline uint32_t CASE_BLOCK_MASK = %d;\n" % (case_block - 1))
+        out.write("constexpr inline char32_t CASE_LIMIT = 0x%x;\n\n" % case_limit)
+        write_index(out, "lower_case_index", lower_index)
+        write_blocks(out, "int32_t", "lower_case_blocks", lower_blocks, 16, "%d")
+        write_index(out, "upper_case_index", upper_index)
+        write_blocks(out, "int32_t", "upper_case_blocks", upper_blocks, 16, "%d")
+
+        out.write("#endif\n")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1] if len(sys.argv) > 1 else None, sys.argv[2] if len(sys.argv) > 2 else "core/string/char_range.inc")
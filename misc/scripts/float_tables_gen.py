@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+
+"""Generates core/string/float_tables.inc, the 128-bit powers of ten and five
+behind the float formatting and parsing of core/string/float_conversion.cpp.
+Run from the repository root:
+
+    python3 misc/scripts/float_tables_gen.py
+"""
+
+import sys
+from fractions import Fraction
+from math import floor
+
+# Parsing (Eisel-Lemire): 5^q for every decimal exponent q that doesn't
+# trivially overflow or underflow a double.
+POW5_MIN = -342
+POW5_MAX = 308
+
+# Formatting (Schubfach): 10^-k for the k of every double.
+POW10_MIN = -324
+POW10_MAX = 292
+
+MASK_63 = (1 << 63) - 1
+MASK_64 = (1 << 64) - 1
+
+
+def pow5_128(q):
+    """5^q normalized to [2^127, 2^128): truncated for q >= 0, and for q < 0
+    rounded up before the truncation, as Eisel-Lemire expects."""
+    if q >= 0:
+        power5 = 5**q
+        while power5 < (1 << 127):
+            power5 *= 2
+        while power5 >= (1 << 128):
+            power5 //= 2
+        return power5
+
+    power5 = 5**-q
+    z = power5.bit_length()
+    if q >= -27:
+        c = 2 ** (z + 127) // power5 + 1
+    else:
+        c = 2 ** (2 * z + 2 * 64) // power5 + 1
+    while c >= (1 << 128):
+        c //= 2
+    return c
+
+
+def pow10_g(k):
+    """floor(beta) + 1, for 10^-k = beta * 2^r with 2^125 <= beta < 2^126."""
+    x = Fraction(10) ** -k
+    r = x.numerator.bit_length() - x.denominator.bit_length() - 126
+    while x / Fraction(2) ** r >= 2**126:
+        r += 1
+    while x / Fraction(2) ** r < 2**125:
+        r -= 1
+    return floor(x / Fraction(2) ** r) + 1
+
+
+def main(path):
+    with open(path, "w", newline="\n") as out:
+        out.write("#ifndef __FLOAT_TABLES_INC__\n#define __FLOAT_TABLES_INC__\n\n")
+        out.write("// Generated by misc/scripts/float_tables_gen.py. Do not edit.\n\n")
+        out.write("#include <stdint.h>\n\n")
+
+        out.write("constexpr inline int POW5_128_MIN_EXPONENT = %d;\n" % POW5_MIN)
+        out.write("constexpr inline int POW5_128_MAX_EXPONENT = %d;\n\n" % POW5_MAX)
+        out.write("/** 5^q normalized to 128 bits, as high and low words, from POW5_128_MIN_EXPONENT up. */\n")
+        out.write("constexpr inline uint64_t pow5_128[%d][2] = {\n" % (POW5_MAX - POW5_MIN + 1))
+        for q in range(POW5_MIN, POW5_MAX + 1):
+            c = pow5_128(q)
+            out.write("    { 0x%016xULL, 0x%016xULL },\n" % (c >> 64, c & MASK_64))
+        out.write("};\n\n")
+
+        out.write("constexpr inline int POW10_G_MIN_EXPONENT = %d;\n" % POW10_MIN)
+        out.write("constexpr inline int POW10_G_MAX_EXPONENT = %d;\n\n" % POW10_MAX)
+        out.write("/** floor(beta) + 1 for 10^-k = beta * 2^r, 2^125 <= beta < 2^126, as its high and\n")
+        out.write(" *  low 63 bits, from POW10_G_MIN_EXPONENT up. */\n")
+        out.write("constexpr inline uint64_t pow10_g[%d][2] = {\n" % (POW10_MAX - POW10_MIN + 1))
+        for k in range(POW10_MIN, POW10_MAX + 1):
+            g = pow10_g(k)
+            out.write("    { 0x%016xULL, 0x%016xULL },\n" % (g >> 63, g & MASK_63))
+        out.write("};\n\n")
+
+        out.write("#endif\n")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1] if len(sys.argv) > 1 else "core/string/float_tables.inc")
@@ -0,0 +1,159 @@
+#include "../../test_macros.hpp"
+
+#include "../../../core/io/async_file_io.hpp"
+#include "../../../core/io/async_file_io_threaded.hpp"
+#include "../../../core/os/memory.hpp"
+
+#if defined(__linux__)
+#include "../../../drivers/unix/async_file_io_uring.hpp"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_ASYNC_FILE_IO_FILES 8
+#define TEST_ASYNC_FILE_IO_BIG_SIZE (5 * 1024 * 1024 + 3)
+
+static String _test_async_file_io_path(const char* p_name) {
+    const char* dir = getenv("TMPDIR");
+    return String(dir && dir[0] ? dir : "/tmp") + "/godot_test_async_file_io_" + String::num_int64(getpid()) + "_" + p_name;
+}
+
+static Vector<uint8_t> _test_async_file_io_data(int64_t p_size, uint8_t p_seed) {
+    Vector<uint8_t> data;
+    data.resize(p_size);
+    uint8_t* w = data.ptrw();
+    for (int64_t i = 0; i < p_size; i++) {
+        w[i] = uint8_t(i * 31 + p_seed + (i >> 8));
+    }
+    return data;
+}
+
+static bool _test_async_file_io_equal(const Vector<uint8_t>& p_data, const uint8_t* p_expected, int64_t p_size) {
+    return p_data.size() == p_size && (p_size == 0 || memcmp(p_data.ptr(), p_expected, p_size) == 0);
+}
+
+static void _test_async_file_io_count(void* p_userdata, AsyncFileBatch* p_batch) {
+    static_cast<SafeNumeric<int>*>(p_userdata)->increment();
+}
+
+/** Writes TEST_ASYNC_FILE_IO_FILES files in one batch, a multi-MB one
+ *  among them, then reads them back whole with read_files(). */
+static void _test_async_file_io_round_trip(AsyncFileIO* p_io, const String* p_paths, SafeNumeric<int>* r_calls) {
+    Vector<AsyncFileIO::Request> writes;
+    writes.resize(TEST_ASYNC_FILE_IO_FILES);
+    Vector<String> paths;
+    for (int i = 0; i < TEST_ASYNC_FILE_IO_FILES; i++) {
+        AsyncFileIO::Request& request = writes.ptrw()[i];
+        request.operation = AsyncFileIO::OP_WRITE;
+        request.path = p_paths[i];
+        request.data = _test_async_file_io_data(i == 0 ? TEST_ASYNC_FILE_IO_BIG_SIZE : i * 1000, uint8_t(i));
+        paths.push_back(p_paths[i]);
+    }
+
+    Ref<AsyncFileBatch> batch = p_io->submit(writes, &_test_async_file_io_count, &r_calls[0]);
+    batch->wait();
+    CHECK(batch->is_completed());
+    CHECK(batch->get_error() == Errors::NONE);
+
+    batch = p_io->read_files(paths, &_test_async_file_io_count, &r_calls[1]);
+    batch->wait();
+    CHECK(batch->get_error() == Errors::NONE);
+    CHECK(batch->get_request_count() == TEST_ASYNC_FILE_IO_FILES);
+    bool same = true;
+    for (int i = 0; i < TEST_ASYNC_FILE_IO_FILES; i++) {
+        const AsyncFileIO::Request& request = batch->get_request(i);
+        same = same && request.error == Errors::NONE && _test_async_file_io_equal(request.data, writes[i].data.ptr(), writes[i].data.size());
+    }
+    CHECK(same);
+}
+
+/** A range inside the file, a read starting past its end, and a path that
+ *  doesn't exist, in one batch. */
+static void _test_async_file_io_ranges(AsyncFileIO* p_io, const String& p_path, const String& p_missing, SafeNumeric<int>* r_calls) {
+    const Vector<uint8_t> data = _test_async_file_io_data(4000, 7);
+    Vector<AsyncFileIO::Request> write;
+    write.resize(1);
+    write.ptrw()[0].operation = AsyncFileIO::OP_WRITE;
+    write.ptrw()[0].path = p_path;
+    write.ptrw()[0].data = data;
+    Ref<AsyncFileBatch> batch = p_io->submit(write);
+    batch->wait();
+    CHECK(batch->get_error() == Errors::NONE);
+
+    Vector<AsyncFileIO::Request> reads;
+    reads.resize(4);
+    AsyncFileIO::Request* w = reads.ptrw();
+    w[0].path = p_path;
+    w[0].offset = 1000;
+    w[0].length = 500;
+    // Runs into the end: gets what's there.
+    w[1].path = p_path;
+    w[1].offset = 3900;
+    w[1].length = 500;
+    w[2].path = p_path;
+    w[2].offset = 5000;
+    w[3].path = p_missing;
+
+    batch = p_io->submit(reads, &_test_async_file_io_count, &r_calls[2]);
+    batch->wait();
+    CHECK(batch->get_request(0).error == Errors::NONE);
+    CHECK(_test_async_file_io_equal(batch->get_request(0).data, data.ptr() + 1000, 500));
+    CHECK(batch->get_request(1).error == Errors::NONE);
+    CHECK(_test_async_file_io_equal(batch->get_request(1).data, data.ptr() + 3900, 100));
+    CHECK(batch->get_request(2).error == Errors::NONE);
+    CHECK(batch->get_request(2).data.is_empty());
+    CHECK(batch->get_request(3).error == Errors::ERROR_FILE_NOT_FOUND);
+    CHECK(batch->get_error() == Errors::ERROR_FILE_NOT_FOUND);
+}
+
+/** Completes within submit(), callback included. */
+static void _test_async_file_io_empty(AsyncFileIO* p_io, SafeNumeric<int>* r_calls) {
+    Ref<AsyncFileBatch> batch = p_io->submit(Vector<AsyncFileIO::Request>(), &_test_async_file_io_count, &r_calls[3]);
+    CHECK(batch->is_completed());
+    CHECK(r_calls[3].get() == 1);
+    CHECK(batch->get_request_count() == 0);
+    CHECK(batch->get_error() == Errors::NONE);
+    batch->wait();
+}
+
+/** Runs every case on p_io, which it deletes, against files in the
+ *  temporary directory. */
+static void _test_async_file_io_backend(AsyncFileIO* p_io, const char* p_backend) {
+    const String prefix = String(p_backend) + "_";
+    String paths[TEST_ASYNC_FILE_IO_FILES + 1];
+    for (int i = 0; i < TEST_ASYNC_FILE_IO_FILES + 1; i++) {
+        paths[i] = _test_async_file_io_path((prefix + String::num_int64(i)).utf8().get_data());
+    }
+    const String missing = _test_async_file_io_path((prefix + "missing").utf8().get_data());
+
+    SafeNumeric<int> calls[4];
+    _test_async_file_io_round_trip(p_io, paths, calls);
+    _test_async_file_io_ranges(p_io, paths[TEST_ASYNC_FILE_IO_FILES], missing, calls);
+    _test_async_file_io_empty(p_io, calls);
+
+    // The callback runs after the batch is marked completed, which wait()
+    // may see first; deleting the backend waits for its threads.
+    memdelete(p_io);
+    bool once = true;
+    for (int i = 0; i < 4; i++) {
+        once = once && calls[i].get() == 1;
+    }
+    CHECK(once);
+
+    for (int i = 0; i < TEST_ASYNC_FILE_IO_FILES + 1; i++) {
+        remove(paths[i].utf8().get_data());
+    }
+}
+
+void test_async_file_io() {
+    _test_async_file_io_backend(memnew(AsyncFileIOThreaded), "threads");
+#if defined(__linux__)
+    AsyncFileIO* uring = AsyncFileIOUring::try_create();
+    if (uring) {
+        _test_async_file_io_backend(uring, "io_uring");
+    }
+#endif
+}
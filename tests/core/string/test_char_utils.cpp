@@ -0,0 +1,20 @@
+#include "../../test_macros.hpp"
+
+#include "../../../core/string/char_utils.hpp"
+
+/** The simple case mappings still apply where the full ones have several
+ *  characters (U+0130 lowers to "i̇", U+1F80 uppers to "ἈΙ"). */
+static void _test_char_utils_case() {
+    CHECK(unicode_to_lower('A') == 'a');
+    CHECK(unicode_to_upper('a') == 'A');
+    CHECK(unicode_to_lower(0x0130) == 0x0069);
+    CHECK(unicode_to_upper(0x1F80) == 0x1F88);
+    CHECK(unicode_to_upper(0x1FB3) == 0x1FBC);
+    CHECK(unicode_to_upper(0x00DF) == 0x00DF);
+    CHECK(unicode_to_lower(0x10400) == 0x10428);
+    CHECK(unicode_to_upper(0x10428) == 0x10400);
+}
+
+void test_char_utils() {
+    _test_char_utils_case();
+}
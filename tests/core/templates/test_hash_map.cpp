@@ -0,0 +1,146 @@
+#include "../../test_macros.hpp"
+
+#include "../../../core/string/ustring.hpp"
+#include "../../../core/templates/hash_map.hpp"
+#include "../../../core/templates/hash_set.hpp"
+
+static void _test_hash_map_basics() {
+    HashMap<int, int> map;
+    CHECK(map.is_empty());
+    for (int i = 0; i < 1000; i++) {
+        map.insert(i, i * 10);
+    }
+    CHECK(map.size() == 1000);
+    CHECK(map.has(999));
+    CHECK(!map.has(1000));
+    CHECK(map.get(123) == 1230);
+    CHECK(map.getptr(1000) == nullptr);
+
+    map.insert(123, 7);
+    CHECK(map.size() == 1000);
+    CHECK(map.get(123) == 7);
+
+    CHECK(map.erase(123));
+    CHECK(!map.erase(123));
+    CHECK(!map.has(123));
+    CHECK(map.size() == 999);
+
+    map[123] = 8;
+    CHECK(map.get(123) == 8);
+
+    HashMap<int, int> copy = map;
+    CHECK(copy.size() == map.size());
+    CHECK(copy.get(500) == 5000);
+
+    map.clear();
+    CHECK(map.is_empty());
+    CHECK(!map.has(500));
+    map.insert(500, 1);
+    CHECK(map.get(500) == 1);
+}
+
+static void _test_hash_map_insertion_order() {
+    HashMap<int, int> map;
+    for (int i = 0; i < 100; i++) {
+        map.insert((i * 37) % 100, i);
+    }
+    for (int i = 0; i < 100; i += 3) {
+        map.erase((i * 37) % 100);
+    }
+
+    // Values left are the insertion indices that aren't multiples of 3.
+    int expected = 1;
+    bool ordered = true;
+    for (const KeyValue<int, int>& E : map) {
+        ordered = ordered && E.value == expected;
+        expected += expected % 3 == 2 ? 2 : 1;
+    }
+    CHECK(ordered);
+    CHECK(expected == 100);
+}
+
+static void _test_hash_map_erase_while_iterating() {
+    HashMap<int, int> map;
+    for (int i = 0; i < 100; i++) {
+        map.insert(i, i);
+    }
+
+    // Erasing every entry, the current one included, must still end.
+    int visited = 0;
+    for (HashMap<int, int>::Iterator it = map.begin(); it != map.end() && visited <= 100;) {
+        const int key = it->key;
+        ++it;
+        map.erase(key);
+        visited++;
+    }
+    CHECK(visited == 100);
+    CHECK(map.is_empty());
+
+    // Emptied by erasing, the map takes new entries as usual.
+    for (int i = 0; i < 100; i++) {
+        map.insert(i + 1000, i);
+    }
+    CHECK(map.size() == 100);
+    CHECK(map.get(1099) == 99);
+    int count = 0;
+    for (const KeyValue<int, int>& E : map) {
+        count += E.key >= 1000;
+    }
+    CHECK(count == 100);
+}
+
+static void _test_hash_map_insert_from_itself() {
+    // Values are read from the map while inserting grows it. Strings leave
+    // nothing behind when moved, so a read of the old storage shows.
+    HashMap<int, String> map;
+    map.insert(0, String("value that lives on the heap"));
+    bool equal = true;
+    for (int i = 1; i < 2000; i++) {
+        map.insert(i, map.get(i - 1));
+        equal = equal && map.get(i) == map.get(0);
+    }
+    CHECK(equal);
+
+    // The documented way to assign from another element: operator[] may
+    // grow the map after m[b] was read.
+    HashMap<int, String> assigned;
+    assigned[0] = String("another heap allocated value");
+    equal = true;
+    for (int i = 1; i < 2000; i++) {
+        const String previous = assigned[i - 1];
+        assigned[i] = previous;
+        equal = equal && assigned[i] == assigned[0];
+    }
+    CHECK(equal);
+}
+
+static void _test_hash_map_reserve() {
+    HashMap<int, int> map;
+    map.reserve(1000);
+    const uint32_t capacity = map.get_capacity();
+    for (int i = 0; i < 1000; i++) {
+        map.insert(i, i);
+    }
+    CHECK(map.get_capacity() == capacity);
+}
+
+static void _test_hash_set() {
+    HashSet<int> set;
+    for (int i = 0; i < 1000; i++) {
+        set.insert(i % 500);
+    }
+    CHECK(set.size() == 500);
+    CHECK(set.has(499));
+    CHECK(set.erase(10));
+    CHECK(!set.has(10));
+    CHECK(set.size() == 499);
+}
+
+void test_hash_map() {
+    _test_hash_map_basics();
+    _test_hash_map_insertion_order();
+    _test_hash_map_erase_while_iterating();
+    _test_hash_map_insert_from_itself();
+    _test_hash_map_reserve();
+    _test_hash_set();
+}
@@ -0,0 +1,155 @@
+#include "../../test_macros.hpp"
+
+#include "../../../core/os/memory.hpp"
+#include "../../../core/variant/packed_kernels.hpp"
+
+#include <string.h>
+#include <type_traits>
+
+#define TEST_PACKED_KERNELS_MAX_COUNT 1024
+
+static const char* _test_packed_kernels_sets[] = { "AVX2", "SSE4.1", "NEON" };
+
+template <typename T>
+struct TestPackedKernelsData {
+    typedef typename PackedKernels::Wide<T>::Type W;
+
+    T dst[TEST_PACKED_KERNELS_MAX_COUNT];
+    T src[TEST_PACKED_KERNELS_MAX_COUNT];
+    T value[3];
+    T other[3];
+    W result[3];
+};
+
+static _FORCE_INLINE_ uint64_t _test_packed_kernels_random(uint64_t& r_seed) {
+    r_seed = r_seed * 6364136223846793005ull + 1442695040888963407ull;
+    return r_seed;
+}
+
+/** Integers over their whole range, so that sums and products wrap. */
+static void _test_packed_kernels_fill(int64_t* r_values, int p_count, uint64_t& r_seed) {
+    for (int i = 0; i < p_count; i++) {
+        r_values[i] = int64_t(_test_packed_kernels_random(r_seed));
+    }
+}
+
+/** Quarters between -4 and 4: products and sums of a few hundred of them are
+ *  exact, so every order of adding them and fused multiply-adds give the
+ *  same bits. */
+static void _test_packed_kernels_fill(float* r_values, int p_count, uint64_t& r_seed) {
+    for (int i = 0; i < p_count; i++) {
+        r_values[i] = float(int(_test_packed_kernels_random(r_seed) >> 59) - 16) * 0.25f;
+    }
+}
+
+/** Runs p_kernel on the same random data, p_count scalars of it, with the
+ *  scalar kernels and with p_set, and checks that both wrote the same bytes. */
+template <typename T, typename F>
+static bool _test_packed_kernels_same(const char* p_set, int p_count, const F& p_kernel) {
+    TestPackedKernelsData<T>* expected = memnew(TestPackedKernelsData<T>);
+    TestPackedKernelsData<T>* data = memnew(TestPackedKernelsData<T>);
+    uint64_t seed = uint64_t(p_count) * 0x9E3779B97F4A7C15ull + 1;
+    _test_packed_kernels_fill(expected->dst, TEST_PACKED_KERNELS_MAX_COUNT, seed);
+    _test_packed_kernels_fill(expected->src, TEST_PACKED_KERNELS_MAX_COUNT, seed);
+    _test_packed_kernels_fill(expected->value, 3, seed);
+    _test_packed_kernels_fill(expected->other, 3, seed);
+    memset(expected->result, 0, sizeof(expected->result));
+    memcpy((void*)data, (const void*)expected, sizeof(TestPackedKernelsData<T>));
+
+    PackedKernels::set_instruction_set("scalar");
+    p_kernel(*expected, p_count);
+    PackedKernels::set_instruction_set(p_set);
+    p_kernel(*data, p_count);
+
+    const bool same = memcmp((const void*)expected, (const void*)data, sizeof(TestPackedKernelsData<T>)) == 0;
+    memdelete(data);
+    memdelete(expected);
+    return same;
+}
+
+/** Every kernel with p_stride (1, or 3 as for Vector3) on p_set against the
+ *  scalar path. Counts go through every remainder of the vector widths, then
+ *  cover a few long buffers. */
+template <typename T>
+static void _test_packed_kernels_against_scalar(const char* p_set, int p_stride) {
+    typedef TestPackedKernelsData<T> Data;
+    static const int long_counts[] = { 255, 256, 257, 1021 };
+
+    bool same = true;
+    for (int c = 0; c < 40 + 4; c++) {
+        const int count = c < 40 ? c * p_stride : long_counts[c - 40] / p_stride * p_stride;
+
+        same = same && _test_packed_kernels_same<T>(p_set, count, [](Data& r_data, int p_count) {
+            PackedKernels::add(r_data.dst, r_data.src, p_count);
+        });
+        same = same && _test_packed_kernels_same<T>(p_set, count, [](Data& r_data, int p_count) {
+            PackedKernels::mul(r_data.dst, r_data.src, p_count);
+        });
+        same = same && _test_packed_kernels_same<T>(p_set, count, [p_stride](Data& r_data, int p_count) {
+            PackedKernels::add_value(r_data.dst, p_count, r_data.value, p_stride);
+        });
+        same = same && _test_packed_kernels_same<T>(p_set, count, [p_stride](Data& r_data, int p_count) {
+            PackedKernels::mul_value(r_data.dst, p_count, r_data.value, p_stride);
+        });
+        same = same && _test_packed_kernels_same<T>(p_set, count, [p_stride](Data& r_data, int p_count) {
+            PackedKernels::fma(r_data.dst, r_data.src, p_count, r_data.value, p_stride);
+        });
+        same = same && _test_packed_kernels_same<T>(p_set, count, [p_stride](Data& r_data, int p_count) {
+            PackedKernels::fma_value(r_data.dst, p_count, r_data.value, r_data.other, p_stride);
+        });
+        same = same && _test_packed_kernels_same<T>(p_set, count, [p_stride](Data& r_data, int p_count) {
+            for (int i = 0; i < 3; i++) {
+                r_data.value[i] = T(-1 - i);
+                r_data.other[i] = T(1 + i);
+            }
+            PackedKernels::clamp(r_data.dst, p_count, r_data.value, r_data.other, p_stride);
+        });
+        same = same && _test_packed_kernels_same<T>(p_set, count, [p_stride](Data& r_data, int p_count) {
+            PackedKernels::sum(r_data.src, p_count, r_data.result, p_stride);
+        });
+        if (count == 0) {
+            continue;
+        }
+        same = same && _test_packed_kernels_same<T>(p_set, count, [p_stride](Data& r_data, int p_count) {
+            PackedKernels::min(r_data.src, p_count, r_data.value, p_stride);
+        });
+        same = same && _test_packed_kernels_same<T>(p_set, count, [p_stride](Data& r_data, int p_count) {
+            PackedKernels::max(r_data.src, p_count, r_data.value, p_stride);
+        });
+        if (p_stride == 1) {
+            same = same && _test_packed_kernels_same<T>(p_set, count, [](Data& r_data, int p_count) {
+                r_data.result[0] = PackedKernels::dot(r_data.dst, r_data.src, p_count);
+            });
+        }
+        if constexpr (std::is_floating_point<T>::value) {
+            same = same && _test_packed_kernels_same<T>(p_set, count, [](Data& r_data, int p_count) {
+                PackedKernels::lerp(r_data.dst, r_data.src, p_count, T(0.5));
+            });
+        }
+    }
+    CHECK(same);
+}
+
+/** Each instruction set this CPU has gives the same results as the scalar
+ *  kernels, on int64_t, float and Vector3 (float with a stride of 3). */
+static void _test_packed_kernels_instruction_sets() {
+    const char* const detected = PackedKernels::get_instruction_set();
+    CHECK(PackedKernels::has_instruction_set("scalar"));
+    CHECK(PackedKernels::has_instruction_set(detected));
+
+    for (const char* set : _test_packed_kernels_sets) {
+        if (!PackedKernels::has_instruction_set(set)) {
+            continue;
+        }
+        _test_packed_kernels_against_scalar<int64_t>(set, 1);
+        _test_packed_kernels_against_scalar<float>(set, 1);
+        _test_packed_kernels_against_scalar<float>(set, 3);
+    }
+
+    PackedKernels::set_instruction_set(detected);
+    CHECK(strcmp(PackedKernels::get_instruction_set(), detected) == 0);
+}
+
+void test_packed_kernels() {
+    _test_packed_kernels_instruction_sets();
+}
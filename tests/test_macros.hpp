@@ -0,0 +1,18 @@
+#ifndef __TEST_MACROS_HPP__
+#define __TEST_MACROS_HPP__
+
+#include "../core/typedefs.hpp"
+
+/** Checks for the tests run by `godot_engine --test`, and by ctest. Each test
+ *  is a function listed in tests.cpp; a failed check prints where it failed
+ *  and the test goes on. */
+
+void _test_check_failed(const char* p_file, int p_line, const char* p_condition);
+
+#define CHECK(m_cond)                                        \
+    if (unlikely(!(m_cond))) {                               \
+        _test_check_failed(__FILE__, __LINE__, _STR(m_cond)); \
+    } else                                                   \
+        ((void)0)
+
+#endif
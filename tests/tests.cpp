@@ -1 +1,45 @@
-void tests() {}
+#include "./test_macros.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+void test_async_file_io();
+void test_char_utils();
+void test_hash_map();
+void test_packed_kernels();
+
+struct TestEntry {
+    const char* name;
+    void (*function)();
+};
+
+static const TestEntry test_entries[] = {
+    { "async_file_io", &test_async_file_io },
+    { "char_utils", &test_char_utils },
+    { "hash_map", &test_hash_map },
+    { "packed_kernels", &test_packed_kernels },
+};
+
+static int _test_failures = 0;
+
+void _test_check_failed(const char* p_file, int p_line, const char* p_condition) {
+    fprintf(stderr, "%s:%d: CHECK(%s) failed\n", p_file, p_line, p_condition);
+    _test_failures++;
+}
+
+/** Runs the tests whose name contains one of p_filters, or all of them
+ *  without filters, and returns how many checks failed. */
+int tests(int p_filter_count, const char* const* p_filters) {
+    for (const TestEntry& entry : test_entries) {
+        bool selected = p_filter_count == 0;
+        for (int i = 0; i < p_filter_count && !selected; i++) {
+            selected = strstr(entry.name, p_filters[i]) != nullptr;
+        }
+        if (selected) {
+            const int failures = _test_failures;
+            entry.function();
+            printf("%s %s\n", _test_failures == failures ? "passed" : "FAILED", entry.name);
+        }
+    }
+    return _test_failures;
+}